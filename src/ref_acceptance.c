@@ -383,6 +383,7 @@ int main(int argc, char *argv[]) {
 
     RSS(ref_gather_scalar_by_extension(ref_grid, 3, xyz, NULL, argv[3]), "in");
 
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     each_ref_node_valid_node(ref_node, node) {
       ref_node_xyz(ref_node, 0, node) = xyz[0 + 3 * node];
       ref_node_xyz(ref_node, 1, node) = xyz[1 + 3 * node];
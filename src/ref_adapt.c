@@ -34,6 +34,7 @@
 #include "ref_metric.h"
 #include "ref_mpi.h"
 #include "ref_node.h"
+#include "ref_perf.h"
 #include "ref_smooth.h"
 #include "ref_split.h"
 #include "ref_swap.h"
@@ -254,7 +255,8 @@ static REF_STATUS ref_adapt_parameter(REF_GRID ref_grid, REF_BOOL *all_done) {
 
   min_normdev = 2.0;
   if (ref_geom_model_loaded(ref_grid_geom(ref_grid)) ||
-      ref_geom_meshlinked(ref_grid_geom(ref_grid))) {
+      ref_geom_meshlinked(ref_grid_geom(ref_grid)) ||
+      ref_geom_surrogated(ref_grid_geom(ref_grid))) {
     ref_cell = ref_grid_tri(ref_grid);
     each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
       RSS(ref_geom_tri_norm_deviation(ref_grid, nodes, &normdev), "norm dev");
@@ -373,6 +375,7 @@ static REF_STATUS ref_adapt_tattle(REF_GRID ref_grid) {
   char is_ok = ' ';
   char not_ok = '*';
   char quality_met, short_met, long_met, normdev_met;
+  REF_STATUS status;
 
   if (ref_grid_twod(ref_grid) || ref_grid_surf(ref_grid)) {
     ref_cell = ref_grid_tri(ref_grid);
@@ -381,19 +384,29 @@ static REF_STATUS ref_adapt_tattle(REF_GRID ref_grid) {
   }
 
   min_quality = 1.0;
-  each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
-    if (ref_grid_twod(ref_grid)) {
-      RSS(ref_node_tri_quality(ref_grid_node(ref_grid), nodes, &quality),
-          "qual");
-    } else if (ref_grid_surf(ref_grid)) {
-      RSS(ref_node_tri_quality(ref_grid_node(ref_grid), nodes, &quality),
-          "qual");
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi)) \
+    schedule(static) private(nodes, quality)                   \
+    reduction(min : min_quality) reduction(max : status)
+#endif
+  for (cell = 0; cell < ref_cell_max(ref_cell); cell++) {
+    if (REF_SUCCESS != ref_cell_nodes(ref_cell, cell, nodes)) continue;
+    /* no return from a parallel loop, skip the cell and report after */
+    if (ref_grid_twod(ref_grid) || ref_grid_surf(ref_grid)) {
+      if (REF_SUCCESS != ref_node_tri_quality(ref_node, nodes, &quality)) {
+        status = REF_FAILURE;
+        continue;
+      }
     } else {
-      RSS(ref_node_tet_quality(ref_grid_node(ref_grid), nodes, &quality),
-          "qual");
+      if (REF_SUCCESS != ref_node_tet_quality(ref_node, nodes, &quality)) {
+        status = REF_FAILURE;
+        continue;
+      }
     }
     min_quality = MIN(min_quality, quality);
   }
+  RSS(status, "qual");
   quality = min_quality;
   RSS(ref_mpi_min(ref_mpi, &quality, &min_quality, REF_DBL_TYPE), "min");
   RSS(ref_mpi_bcast(ref_mpi, &quality, 1, REF_DBL_TYPE), "min");
@@ -408,7 +421,8 @@ static REF_STATUS ref_adapt_tattle(REF_GRID ref_grid) {
 
   min_normdev = 2.0;
   if (ref_geom_model_loaded(ref_grid_geom(ref_grid)) ||
-      ref_geom_meshlinked(ref_grid_geom(ref_grid))) {
+      ref_geom_meshlinked(ref_grid_geom(ref_grid)) ||
+      ref_geom_surrogated(ref_grid_geom(ref_grid))) {
     ref_cell = ref_grid_tri(ref_grid);
     each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
       RSS(ref_geom_tri_norm_deviation(ref_grid, nodes, &normdev), "norm dev");
@@ -534,7 +548,8 @@ REF_STATUS ref_adapt_tattle_faces(REF_GRID ref_grid) {
     min_normdev = 2.0;
     min_angle = 90.0;
     if (ref_geom_model_loaded(ref_grid_geom(ref_grid)) ||
-        ref_geom_meshlinked(ref_grid_geom(ref_grid))) {
+        ref_geom_meshlinked(ref_grid_geom(ref_grid)) ||
+        ref_geom_surrogated(ref_grid_geom(ref_grid))) {
       ref_cell = ref_grid_tri(ref_grid);
       each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
         if (id != nodes[ref_cell_id_index(ref_cell)]) continue;
@@ -590,12 +605,14 @@ REF_STATUS ref_adapt_tattle_faces(REF_GRID ref_grid) {
 
 static REF_STATUS ref_adapt_swap(REF_GRID ref_grid) {
   REF_INT pass;
+  RSS(ref_perf_start(ref_grid, REF_PERF_SWAP), "perf");
   RSS(ref_cavity_pass(ref_grid), "cavity pass");
   if (ref_grid_surf(ref_grid) || ref_grid_twod(ref_grid)) {
     for (pass = 0; pass < 3; pass++) {
       RSS(ref_swap_tri_pass(ref_grid), "swap pass");
     }
   }
+  RSS(ref_perf_stop(ref_grid), "perf");
   return REF_SUCCESS;
 }
 
@@ -608,6 +625,22 @@ REF_STATUS ref_adapt_pass(REF_GRID ref_grid, REF_BOOL *all_done) {
   REF_INT ngeom;
   REF_BOOL all_done0, all_done1;
   REF_INT i, swap_smooth_passes = 1;
+  REF_BOOL counting;
+
+  /* count outcomes for the instrument printout without a perf report in
+   * the counts kept by the grid over every pass, the predicate laps read
+   * the clock only for a report */
+  counting = (ref_grid_adapt(ref_grid, instrument) &&
+              NULL == (void *)ref_grid_perf(ref_grid));
+  if (counting) {
+    if (NULL == (void *)ref_grid_counts(ref_grid)) {
+      RSS(ref_perf_create(&ref_grid_counts(ref_grid)), "create counts");
+      ref_perf_timing(ref_grid_counts(ref_grid)) = REF_FALSE;
+    }
+    ref_grid_perf(ref_grid) = ref_grid_counts(ref_grid);
+  }
+  RSS(ref_perf_pass(ref_grid_perf(ref_grid)), "perf pass");
+  RSS(ref_mpi_trace_begin(ref_grid_mpi(ref_grid), "adapt pass"), "trace");
 
   RSS(ref_adapt_parameter(ref_grid, &all_done0), "param");
 
@@ -780,6 +813,13 @@ REF_STATUS ref_adapt_pass(REF_GRID ref_grid, REF_BOOL *all_done) {
 
   *all_done = (all_done0 && all_done1);
 
+  if (ref_grid_adapt(ref_grid, instrument))
+    RSS(ref_perf_tattle(ref_grid_perf(ref_grid), ref_grid_mpi(ref_grid)),
+        "perf tattle");
+  if (counting) ref_grid_perf(ref_grid) = NULL;
+
+  RSS(ref_mpi_trace_end(ref_grid_mpi(ref_grid)), "trace");
+
   return REF_SUCCESS;
 }
 
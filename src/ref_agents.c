@@ -27,6 +27,11 @@
 #define ref_agent_previous(ref_agents, id) ((ref_agents)->agent[(id)].previous)
 #define ref_agent_next(ref_agents, id) ((ref_agents)->agent[(id)].next)
 
+/* packed agent width for migration */
+#define REF_AGENTS_NINT (6)
+#define REF_AGENTS_NGLOB (1)
+#define REF_AGENTS_NDBL (7)
+
 REF_STATUS ref_agents_create(REF_AGENTS *ref_agents_ptr, REF_MPI ref_mpi) {
   REF_AGENTS ref_agents;
   REF_INT id;
@@ -50,11 +55,23 @@ REF_STATUS ref_agents_create(REF_AGENTS *ref_agents_ptr, REF_MPI ref_mpi) {
   ref_agents->blank = 0;
   ref_agents->last = REF_EMPTY;
 
+  ref_agents->migrating = REF_FALSE;
+  ref_agents->nrecv = 0;
+  ref_agents->send_int = NULL;
+  ref_agents->recv_int = NULL;
+  ref_agents->send_glob = NULL;
+  ref_agents->recv_glob = NULL;
+  ref_agents->send_dbl = NULL;
+  ref_agents->recv_dbl = NULL;
+  for (id = 0; id < 3; id++) ref_agents->request[id] = NULL;
+
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_agents_free(REF_AGENTS ref_agents) {
   if (NULL == (void *)ref_agents) return REF_NULL;
+  if (ref_agents->migrating)
+    RSS(ref_agents_migrate_end(ref_agents), "complete migration");
   ref_free(ref_agents->agent);
   ref_free(ref_agents);
   return REF_SUCCESS;
@@ -262,85 +279,148 @@ static REF_STATUS ref_agents_dest(REF_AGENTS ref_agents, REF_INT id,
 }
 
 REF_STATUS ref_agents_migrate(REF_AGENTS ref_agents) {
+  RSS(ref_agents_migrate_begin(ref_agents), "begin");
+  RSS(ref_agents_migrate_end(ref_agents), "end");
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_agents_migrate_begin(REF_AGENTS ref_agents) {
   REF_MPI ref_mpi = ref_agents->ref_mpi;
-  REF_INT i, id, nsend, nrecv, dest, rec;
-  REF_INT n_ints, n_globs, n_dbls;
-  REF_INT *destination, *send_int, *recv_int;
-  REF_GLOB *send_glob, *recv_glob;
-  REF_DBL *send_dbl, *recv_dbl;
-  nsend = 0;
+  REF_INT i, id, dest, part, slot, nsend;
+  REF_INT *send_size, *recv_size, *next;
+
+  RAS(!ref_agents->migrating, "migration already in flight");
+
+  ref_malloc_init(send_size, ref_mpi_n(ref_mpi), REF_INT, 0);
+  ref_malloc_init(recv_size, ref_mpi_n(ref_mpi), REF_INT, 0);
+  ref_malloc(next, ref_mpi_n(ref_mpi), REF_INT);
   each_active_ref_agent(ref_agents, id) {
     RSS(ref_agents_dest(ref_agents, id, &dest), "dest");
-    if (ref_mpi_rank(ref_mpi) != dest) {
-      nsend++;
-    }
+    if (ref_mpi_rank(ref_mpi) != dest) send_size[dest]++;
   }
-  n_ints = 6;
-  n_globs = 1;
-  n_dbls = 7;
-  ref_malloc_init(destination, nsend, REF_INT, REF_EMPTY);
-  ref_malloc_init(send_int, nsend * n_ints, REF_INT, REF_EMPTY);
-  ref_malloc_init(send_glob, nsend * n_globs, REF_GLOB, REF_EMPTY);
-  ref_malloc_init(send_dbl, nsend * n_dbls, REF_DBL, 0.0);
+  RSS(ref_mpi_alltoall(ref_mpi, send_size, recv_size, REF_INT_TYPE),
+      "alltoall sizes");
+
   nsend = 0;
+  ref_agents->nrecv = 0;
+  each_ref_mpi_part(ref_mpi, part) {
+    next[part] = nsend;
+    nsend += send_size[part];
+    ref_agents->nrecv += recv_size[part];
+  }
+
+  ref_malloc(ref_agents->send_int, REF_AGENTS_NINT * nsend, REF_INT);
+  ref_malloc(ref_agents->send_glob, REF_AGENTS_NGLOB * nsend, REF_GLOB);
+  ref_malloc(ref_agents->send_dbl, REF_AGENTS_NDBL * nsend, REF_DBL);
+  ref_malloc(ref_agents->recv_int, REF_AGENTS_NINT * ref_agents->nrecv,
+             REF_INT);
+  ref_malloc(ref_agents->recv_glob, REF_AGENTS_NGLOB * ref_agents->nrecv,
+             REF_GLOB);
+  ref_malloc(ref_agents->recv_dbl, REF_AGENTS_NDBL * ref_agents->nrecv,
+             REF_DBL);
+
+  /* packed in destination order for alltoallv */
   each_active_ref_agent(ref_agents, id) {
     RSS(ref_agents_dest(ref_agents, id, &dest), "dest");
-    if (ref_mpi_rank(ref_mpi) != dest) {
-      destination[nsend] = dest;
-      send_int[0 + nsend * n_ints] = (REF_INT)ref_agent_mode(ref_agents, id);
-      send_int[1 + nsend * n_ints] = ref_agent_home(ref_agents, id);
-      send_int[2 + nsend * n_ints] = ref_agent_node(ref_agents, id);
-      send_int[3 + nsend * n_ints] = ref_agent_part(ref_agents, id);
-      send_int[4 + nsend * n_ints] = ref_agent_seed(ref_agents, id);
-      send_int[5 + nsend * n_ints] = ref_agent_step(ref_agents, id);
+    if (ref_mpi_rank(ref_mpi) == dest) continue;
+    slot = next[dest];
+    next[dest]++;
+    ref_agents->send_int[0 + REF_AGENTS_NINT * slot] =
+        (REF_INT)ref_agent_mode(ref_agents, id);
+    ref_agents->send_int[1 + REF_AGENTS_NINT * slot] =
+        ref_agent_home(ref_agents, id);
+    ref_agents->send_int[2 + REF_AGENTS_NINT * slot] =
+        ref_agent_node(ref_agents, id);
+    ref_agents->send_int[3 + REF_AGENTS_NINT * slot] =
+        ref_agent_part(ref_agents, id);
+    ref_agents->send_int[4 + REF_AGENTS_NINT * slot] =
+        ref_agent_seed(ref_agents, id);
+    ref_agents->send_int[5 + REF_AGENTS_NINT * slot] =
+        ref_agent_step(ref_agents, id);
+
+    ref_agents->send_glob[0 + REF_AGENTS_NGLOB * slot] =
+        ref_agent_global(ref_agents, id);
 
-      send_glob[0 + nsend * n_globs] = ref_agent_global(ref_agents, id);
+    for (i = 0; i < 3; i++)
+      ref_agents->send_dbl[i + REF_AGENTS_NDBL * slot] =
+          ref_agent_xyz(ref_agents, i, id);
+    for (i = 0; i < 4; i++)
+      ref_agents->send_dbl[3 + i + REF_AGENTS_NDBL * slot] =
+          ref_agent_bary(ref_agents, i, id);
 
-      for (i = 0; i < 3; i++)
-        send_dbl[i + nsend * n_dbls] = ref_agent_xyz(ref_agents, i, id);
-      for (i = 0; i < 4; i++)
-        send_dbl[3 + i + nsend * n_dbls] = ref_agent_bary(ref_agents, i, id);
+    RSS(ref_agents_remove(ref_agents, id), "poof");
+  }
 
-      RSS(ref_agents_remove(ref_agents, id), "poof");
+  RSS(ref_mpi_ialltoallv(ref_mpi, ref_agents->send_int, send_size,
+                         ref_agents->recv_int, recv_size, REF_AGENTS_NINT,
+                         REF_INT_TYPE, &(ref_agents->request[0])),
+      "post int");
+  RSS(ref_mpi_ialltoallv(ref_mpi, ref_agents->send_glob, send_size,
+                         ref_agents->recv_glob, recv_size, REF_AGENTS_NGLOB,
+                         REF_GLOB_TYPE, &(ref_agents->request[1])),
+      "post glob");
+  RSS(ref_mpi_ialltoallv(ref_mpi, ref_agents->send_dbl, send_size,
+                         ref_agents->recv_dbl, recv_size, REF_AGENTS_NDBL,
+                         REF_DBL_TYPE, &(ref_agents->request[2])),
+      "post dbl");
+
+  ref_free(next);
+  ref_free(recv_size);
+  ref_free(send_size);
+
+  ref_agents->migrating = REF_TRUE;
 
-      nsend++;
-    }
-  }
+  return REF_SUCCESS;
+}
 
-  RSS(ref_mpi_blindsend(ref_mpi, destination, (void *)send_int, n_ints, nsend,
-                        (void **)(&recv_int), &nrecv, REF_INT_TYPE),
-      "is");
-  RSS(ref_mpi_blindsend(ref_mpi, destination, (void *)send_glob, n_globs, nsend,
-                        (void **)(&recv_glob), &nrecv, REF_GLOB_TYPE),
-      "is");
-  RSS(ref_mpi_blindsend(ref_mpi, destination, (void *)send_dbl, n_dbls, nsend,
-                        (void **)(&recv_dbl), &nrecv, REF_DBL_TYPE),
-      "ds");
-  ref_free(send_dbl);
-  ref_free(send_glob);
-  ref_free(send_int);
-  ref_free(destination);
-
-  for (rec = 0; rec < nrecv; rec++) {
-    RSS(ref_agents_new(ref_agents, &id), "new");
-    ref_agent_mode(ref_agents, id) = (REF_AGENT_MODE)recv_int[0 + rec * n_ints];
-    ref_agent_home(ref_agents, id) = recv_int[1 + rec * n_ints];
-    ref_agent_node(ref_agents, id) = recv_int[2 + rec * n_ints];
-    ref_agent_part(ref_agents, id) = recv_int[3 + rec * n_ints];
-    ref_agent_seed(ref_agents, id) = recv_int[4 + rec * n_ints];
-    ref_agent_step(ref_agents, id) = recv_int[5 + rec * n_ints];
+REF_STATUS ref_agents_migrate_end(REF_AGENTS ref_agents) {
+  REF_MPI ref_mpi = ref_agents->ref_mpi;
+  REF_INT i, id, rec;
 
-    ref_agent_global(ref_agents, id) = recv_glob[0 + rec * n_globs];
+  RAS(ref_agents->migrating, "no migration in flight");
+
+  RSS(ref_mpi_waitall(ref_mpi, 3, ref_agents->request), "wait");
+
+  for (rec = 0; rec < ref_agents->nrecv; rec++) {
+    RSS(ref_agents_new(ref_agents, &id), "new");
+    ref_agent_mode(ref_agents, id) =
+        (REF_AGENT_MODE)ref_agents->recv_int[0 + REF_AGENTS_NINT * rec];
+    ref_agent_home(ref_agents, id) =
+        ref_agents->recv_int[1 + REF_AGENTS_NINT * rec];
+    ref_agent_node(ref_agents, id) =
+        ref_agents->recv_int[2 + REF_AGENTS_NINT * rec];
+    ref_agent_part(ref_agents, id) =
+        ref_agents->recv_int[3 + REF_AGENTS_NINT * rec];
+    ref_agent_seed(ref_agents, id) =
+        ref_agents->recv_int[4 + REF_AGENTS_NINT * rec];
+    ref_agent_step(ref_agents, id) =
+        ref_agents->recv_int[5 + REF_AGENTS_NINT * rec];
+
+    ref_agent_global(ref_agents, id) =
+        ref_agents->recv_glob[0 + REF_AGENTS_NGLOB * rec];
 
     for (i = 0; i < 3; i++)
-      ref_agent_xyz(ref_agents, i, id) = recv_dbl[i + rec * n_dbls];
+      ref_agent_xyz(ref_agents, i, id) =
+          ref_agents->recv_dbl[i + REF_AGENTS_NDBL * rec];
     for (i = 0; i < 4; i++)
-      ref_agent_bary(ref_agents, i, id) = recv_dbl[3 + i + rec * n_dbls];
+      ref_agent_bary(ref_agents, i, id) =
+          ref_agents->recv_dbl[3 + i + REF_AGENTS_NDBL * rec];
   }
 
-  ref_free(recv_dbl);
-  ref_free(recv_glob);
-  ref_free(recv_int);
+  ref_free(ref_agents->recv_dbl);
+  ref_free(ref_agents->recv_glob);
+  ref_free(ref_agents->recv_int);
+  ref_free(ref_agents->send_dbl);
+  ref_free(ref_agents->send_glob);
+  ref_free(ref_agents->send_int);
+  ref_agents->recv_dbl = NULL;
+  ref_agents->recv_glob = NULL;
+  ref_agents->recv_int = NULL;
+  ref_agents->send_dbl = NULL;
+  ref_agents->send_glob = NULL;
+  ref_agents->send_int = NULL;
+  ref_agents->nrecv = 0;
+  ref_agents->migrating = REF_FALSE;
 
   return REF_SUCCESS;
 }
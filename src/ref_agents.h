@@ -66,6 +66,13 @@ struct REF_AGENTS_STRUCT {
   REF_INT last;
   REF_AGENT_STRUCT *agent;
   REF_MPI ref_mpi;
+  /* exchange in flight between ref_agents_migrate_begin and _end */
+  REF_BOOL migrating;
+  REF_INT nrecv;
+  REF_INT *send_int, *recv_int;
+  REF_GLOB *send_glob, *recv_glob;
+  REF_DBL *send_dbl, *recv_dbl;
+  REF_MPI_REQUEST request[3];
 };
 
 #define ref_agents_n(ref_agents) ((ref_agents)->n)
@@ -113,6 +120,9 @@ REF_STATUS ref_agents_pop(REF_AGENTS ref_agents, REF_INT *node, REF_INT *part,
 REF_STATUS ref_agents_delete(REF_AGENTS ref_agents, REF_INT node);
 
 REF_STATUS ref_agents_migrate(REF_AGENTS ref_agents);
+/* departing agents are removed and posted, arrivals are added at end */
+REF_STATUS ref_agents_migrate_begin(REF_AGENTS ref_agents);
+REF_STATUS ref_agents_migrate_end(REF_AGENTS ref_agents);
 
 END_C_DECLORATION
 
@@ -114,6 +114,35 @@ int main(int argc, char *argv[]) {
     RSS(ref_agents_free(ref_agents), "free");
   }
 
+  { /* migrate walking agent to next part */
+    REF_INT part, seed = 7, id;
+    REF_DBL xyz[] = {1.0, 2.0, 3.0};
+    REF_AGENTS ref_agents;
+    RSS(ref_agents_create(&ref_agents, ref_mpi), "create");
+
+    part = (ref_mpi_rank(ref_mpi) + 1) % ref_mpi_n(ref_mpi);
+    RSS(ref_agents_push(ref_agents, ref_mpi_rank(ref_mpi), part, seed, xyz,
+                        &id),
+        "add");
+
+    RSS(ref_agents_migrate_begin(ref_agents), "begin");
+    REIS(ref_mpi_para(ref_mpi) ? 0 : 1, ref_agents_n(ref_agents),
+         "departed agent should be removed");
+    RSS(ref_agents_migrate_end(ref_agents), "end");
+    REIS(1, ref_agents_n(ref_agents), "arrival count");
+
+    each_active_ref_agent(ref_agents, id) {
+      REIS(ref_mpi_rank(ref_mpi), ref_agent_part(ref_agents, id), "part");
+      REIS((ref_mpi_rank(ref_mpi) + ref_mpi_n(ref_mpi) - 1) %
+               ref_mpi_n(ref_mpi),
+           ref_agent_home(ref_agents, id), "home");
+      REIS(seed, ref_agent_seed(ref_agents, id), "seed");
+      RWDS(3.0, ref_agent_xyz(ref_agents, 2, id), -1, "z");
+    }
+
+    RSS(ref_agents_free(ref_agents), "free");
+  }
+
   RSS(ref_mpi_free(ref_mpi), "mpi free");
   RSS(ref_mpi_stop(), "stop");
   return 0;
@@ -0,0 +1,224 @@
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "ref_arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ref_malloc.h"
+
+/* keep every push aligned for any scalar type */
+#define REF_ARENA_ALIGN ((REF_SIZE)16)
+/* smallest block requested from malloc */
+#define REF_ARENA_MIN_BLOCK ((REF_SIZE)1 << 20)
+
+REF_STATUS ref_arena_create(REF_ARENA *ref_arena_ptr) {
+  REF_ARENA ref_arena;
+
+  ref_malloc(*ref_arena_ptr, 1, REF_ARENA_STRUCT);
+  ref_arena = (*ref_arena_ptr);
+
+  ref_arena->nblock = 0;
+  ref_arena->max_block = 10;
+  ref_malloc(ref_arena->block, ref_arena->max_block, REF_BYTE *);
+  ref_malloc(ref_arena->block_size, ref_arena->max_block, REF_SIZE);
+  ref_arena->top_block = 0;
+  ref_arena->top = 0;
+
+  ref_arena->nframe = 0;
+  ref_arena->max_frame = 20;
+  ref_malloc(ref_arena->frame_ptr, ref_arena->max_frame, void *);
+  ref_malloc(ref_arena->frame_block, ref_arena->max_frame, REF_INT);
+  ref_malloc(ref_arena->frame_top, ref_arena->max_frame, REF_SIZE);
+
+  ref_arena_used(ref_arena) = 0;
+  ref_arena_peak(ref_arena) = 0;
+  ref_arena->pass_peak = 0;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_arena_free(REF_ARENA ref_arena) {
+  REF_INT i;
+  if (NULL == (void *)ref_arena) return REF_NULL;
+  ref_free(ref_arena->frame_top);
+  ref_free(ref_arena->frame_block);
+  ref_free(ref_arena->frame_ptr);
+  for (i = 0; i < ref_arena->nblock; i++) ref_free(ref_arena->block[i]);
+  ref_free(ref_arena->block_size);
+  ref_free(ref_arena->block);
+  ref_free(ref_arena);
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_arena_block(REF_ARENA ref_arena, REF_INT block,
+                                  REF_SIZE bytes) {
+  REF_SIZE size;
+
+  size = MAX(bytes, REF_ARENA_MIN_BLOCK);
+  if (block == ref_arena->nblock) {
+    if (ref_arena->max_block == ref_arena->nblock) {
+      ref_arena->max_block += 10;
+      ref_realloc(ref_arena->block, ref_arena->max_block, REF_BYTE *);
+      ref_realloc(ref_arena->block_size, ref_arena->max_block, REF_SIZE);
+    }
+    /* grow geometrically with the total held */
+    if (0 < block)
+      size = MAX(size, ref_arena->block_size[block - 1] * 2);
+    ref_malloc_size_t(ref_arena->block[block], size, REF_BYTE);
+    ref_arena->block_size[block] = size;
+    ref_arena->nblock++;
+  } else {
+    /* unused block above the top of the stack, safe to replace */
+    ref_free(ref_arena->block[block]);
+    ref_malloc_size_t(ref_arena->block[block], size, REF_BYTE);
+    ref_arena->block_size[block] = size;
+  }
+
+  return REF_SUCCESS;
+}
+
+/* the stack is empty, keep one block that holds the pass that emptied
+ * it, within a factor of two to avoid reallocating for small changes */
+static REF_STATUS ref_arena_trim(REF_ARENA ref_arena) {
+  REF_SIZE size;
+  REF_INT i;
+
+  size = MAX(ref_arena->pass_peak, REF_ARENA_MIN_BLOCK);
+  ref_arena->pass_peak = 0;
+  if (1 == ref_arena->nblock && size <= ref_arena->block_size[0] &&
+      ref_arena->block_size[0] <= 2 * size)
+    return REF_SUCCESS;
+
+  for (i = 0; i < ref_arena->nblock; i++) ref_free(ref_arena->block[i]);
+  ref_malloc_size_t(ref_arena->block[0], size, REF_BYTE);
+  ref_arena->block_size[0] = size;
+  ref_arena->nblock = 1;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_arena_push(REF_ARENA ref_arena, REF_SIZE bytes, void **ptr) {
+  REF_INT block;
+  REF_INT frame;
+
+  if (NULL == (void *)ref_arena) {
+    *ptr = malloc(MAX(bytes, (REF_SIZE)1));
+    RNS(*ptr, "malloc fallback NULL");
+    return REF_SUCCESS;
+  }
+
+  bytes = MAX(bytes, REF_ARENA_ALIGN);
+  bytes = REF_ARENA_ALIGN * ((bytes + REF_ARENA_ALIGN - 1) / REF_ARENA_ALIGN);
+
+  if (ref_arena->max_frame == ref_arena->nframe) {
+    ref_arena->max_frame += 20;
+    ref_realloc(ref_arena->frame_ptr, ref_arena->max_frame, void *);
+    ref_realloc(ref_arena->frame_block, ref_arena->max_frame, REF_INT);
+    ref_realloc(ref_arena->frame_top, ref_arena->max_frame, REF_SIZE);
+  }
+
+  block = ref_arena->top_block;
+  if (block < ref_arena->nblock &&
+      ref_arena->top + bytes <= ref_arena->block_size[block]) {
+    *ptr = (void *)(ref_arena->block[block] + ref_arena->top);
+  } else {
+    if (0 < ref_arena->top) block++;
+    if (block == ref_arena->nblock || ref_arena->block_size[block] < bytes)
+      RSS(ref_arena_block(ref_arena, block, bytes), "block");
+    *ptr = (void *)(ref_arena->block[block]);
+  }
+
+  frame = ref_arena->nframe;
+  ref_arena->frame_ptr[frame] = *ptr;
+  ref_arena->frame_block[frame] = ref_arena->top_block;
+  ref_arena->frame_top[frame] = ref_arena->top;
+  ref_arena->nframe++;
+
+  if (block != ref_arena->top_block) ref_arena->top = 0;
+  ref_arena->top_block = block;
+  ref_arena->top += bytes;
+
+  ref_arena_used(ref_arena) += bytes;
+  ref_arena_peak(ref_arena) =
+      MAX(ref_arena_peak(ref_arena), ref_arena_used(ref_arena));
+  ref_arena->pass_peak = MAX(ref_arena->pass_peak, ref_arena_used(ref_arena));
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_arena_pop(REF_ARENA ref_arena, void *ptr) {
+  REF_INT frame, block;
+  REF_SIZE bytes;
+
+  if (NULL == (void *)ref_arena) {
+    free(ptr);
+    return REF_SUCCESS;
+  }
+
+  RAS(0 < ref_arena->nframe, "pop of empty arena");
+  frame = ref_arena->nframe - 1;
+  RAS(ptr == ref_arena->frame_ptr[frame], "arena pop out of order");
+
+  block = ref_arena->top_block;
+  bytes = ref_arena->top;
+  if (block == ref_arena->frame_block[frame]) {
+    bytes -= ref_arena->frame_top[frame];
+  }
+  ref_arena_used(ref_arena) -= bytes;
+
+  ref_arena->top_block = ref_arena->frame_block[frame];
+  ref_arena->top = ref_arena->frame_top[frame];
+  ref_arena->nframe--;
+
+  if (0 == ref_arena->nframe) {
+    ref_arena_used(ref_arena) = 0;
+    ref_arena->top_block = 0;
+    ref_arena->top = 0;
+    RSS(ref_arena_trim(ref_arena), "trim");
+  }
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_arena_mark(REF_ARENA ref_arena, REF_INT *mark) {
+  *mark = 0;
+  if (NULL == (void *)ref_arena) return REF_SUCCESS;
+  *mark = ref_arena_nframe(ref_arena);
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_arena_unwind(REF_ARENA ref_arena, REF_INT mark) {
+  if (NULL == (void *)ref_arena) return REF_SUCCESS;
+  while (ref_arena_nframe(ref_arena) > mark) {
+    RSS(ref_arena_pop(ref_arena,
+                      ref_arena->frame_ptr[ref_arena_nframe(ref_arena) - 1]),
+        "pop");
+  }
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_arena_capacity(REF_ARENA ref_arena, REF_SIZE *capacity) {
+  REF_INT i;
+  *capacity = 0;
+  if (NULL == (void *)ref_arena) return REF_SUCCESS;
+  for (i = 0; i < ref_arena->nblock; i++)
+    *capacity += ref_arena->block_size[i];
+  return REF_SUCCESS;
+}
@@ -0,0 +1,94 @@
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef REF_ARENA_H
+#define REF_ARENA_H
+
+#include "ref_defs.h"
+
+BEGIN_C_DECLORATION
+typedef struct REF_ARENA_STRUCT REF_ARENA_STRUCT;
+typedef REF_ARENA_STRUCT *REF_ARENA;
+END_C_DECLORATION
+
+BEGIN_C_DECLORATION
+
+/* stack (LIFO) scratch allocator. Pushes bump a pointer through a list
+ * of blocks that are kept between passes. When the stack empties, the
+ * blocks are replaced by a single block sized to the peak of the pass
+ * that emptied it, so the next pass with the same footprint runs
+ * without touching malloc and a smaller pass releases the excess. A
+ * NULL arena falls back to malloc and free. */
+
+struct REF_ARENA_STRUCT {
+  REF_INT nblock, max_block;
+  REF_BYTE **block;
+  REF_SIZE *block_size;
+  REF_INT top_block;
+  REF_SIZE top;
+  REF_INT nframe, max_frame;
+  void **frame_ptr;
+  REF_INT *frame_block;
+  REF_SIZE *frame_top;
+  REF_SIZE used, peak;
+  REF_SIZE pass_peak; /* used high water since the stack was last empty */
+};
+
+#define ref_arena_used(ref_arena) ((ref_arena)->used)
+#define ref_arena_peak(ref_arena) ((ref_arena)->peak)
+#define ref_arena_nframe(ref_arena) ((ref_arena)->nframe)
+
+REF_STATUS ref_arena_create(REF_ARENA *ref_arena);
+REF_STATUS ref_arena_free(REF_ARENA ref_arena);
+
+REF_STATUS ref_arena_push(REF_ARENA ref_arena, REF_SIZE bytes, void **ptr);
+REF_STATUS ref_arena_pop(REF_ARENA ref_arena, void *ptr);
+
+/* pops every frame pushed after the mark, for error returns that skip
+ * the releases */
+REF_STATUS ref_arena_mark(REF_ARENA ref_arena, REF_INT *mark);
+REF_STATUS ref_arena_unwind(REF_ARENA ref_arena, REF_INT mark);
+
+/* bytes held by the arena blocks */
+REF_STATUS ref_arena_capacity(REF_ARENA ref_arena, REF_SIZE *capacity);
+
+#define ref_arena_malloc(ref_arena, ptr, n, ptr_type)                   \
+  {                                                                     \
+    void *ref_arena_malloc_ptr;                                         \
+    RAS((n) >= 0, "arena " #ptr " of " #ptr_type " negative");          \
+    RSS(ref_arena_push(ref_arena, (REF_SIZE)(n) * sizeof(ptr_type),     \
+                       &ref_arena_malloc_ptr),                          \
+        "arena " #ptr " of " #ptr_type);                                \
+    (ptr) = (ptr_type *)ref_arena_malloc_ptr;                           \
+  }
+
+#define ref_arena_malloc_init(ref_arena, ptr, n, ptr_type, initial_value) \
+  {                                                                       \
+    REF_INT ref_arena_malloc_init_i;                                      \
+    ref_arena_malloc(ref_arena, ptr, n, ptr_type);                        \
+    for (ref_arena_malloc_init_i = 0; ref_arena_malloc_init_i < (n);      \
+         ref_arena_malloc_init_i++)                                       \
+      (ptr)[ref_arena_malloc_init_i] = (ptr_type)(initial_value);         \
+  }
+
+#define ref_arena_release(ref_arena, ptr) \
+  RSS(ref_arena_pop(ref_arena, (void *)(ptr)), "arena free " #ptr)
+
+END_C_DECLORATION
+
+#endif /* REF_ARENA_H */
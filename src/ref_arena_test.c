@@ -0,0 +1,134 @@
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "ref_arena.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(void) {
+  REF_ARENA ref_arena;
+
+  {
+    REIS(REF_NULL, ref_arena_free(NULL), "dont free NULL");
+    RSS(ref_arena_create(&ref_arena), "create");
+    REIS(0, ref_arena_nframe(ref_arena), "init zero");
+    RSS(ref_arena_free(ref_arena), "free");
+  }
+
+  { /* NULL arena falls back to malloc */
+    REF_INT *ints;
+    ref_arena_malloc_init(NULL, ints, 10, REF_INT, 3);
+    REIS(3, ints[9], "init");
+    ref_arena_release(NULL, ints);
+  }
+
+  { /* push, pop, aligned and reused */
+    REF_INT *ints, *again;
+    REF_DBL *dbls;
+    RSS(ref_arena_create(&ref_arena), "create");
+    ref_arena_malloc_init(ref_arena, ints, 3, REF_INT, 7);
+    ref_arena_malloc(ref_arena, dbls, 5, REF_DBL);
+    REIS(0, ((size_t)dbls) % sizeof(REF_DBL), "aligned");
+    RAS((void *)dbls != (void *)ints, "distinct");
+    REIS(2, ref_arena_nframe(ref_arena), "two frames");
+    dbls[4] = 1.0;
+    REIS(7, ints[2], "untouched");
+    REIS(REF_FAILURE, ref_arena_pop(ref_arena, ints), "out of order");
+    ref_arena_release(ref_arena, dbls);
+    ref_arena_release(ref_arena, ints);
+    REIS(0, ref_arena_used(ref_arena), "empty");
+    RAS(0 < ref_arena_peak(ref_arena), "peak");
+    ref_arena_malloc(ref_arena, again, 3, REF_INT);
+    RAS((void *)again == (void *)ints, "reused");
+    ref_arena_release(ref_arena, again);
+    REIS(REF_FAILURE, ref_arena_pop(ref_arena, again), "empty");
+    RSS(ref_arena_free(ref_arena), "free");
+  }
+
+  { /* spill to more blocks, coalesce when empty */
+    REF_BYTE *small, *big, *bigger;
+    REF_SIZE capacity;
+    REF_INT n = 3000000;
+    RSS(ref_arena_create(&ref_arena), "create");
+    ref_arena_malloc(ref_arena, small, 100, REF_BYTE);
+    ref_arena_malloc(ref_arena, big, n, REF_BYTE);
+    ref_arena_malloc(ref_arena, bigger, 2 * n, REF_BYTE);
+    small[99] = 1;
+    big[n - 1] = 2;
+    bigger[2 * n - 1] = 3;
+    REIS(1, small[99], "small kept");
+    REIS(2, big[n - 1], "big kept");
+    ref_arena_release(ref_arena, bigger);
+    ref_arena_release(ref_arena, big);
+    ref_arena_release(ref_arena, small);
+    RSS(ref_arena_capacity(ref_arena, &capacity), "cap");
+    RAS((REF_SIZE)(3 * n) <= capacity, "holds the pass");
+    REIS(1, ref_arena->nblock, "coalesced");
+    ref_arena_malloc(ref_arena, small, 100, REF_BYTE);
+    ref_arena_malloc(ref_arena, big, n, REF_BYTE);
+    ref_arena_malloc(ref_arena, bigger, 2 * n, REF_BYTE);
+    REIS(1, ref_arena->nblock, "fits in one");
+    ref_arena_release(ref_arena, bigger);
+    ref_arena_release(ref_arena, big);
+    ref_arena_release(ref_arena, small);
+    RSS(ref_arena_free(ref_arena), "free");
+  }
+
+  { /* smaller pass trims the held block */
+    REF_BYTE *small, *big;
+    REF_SIZE capacity;
+    REF_INT n = 9000000;
+    RSS(ref_arena_create(&ref_arena), "create");
+    ref_arena_malloc(ref_arena, big, n, REF_BYTE);
+    ref_arena_release(ref_arena, big);
+    RSS(ref_arena_capacity(ref_arena, &capacity), "cap");
+    RAS((REF_SIZE)n <= capacity, "holds the big pass");
+    ref_arena_malloc(ref_arena, small, 100, REF_BYTE);
+    ref_arena_release(ref_arena, small);
+    RSS(ref_arena_capacity(ref_arena, &capacity), "cap");
+    RAS((REF_SIZE)n > capacity, "released the big pass");
+    REIS(1, ref_arena->nblock, "one block");
+    RSS(ref_arena_free(ref_arena), "free");
+  }
+
+  { /* unwind to mark */
+    REF_INT *outer, *inner, *deeper;
+    REF_INT mark;
+    RSS(ref_arena_create(&ref_arena), "create");
+    ref_arena_malloc(ref_arena, outer, 10, REF_INT);
+    RSS(ref_arena_mark(ref_arena, &mark), "mark");
+    REIS(1, mark, "outer frame");
+    ref_arena_malloc(ref_arena, inner, 10, REF_INT);
+    ref_arena_malloc(ref_arena, deeper, 10, REF_INT);
+    outer[0] = 1;
+    inner[0] = 2;
+    deeper[0] = 3;
+    RSS(ref_arena_unwind(ref_arena, mark), "unwind");
+    REIS(1, ref_arena_nframe(ref_arena), "back to mark");
+    ref_arena_release(ref_arena, outer);
+    REIS(0, ref_arena_used(ref_arena), "empty");
+    RSS(ref_arena_mark(NULL, &mark), "NULL mark");
+    RSS(ref_arena_unwind(NULL, mark), "NULL unwind");
+    RSS(ref_arena_free(ref_arena), "free");
+  }
+
+  return 0;
+}
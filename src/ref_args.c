@@ -55,3 +55,40 @@ REF_STATUS ref_args_char(REF_INT n, char **args, const char *target,
   *value = args[pos + 1];
   return REF_SUCCESS;
 }
+
+/* a single complexity or a comma separated ladder c1,c2,c3 */
+REF_STATUS ref_args_ladder(const char *arg, REF_INT *n, REF_DBL *complexity) {
+  const char *start = arg;
+  char *end;
+  *n = 0;
+  while (REF_TRUE) {
+    RAS(*n < REF_ARGS_MAX_LADDER, "too many complexities");
+    complexity[*n] = strtod(start, &end);
+    RAB(end != start, "complexity is not a number", { printf("%s\n", arg); });
+    (*n)++;
+    if ('\0' == *end) break;
+    RAB(',' == *end, "complexities are comma separated",
+        { printf("%s\n", arg); });
+    start = end + 1;
+  }
+  return REF_SUCCESS;
+}
+
+/* ladder outputs insert -<rung> ahead of the extension */
+REF_STATUS ref_args_rung_filename(char *filename, size_t size,
+                                  const char *name, REF_INT rung,
+                                  REF_INT nrung) {
+  const char *dot = strrchr(name, '.');
+  const char *slash = strrchr(name, '/');
+  int length;
+  if (1 == nrung) {
+    length = snprintf(filename, size, "%s", name);
+  } else if (NULL == dot || (NULL != slash && slash > dot)) {
+    length = snprintf(filename, size, "%s-%d", name, (int)rung + 1);
+  } else {
+    length = snprintf(filename, size, "%.*s-%d%s", (int)(dot - name), name,
+                      (int)rung + 1, dot);
+  }
+  RAS(0 <= length && (size_t)length < size, "rung filename too long");
+  return REF_SUCCESS;
+}
@@ -30,6 +30,12 @@ REF_STATUS ref_args_find(REF_INT n, char **args, const char *target,
 REF_STATUS ref_args_char(REF_INT n, char **args, const char *target,
                          char **value);
 
+#define REF_ARGS_MAX_LADDER (32)
+REF_STATUS ref_args_ladder(const char *arg, REF_INT *n, REF_DBL *complexity);
+REF_STATUS ref_args_rung_filename(char *filename, size_t size,
+                                  const char *name, REF_INT rung,
+                                  REF_INT nrung);
+
 END_C_DECLORATION
 
 #endif /* REF_ARGS_H */
@@ -48,5 +48,39 @@ int main(int argc, char *argv[]) {
     REIS(REF_EMPTY, pos, "location");
   }
 
+  { /* complexity ladder */
+    REF_INT n;
+    REF_DBL complexity[REF_ARGS_MAX_LADDER];
+    RSS(ref_args_ladder("2000", &n, complexity), "single");
+    REIS(1, n, "one rung");
+    RWDS(2000.0, complexity[0], -1.0, "rung 1");
+    RSS(ref_args_ladder("500,1e3,4000.5", &n, complexity), "ladder");
+    REIS(3, n, "three rungs");
+    RWDS(500.0, complexity[0], -1.0, "rung 1");
+    RWDS(1000.0, complexity[1], -1.0, "rung 2");
+    RWDS(4000.5, complexity[2], -1.0, "rung 3");
+    REIS(REF_FAILURE, ref_args_ladder("500,,1000", &n, complexity), "empty");
+    REIS(REF_FAILURE, ref_args_ladder("500;1000", &n, complexity), "sep");
+  }
+
+  { /* rung filenames */
+    char filename[32];
+    RSS(ref_args_rung_filename(filename, sizeof(filename), "metric.solb", 0,
+                               1),
+        "single");
+    REIS(0, strcmp("metric.solb", filename), "unchanged");
+    RSS(ref_args_rung_filename(filename, sizeof(filename), "metric.solb", 1,
+                               3),
+        "ext");
+    REIS(0, strcmp("metric-2.solb", filename), "before extension");
+    RSS(ref_args_rung_filename(filename, sizeof(filename), "out.v1/grid", 2,
+                               3),
+        "dir");
+    REIS(0, strcmp("out.v1/grid-3", filename), "no extension");
+    REIS(REF_FAILURE,
+         ref_args_rung_filename(filename, 8, "metric.solb", 0, 2),
+         "too long");
+  }
+
   return 0;
 }
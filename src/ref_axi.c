@@ -63,6 +63,7 @@ REF_STATUS ref_axi_wedge(REF_GRID ref_grid) {
     }
     if (ABS(ref_node_xyz(ref_node, 1, node)) > 0.5) {
       radius = ref_node_xyz(ref_node, 2, node);
+      RSS(ref_node_index_invalidate(ref_node), "moved");
       ref_node_xyz(ref_node, 1, node) = radius * sin(wedge_angle);
       ref_node_xyz(ref_node, 2, node) = radius * cos(wedge_angle);
     }
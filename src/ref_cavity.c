@@ -27,6 +27,7 @@
 #include "ref_export.h"
 #include "ref_list.h"
 #include "ref_malloc.h"
+#include "ref_perf.h"
 #include "ref_sort.h"
 #include "ref_swap.h"
 
@@ -1560,6 +1561,8 @@ REF_STATUS ref_cavity_tec(REF_CAVITY ref_cavity, const char *filename) {
     }
   }
 
+  RSS(ref_dict_sort(node_dict), "sort nodes");
+  RSS(ref_dict_sort(face_dict), "sort faces");
   if (0 < ref_dict_n(node_dict) && 0 < ref_dict_n(face_dict)) {
     fprintf(f,
             "zone t=\"old-tet\", nodes=%d, elements=%d, datapacking=%s, "
@@ -1599,6 +1602,8 @@ REF_STATUS ref_cavity_tec(REF_CAVITY ref_cavity, const char *filename) {
     }
   }
 
+  RSS(ref_dict_sort(node_dict), "sort nodes");
+  RSS(ref_dict_sort(face_dict), "sort faces");
   if (0 < ref_dict_n(node_dict) && 0 < ref_dict_n(face_dict)) {
     fprintf(f,
             "zone t=\"new-tet\", nodes=%d, elements=%d, datapacking=%s, "
@@ -1644,6 +1649,8 @@ REF_STATUS ref_cavity_tec(REF_CAVITY ref_cavity, const char *filename) {
     }
   }
 
+  RSS(ref_dict_sort(node_dict), "sort nodes");
+  RSS(ref_dict_sort(face_dict), "sort faces");
   if (0 < ref_dict_n(node_dict) && 0 < ref_dict_n(face_dict)) {
     fprintf(f,
             "zone t=\"old-tri\", nodes=%d, elements=%d, datapacking=%s, "
@@ -1683,6 +1690,8 @@ REF_STATUS ref_cavity_tec(REF_CAVITY ref_cavity, const char *filename) {
     }
   }
 
+  RSS(ref_dict_sort(node_dict), "sort nodes");
+  RSS(ref_dict_sort(face_dict), "sort faces");
   if (0 < ref_dict_n(node_dict) && 0 < ref_dict_n(face_dict)) {
     fprintf(f,
             "zone t=\"new-tri\", nodes=%d, elements=%d, datapacking=%s, "
@@ -2025,6 +2034,7 @@ static REF_STATUS ref_cavity_edge_swap_boundary(REF_GRID ref_grid,
 static REF_STATUS ref_cavity_swap_tet_pass(REF_GRID ref_grid) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_CELL ref_cell = ref_grid_tet(ref_grid);
+  REF_PERF ref_perf = ref_grid_perf(ref_grid);
   REF_INT cell, nodes[REF_CELL_MAX_SIZE_PER];
   REF_DBL quality, min_del, min_add, best;
   REF_INT best_other;
@@ -2033,6 +2043,7 @@ static REF_STATUS ref_cavity_swap_tet_pass(REF_GRID ref_grid) {
   REF_INT degree;
   REF_INT n0, n1, n2;
   REF_INT other;
+  REF_STATUS status;
   REF_INT others[12][3] = {
       {0, 1, 2}, {0, 1, 3}, {0, 2, 1}, {0, 2, 3}, {0, 3, 1}, {0, 3, 2},
       {1, 2, 0}, {1, 2, 3}, {1, 3, 0}, {1, 3, 2}, {2, 3, 0}, {2, 3, 1},
@@ -2047,52 +2058,80 @@ static REF_STATUS ref_cavity_swap_tet_pass(REF_GRID ref_grid) {
         n0 = others[other][0];
         n1 = others[other][1];
         n2 = others[other][2];
+        ref_perf_attempt(ref_perf);
+        RSS(ref_perf_lap(ref_grid, REF_PERF_LAST_REASON), "lap");
         RSS(ref_cell_local_gem(ref_cell, ref_node, nodes[n0], nodes[n1],
                                &allowed),
             "local gem");
-        if (!allowed) continue;
+        RSS(ref_perf_lap(ref_grid, REF_PERF_GHOST), "lap");
+        if (!allowed) {
+          ref_perf_reject(ref_perf, REF_PERF_GHOST);
+          continue;
+        }
         RSS(ref_cavity_edge_swap_boundary(ref_grid, nodes[n0], nodes[n1],
                                           &allowed),
             "surface geom and topo");
-        if (!allowed) continue;
+        RSS(ref_perf_lap(ref_grid, REF_PERF_GEOMETRY), "lap");
+        if (!allowed) {
+          ref_perf_reject(ref_perf, REF_PERF_GEOMETRY);
+          continue;
+        }
         RSS(ref_cell_degree_with2(ref_cell, nodes[n0], nodes[n1], &degree),
             "edge degree");
-        if (degree > ref_grid_adapt(ref_grid, swap_max_degree)) continue;
+        RSS(ref_perf_lap(ref_grid, REF_PERF_DEGREE), "lap");
+        if (degree > ref_grid_adapt(ref_grid, swap_max_degree)) {
+          ref_perf_reject(ref_perf, REF_PERF_DEGREE);
+          continue;
+        }
         RSS(ref_cavity_create(&ref_cavity), "create");
         if (REF_SUCCESS != ref_cavity_form_edge_swap(ref_cavity, ref_grid,
                                                      nodes[n0], nodes[n1],
                                                      nodes[n2])) {
           REF_WHERE("form edge swap"); /* note but skip cavity failures */
           RSS(ref_cavity_free(ref_cavity), "free");
+          ref_perf_reject(ref_perf, REF_PERF_CAVITY);
           continue;
         }
         if (REF_CAVITY_INCONSISTENT == ref_cavity_state(ref_cavity)) {
           /* skip cavity failures */
           RSS(ref_cavity_free(ref_cavity), "free");
+          ref_perf_reject(ref_perf, REF_PERF_CAVITY);
           continue;
         }
-        if (REF_SUCCESS != ref_cavity_check_visible(ref_cavity)) {
+        status = ref_cavity_check_visible(ref_cavity);
+        RSS(ref_perf_lap(ref_grid, REF_PERF_CAVITY), "lap");
+        if (REF_SUCCESS != status) {
           REF_WHERE("check visible"); /* note but skip cavity failures */
           RSS(ref_cavity_free(ref_cavity), "free");
+          ref_perf_reject(ref_perf, REF_PERF_CAVITY);
           continue;
         }
         if (REF_CAVITY_VISIBLE == ref_cavity_state(ref_cavity)) {
           RSS(ref_cavity_ratio(ref_cavity, &allowed), "post ratio limits");
+          RSS(ref_perf_lap(ref_grid, REF_PERF_RATIO), "lap");
           if (!allowed) {
             RSS(ref_cavity_free(ref_cavity), "free");
+            ref_perf_reject(ref_perf, REF_PERF_RATIO);
             continue;
           }
           RSS(ref_cavity_change(ref_cavity, &min_del, &min_add), "change");
-          if (min_add - min_del > 0.0001) {
-            if (best < min_add) {
-              best = min_add;
-              best_other = other;
-            }
+          RSS(ref_perf_lap(ref_grid, REF_PERF_QUALITY), "lap");
+          /* candidates that lose to a better swap are quality rejects */
+          if (min_add - min_del > 0.0001 && best < min_add) {
+            if (REF_EMPTY != best_other)
+              ref_perf_reject(ref_perf, REF_PERF_QUALITY);
+            best = min_add;
+            best_other = other;
+          } else {
+            ref_perf_reject(ref_perf, REF_PERF_QUALITY);
           }
+        } else {
+          ref_perf_reject(ref_perf, REF_PERF_CAVITY);
         }
         RSS(ref_cavity_free(ref_cavity), "free");
       }
       if (REF_EMPTY != best_other) {
+        ref_perf_success(ref_perf);
         RSS(ref_cavity_create(&ref_cavity), "create");
         n0 = others[best_other][0];
         n1 = others[best_other][1];
@@ -397,11 +397,17 @@ REF_STATUS ref_cell_create(REF_CELL *ref_cell_ptr, REF_CELL_TYPE type) {
 
   RSS(ref_adj_create(&(ref_cell->ref_adj)), "create ref_adj for ref_cell");
 
+  ref_cell->ncolor = 0;
+  ref_cell->color_nthread = REF_EMPTY;
+  ref_cell->color_first = NULL;
+  ref_cell->color_cell = NULL;
+
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_cell_free(REF_CELL ref_cell) {
   if (NULL == (void *)ref_cell) return REF_NULL;
+  RSS(ref_cell_color_invalidate(ref_cell), "free colors");
   ref_adj_free(ref_cell->ref_adj);
   ref_free(ref_cell->c2n);
   ref_free(ref_cell->f2n);
@@ -435,6 +441,11 @@ REF_STATUS ref_cell_deep_copy(REF_CELL *ref_cell_ptr, REF_CELL original) {
   RSS(ref_adj_deep_copy(&(ref_cell->ref_adj), original->ref_adj),
       "deep copy ref_adj for ref_cell");
 
+  ref_cell->ncolor = 0;
+  ref_cell->color_nthread = REF_EMPTY;
+  ref_cell->color_first = NULL;
+  ref_cell->color_cell = NULL;
+
   return REF_SUCCESS;
 }
 
@@ -442,6 +453,8 @@ REF_STATUS ref_cell_pack(REF_CELL ref_cell, REF_INT *o2n) {
   REF_INT node, cell, compact;
   REF_INT nodes[REF_CELL_MAX_SIZE_PER];
 
+  RSS(ref_cell_color_invalidate(ref_cell), "packed");
+
   compact = 0;
   each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
     for (node = 0; node < ref_cell_node_per(ref_cell); node++)
@@ -476,7 +489,7 @@ REF_STATUS ref_cell_pack(REF_CELL ref_cell, REF_INT *o2n) {
         if (nodes[node] < key[cell]) key[cell] = nodes[node];
       }
     }
-    RSS(ref_sort_heap_int(ref_cell_n(ref_cell), key, order), "sort smallest");
+    RSS(ref_sort_radix_int(ref_cell_n(ref_cell), key, order), "sort smallest");
     for (cell = 0; cell < ref_cell_n(ref_cell); cell++) {
       for (node = 0; node < ref_cell_size_per(ref_cell); node++) {
         c2n[node + cell * ref_cell_size_per(ref_cell)] =
@@ -599,6 +612,8 @@ REF_STATUS ref_cell_add(REF_CELL ref_cell, REF_INT *nodes, REF_INT *new_cell) {
     ref_cell_blank(ref_cell) = orig;
   }
 
+  RSS(ref_cell_color_invalidate(ref_cell), "added");
+
   cell = ref_cell_blank(ref_cell);
   ref_cell_blank(ref_cell) = ref_cell_c2n(ref_cell, 1, cell);
   for (node = 0; node < ref_cell_size_per(ref_cell); node++)
@@ -664,6 +679,7 @@ REF_STATUS ref_cell_add_many_global(REF_CELL ref_cell, REF_NODE ref_node,
 REF_STATUS ref_cell_remove(REF_CELL ref_cell, REF_INT cell) {
   REF_INT node;
   if (!ref_cell_valid(ref_cell, cell)) return REF_INVALID;
+  RSS(ref_cell_color_invalidate(ref_cell), "removed");
   ref_cell_n(ref_cell)--;
 
   for (node = 0; node < ref_cell_node_per(ref_cell); node++)
@@ -682,6 +698,7 @@ REF_STATUS ref_cell_replace_whole(REF_CELL ref_cell, REF_INT cell,
                                   REF_INT *nodes) {
   REF_INT node;
   if (!ref_cell_valid(ref_cell, cell)) return REF_FAILURE;
+  RSS(ref_cell_color_invalidate(ref_cell), "replaced");
 
   for (node = 0; node < ref_cell_node_per(ref_cell); node++) {
     RSS(ref_adj_remove(ref_cell->ref_adj, ref_cell_c2n(ref_cell, node, cell),
@@ -707,6 +724,7 @@ REF_STATUS ref_cell_replace_node(REF_CELL ref_cell, REF_INT old_node,
   REF_INT item, cell;
 
   if (old_node == new_node) return REF_SUCCESS;
+  RSS(ref_cell_color_invalidate(ref_cell), "replaced");
 
   item = ref_adj_first(ref_adj, old_node);
   while (ref_adj_valid(item)) {
@@ -729,6 +747,97 @@ REF_STATUS ref_cell_replace_node(REF_CELL ref_cell, REF_INT old_node,
   return REF_SUCCESS;
 }
 
+REF_STATUS ref_cell_color_invalidate(REF_CELL ref_cell) {
+  ref_free(ref_cell->color_cell);
+  ref_free(ref_cell->color_first);
+  ref_cell->color_cell = NULL;
+  ref_cell->color_first = NULL;
+  ref_cell->ncolor = 0;
+  ref_cell->color_nthread = REF_EMPTY;
+  return REF_SUCCESS;
+}
+
+/* greedy, a single color of every valid cell when there is only one
+ * thread to scatter */
+REF_STATUS ref_cell_colors(REF_CELL ref_cell, REF_INT nthread, REF_INT *ncolor,
+                           REF_INT **color_first, REF_INT **color_cell) {
+  REF_INT *stamp, *remaining;
+  REF_INT cell, cell_node, nodes[REF_CELL_MAX_SIZE_PER];
+  REF_INT nremaining, nkeep, i, ncell, node_max;
+  REF_BOOL available;
+
+  nthread = MAX(1, nthread);
+  if (NULL != (void *)ref_cell->color_first &&
+      (nthread == ref_cell->color_nthread ||
+       (nthread > 1 && ref_cell->color_nthread > 1))) {
+    *ncolor = ref_cell->ncolor;
+    *color_first = ref_cell->color_first;
+    *color_cell = ref_cell->color_cell;
+    return REF_SUCCESS;
+  }
+  RSS(ref_cell_color_invalidate(ref_cell), "stale colors");
+  ref_cell->color_nthread = nthread;
+
+  ref_malloc_init(ref_cell->color_first, ref_cell_n(ref_cell) + 1, REF_INT,
+                  0);
+  ref_malloc(ref_cell->color_cell, ref_cell_n(ref_cell), REF_INT);
+  *ncolor = 0;
+  *color_first = ref_cell->color_first;
+  *color_cell = ref_cell->color_cell;
+
+  ncell = 0;
+  node_max = 0;
+  each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
+    (*color_cell)[ncell] = cell;
+    ncell++;
+    each_ref_cell_cell_node(ref_cell, cell_node) {
+      node_max = MAX(node_max, nodes[cell_node] + 1);
+    }
+  }
+  if (0 == ncell) return REF_SUCCESS;
+  if (1 == nthread) {
+    ref_cell->ncolor = 1;
+    *ncolor = ref_cell->ncolor;
+    (*color_first)[1] = ncell;
+    return REF_SUCCESS;
+  }
+
+  ref_malloc_init(stamp, node_max, REF_INT, REF_EMPTY);
+  ref_malloc(remaining, ncell, REF_INT);
+  for (i = 0; i < ncell; i++) remaining[i] = (*color_cell)[i];
+  nremaining = ncell;
+  ncell = 0;
+  while (nremaining > 0) {
+    nkeep = 0;
+    for (i = 0; i < nremaining; i++) {
+      cell = remaining[i];
+      RSS(ref_cell_nodes(ref_cell, cell, nodes), "nodes");
+      available = REF_TRUE;
+      each_ref_cell_cell_node(ref_cell, cell_node) {
+        if (*ncolor == stamp[nodes[cell_node]]) available = REF_FALSE;
+      }
+      if (available) {
+        each_ref_cell_cell_node(ref_cell, cell_node) {
+          stamp[nodes[cell_node]] = *ncolor;
+        }
+        (*color_cell)[ncell] = cell;
+        ncell++;
+      } else {
+        remaining[nkeep] = cell;
+        nkeep++;
+      }
+    }
+    nremaining = nkeep;
+    (*ncolor)++;
+    (*color_first)[*ncolor] = ncell;
+  }
+  ref_free(remaining);
+  ref_free(stamp);
+  ref_cell->ncolor = *ncolor;
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_cell_compact(REF_CELL ref_cell, REF_INT **o2n_ptr,
                             REF_INT **n2o_ptr) {
   REF_INT cell;
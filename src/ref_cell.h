@@ -53,6 +53,8 @@ struct REF_CELL_STRUCT {
   REF_INT blank;
   REF_INT *c2n;
   REF_ADJ ref_adj;
+  REF_INT ncolor, color_nthread;
+  REF_INT *color_first, *color_cell;
 };
 
 #define ref_cell_type(ref_cell) ((ref_cell)->type)
@@ -152,6 +154,12 @@ REF_STATUS ref_cell_replace_node(REF_CELL ref_cell, REF_INT old_node,
                                  REF_INT new_node);
 REF_STATUS ref_cell_compact(REF_CELL ref_cell, REF_INT **o2n, REF_INT **n2o);
 
+/* cells grouped so that no two cells of a color share a node, built at
+ * first request and kept (owned by ref_cell) until the cells change */
+REF_STATUS ref_cell_colors(REF_CELL ref_cell, REF_INT nthread, REF_INT *ncolor,
+                           REF_INT **color_first, REF_INT **color_cell);
+REF_STATUS ref_cell_color_invalidate(REF_CELL ref_cell);
+
 REF_STATUS ref_cell_nodes(REF_CELL ref_cell, REF_INT cell, REF_INT *nodes);
 REF_STATUS ref_cell_part_cell_node(REF_CELL ref_cell, REF_NODE ref_node,
                                    REF_INT cell, REF_INT *cell_node);
@@ -232,6 +232,55 @@ int main(int argc, char *argv[]) {
     RSS(ref_cell_free(ref_cell), "cleanup");
   }
 
+  { /* colors of tets sharing nodes */
+    REF_CELL ref_cell;
+    REF_INT nodes[4];
+    REF_INT cell;
+    REF_INT ncolor, *color_first, *color_cell;
+
+    RSS(ref_tet(&ref_cell), "create");
+
+    nodes[0] = 0;
+    nodes[1] = 1;
+    nodes[2] = 2;
+    nodes[3] = 3;
+    RSS(ref_cell_add(ref_cell, nodes, &cell), "add cell");
+    nodes[0] = 4;
+    nodes[1] = 5;
+    nodes[2] = 6;
+    nodes[3] = 7;
+    RSS(ref_cell_add(ref_cell, nodes, &cell), "add cell");
+
+    RSS(ref_cell_colors(ref_cell, 2, &ncolor, &color_first, &color_cell),
+        "color");
+    REIS(1, ncolor, "disjoint tets share a color");
+    REIS(2, color_first[1], "both tets");
+    RSS(ref_cell_colors(ref_cell, 4, &ncolor, &color_first, &color_cell),
+        "color");
+    RAS(color_first == ref_cell->color_first, "not reused");
+
+    nodes[0] = 3;
+    nodes[1] = 4;
+    nodes[2] = 8;
+    nodes[3] = 9;
+    RSS(ref_cell_add(ref_cell, nodes, &cell), "add cell");
+    RAS(NULL == ref_cell->color_first, "not invalidated");
+
+    RSS(ref_cell_colors(ref_cell, 2, &ncolor, &color_first, &color_cell),
+        "color");
+    REIS(2, ncolor, "bridging tet needs a second color");
+    REIS(2, color_first[1], "first color");
+    REIS(3, color_first[2], "second color");
+    REIS(2, color_cell[2], "bridging tet");
+
+    RSS(ref_cell_colors(ref_cell, 1, &ncolor, &color_first, &color_cell),
+        "color");
+    REIS(1, ncolor, "one thread, one color");
+    REIS(3, color_first[1], "all tets");
+
+    RSS(ref_cell_free(ref_cell), "cleanup");
+  }
+
   { /* remove tri*/
     REF_CELL ref_cell;
     REF_INT nodes[4];
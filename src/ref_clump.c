@@ -94,6 +94,7 @@ static REF_STATUS ref_clump_cell_zone(FILE *f, REF_CELL ref_cell,
       RSS(ref_dict_store(node_dict, nodes[cell_node], 0), "store");
     }
   }
+  RSS(ref_dict_sort(node_dict), "sort nodes");
 
   fprintf(
       f, "zone t=\"%s\", nodes=%d, elements=%d, datapacking=%s, zonetype=%s\n",
@@ -150,6 +151,10 @@ REF_STATUS ref_clump_around(REF_GRID ref_grid, REF_INT node,
         RSS(ref_dict_store(node_dict, nodes[cell_node], 0), "store");
   }
 
+  RSS(ref_dict_sort(node_dict), "sort nodes");
+  RSS(ref_dict_sort(tri_dict), "sort tris");
+  RSS(ref_dict_sort(tet_dict), "sort tets");
+
   f = fopen(filename, "w");
   if (NULL == (void *)f) printf("unable to open %s\n", filename);
   RNS(f, "unable to open file");
@@ -224,6 +229,10 @@ REF_STATUS ref_clump_between(REF_GRID ref_grid, REF_INT node0, REF_INT node1,
         RSS(ref_dict_store(node_dict, nodes[cell_node], 0), "store");
   }
 
+  RSS(ref_dict_sort(node_dict), "sort nodes");
+  RSS(ref_dict_sort(tri_dict), "sort tris");
+  RSS(ref_dict_sort(tet_dict), "sort tets");
+
   f = fopen(filename, "w");
   if (NULL == (void *)f) printf("unable to open %s\n", filename);
   RNS(f, "unable to open file");
@@ -292,6 +301,8 @@ REF_STATUS ref_clump_between_export_to(REF_GRID ref_grid, REF_INT node0,
         RSS(ref_dict_store(node_dict, nodes[cell_node], 0), "store");
   }
 
+  RSS(ref_dict_sort(node_dict), "sort nodes");
+
   ref_node = ref_grid_node(ref_grid);
   loc_node = ref_grid_node(loc_grid);
   each_ref_dict_key(node_dict, index, old) {
@@ -389,6 +400,9 @@ REF_STATUS ref_clump_tri_around(REF_GRID ref_grid, REF_INT node,
         RSS(ref_dict_store(node_dict, nodes[cell_node], 0), "store");
   }
 
+  RSS(ref_dict_sort(node_dict), "sort nodes");
+  RSS(ref_dict_sort(tri_dict), "sort tris");
+
   f = fopen(filename, "w");
   if (NULL == (void *)f) printf("unable to open %s\n", filename);
   RNS(f, "unable to open file");
@@ -31,6 +31,7 @@
 #include "ref_malloc.h"
 #include "ref_math.h"
 #include "ref_mpi.h"
+#include "ref_perf.h"
 #include "ref_sort.h"
 #include "ref_validation.h"
 
@@ -60,8 +61,9 @@ REF_STATUS ref_collapse_diagnostics(REF_GRID ref_grid) {
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_collapse_pass(REF_GRID ref_grid) {
+static REF_STATUS ref_collapse_pass_frames(REF_GRID ref_grid) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_ARENA ref_arena = ref_grid_arena(ref_grid);
   REF_CELL ref_cell;
   REF_EDGE ref_edge;
   REF_DBL *ratio;
@@ -70,7 +72,8 @@ REF_STATUS ref_collapse_pass(REF_GRID ref_grid) {
   REF_INT node, node0, node1;
   REF_INT i, edge;
   REF_INT item, cell, nodes[REF_CELL_MAX_SIZE_PER];
-  REF_DBL edge_ratio;
+  REF_DBL *edge_ratio;
+  REF_STATUS status;
 
   if (ref_grid_surf(ref_grid)) {
     ref_cell = ref_grid_tri(ref_grid);
@@ -78,21 +81,40 @@ REF_STATUS ref_collapse_pass(REF_GRID ref_grid) {
     ref_cell = ref_grid_tet(ref_grid);
   }
 
+  RSS(ref_perf_start(ref_grid, REF_PERF_COLLAPSE), "perf");
+
   RSS(ref_edge_create(&ref_edge, ref_grid), "orig edges");
 
-  ref_malloc_init(ratio, ref_node_max(ref_node), REF_DBL,
-                  2.0 * ref_grid_adapt(ref_grid, collapse_ratio));
+  ref_arena_malloc_init(ref_arena, ratio, ref_node_max(ref_node), REF_DBL,
+                        2.0 * ref_grid_adapt(ref_grid, collapse_ratio));
 
+  ref_arena_malloc(ref_arena, edge_ratio, ref_edge_n(ref_edge), REF_DBL);
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) private(node0, node1) \
+    num_threads(ref_mpi_nthread(ref_grid_mpi(ref_grid)))          \
+    reduction(max : status)
+#endif
   for (edge = 0; edge < ref_edge_n(ref_edge); edge++) {
     node0 = ref_edge_e2n(ref_edge, 0, edge);
     node1 = ref_edge_e2n(ref_edge, 1, edge);
-    RSS(ref_node_ratio(ref_node, node0, node1, &edge_ratio), "ratio");
-    ratio[node0] = MIN(ratio[node0], edge_ratio);
-    ratio[node1] = MIN(ratio[node1], edge_ratio);
+    if (REF_SUCCESS !=
+        ref_node_ratio(ref_node, node0, node1, &(edge_ratio[edge])))
+      status = REF_FAILURE;
   }
+  RSS(status, "ratio");
 
-  ref_malloc(target, ref_node_n(ref_node), REF_INT);
-  ref_malloc_init(node2target, ref_node_max(ref_node), REF_INT, REF_EMPTY);
+  for (edge = 0; edge < ref_edge_n(ref_edge); edge++) {
+    node0 = ref_edge_e2n(ref_edge, 0, edge);
+    node1 = ref_edge_e2n(ref_edge, 1, edge);
+    ratio[node0] = MIN(ratio[node0], edge_ratio[edge]);
+    ratio[node1] = MIN(ratio[node1], edge_ratio[edge]);
+  }
+  ref_arena_release(ref_arena, edge_ratio);
+
+  ref_arena_malloc(ref_arena, target, ref_node_n(ref_node), REF_INT);
+  ref_arena_malloc_init(ref_arena, node2target, ref_node_max(ref_node), REF_INT,
+                        REF_EMPTY);
 
   ntarget = 0;
   for (node = 0; node < ref_node_max(ref_node); node++)
@@ -103,9 +125,9 @@ REF_STATUS ref_collapse_pass(REF_GRID ref_grid) {
       ntarget++;
     }
 
-  ref_malloc(order, ntarget, REF_INT);
+  ref_arena_malloc(ref_arena, order, ntarget, REF_INT);
 
-  RSS(ref_sort_heap_dbl(ntarget, ratio, order), "sort lengths");
+  RSS(ref_sort_radix_dbl(ntarget, ratio, order), "sort lengths");
 
   for (i = 0; i < ntarget; i++) {
     if (ratio[order[i]] > ref_grid_adapt(ref_grid, collapse_ratio)) continue;
@@ -126,19 +148,31 @@ REF_STATUS ref_collapse_pass(REF_GRID ref_grid) {
     }
   }
 
-  ref_free(order);
-  ref_free(node2target);
-  ref_free(target);
-  ref_free(ratio);
+  ref_arena_release(ref_arena, order);
+  ref_arena_release(ref_arena, node2target);
+  ref_arena_release(ref_arena, target);
+  ref_arena_release(ref_arena, ratio);
 
   ref_edge_free(ref_edge);
 
+  RSS(ref_perf_stop(ref_grid), "perf");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_collapse_pass(REF_GRID ref_grid) {
+  REF_ARENA ref_arena = ref_grid_arena(ref_grid);
+  REF_INT mark;
+  RSS(ref_arena_mark(ref_arena, &mark), "mark");
+  RSB(ref_collapse_pass_frames(ref_grid), "collapse pass",
+      { ref_arena_unwind(ref_arena, mark); });
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_collapse_to_remove_node1(REF_GRID ref_grid,
                                         REF_INT *actual_node0, REF_INT node1) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_PERF ref_perf = ref_grid_perf(ref_grid);
   REF_CELL ref_cell;
   REF_INT nnode, node;
   REF_INT node_to_collapse[MAX_NODE_LIST];
@@ -170,7 +204,7 @@ REF_STATUS ref_collapse_to_remove_node1(REF_GRID ref_grid,
         "ratio");
   }
 
-  RSS(ref_sort_heap_dbl(nnode, ratio_to_collapse, order), "sort lengths");
+  RSS(ref_sort_radix_dbl(nnode, ratio_to_collapse, order), "sort lengths");
 
   /* audit = (nnode > 0 && ratio_to_collapse[order[0]] < 0.2); */
   if (audit) {
@@ -184,67 +218,113 @@ REF_STATUS ref_collapse_to_remove_node1(REF_GRID ref_grid,
       printf(" %d node0 %d ratio %f\n", nnode - node, node0,
              ratio_to_collapse[order[node]]);
 
+    ref_perf_attempt(ref_perf);
+    RSS(ref_perf_lap(ref_grid, REF_PERF_LAST_REASON), "lap");
+
     RSS(ref_collapse_edge_mixed(ref_grid, node0, node1, &allowed), "col mixed");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_MIXED), "lap");
     if (!allowed && audit) printf("   mixed\n");
-    if (!allowed) continue;
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_MIXED);
+      continue;
+    }
 
     RSS(ref_collapse_edge_geometry(ref_grid, node0, node1, &allowed),
         "col geom");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_GEOMETRY), "lap");
     if (!allowed && audit) printf("   geom\n");
-    if (!allowed) continue;
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_GEOMETRY);
+      continue;
+    }
 
     RSS(ref_collapse_edge_manifold(ref_grid, node0, node1, &allowed),
         "col manifold");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_GEOMETRY), "lap");
     if (!allowed && audit) printf("   manifold\n");
-    if (!allowed) continue;
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_GEOMETRY);
+      continue;
+    }
 
     RSS(ref_collapse_edge_chord_height(ref_grid, node0, node1, &allowed),
         "col edge chord height");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_CONFORMITY), "lap");
     if (!allowed && audit) printf("   chord\n");
-    if (!allowed) continue;
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_CONFORMITY);
+      continue;
+    }
 
     RSS(ref_collapse_edge_ratio(ref_grid, node0, node1, &allowed), "ratio");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_RATIO), "lap");
     if (!allowed && audit) printf("   ratio\n");
-    if (!allowed) continue;
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_RATIO);
+      continue;
+    }
 
     RSS(ref_geom_supported(ref_grid_geom(ref_grid), node0,
                            &have_geometry_support),
         "geom");
     RSS(ref_collapse_edge_normdev(ref_grid, node0, node1, &allowed), "normdev");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_CONFORMITY), "lap");
     if (!allowed && audit) printf("   normdev\n");
-    if (!allowed) continue;
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_CONFORMITY);
+      continue;
+    }
     RSS(ref_collapse_edge_same_normal(ref_grid, node0, node1, &allowed),
         "normal deviation");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_CONFORMITY), "lap");
     if (!allowed && audit) printf("   same normal\n");
-    if (!allowed) continue;
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_CONFORMITY);
+      continue;
+    }
     if (!have_geometry_support) {
       RSS(ref_collapse_edge_same_tangent(ref_grid, node0, node1, &allowed),
           "normal deviation");
+      RSS(ref_perf_lap(ref_grid, REF_PERF_CONFORMITY), "lap");
       if (!allowed && audit) printf("   same tangent\n");
-      if (!allowed) continue;
+      if (!allowed) {
+        ref_perf_reject(ref_perf, REF_PERF_CONFORMITY);
+        continue;
+      }
     }
     if (!have_geometry_support && ref_grid_twod(ref_grid)) {
       RSS(ref_collapse_edge_twod_orientation(ref_grid, node0, node1, &allowed),
           "norm");
+      RSS(ref_perf_lap(ref_grid, REF_PERF_QUALITY), "lap");
       if (!allowed && audit) printf("   twod orientation\n");
-      if (!allowed) continue;
+      if (!allowed) {
+        ref_perf_reject(ref_perf, REF_PERF_QUALITY);
+        continue;
+      }
     }
 
     RSS(ref_collapse_edge_tri_quality(ref_grid, node0, node1, &allowed),
         "tri qual");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_QUALITY), "lap");
     if (!allowed && audit) printf("   tri qual\n");
-    if (!allowed) continue;
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_QUALITY);
+      continue;
+    }
 
     RSS(ref_collapse_edge_tet_quality(ref_grid, node0, node1, &allowed),
         "tet qual");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_QUALITY), "lap");
     if (!allowed && audit) printf("   tet qual\n");
 
     RSS(ref_collapse_edge_local_cell(ref_grid, node0, node1, &local), "colloc");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_GHOST), "lap");
     if (!local) {
       if (allowed) {
         ref_node_age(ref_node, node0)++;
         ref_node_age(ref_node, node1)++;
       }
+      ref_perf_reject(ref_perf, REF_PERF_GHOST);
       continue;
     }
 
@@ -254,6 +334,7 @@ REF_STATUS ref_collapse_to_remove_node1(REF_GRID ref_grid,
            ref_cavity_form_edge_collapse(ref_cavity, ref_grid, node0, node1)) &&
           (REF_CAVITY_INCONSISTENT != ref_cavity_state(ref_cavity))) {
         RSS(ref_cavity_enlarge_visible(ref_cavity), "enlarge");
+        RSS(ref_perf_lap(ref_grid, REF_PERF_CAVITY), "lap");
         if (REF_CAVITY_VISIBLE == ref_cavity_state(ref_cavity)) {
           RSS(ref_cavity_ratio(ref_cavity, &allowed_cavity_ratio),
               "cavity ratio");
@@ -267,6 +348,7 @@ REF_STATUS ref_collapse_to_remove_node1(REF_GRID ref_grid,
             RSS(ref_cavity_replace(ref_cavity), "cav replace");
             RSS(ref_cavity_free(ref_cavity), "cav free");
             ref_cavity = (REF_CAVITY)NULL;
+            ref_perf_success(ref_perf);
             if (ref_grid_adapt(ref_grid, watch_topo))
               RSS(ref_validation_cell_face_node(ref_grid, node0),
                   "cavity topo");
@@ -278,6 +360,11 @@ REF_STATUS ref_collapse_to_remove_node1(REF_GRID ref_grid,
           ref_node_age(ref_node, node1)++;
         }
       }
+      if (REF_CAVITY_PARTITION_CONSTRAINED == ref_cavity_state(ref_cavity)) {
+        ref_perf_reject(ref_perf, REF_PERF_GHOST);
+      } else {
+        ref_perf_reject(ref_perf, REF_PERF_CAVITY);
+      }
       RSS(ref_cavity_free(ref_cavity), "cav free");
       ref_cavity = (REF_CAVITY)NULL;
       if (!allowed && audit) printf("   cav unsuccessful\n");
@@ -286,6 +373,7 @@ REF_STATUS ref_collapse_to_remove_node1(REF_GRID ref_grid,
 
     *actual_node0 = node0;
     RSS(ref_collapse_edge(ref_grid, node0, node1), "col!");
+    ref_perf_success(ref_perf);
     if (ref_grid_adapt(ref_grid, watch_topo))
       RSB(ref_validation_cell_face_node(ref_grid, node0), "standard topo",
           { printf("node0 %d node1 %d\n", node0, node1); });
@@ -901,7 +989,8 @@ REF_STATUS ref_collapse_edge_normdev(REF_GRID ref_grid, REF_INT node0,
 
   RSS(ref_geom_supported(ref_geom, node0, &node0_support), "support0");
   RSS(ref_geom_supported(ref_geom, node1, &node1_support), "support1");
-  if (!(ref_geom_model_loaded(ref_geom) || ref_geom_meshlinked(ref_geom)) ||
+  if (!(ref_geom_model_loaded(ref_geom) || ref_geom_meshlinked(ref_geom) ||
+        ref_geom_surrogated(ref_geom)) ||
       !node0_support || !node1_support) {
     *allowed = REF_TRUE;
     return REF_SUCCESS;
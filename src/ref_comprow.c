@@ -24,6 +24,7 @@
 #include "ref_edge.h"
 #include "ref_grid.h"
 #include "ref_malloc.h"
+#include "ref_mpi.h"
 #include "ref_node.h"
 
 REF_STATUS ref_comprow_create(REF_COMPROW *ref_comprow_ptr, REF_GRID ref_grid) {
@@ -130,3 +131,37 @@ REF_STATUS ref_comprow_entry(REF_COMPROW ref_comprow, REF_INT row, REF_INT col,
   (*entry) = REF_EMPTY;
   return REF_NOT_FOUND;
 }
+
+REF_STATUS ref_comprow_block3_spmv(REF_COMPROW ref_comprow, REF_MPI ref_mpi,
+                                   REF_DBL *a, REF_DBL *x, REF_DBL *y) {
+  REF_INT row, entry, col;
+  REF_DBL y0, y1, y2, x0, x1, x2;
+  const REF_DBL *block;
+
+  SUPRESS_UNUSED_COMPILER_WARNING(ref_mpi);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi)) \
+    schedule(static) private(entry, col, y0, y1, y2, x0, x1, x2, block)
+#endif
+  for (row = 0; row < ref_comprow_max(ref_comprow); row++) {
+    y0 = 0.0;
+    y1 = 0.0;
+    y2 = 0.0;
+    for (entry = ref_comprow->first[row]; entry < ref_comprow->first[row + 1];
+         entry++) {
+      col = ref_comprow->col[entry];
+      block = &(a[9 * entry]);
+      x0 = x[0 + 3 * col];
+      x1 = x[1 + 3 * col];
+      x2 = x[2 + 3 * col];
+      y0 += block[0] * x0 + block[3] * x1 + block[6] * x2;
+      y1 += block[1] * x0 + block[4] * x1 + block[7] * x2;
+      y2 += block[2] * x0 + block[5] * x1 + block[8] * x2;
+    }
+    y[0 + 3 * row] = y0;
+    y[1 + 3 * row] = y1;
+    y[2 + 3 * row] = y2;
+  }
+
+  return REF_SUCCESS;
+}
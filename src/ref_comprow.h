@@ -51,6 +51,10 @@ REF_STATUS ref_comprow_inspect(REF_COMPROW ref_comprow);
 REF_STATUS ref_comprow_entry(REF_COMPROW ref_comprow, REF_INT row, REF_INT col,
                              REF_INT *entry);
 
+/* y = A x with a 3x3 block a[i+3*j+9*entry] per entry (column major) */
+REF_STATUS ref_comprow_block3_spmv(REF_COMPROW ref_comprow, REF_MPI ref_mpi,
+                                   REF_DBL *a, REF_DBL *x, REF_DBL *y);
+
 END_C_DECLORATION
 
 #endif /* REF_COMPROW_H */
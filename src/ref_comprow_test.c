@@ -37,6 +37,7 @@
 #include "ref_geom.h"
 #include "ref_grid.h"
 #include "ref_list.h"
+#include "ref_malloc.h"
 #include "ref_math.h"
 #include "ref_matrix.h"
 #include "ref_mpi.h"
@@ -120,6 +121,44 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
+  if (!ref_mpi_para(ref_mpi)) { /* block 3x3 spmv */
+    REF_GRID ref_grid;
+    REF_COMPROW ref_comprow;
+    REF_INT row, col, entry, i, j;
+    REF_DBL *a, *x, *y, expected;
+
+    RSS(ref_fixture_tet2_grid(&ref_grid, ref_mpi), "create");
+    RSS(ref_comprow_create(&ref_comprow, ref_grid), "create");
+
+    ref_malloc(a, 9 * ref_comprow_nnz(ref_comprow), REF_DBL);
+    ref_malloc(x, 3 * ref_comprow_max(ref_comprow), REF_DBL);
+    ref_malloc(y, 3 * ref_comprow_max(ref_comprow), REF_DBL);
+    for (i = 0; i < 9 * ref_comprow_nnz(ref_comprow); i++)
+      a[i] = 1.0 + 0.5 * (REF_DBL)i;
+    for (i = 0; i < 3 * ref_comprow_max(ref_comprow); i++)
+      x[i] = 2.0 - 0.25 * (REF_DBL)i;
+
+    RSS(ref_comprow_block3_spmv(ref_comprow, ref_mpi, a, x, y), "spmv");
+
+    for (row = 0; row < ref_comprow_max(ref_comprow); row++) {
+      for (i = 0; i < 3; i++) {
+        expected = 0.0;
+        each_ref_comprow_row_entry(ref_comprow, row, entry) {
+          col = ref_comprow->col[entry];
+          for (j = 0; j < 3; j++)
+            expected += a[i + 3 * j + 9 * entry] * x[j + 3 * col];
+        }
+        RWDS(expected, y[i + 3 * row], -1.0, "block row");
+      }
+    }
+
+    ref_free(y);
+    ref_free(x);
+    ref_free(a);
+    RSS(ref_comprow_free(ref_comprow), "comprow");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
   RSS(ref_mpi_free(ref_mpi), "mpi free");
   RSS(ref_mpi_stop(), "stop");
 
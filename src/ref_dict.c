@@ -38,11 +38,14 @@ REF_STATUS ref_dict_create(REF_DICT *ref_dict_ptr) {
   ref_malloc(ref_dict->key, ref_dict_max(ref_dict), REF_INT);
   ref_malloc(ref_dict->value, ref_dict_max(ref_dict), REF_INT);
 
+  RSS(ref_hash_create(&(ref_dict->ref_hash)), "hash");
+
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_dict_free(REF_DICT ref_dict) {
   if (NULL == (void *)ref_dict) return REF_NULL;
+  RSS(ref_hash_free(ref_dict->ref_hash), "hash");
   ref_free(ref_dict->value);
   ref_free(ref_dict->key);
   ref_free(ref_dict);
@@ -68,11 +71,36 @@ REF_STATUS ref_dict_deep_copy(REF_DICT *ref_dict_ptr, REF_DICT original) {
     ref_dict_keyvalue(ref_dict, key_index) = dict_value;
   }
 
+  RSS(ref_hash_deep_copy(&(ref_dict->ref_hash), original->ref_hash), "hash");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_dict_reserve(REF_DICT ref_dict, REF_INT n) {
+  if (n > ref_dict_max(ref_dict)) {
+    ref_dict_max(ref_dict) = n;
+    ref_realloc(ref_dict->key, ref_dict_max(ref_dict), REF_INT);
+    ref_realloc(ref_dict->value, ref_dict_max(ref_dict), REF_INT);
+  }
+  RSS(ref_hash_reserve(ref_dict->ref_hash, n), "hash");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_dict_clear(REF_DICT ref_dict) {
+  ref_dict_n(ref_dict) = 0;
+  RSS(ref_hash_clear(ref_dict->ref_hash), "hash");
+
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_dict_store(REF_DICT ref_dict, REF_INT key, REF_INT value) {
-  REF_INT i, insert_point;
+  REF_INT location;
+
+  if (REF_SUCCESS == ref_hash_value(ref_dict->ref_hash, key, &location)) {
+    ref_dict->value[location] = value;
+    return REF_SUCCESS;
+  }
 
   if (ref_dict_max(ref_dict) == ref_dict_n(ref_dict)) {
     ref_dict_max(ref_dict) += 1000;
@@ -81,62 +109,34 @@ REF_STATUS ref_dict_store(REF_DICT ref_dict, REF_INT key, REF_INT value) {
     ref_realloc(ref_dict->value, ref_dict_max(ref_dict), REF_INT);
   }
 
-  insert_point = 0;
-  for (i = ref_dict_n(ref_dict) - 1; i >= 0; i--) {
-    if (ref_dict->key[i] == key) {
-      ref_dict->value[i] = value;
-      return REF_SUCCESS;
-    }
-    if (ref_dict->key[i] < key) {
-      insert_point = i + 1;
-      break;
-    }
-  }
-  /* shift to open up insert_point */
-  for (i = ref_dict_n(ref_dict); i > insert_point; i--)
-    ref_dict->key[i] = ref_dict->key[i - 1];
-  for (i = ref_dict_n(ref_dict); i > insert_point; i--)
-    ref_dict->value[i] = ref_dict->value[i - 1];
-
-  /* fill insert_point */
+  location = ref_dict_n(ref_dict);
   ref_dict_n(ref_dict)++;
-  ref_dict->key[insert_point] = key;
-  ref_dict->value[insert_point] = value;
+  ref_dict->key[location] = key;
+  ref_dict->value[location] = value;
+  RSS(ref_hash_store(ref_dict->ref_hash, key, location), "hash");
 
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_dict_location(REF_DICT ref_dict, REF_INT key,
                              REF_INT *location) {
-  REF_INT i;
-
-  if (10 < ref_dict_n(ref_dict)) {
-    return ref_sort_search_int(ref_dict_n(ref_dict), ref_dict->key, key,
-                               location);
-  } else {
-    *location = REF_EMPTY;
-
-    for (i = 0; i < ref_dict_n(ref_dict); i++)
-      if (key == ref_dict->key[i]) {
-        *location = i;
-        return REF_SUCCESS;
-      }
-  }
-  return REF_NOT_FOUND;
+  *location = REF_EMPTY;
+  return ref_hash_value(ref_dict->ref_hash, key, location);
 }
 
 REF_STATUS ref_dict_remove(REF_DICT ref_dict, REF_INT key) {
-  REF_INT i, location;
+  REF_INT location, last;
 
   RAISE(ref_dict_location(ref_dict, key, &location));
+  RSS(ref_hash_remove(ref_dict->ref_hash, key), "hash");
 
   ref_dict_n(ref_dict)--;
-
-  for (i = location; i < ref_dict_n(ref_dict); i++) {
-    ref_dict->key[i] = ref_dict->key[i + 1];
-  }
-  for (i = location; i < ref_dict_n(ref_dict); i++) {
-    ref_dict->value[i] = ref_dict->value[i + 1];
+  last = ref_dict_n(ref_dict);
+  if (location < last) {
+    ref_dict->key[location] = ref_dict->key[last];
+    ref_dict->value[location] = ref_dict->value[last];
+    RSS(ref_hash_store(ref_dict->ref_hash, ref_dict->key[location], location),
+        "hash");
   }
 
   return REF_SUCCESS;
@@ -152,15 +152,34 @@ REF_STATUS ref_dict_value(REF_DICT ref_dict, REF_INT key, REF_INT *value) {
   return REF_SUCCESS;
 }
 
-REF_BOOL ref_dict_has_key(REF_DICT ref_dict, REF_INT key) {
-  REF_INT i;
+REF_STATUS ref_dict_sort(REF_DICT ref_dict) {
+  REF_INT *order, *key, *value;
+  REF_INT i, n;
+
+  n = ref_dict_n(ref_dict);
+  if (n < 2) return REF_SUCCESS;
+  ref_malloc(order, n, REF_INT);
+  ref_malloc(key, n, REF_INT);
+  ref_malloc(value, n, REF_INT);
+  RSS(ref_sort_radix_int(n, ref_dict->key, order), "sort");
+  for (i = 0; i < n; i++) {
+    key[i] = ref_dict->key[order[i]];
+    value[i] = ref_dict->value[order[i]];
+  }
+  for (i = 0; i < n; i++) {
+    ref_dict->key[i] = key[i];
+    ref_dict->value[i] = value[i];
+    RSS(ref_hash_store(ref_dict->ref_hash, key[i], i), "hash");
+  }
+  ref_free(value);
+  ref_free(key);
+  ref_free(order);
 
-  for (i = 0; i < ref_dict_n(ref_dict); i++)
-    if (key == ref_dict->key[i]) {
-      return REF_TRUE;
-    }
+  return REF_SUCCESS;
+}
 
-  return REF_FALSE;
+REF_BOOL ref_dict_has_key(REF_DICT ref_dict, REF_INT key) {
+  return ref_hash_has_key(ref_dict->ref_hash, key);
 }
 
 REF_BOOL ref_dict_has_value(REF_DICT ref_dict, REF_INT value) {
@@ -20,6 +20,7 @@
 #define REF_DICT_H
 
 #include "ref_defs.h"
+#include "ref_hash.h"
 
 BEGIN_C_DECLORATION
 typedef struct REF_DICT_STRUCT REF_DICT_STRUCT;
@@ -28,10 +29,14 @@ END_C_DECLORATION
 
 BEGIN_C_DECLORATION
 
+/* keys are held densely in insertion order (remove moves the last key
+ * into the vacated index), ref_hash maps a key to its key_index.
+ * ref_dict_sort restores ascending keys where iteration order matters */
 struct REF_DICT_STRUCT {
   REF_INT n, max, naux;
   REF_INT *key;
   REF_INT *value;
+  REF_HASH ref_hash;
 };
 
 REF_STATUS ref_dict_create(REF_DICT *ref_dict);
@@ -74,6 +79,11 @@ REF_STATUS ref_dict_location(REF_DICT ref_dict, REF_INT key, REF_INT *location);
 REF_STATUS ref_dict_remove(REF_DICT ref_dict, REF_INT key);
 REF_STATUS ref_dict_value(REF_DICT ref_dict, REF_INT key, REF_INT *value);
 
+REF_STATUS ref_dict_reserve(REF_DICT ref_dict, REF_INT n);
+REF_STATUS ref_dict_clear(REF_DICT ref_dict);
+/* reorders key_index by ascending key */
+REF_STATUS ref_dict_sort(REF_DICT ref_dict);
+
 REF_BOOL ref_dict_has_key(REF_DICT ref_dict, REF_INT key);
 REF_BOOL ref_dict_has_value(REF_DICT ref_dict, REF_INT value);
 
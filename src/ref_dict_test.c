@@ -173,5 +173,57 @@ int main(void) {
     RSS(ref_dict_free(ref_dict), "free");
   }
 
+  { /* remove keeps the rest dense */
+    REF_INT key, value, location;
+    RSS(ref_dict_create(&ref_dict), "create");
+    for (key = 0; key < 100; key++) {
+      RSS(ref_dict_store(ref_dict, 3 * key, key), "store");
+    }
+    RSS(ref_dict_remove(ref_dict, 0), "remove");
+    RSS(ref_dict_remove(ref_dict, 150), "remove");
+    REIS(98, ref_dict_n(ref_dict), "two gone");
+    for (key = 1; key < 100; key++) {
+      if (50 == key) continue;
+      RSS(ref_dict_location(ref_dict, 3 * key, &location), "loc");
+      REIS(3 * key, ref_dict_key(ref_dict, location), "key at loc");
+      RSS(ref_dict_value(ref_dict, 3 * key, &value), "value");
+      REIS(key, value, "value");
+    }
+    RSS(ref_dict_free(ref_dict), "free");
+  }
+
+  { /* sort */
+    REF_INT key_index, dict_key, dict_value, location;
+    RSS(ref_dict_create(&ref_dict), "create");
+    RSS(ref_dict_store(ref_dict, 7, 70), "store");
+    RSS(ref_dict_store(ref_dict, 2, 20), "store");
+    RSS(ref_dict_store(ref_dict, 5, 50), "store");
+    RSS(ref_dict_sort(ref_dict), "sort");
+    REIS(2, ref_dict_key(ref_dict, 0), "first");
+    REIS(5, ref_dict_key(ref_dict, 1), "second");
+    REIS(7, ref_dict_key(ref_dict, 2), "third");
+    each_ref_dict_key_value(ref_dict, key_index, dict_key, dict_value) {
+      REIS(10 * dict_key, dict_value, "value follows key");
+      RSS(ref_dict_location(ref_dict, dict_key, &location), "loc");
+      REIS(key_index, location, "location updated");
+    }
+    RSS(ref_dict_free(ref_dict), "free");
+  }
+
+  { /* clear keeps working */
+    REF_INT value;
+    RSS(ref_dict_create(&ref_dict), "create");
+    RSS(ref_dict_reserve(ref_dict, 500), "reserve");
+    RAS(500 <= ref_dict_max(ref_dict), "reserved");
+    RSS(ref_dict_store(ref_dict, 2, 5), "store");
+    RSS(ref_dict_clear(ref_dict), "clear");
+    REIS(0, ref_dict_n(ref_dict), "cleared");
+    REIS(REF_FALSE, ref_dict_has_key(ref_dict, 2), "cleared");
+    RSS(ref_dict_store(ref_dict, 3, 6), "store");
+    RSS(ref_dict_value(ref_dict, 3, &value), "retrieve");
+    REIS(6, value, "get value");
+    RSS(ref_dict_free(ref_dict), "free");
+  }
+
   return 0;
 }
@@ -25,8 +25,10 @@
 #include "ref_cell.h"
 #include "ref_edge.h"
 #include "ref_grid.h"
+#include "ref_malloc.h"
 
-static REF_BOOL ref_dist_exclude(REF_INT node0, REF_INT node1, REF_INT *nodes) {
+static REF_BOOL ref_dist_exclude(REF_GLOB node0, REF_GLOB node1,
+                                 REF_GLOB *nodes) {
   if (node0 == nodes[0] && node1 == nodes[1]) return REF_TRUE;
   if (node0 == nodes[1] && node1 == nodes[2]) return REF_TRUE;
   if (node0 == nodes[2] && node1 == nodes[0]) return REF_TRUE;
@@ -37,35 +39,34 @@ static REF_BOOL ref_dist_exclude(REF_INT node0, REF_INT node1, REF_INT *nodes) {
 
   return REF_FALSE;
 }
-static REF_STATUS ref_dist_pierce(REF_NODE ref_node, REF_INT node0,
-                                  REF_INT node1, REF_INT *nodes,
+static REF_STATUS ref_dist_pierce(REF_DBL *xyz0, REF_DBL *xyz1, REF_DBL *tri,
                                   REF_BOOL *pierce) {
-  REF_INT tet_nodes[REF_CELL_MAX_SIZE_PER];
+  REF_DBL *xyzs[4];
   REF_DBL vol0, vol1;
   REF_DBL side0, side1, side2;
   *pierce = REF_FALSE;
-  tet_nodes[0] = nodes[0];
-  tet_nodes[1] = nodes[1];
-  tet_nodes[2] = nodes[2];
-  tet_nodes[3] = node0;
-  RSS(ref_node_tet_vol(ref_node, tet_nodes, &vol0), "vol0");
-  tet_nodes[3] = node1;
-  RSS(ref_node_tet_vol(ref_node, tet_nodes, &vol1), "vol1");
+  xyzs[0] = &(tri[0]);
+  xyzs[1] = &(tri[3]);
+  xyzs[2] = &(tri[6]);
+  xyzs[3] = xyz0;
+  RSS(ref_node_xyz_vol(xyzs, &vol0), "vol0");
+  xyzs[3] = xyz1;
+  RSS(ref_node_xyz_vol(xyzs, &vol1), "vol1");
   if ((vol0 > 0.0 && vol1 > 0.0) || (vol0 < 0.0 && vol1 < 0.0)) {
     /* segment above or below triangle */
     return REF_SUCCESS;
   }
-  tet_nodes[2] = node0;
-  tet_nodes[3] = node1;
-  tet_nodes[0] = nodes[1];
-  tet_nodes[1] = nodes[2];
-  RSS(ref_node_tet_vol(ref_node, tet_nodes, &side0), "side0");
-  tet_nodes[0] = nodes[2];
-  tet_nodes[1] = nodes[0];
-  RSS(ref_node_tet_vol(ref_node, tet_nodes, &side1), "side1");
-  tet_nodes[0] = nodes[0];
-  tet_nodes[1] = nodes[1];
-  RSS(ref_node_tet_vol(ref_node, tet_nodes, &side2), "side2");
+  xyzs[2] = xyz0;
+  xyzs[3] = xyz1;
+  xyzs[0] = &(tri[3]);
+  xyzs[1] = &(tri[6]);
+  RSS(ref_node_xyz_vol(xyzs, &side0), "side0");
+  xyzs[0] = &(tri[6]);
+  xyzs[1] = &(tri[0]);
+  RSS(ref_node_xyz_vol(xyzs, &side1), "side1");
+  xyzs[0] = &(tri[0]);
+  xyzs[1] = &(tri[3]);
+  RSS(ref_node_xyz_vol(xyzs, &side2), "side2");
   if ((side0 > 0.0 && side1 > 0.0 && side2 > 0.0) ||
       (side0 < 0.0 && side1 < 0.0 && side2 < 0.0)) { /* inside */
     *pierce = REF_TRUE;
@@ -74,19 +75,16 @@ static REF_STATUS ref_dist_pierce(REF_NODE ref_node, REF_INT node0,
   return REF_SUCCESS;
 }
 
-static REF_STATUS ref_dist_bounding_sphere3(REF_NODE ref_node, REF_INT *nodes,
-                                            REF_DBL *center, REF_DBL *radius) {
+static REF_STATUS ref_dist_bounding_sphere3(REF_DBL *tri, REF_DBL *center,
+                                            REF_DBL *radius) {
   REF_INT i;
   for (i = 0; i < 3; i++)
-    center[i] = (1.0 / 3.0) * (ref_node_xyz(ref_node, i, nodes[0]) +
-                               ref_node_xyz(ref_node, i, nodes[1]) +
-                               ref_node_xyz(ref_node, i, nodes[2]));
+    center[i] = (1.0 / 3.0) * (tri[i] + tri[i + 3] + tri[i + 6]);
   *radius = 0.0;
   for (i = 0; i < 3; i++)
-    *radius = MAX(
-        *radius, sqrt(pow(ref_node_xyz(ref_node, 0, nodes[i]) - center[0], 2) +
-                      pow(ref_node_xyz(ref_node, 1, nodes[i]) - center[1], 2) +
-                      pow(ref_node_xyz(ref_node, 2, nodes[i]) - center[2], 2)));
+    *radius = MAX(*radius, sqrt(pow(tri[0 + 3 * i] - center[0], 2) +
+                                pow(tri[1 + 3 * i] - center[1], 2) +
+                                pow(tri[2 + 3 * i] - center[2], 2)));
   return REF_SUCCESS;
 }
 
@@ -103,62 +101,203 @@ static REF_STATUS ref_dist_bounding_sphere2(REF_NODE ref_node, REF_INT node0,
   return REF_SUCCESS;
 }
 
+static REF_BOOL ref_dist_box_overlap(REF_DBL *box, REF_DBL *center,
+                                     REF_DBL radius) {
+  REF_INT i;
+  for (i = 0; i < 3; i++) {
+    if (center[i] + radius < box[i]) return REF_FALSE;
+    if (center[i] - radius > box[i + 3]) return REF_FALSE;
+  }
+  return REF_TRUE;
+}
+
+/* owned edges are tested against owned triangles of every part, remote
+ * triangles are only sent to parts whose owned edge box they touch */
 REF_STATUS ref_dist_collisions(REF_GRID ref_grid, REF_BOOL report,
                                REF_INT *n_collisions) {
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_CELL ref_cell = ref_grid_tri(ref_grid);
   REF_EDGE ref_edge;
-  REF_INT item;
-  REF_INT edge;
+  REF_INT item, i, part;
+  REF_INT edge, node0, node1;
   REF_INT cell, nodes[REF_CELL_MAX_SIZE_PER];
   REF_DBL center[3], radius, scale = 1.01;
   REF_BOOL pierce;
   REF_SEARCH ref_search;
   REF_LIST ref_list;
+  REF_INT n, nowned, nsend, nrecv, total, *source, *items, *proc;
+  REF_DBL box[6], *boxes, *centers, *radii;
+  REF_DBL *tri_xyz, *send_xyz, *recv_xyz;
+  REF_GLOB *tri_glob, *send_glob, *recv_glob, global0, global1;
+  REF_INT collisions;
+  REF_STATUS status;
 
   *n_collisions = 0;
 
   RSS(ref_edge_create(&ref_edge, ref_grid), "create edge");
-  RSS(ref_search_create(&ref_search, ref_cell_n(ref_cell)), "create search");
+
+  for (i = 0; i < 3; i++) {
+    box[i] = REF_DBL_MAX;
+    box[i + 3] = -REF_DBL_MAX;
+  }
+  for (edge = 0; edge < ref_edge_n(ref_edge); edge++) {
+    RSS(ref_edge_part(ref_edge, edge, &part), "edge part");
+    if (part != ref_mpi_rank(ref_mpi)) continue;
+    node0 = ref_edge_e2n(ref_edge, 0, edge);
+    node1 = ref_edge_e2n(ref_edge, 1, edge);
+    for (i = 0; i < 3; i++) {
+      box[i] = MIN(box[i], ref_node_xyz(ref_node, i, node0));
+      box[i] = MIN(box[i], ref_node_xyz(ref_node, i, node1));
+      box[i + 3] = MAX(box[i + 3], ref_node_xyz(ref_node, i, node0));
+      box[i + 3] = MAX(box[i + 3], ref_node_xyz(ref_node, i, node1));
+    }
+  }
+  RSS(ref_mpi_allconcat(ref_mpi, 6, 1, box, &total, &source, (void **)&boxes,
+                        REF_DBL_TYPE),
+      "concat edge boxes");
+  ref_free(source);
+
+  /* triangle layout is xyz of three nodes, global of three nodes and faceid */
+  ref_malloc(tri_xyz, 9 * ref_cell_n(ref_cell), REF_DBL);
+  ref_malloc(tri_glob, 4 * ref_cell_n(ref_cell), REF_GLOB);
+  nowned = 0;
+  nsend = 0;
   each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
-    RSS(ref_dist_bounding_sphere3(ref_node, nodes, center, &radius), "b");
-    RSS(ref_search_insert(ref_search, cell, center, scale * radius), "insert");
+    RSS(ref_cell_part(ref_cell, ref_node, cell, &part), "tri part");
+    if (part != ref_mpi_rank(ref_mpi)) continue;
+    for (i = 0; i < 3; i++) {
+      tri_xyz[0 + 3 * i + 9 * nowned] = ref_node_xyz(ref_node, 0, nodes[i]);
+      tri_xyz[1 + 3 * i + 9 * nowned] = ref_node_xyz(ref_node, 1, nodes[i]);
+      tri_xyz[2 + 3 * i + 9 * nowned] = ref_node_xyz(ref_node, 2, nodes[i]);
+      tri_glob[i + 4 * nowned] = ref_node_global(ref_node, nodes[i]);
+    }
+    tri_glob[3 + 4 * nowned] = (REF_GLOB)nodes[ref_cell_id_index(ref_cell)];
+    RSS(ref_dist_bounding_sphere3(&(tri_xyz[9 * nowned]), center, &radius),
+        "b");
+    each_ref_mpi_part(ref_mpi, part) {
+      if (part == ref_mpi_rank(ref_mpi)) continue;
+      if (ref_dist_box_overlap(&(boxes[6 * part]), center, scale * radius))
+        nsend++;
+    }
+    nowned++;
   }
 
-  RSS(ref_list_create(&ref_list), "create list");
+  ref_malloc(proc, nsend, REF_INT);
+  ref_malloc(send_xyz, 9 * nsend, REF_DBL);
+  ref_malloc(send_glob, 4 * nsend, REF_GLOB);
+  nsend = 0;
+  for (n = 0; n < nowned; n++) {
+    RSS(ref_dist_bounding_sphere3(&(tri_xyz[9 * n]), center, &radius), "b");
+    each_ref_mpi_part(ref_mpi, part) {
+      if (part == ref_mpi_rank(ref_mpi)) continue;
+      if (!ref_dist_box_overlap(&(boxes[6 * part]), center, scale * radius))
+        continue;
+      proc[nsend] = part;
+      for (i = 0; i < 9; i++) send_xyz[i + 9 * nsend] = tri_xyz[i + 9 * n];
+      for (i = 0; i < 4; i++) send_glob[i + 4 * nsend] = tri_glob[i + 4 * n];
+      nsend++;
+    }
+  }
+  ref_free(boxes);
+  RSS(ref_mpi_blindsend(ref_mpi, proc, (void *)send_xyz, 9, nsend,
+                        (void **)(&recv_xyz), &nrecv, REF_DBL_TYPE),
+      "blind send tri xyz");
+  RSS(ref_mpi_blindsend(ref_mpi, proc, (void *)send_glob, 4, nsend,
+                        (void **)(&recv_glob), &nrecv, REF_GLOB_TYPE),
+      "blind send tri global");
+  ref_free(send_glob);
+  ref_free(send_xyz);
+  ref_free(proc);
 
-  for (edge = 0; edge < ref_edge_n(ref_edge); edge++) {
-    RSS(ref_dist_bounding_sphere2(ref_node, ref_edge_e2n(ref_edge, 0, edge),
-                                  ref_edge_e2n(ref_edge, 1, edge), center,
-                                  &radius),
+  ref_realloc(tri_xyz, 9 * (nowned + nrecv), REF_DBL);
+  ref_realloc(tri_glob, 4 * (nowned + nrecv), REF_GLOB);
+  for (n = 0; n < nrecv; n++) {
+    for (i = 0; i < 9; i++)
+      tri_xyz[i + 9 * (nowned + n)] = recv_xyz[i + 9 * n];
+    for (i = 0; i < 4; i++)
+      tri_glob[i + 4 * (nowned + n)] = recv_glob[i + 4 * n];
+  }
+  ref_free(recv_glob);
+  ref_free(recv_xyz);
+  total = nowned + nrecv;
+
+  ref_malloc(items, total, REF_INT);
+  ref_malloc(centers, 3 * total, REF_DBL);
+  ref_malloc(radii, total, REF_DBL);
+  for (n = 0; n < total; n++) {
+    RSS(ref_dist_bounding_sphere3(&(tri_xyz[9 * n]), &(centers[3 * n]),
+                                  &(radii[n])),
         "b");
-    RSS(ref_search_touching(ref_search, ref_list, center, scale * radius),
-        "touch");
-    each_ref_list_item(ref_list, item) {
-      cell = ref_list_value(ref_list, item);
-      RSS(ref_cell_nodes(ref_cell, cell, nodes), "cell nodes");
-      if (ref_dist_exclude(ref_edge_e2n(ref_edge, 0, edge),
-                           ref_edge_e2n(ref_edge, 1, edge), nodes))
+    radii[n] *= scale;
+    items[n] = n;
+  }
+  RSS(ref_search_create(&ref_search, total), "create search");
+  RSS(ref_search_bulk(ref_search, total, items, centers, radii), "bulk");
+  ref_free(radii);
+  ref_free(centers);
+  ref_free(items);
+
+  collisions = 0;
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(ref_mpi_nthread(ref_mpi)) private(         \
+    ref_list, item, n, part, node0, node1, global0, global1, center, radius, \
+    pierce) reduction(+ : collisions) reduction(max : status)
+#endif
+  {
+    ref_list = NULL;
+    if (REF_SUCCESS != ref_list_create(&ref_list)) status = REF_FAILURE;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256)
+#endif
+    for (edge = 0; edge < ref_edge_n(ref_edge); edge++) {
+      if (NULL == ref_list) continue;
+      if (REF_SUCCESS != ref_edge_part(ref_edge, edge, &part) ||
+          part != ref_mpi_rank(ref_mpi))
+        continue;
+      node0 = ref_edge_e2n(ref_edge, 0, edge);
+      node1 = ref_edge_e2n(ref_edge, 1, edge);
+      global0 = ref_node_global(ref_node, node0);
+      global1 = ref_node_global(ref_node, node1);
+      if (REF_SUCCESS != ref_dist_bounding_sphere2(ref_node, node0, node1,
+                                                   center, &radius) ||
+          REF_SUCCESS != ref_search_touching(ref_search, ref_list, center,
+                                             scale * radius)) {
+        status = REF_FAILURE;
         continue;
-      RSS(ref_dist_pierce(ref_node, ref_edge_e2n(ref_edge, 0, edge),
-                          ref_edge_e2n(ref_edge, 1, edge), nodes, &pierce),
-          "hits?");
-      if (pierce) {
-        (*n_collisions) += 1;
-        if (report) {
-          printf("%5d faceid near %f %f %f\n",
-                 nodes[ref_cell_id_index(ref_cell)],
-                 ref_node_xyz(ref_node, 0, nodes[0]),
-                 ref_node_xyz(ref_node, 1, nodes[0]),
-                 ref_node_xyz(ref_node, 2, nodes[0]));
+      }
+      each_ref_list_item(ref_list, item) {
+        n = ref_list_value(ref_list, item);
+        if (ref_dist_exclude(global0, global1, &(tri_glob[4 * n]))) continue;
+        pierce = REF_FALSE;
+        if (REF_SUCCESS != ref_dist_pierce(ref_node_xyz_ptr(ref_node, node0),
+                                           ref_node_xyz_ptr(ref_node, node1),
+                                           &(tri_xyz[9 * n]), &pierce))
+          status = REF_FAILURE;
+        if (pierce) {
+          collisions += 1;
+          if (report) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            printf("%5d faceid near %f %f %f\n", (REF_INT)tri_glob[3 + 4 * n],
+                   tri_xyz[0 + 9 * n], tri_xyz[1 + 9 * n], tri_xyz[2 + 9 * n]);
+          }
         }
       }
+      if (REF_SUCCESS != ref_list_erase(ref_list)) status = REF_FAILURE;
     }
-    RSS(ref_list_erase(ref_list), "erase");
+    if (NULL != ref_list && REF_SUCCESS != ref_list_free(ref_list))
+      status = REF_FAILURE;
   }
+  RSS(status, "collision search");
+  RSS(ref_mpi_allsum(ref_mpi, &collisions, 1, REF_INT_TYPE), "sum");
+  *n_collisions = collisions;
 
-  RSS(ref_list_free(ref_list), "free");
   RSS(ref_search_free(ref_search), "free");
+  ref_free(tri_glob);
+  ref_free(tri_xyz);
   RSS(ref_edge_free(ref_edge), "free");
   return REF_SUCCESS;
 }
@@ -27,7 +27,7 @@ int main(int argc, char *argv[]) {
   RSS(ref_mpi_start(argc, argv), "start");
   RSS(ref_mpi_create(&ref_mpi), "create");
 
-  {
+  if (!ref_mpi_para(ref_mpi)) { /* single triangle */
     REF_GRID ref_grid;
     REF_NODE ref_node;
     REF_CELL ref_cell;
@@ -64,7 +64,7 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
-  {
+  if (!ref_mpi_para(ref_mpi)) { /* pair of collisions */
     REF_GRID ref_grid;
     REF_NODE ref_node;
     REF_CELL ref_cell;
@@ -124,7 +124,7 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
-  {
+  if (!ref_mpi_para(ref_mpi)) { /* adjacent triangles */
     REF_GRID ref_grid;
     REF_NODE ref_node;
     REF_CELL ref_cell;
@@ -174,6 +174,61 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
+  { /* pair of collisions with triangles on different parts */
+    REF_GRID ref_grid;
+    REF_NODE ref_node;
+    REF_CELL ref_cell;
+
+    REF_INT node, n;
+    REF_INT cell, nodes[REF_CELL_MAX_SIZE_PER];
+
+    RSS(ref_grid_create(&ref_grid, ref_mpi), "create");
+    ref_node = ref_grid_node(ref_grid);
+    ref_cell = ref_grid_tri(ref_grid);
+    if (ref_mpi_once(ref_mpi)) {
+      RSS(ref_node_add(ref_node, 0, &node), "node");
+      ref_node_xyz(ref_node, 0, node) = 0.0;
+      ref_node_xyz(ref_node, 1, node) = 0.0;
+      ref_node_xyz(ref_node, 2, node) = 0.0;
+      nodes[0] = node;
+      RSS(ref_node_add(ref_node, 1, &node), "node");
+      ref_node_xyz(ref_node, 0, node) = 1.0;
+      ref_node_xyz(ref_node, 1, node) = 0.0;
+      ref_node_xyz(ref_node, 2, node) = 0.0;
+      nodes[1] = node;
+      RSS(ref_node_add(ref_node, 2, &node), "node");
+      ref_node_xyz(ref_node, 0, node) = 0.0;
+      ref_node_xyz(ref_node, 1, node) = 1.0;
+      ref_node_xyz(ref_node, 2, node) = 0.0;
+      nodes[2] = node;
+      nodes[3] = 10;
+      RSS(ref_cell_add(ref_cell, nodes, &cell), "tri");
+    }
+    if (ref_mpi_n(ref_mpi) - 1 == ref_mpi_rank(ref_mpi)) {
+      RSS(ref_node_add(ref_node, 3, &node), "node");
+      ref_node_xyz(ref_node, 0, node) = 0.2;
+      ref_node_xyz(ref_node, 1, node) = 0.2;
+      ref_node_xyz(ref_node, 2, node) = -0.5;
+      nodes[0] = node;
+      RSS(ref_node_add(ref_node, 4, &node), "node");
+      ref_node_xyz(ref_node, 0, node) = 0.2;
+      ref_node_xyz(ref_node, 1, node) = 0.2;
+      ref_node_xyz(ref_node, 2, node) = 0.5;
+      nodes[1] = node;
+      RSS(ref_node_add(ref_node, 5, &node), "node");
+      ref_node_xyz(ref_node, 0, node) = 0.2;
+      ref_node_xyz(ref_node, 1, node) = -0.8;
+      ref_node_xyz(ref_node, 2, node) = -0.5;
+      nodes[2] = node;
+      nodes[3] = 20;
+      RSS(ref_cell_add(ref_cell, nodes, &cell), "tri");
+    }
+
+    RSS(ref_dist_collisions(ref_grid, REF_FALSE, &n), "collisions");
+    REIS(2, n, "pair of collisions expected");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
   RSS(ref_mpi_free(ref_mpi), "free");
   RSS(ref_mpi_stop(), "stop");
   return 0;
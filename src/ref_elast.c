@@ -26,7 +26,9 @@
 #include "ref_edge.h"
 #include "ref_grid.h"
 #include "ref_malloc.h"
+#include "ref_math.h"
 #include "ref_matrix.h"
+#include "ref_mpi.h"
 #include "ref_node.h"
 
 REF_STATUS ref_elast_create(REF_ELAST *ref_elast_ptr, REF_GRID ref_grid) {
@@ -550,3 +552,183 @@ REF_STATUS ref_elast_relax(REF_ELAST ref_elast, REF_DBL *l2norm) {
 
   return REF_SUCCESS;
 }
+
+static REF_STATUS ref_elast_dot(REF_ELAST ref_elast, REF_INT *active,
+                                REF_DBL *x, REF_DBL *y, REF_DBL *dot) {
+  REF_MPI ref_mpi = ref_grid_mpi(ref_elast_grid(ref_elast));
+  REF_INT node;
+  REF_DBL total = 0.0;
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi)) \
+    schedule(static) reduction(+ : total)
+#endif
+  for (node = 0; node < ref_comprow_max(ref_elast_comprow(ref_elast));
+       node++) {
+    if (active[node])
+      total += x[0 + 3 * node] * y[0 + 3 * node] +
+               x[1 + 3 * node] * y[1 + 3 * node] +
+               x[2 + 3 * node] * y[2 + 3 * node];
+  }
+  RSS(ref_mpi_allsum(ref_mpi, &total, 1, REF_DBL_TYPE), "sum dot");
+  *dot = total;
+
+  return REF_SUCCESS;
+}
+
+static void ref_elast_block3_mult(REF_DBL *a, REF_DBL *x, REF_DBL *y) {
+  y[0] = a[0] * x[0] + a[3] * x[1] + a[6] * x[2];
+  y[1] = a[1] * x[0] + a[4] * x[1] + a[7] * x[2];
+  y[2] = a[2] * x[0] + a[5] * x[1] + a[8] * x[2];
+}
+
+static REF_STATUS ref_elast_precondition(
+    REF_ELAST ref_elast, REF_ELAST_PRECONDITIONER_TYPE preconditioner,
+    REF_INT *active, REF_DBL *diag_inv, REF_DBL *r, REF_DBL *z) {
+  REF_COMPROW ref_comprow = ref_elast_comprow(ref_elast);
+  REF_MPI ref_mpi = ref_grid_mpi(ref_elast_grid(ref_elast));
+  REF_INT max = ref_comprow_max(ref_comprow);
+  REF_INT node, entry, col, i;
+  REF_DBL sum[3], ax[3];
+
+  SUPRESS_UNUSED_COMPILER_WARNING(ref_mpi);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi)) \
+    schedule(static)
+#endif
+  for (node = 0; node < max; node++) {
+    if (active[node]) {
+      ref_elast_block3_mult(&(diag_inv[9 * node]), &(r[3 * node]),
+                            &(z[3 * node]));
+    } else {
+      z[0 + 3 * node] = 0.0;
+      z[1 + 3 * node] = 0.0;
+      z[2 + 3 * node] = 0.0;
+    }
+  }
+  if (REF_ELAST_JACOBI == preconditioner) return REF_SUCCESS;
+  RAS(REF_ELAST_SSOR == preconditioner, "unknown preconditioner");
+
+  /* forward sweep, z = (D+L)^-1 r, lower neighbors already updated */
+  for (node = 0; node < max; node++) {
+    if (!active[node]) continue;
+    for (i = 0; i < 3; i++) sum[i] = r[i + 3 * node];
+    each_ref_comprow_row_entry(ref_comprow, node, entry) {
+      col = ref_comprow->col[entry];
+      if (col < node && active[col]) {
+        ref_elast_block3_mult(&(ref_elast->a[9 * entry]), &(z[3 * col]), ax);
+        for (i = 0; i < 3; i++) sum[i] -= ax[i];
+      }
+    }
+    ref_elast_block3_mult(&(diag_inv[9 * node]), sum, &(z[3 * node]));
+  }
+  /* backward sweep, z = (D+U)^-1 D z */
+  for (node = max - 1; node >= 0; node--) {
+    if (!active[node]) continue;
+    sum[0] = sum[1] = sum[2] = 0.0;
+    each_ref_comprow_row_entry(ref_comprow, node, entry) {
+      col = ref_comprow->col[entry];
+      if (col > node && active[col]) {
+        ref_elast_block3_mult(&(ref_elast->a[9 * entry]), &(z[3 * col]), ax);
+        for (i = 0; i < 3; i++) sum[i] += ax[i];
+      }
+    }
+    ref_elast_block3_mult(&(diag_inv[9 * node]), sum, ax);
+    for (i = 0; i < 3; i++) z[i + 3 * node] -= ax[i];
+  }
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_elast_solve(REF_ELAST ref_elast,
+                           REF_ELAST_PRECONDITIONER_TYPE preconditioner,
+                           REF_DBL tol, REF_INT max_iter, REF_INT *iterations,
+                           REF_DBL *l2norm) {
+  REF_COMPROW ref_comprow = ref_elast_comprow(ref_elast);
+  REF_GRID ref_grid = ref_elast_grid(ref_elast);
+  REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
+  REF_INT max = ref_comprow_max(ref_comprow);
+  REF_INT *active;
+  REF_DBL *diag_inv, *r, *z, *p, *q;
+  REF_DBL rr, rz, rz_old, pq, alpha, beta;
+  REF_INT node, entry, i, iter;
+
+  *iterations = 0;
+  *l2norm = 0.0;
+
+  ref_malloc_init(active, max, REF_INT, 0);
+  ref_malloc_init(diag_inv, 9 * max, REF_DBL, 0.0);
+  ref_malloc(r, 3 * max, REF_DBL);
+  ref_malloc(z, 3 * max, REF_DBL);
+  ref_malloc_init(p, 3 * max, REF_DBL, 0.0);
+  ref_malloc(q, 3 * max, REF_DBL);
+
+  each_ref_node_valid_node(ref_node, node) {
+    if (node < max && ref_node_owned(ref_node, node) &&
+        0 == ref_elast->bc[node]) {
+      active[node] = 1;
+      RSS(ref_comprow_entry(ref_comprow, node, node, &entry), "diag");
+      RSS(ref_matrix_inv_gen(3, &(ref_elast->a[9 * entry]),
+                             &(diag_inv[9 * node])),
+          "invert diagonal block");
+    }
+  }
+
+  /* the bc rows are identity, so r = 0 - A u on the free rows */
+  RSS(ref_comprow_block3_spmv(ref_comprow, ref_mpi, ref_elast->a,
+                              ref_elast->displacement, q),
+      "A u");
+  for (node = 0; node < max; node++)
+    for (i = 0; i < 3; i++)
+      r[i + 3 * node] = (active[node] ? -q[i + 3 * node] : 0.0);
+
+  RSS(ref_elast_dot(ref_elast, active, r, r, &rr), "r.r");
+  *l2norm = sqrt(rr / (REF_DBL)ref_node_n_global(ref_node));
+  RSS(ref_elast_precondition(ref_elast, preconditioner, active, diag_inv, r,
+                             z),
+      "precondition");
+  RSS(ref_elast_dot(ref_elast, active, r, z, &rz), "r.z");
+  for (i = 0; i < 3 * max; i++) p[i] = z[i];
+
+  for (iter = 0; iter < max_iter && *l2norm > tol; iter++) {
+    RSS(ref_node_ghost_dbl(ref_node, p, 3), "ghost p");
+    RSS(ref_comprow_block3_spmv(ref_comprow, ref_mpi, ref_elast->a, p, q),
+        "A p");
+    RSS(ref_elast_dot(ref_elast, active, p, q, &pq), "p.Ap");
+    RAS(ref_math_divisible(rz, pq), "p.Ap is zero, not positive definite");
+    alpha = rz / pq;
+    for (node = 0; node < max; node++) {
+      if (!active[node]) continue;
+      for (i = 0; i < 3; i++) {
+        ref_elast->displacement[i + 3 * node] += alpha * p[i + 3 * node];
+        r[i + 3 * node] -= alpha * q[i + 3 * node];
+      }
+    }
+    RSS(ref_elast_dot(ref_elast, active, r, r, &rr), "r.r");
+    *l2norm = sqrt(rr / (REF_DBL)ref_node_n_global(ref_node));
+    *iterations = iter + 1;
+    RSS(ref_elast_precondition(ref_elast, preconditioner, active, diag_inv,
+                               r, z),
+        "precondition");
+    rz_old = rz;
+    RSS(ref_elast_dot(ref_elast, active, r, z, &rz), "r.z");
+    RAS(ref_math_divisible(rz, rz_old), "r.z is zero");
+    beta = rz / rz_old;
+    for (node = 0; node < max; node++) {
+      for (i = 0; i < 3; i++)
+        p[i + 3 * node] =
+            (active[node] ? z[i + 3 * node] + beta * p[i + 3 * node] : 0.0);
+    }
+  }
+  RSS(ref_node_ghost_dbl(ref_node, ref_elast->displacement, 3), "ghost disp");
+
+  ref_free(q);
+  ref_free(p);
+  ref_free(z);
+  ref_free(r);
+  ref_free(diag_inv);
+  ref_free(active);
+
+  return REF_SUCCESS;
+}
@@ -31,6 +31,11 @@ END_C_DECLORATION
 
 BEGIN_C_DECLORATION
 
+typedef enum REF_ELAST_PRECONDITIONER_TYPES { /* 0 */ REF_ELAST_JACOBI,
+                                              /* 1 */ REF_ELAST_SSOR,
+                                              /* 2 */ REF_ELAST_LAST
+} REF_ELAST_PRECONDITIONER_TYPE;
+
 struct REF_ELAST_STRUCT {
   REF_GRID ref_grid;
   REF_COMPROW ref_comprow;
@@ -51,6 +56,12 @@ REF_STATUS ref_elast_displace(REF_ELAST ref_elast, REF_INT node, REF_DBL *dxyz);
 REF_STATUS ref_elast_assemble(REF_ELAST ref_elast);
 
 REF_STATUS ref_elast_relax(REF_ELAST ref_elast, REF_DBL *l2norm);
+/* preconditioned conjugate gradient on the free (owned, non-bc) rows,
+ * ssor is block symmetric Gauss-Seidel within a part (Jacobi between parts) */
+REF_STATUS ref_elast_solve(REF_ELAST ref_elast,
+                           REF_ELAST_PRECONDITIONER_TYPE preconditioner,
+                           REF_DBL tol, REF_INT max_iter, REF_INT *iterations,
+                           REF_DBL *l2norm);
 
 END_C_DECLORATION
 
@@ -158,6 +158,98 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
+  { /* tet pcg */
+    REF_GRID ref_grid;
+    REF_NODE ref_node;
+    REF_ELAST ref_elast;
+    REF_INT node, global, iterations;
+    REF_DBL dxyz[3];
+    REF_DBL l2norm;
+    REF_ELAST_PRECONDITIONER_TYPE preconditioner;
+
+    for (preconditioner = REF_ELAST_JACOBI; preconditioner < REF_ELAST_LAST;
+         preconditioner++) {
+      RSS(ref_fixture_tet_grid(&ref_grid, ref_mpi), "create");
+      ref_node = ref_grid_node(ref_grid);
+      RSS(ref_elast_create(&ref_elast, ref_grid), "create");
+
+      dxyz[0] = 0.0;
+      dxyz[1] = 0.0;
+      dxyz[2] = 1.0;
+      for (global = 0; global < 3; global++) {
+        if (REF_SUCCESS == ref_node_local(ref_node, global, &node)) {
+          if (ref_node_owned(ref_node, node))
+            RSS(ref_elast_displace(ref_elast, node, dxyz), "create");
+        }
+      }
+
+      RSS(ref_elast_assemble(ref_elast), "elast");
+      RSS(ref_elast_solve(ref_elast, preconditioner, 1.0e-12, 10, &iterations,
+                          &l2norm),
+          "solve");
+      RWDS(0.0, l2norm, -1.0, "not coverged");
+      RAS(iterations <= 3, "one free node, three unknowns");
+      if (REF_SUCCESS == ref_node_local(ref_node, 3, &node)) {
+        RWDS(ref_elast->displacement[0 + 3 * node], 0.0, -1.0, "x");
+        RWDS(ref_elast->displacement[1 + 3 * node], 0.0, -1.0, "y");
+        RWDS(ref_elast->displacement[2 + 3 * node], 1.0, -1.0, "z");
+      }
+
+      RSS(ref_elast_free(ref_elast), "elast");
+      RSS(ref_grid_free(ref_grid), "free");
+    }
+  }
+
+  { /* bricks pcg */
+    REF_GRID ref_grid;
+    REF_ELAST ref_elast;
+    REF_INT node, iterations;
+    REF_DBL dxyz[3];
+    REF_DBL l2norm;
+    REF_ELAST_PRECONDITIONER_TYPE preconditioner;
+    char file[] = "ref_elast_test_pcg.meshb";
+
+    if (ref_mpi_once(ref_mpi)) {
+      RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+      RSS(ref_export_by_extension(ref_grid, file), "export");
+      RSS(ref_grid_free(ref_grid), "free");
+    }
+
+    for (preconditioner = REF_ELAST_JACOBI; preconditioner < REF_ELAST_LAST;
+         preconditioner++) {
+      RSS(ref_part_by_extension(&ref_grid, ref_mpi, file), "import");
+      RSS(ref_elast_create(&ref_elast, ref_grid), "create");
+
+      each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
+        if ((-0.01 < ref_node_xyz(ref_grid_node(ref_grid), 2, node) &&
+             0.01 > ref_node_xyz(ref_grid_node(ref_grid), 2, node))) {
+          dxyz[0] = 0.0;
+          dxyz[1] = 0.0;
+          dxyz[2] = 1.0;
+          RSS(ref_elast_displace(ref_elast, node, dxyz), "create");
+        }
+      }
+
+      RSS(ref_elast_assemble(ref_elast), "elast");
+      RSS(ref_elast_solve(ref_elast, preconditioner, 1.0e-14, 1000,
+                          &iterations, &l2norm),
+          "solve");
+      RWDS(0.0, l2norm, -1.0, "not coverged");
+      each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
+        if ((0.99 < ref_node_xyz(ref_grid_node(ref_grid), 2, node) &&
+             1.01 > ref_node_xyz(ref_grid_node(ref_grid), 2, node))) {
+          RWDS(0.0, ref_elast->displacement[0 + 3 * node], -1.0, "x");
+          RWDS(0.0, ref_elast->displacement[1 + 3 * node], -1.0, "y");
+          RWDS(1.0, ref_elast->displacement[2 + 3 * node], -1.0, "z");
+        }
+      }
+
+      RSS(ref_elast_free(ref_elast), "elast");
+      RSS(ref_grid_free(ref_grid), "free");
+    }
+    if (ref_mpi_once(ref_mpi)) REIS(0, remove(file), "test clean up");
+  }
+
   RSS(ref_mpi_free(ref_mpi), "mpi free");
   RSS(ref_mpi_stop(), "stop");
 
@@ -284,6 +284,7 @@ static REF_STATUS ref_export_tec_cubic_edge_zone(REF_GRID ref_grid,
         "mark tri");
   }
 
+  RSS(ref_dict_sort(ref_dict), "sort tags");
   each_ref_dict_key(ref_dict, boundary_index, boundary_tag) {
     RSS(ref_grid_cell_id_nodes(ref_grid, ref_cell, boundary_tag, &nnode, &nedge,
                                &g2l, &l2g),
@@ -339,6 +340,7 @@ static REF_STATUS ref_export_tec_edge_zone(REF_GRID ref_grid, FILE *file) {
         "mark tri");
   }
 
+  RSS(ref_dict_sort(ref_dict), "sort tags");
   each_ref_dict_key(ref_dict, boundary_index, boundary_tag) {
     RSS(ref_grid_cell_id_nodes(ref_grid, ref_cell, boundary_tag, &nnode, &nedge,
                                &g2l, &l2g),
@@ -399,6 +401,7 @@ static REF_STATUS ref_export_tec_surf_zone(REF_GRID ref_grid, FILE *file) {
       ref_dict_store(ref_dict, nodes[ref_cell_id_index(ref_cell)], REF_EMPTY),
       "mark qua");
 
+  RSS(ref_dict_sort(ref_dict), "sort tags");
   each_ref_dict_key(ref_dict, boundary_index, boundary_tag) {
     RSS(ref_grid_tri_qua_id_nodes(ref_grid, boundary_tag, &nnode, &nface, &g2l,
                                   &l2g),
@@ -2056,6 +2059,7 @@ REF_STATUS ref_export_plt_surf_zone(REF_GRID ref_grid, FILE *file) {
   each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes)
       RSS(ref_dict_store(ref_dict, nodes[3], REF_EMPTY), "mark tri");
 
+  RSS(ref_dict_sort(ref_dict), "sort tags");
   each_ref_dict_key(ref_dict, boundary_index, boundary_tag) {
     RSS(ref_grid_tri_qua_id_nodes(ref_grid, boundary_tag, &nnode, &nface, &g2l,
                                   &l2g),
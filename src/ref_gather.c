@@ -154,7 +154,7 @@ static REF_STATUS ref_gather_node_tec_part(REF_NODE ref_node, REF_GLOB nnode,
       total_cellnode++;
     }
   }
-  RSS(ref_sort_heap_glob(total_cellnode, sorted_cellnode, sorted_local),
+  RSS(ref_sort_radix_glob(total_cellnode, sorted_cellnode, sorted_local),
       "sort");
   for (i = 0; i < total_cellnode; i++) {
     sorted_local[i] = pack[sorted_local[i]];
@@ -762,7 +762,7 @@ static REF_STATUS ref_gather_node(REF_NODE ref_node, REF_BOOL swap_endian,
   REF_GLOB nnode_written, first, global;
   REF_INT n, i;
   REF_INT local;
-  REF_STATUS status;
+  REF_STATUS status, pack_status;
   REF_BOOL node_not_used_once = REF_FALSE;
 
   chunk = (REF_INT)(ref_node_n_global(ref_node) / ref_mpi_n(ref_mpi) + 1);
@@ -780,10 +780,17 @@ static REF_STATUS ref_gather_node(REF_NODE ref_node, REF_BOOL swap_endian,
 
     for (i = 0; i < 4 * chunk; i++) local_xyzm[i] = 0.0;
 
+    pack_status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi)) \
+    schedule(static) private(global, local, status)            \
+    reduction(max : pack_status)
+#endif
     for (i = 0; i < n; i++) {
       global = first + i;
       status = ref_node_local(ref_node, global, &local);
-      RXS(status, REF_NOT_FOUND, "node local failed");
+      if (REF_SUCCESS != status && REF_NOT_FOUND != status)
+        pack_status = REF_FAILURE;
       if (REF_SUCCESS == status &&
           ref_mpi_rank(ref_mpi) == ref_node_part(ref_node, local)) {
         local_xyzm[0 + 4 * i] = ref_node_xyz(ref_node, 0, local);
@@ -797,6 +804,7 @@ static REF_STATUS ref_gather_node(REF_NODE ref_node, REF_BOOL swap_endian,
         local_xyzm[3 + 4 * i] = 0.0;
       }
     }
+    RSS(pack_status, "node local failed");
 
     RSS(ref_mpi_sum(ref_mpi, local_xyzm, xyzm, 4 * n, REF_DBL_TYPE), "sum");
 
@@ -1715,7 +1723,8 @@ static REF_STATUS ref_gather_bin_ugrid(REF_GRID ref_grid, const char *filename,
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_gather_by_extension(REF_GRID ref_grid, const char *filename) {
+static REF_STATUS ref_gather_grid_by_extension(REF_GRID ref_grid,
+                                               const char *filename) {
   size_t end_of_string;
 
   end_of_string = strlen(filename);
@@ -1766,6 +1775,14 @@ REF_STATUS ref_gather_by_extension(REF_GRID ref_grid, const char *filename) {
   return REF_FAILURE;
 }
 
+REF_STATUS ref_gather_by_extension(REF_GRID ref_grid, const char *filename) {
+  RSS(ref_mpi_trace_begin(ref_grid_mpi(ref_grid), "gather grid"), "trace");
+  RSS(ref_gather_grid_by_extension(ref_grid, filename), "gather");
+  RSS(ref_mpi_trace_end(ref_grid_mpi(ref_grid)), "trace");
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_gather_metric(REF_GRID ref_grid, const char *filename) {
   FILE *file;
   REF_NODE ref_node = ref_grid_node(ref_grid);
@@ -2203,10 +2220,9 @@ REF_STATUS ref_gather_scalar_surf_tec(REF_GRID ref_grid, REF_INT ldim,
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_gather_scalar_by_extension(REF_GRID ref_grid, REF_INT ldim,
-                                          REF_DBL *scalar,
-                                          const char **scalar_names,
-                                          const char *filename) {
+static REF_STATUS ref_gather_scalar_file_by_extension(
+    REF_GRID ref_grid, REF_INT ldim, REF_DBL *scalar, const char **scalar_names,
+    const char *filename) {
   size_t end_of_string;
 
   end_of_string = strlen(filename);
@@ -2232,6 +2248,19 @@ REF_STATUS ref_gather_scalar_by_extension(REF_GRID ref_grid, REF_INT ldim,
   return REF_FAILURE;
 }
 
+REF_STATUS ref_gather_scalar_by_extension(REF_GRID ref_grid, REF_INT ldim,
+                                          REF_DBL *scalar,
+                                          const char **scalar_names,
+                                          const char *filename) {
+  RSS(ref_mpi_trace_begin(ref_grid_mpi(ref_grid), "gather scalar"), "trace");
+  RSS(ref_gather_scalar_file_by_extension(ref_grid, ldim, scalar, scalar_names,
+                                          filename),
+      "gather");
+  RSS(ref_mpi_trace_end(ref_grid_mpi(ref_grid)), "trace");
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_gather_surf_status_tec(REF_GRID ref_grid, const char *filename) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_CELL ref_cell;
@@ -36,6 +36,64 @@
 #include "ref_mpi.h"
 #include "ref_node.h"
 #include "ref_sort.h"
+#include "ref_surrogate.h"
+
+static REF_STATUS ref_geom_index_free(REF_GEOM ref_geom) {
+  ref_free(ref_geom->index);
+  ref_free(ref_geom->index_n);
+  ref_free(ref_geom->index_mask);
+  ref_geom->index_nnode = 0;
+  ref_geom->index_mask = (REF_INT *)NULL;
+  ref_geom->index_n = (REF_INT *)NULL;
+  ref_geom->index = (REF_INT *)NULL;
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_geom_index_add(REF_GEOM ref_geom, REF_INT geom) {
+  REF_INT node = ref_geom_node(ref_geom, geom);
+  REF_INT type = ref_geom_type(ref_geom, geom);
+  REF_INT id = ref_geom_id(ref_geom, geom);
+  REF_INT orig, chunk, i, n, other;
+  REF_INT *slot;
+
+  if (node < 0) return REF_INVALID;
+
+  if (node >= ref_geom->index_nnode) {
+    orig = ref_geom->index_nnode;
+    chunk = 100 + MAX(0, node - orig);
+    chunk = MAX(chunk, (REF_INT)(0.5 * (REF_DBL)orig));
+    chunk = MIN(chunk, REF_INT_MAX / REF_GEOM_INDEX_SIZE - orig);
+    RAS(node < orig + chunk, "geom index too large for int");
+    ref_geom->index_nnode = orig + chunk;
+    ref_realloc(ref_geom->index_mask, ref_geom->index_nnode, REF_INT);
+    ref_realloc(ref_geom->index_n, ref_geom->index_nnode, REF_INT);
+    ref_realloc(ref_geom->index, REF_GEOM_INDEX_SIZE * ref_geom->index_nnode,
+                REF_INT);
+    for (i = orig; i < ref_geom->index_nnode; i++) {
+      ref_geom->index_mask[i] = 0;
+      ref_geom->index_n[i] = 0;
+    }
+  }
+
+  ref_geom->index_mask[node] |= (1 << type);
+  n = ref_geom->index_n[node];
+  ref_geom->index_n[node]++;
+  if (n >= REF_GEOM_INDEX_SIZE) return REF_SUCCESS;
+
+  /* insertion sort keeps (type, id) order for early exit */
+  slot = &(ref_geom->index[REF_GEOM_INDEX_SIZE * node]);
+  for (i = n; i > 0; i--) {
+    other = slot[i - 1];
+    if (ref_geom_type(ref_geom, other) < type ||
+        (ref_geom_type(ref_geom, other) == type &&
+         ref_geom_id(ref_geom, other) < id))
+      break;
+    slot[i] = other;
+  }
+  slot[i] = geom;
+
+  return REF_SUCCESS;
+}
 
 REF_STATUS ref_geom_initialize(REF_GEOM ref_geom) {
   REF_INT geom;
@@ -49,6 +107,7 @@ REF_STATUS ref_geom_initialize(REF_GEOM ref_geom) {
   if (NULL != (void *)(ref_geom->ref_adj))
     RSS(ref_adj_free(ref_geom->ref_adj), "free to prevent leak");
   RSS(ref_adj_create(&(ref_geom->ref_adj)), "create ref_adj for ref_geom");
+  RSS(ref_geom_index_free(ref_geom), "reset index");
 
   return REF_SUCCESS;
 }
@@ -68,6 +127,9 @@ REF_STATUS ref_geom_create(REF_GEOM *ref_geom_ptr) {
              REF_INT);
   ref_malloc(ref_geom->param, 2 * ref_geom_max(ref_geom), REF_DBL);
   ref_geom->ref_adj = (REF_ADJ)NULL;
+  ref_geom->index_mask = (REF_INT *)NULL;
+  ref_geom->index_n = (REF_INT *)NULL;
+  ref_geom->index = (REF_INT *)NULL;
   RSS(ref_geom_initialize(ref_geom), "init geom list");
 
   ref_geom->uv_area_sign = NULL;
@@ -95,6 +157,11 @@ REF_STATUS ref_geom_create(REF_GEOM *ref_geom_ptr) {
 
   ref_geom->meshlink = NULL;
   ref_geom->meshlink_projection = NULL;
+  ref_geom->surrogate = NULL;
+  ref_geom->patch = NULL;
+  ref_geom->inverse_hit = 0;
+  ref_geom->inverse_refresh = 0;
+  ref_geom->inverse_miss = 0;
 
   return REF_SUCCESS;
 }
@@ -103,6 +170,10 @@ REF_STATUS ref_geom_free(REF_GEOM ref_geom) {
   if (NULL == (void *)ref_geom) return REF_NULL;
   ref_free(ref_geom->cad_data);
   RSS(ref_egads_close(ref_geom), "open egads");
+  ref_free(ref_geom->patch);
+  if (NULL != ref_geom->surrogate)
+    RSS(ref_surrogate_free((REF_SURROGATE)(ref_geom->surrogate)), "surrogate");
+  RSS(ref_geom_index_free(ref_geom), "index free");
   RSS(ref_adj_free(ref_geom->ref_adj), "adj free");
   ref_free(ref_geom->face_seg_per_rad);
   ref_free(ref_geom->face_min_length);
@@ -150,6 +221,23 @@ REF_STATUS ref_geom_deep_copy(REF_GEOM *ref_geom_ptr, REF_GEOM original) {
 
   RSS(ref_adj_deep_copy(&(ref_geom->ref_adj), original->ref_adj),
       "deep copy ref_adj for ref_geom");
+  ref_geom->index_nnode = original->index_nnode;
+  ref_geom->index_mask = (REF_INT *)NULL;
+  ref_geom->index_n = (REF_INT *)NULL;
+  ref_geom->index = (REF_INT *)NULL;
+  if (0 < ref_geom->index_nnode) {
+    ref_malloc(ref_geom->index_mask, ref_geom->index_nnode, REF_INT);
+    ref_malloc(ref_geom->index_n, ref_geom->index_nnode, REF_INT);
+    ref_malloc(ref_geom->index, REF_GEOM_INDEX_SIZE * ref_geom->index_nnode,
+               REF_INT);
+    for (geom = 0; geom < ref_geom->index_nnode; geom++) {
+      ref_geom->index_mask[geom] = original->index_mask[geom];
+      ref_geom->index_n[geom] = original->index_n[geom];
+      for (i = 0; i < MIN(REF_GEOM_INDEX_SIZE, original->index_n[geom]); i++)
+        ref_geom->index[i + REF_GEOM_INDEX_SIZE * geom] =
+            original->index[i + REF_GEOM_INDEX_SIZE * geom];
+    }
+  }
 
   ref_geom->nnode = REF_EMPTY;
   ref_geom->nedge = REF_EMPTY;
@@ -161,11 +249,23 @@ REF_STATUS ref_geom_deep_copy(REF_GEOM *ref_geom_ptr, REF_GEOM original) {
   ref_geom->edges = NULL;
   ref_geom->nodes = NULL;
 
-  ref_geom->cad_data_size = 0;
+  /* the byte stream is kept so the copy can load its own model */
+  ref_geom->cad_data_size = original->cad_data_size;
   ref_geom->cad_data = (REF_BYTE *)NULL;
+  if (0 < ref_geom_cad_data_size(ref_geom)) {
+    ref_malloc_size_t(ref_geom_cad_data(ref_geom),
+                      ref_geom_cad_data_size(ref_geom), REF_BYTE);
+    memcpy(ref_geom_cad_data(ref_geom), ref_geom_cad_data(original),
+           ref_geom_cad_data_size(ref_geom));
+  }
 
   ref_geom->meshlink = NULL;
   ref_geom->meshlink_projection = NULL;
+  ref_geom->surrogate = NULL;
+  ref_geom->patch = NULL;
+  ref_geom->inverse_hit = 0;
+  ref_geom->inverse_refresh = 0;
+  ref_geom->inverse_miss = 0;
 
   return REF_SUCCESS;
 }
@@ -182,6 +282,14 @@ REF_STATUS ref_geom_pack(REF_GEOM ref_geom, REF_INT *o2n) {
     compact++;
   }
   REIS(compact, ref_geom_n(ref_geom), "count mismatch");
+  /* release storage left behind by removals, keep slack for growth */
+  if (ref_geom_max(ref_geom) > 2 * ref_geom_n(ref_geom) + 10) {
+    ref_geom_max(ref_geom) =
+        ref_geom_n(ref_geom) + ref_geom_n(ref_geom) / 2 + 10;
+    ref_realloc(ref_geom->descr, REF_GEOM_DESCR_SIZE * ref_geom_max(ref_geom),
+                REF_INT);
+    ref_realloc(ref_geom->param, 2 * ref_geom_max(ref_geom), REF_DBL);
+  }
   if (ref_geom_n(ref_geom) < ref_geom_max(ref_geom)) {
     for (geom = ref_geom_n(ref_geom); geom < ref_geom_max(ref_geom); geom++) {
       ref_geom_type(ref_geom, geom) = REF_EMPTY;
@@ -194,10 +302,12 @@ REF_STATUS ref_geom_pack(REF_GEOM ref_geom, REF_INT *o2n) {
   }
   RSS(ref_adj_free(ref_geom->ref_adj), "free to prevent leak");
   RSS(ref_adj_create(&(ref_geom->ref_adj)), "create ref_adj for ref_geom");
+  RSS(ref_geom_index_free(ref_geom), "reset index");
 
   each_ref_geom(ref_geom, geom) {
     RSS(ref_adj_add(ref_geom->ref_adj, ref_geom_node(ref_geom, geom), geom),
         "register geom");
+    RSS(ref_geom_index_add(ref_geom, geom), "index geom");
   }
 
   return REF_SUCCESS;
@@ -481,6 +591,7 @@ REF_STATUS ref_geom_add(REF_GEOM ref_geom, REF_INT node, REF_INT type,
            ref_geom_node(ref_geom, geom), geom, ref_geom_type(ref_geom, geom),
            ref_geom_id(ref_geom, geom));
   });
+  RSS(ref_geom_index_add(ref_geom, geom), "index geom");
 
   ref_geom_n(ref_geom)++;
 
@@ -503,20 +614,20 @@ REF_STATUS ref_geom_remove_all(REF_GEOM ref_geom, REF_INT node) {
 
     item = ref_adj_first(ref_adj, node);
   }
+  if (0 <= node && node < ref_geom->index_nnode) {
+    ref_geom->index_mask[node] = 0;
+    ref_geom->index_n[node] = 0;
+  }
 
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_geom_is_a(REF_GEOM ref_geom, REF_INT node, REF_INT type,
                          REF_BOOL *it_is) {
-  REF_INT item, geom;
   *it_is = REF_FALSE;
-  each_ref_adj_node_item_with_ref(ref_geom_adj(ref_geom), node, item, geom) {
-    if (type == ref_geom_type(ref_geom, geom)) {
-      *it_is = REF_TRUE;
-      return REF_SUCCESS;
-    }
-  }
+  if (node < 0 || ref_geom->index_nnode <= node) return REF_SUCCESS;
+  if (type < 0 || 2 < type) return REF_SUCCESS;
+  *it_is = (0 != (ref_geom->index_mask[node] & (1 << type)));
   return REF_SUCCESS;
 }
 
@@ -524,6 +635,8 @@ REF_STATUS ref_geom_unique_id(REF_GEOM ref_geom, REF_INT node, REF_INT type,
                               REF_INT *id) {
   REF_INT item, geom;
   REF_BOOL found_one;
+  RSS(ref_geom_is_a(ref_geom, node, type, &found_one), "type mask");
+  if (!found_one) return REF_NOT_FOUND;
   found_one = REF_FALSE;
   each_ref_adj_node_item_with_ref(ref_geom_adj(ref_geom), node, item, geom) {
     if (type == ref_geom_type(ref_geom, geom)) {
@@ -538,8 +651,25 @@ REF_STATUS ref_geom_unique_id(REF_GEOM ref_geom, REF_INT node, REF_INT type,
 
 REF_STATUS ref_geom_find(REF_GEOM ref_geom, REF_INT node, REF_INT type,
                          REF_INT id, REF_INT *found) {
-  REF_INT item, geom;
+  REF_INT item, geom, i;
+  REF_INT *slot;
   *found = REF_EMPTY;
+  if (node < 0 || ref_geom->index_nnode <= node) return REF_NOT_FOUND;
+  if (type < 0 || 2 < type) return REF_NOT_FOUND;
+  if (0 == (ref_geom->index_mask[node] & (1 << type))) return REF_NOT_FOUND;
+  if (ref_geom->index_n[node] <= REF_GEOM_INDEX_SIZE) {
+    slot = &(ref_geom->index[REF_GEOM_INDEX_SIZE * node]);
+    for (i = 0; i < ref_geom->index_n[node]; i++) {
+      geom = slot[i];
+      if (ref_geom_type(ref_geom, geom) < type) continue;
+      if (ref_geom_type(ref_geom, geom) > type) break;
+      if (ref_geom_id(ref_geom, geom) < id) continue;
+      if (ref_geom_id(ref_geom, geom) > id) break;
+      *found = geom;
+      return REF_SUCCESS;
+    }
+    return REF_NOT_FOUND;
+  }
   each_ref_adj_node_item_with_ref(ref_geom_adj(ref_geom), node, item, geom) {
     if (type == ref_geom_type(ref_geom, geom) &&
         id == ref_geom_id(ref_geom, geom)) {
@@ -759,6 +889,231 @@ REF_STATUS ref_geom_cell_tuv(REF_GEOM ref_geom, REF_INT node, REF_INT *nodes,
   return REF_SUCCESS;
 }
 
+REF_STATUS ref_geom_patch_project(REF_INT type, REF_DBL *center, REF_DBL *eval,
+                                  REF_DBL *xyz, REF_DBL *param,
+                                  REF_BOOL *converged) {
+  REF_DBL d[2], dd[2], surf[3], tang[6], gap[3], grad[2], hess[4];
+  REF_DBL first, second, det, len2;
+  REF_DBL *sec;
+  REF_INT i, j, k, iter, second_index[4];
+
+  *converged = REF_FALSE;
+  RAS(REF_GEOM_EDGE == type || REF_GEOM_FACE == type, "edge or face");
+  /* uu uv vu vv into the packed x_uu x_uv x_vv */
+  second_index[0] = 0;
+  second_index[1] = 1;
+  second_index[2] = 1;
+  second_index[3] = 2;
+  sec = &(eval[3 + 3 * type]);
+
+  for (i = 0; i < type; i++) d[i] = param[i] - center[i];
+  for (iter = 0; iter < 20; iter++) {
+    for (k = 0; k < 3; k++) {
+      surf[k] = eval[k];
+      for (i = 0; i < type; i++) {
+        surf[k] += eval[3 + k + 3 * i] * d[i];
+        for (j = 0; j < type; j++)
+          surf[k] += 0.5 * sec[k + 3 * second_index[i + 2 * j]] * d[i] * d[j];
+      }
+      gap[k] = surf[k] - xyz[k];
+    }
+    for (i = 0; i < type; i++) {
+      for (k = 0; k < 3; k++) {
+        tang[k + 3 * i] = eval[3 + k + 3 * i];
+        for (j = 0; j < type; j++)
+          tang[k + 3 * i] += sec[k + 3 * second_index[i + 2 * j]] * d[j];
+      }
+      grad[i] = ref_math_dot(gap, &(tang[3 * i]));
+    }
+    for (i = 0; i < type; i++)
+      for (j = 0; j < type; j++)
+        hess[i + 2 * j] =
+            ref_math_dot(&(tang[3 * i]), &(tang[3 * j])) +
+            ref_math_dot(gap, &(sec[3 * second_index[i + 2 * j]]));
+    if (REF_GEOM_EDGE == type) {
+      if (!ref_math_divisible(grad[0], hess[0])) return REF_SUCCESS;
+      dd[0] = -grad[0] / hess[0];
+    } else {
+      det = hess[0] * hess[3] - hess[1] * hess[2];
+      if (!ref_math_divisible(1.0, det) || det <= 0.0 || hess[0] <= 0.0)
+        return REF_SUCCESS;
+      dd[0] = -(hess[3] * grad[0] - hess[2] * grad[1]) / det;
+      dd[1] = -(-hess[1] * grad[0] + hess[0] * grad[1]) / det;
+    }
+    len2 = 0.0;
+    for (i = 0; i < type; i++) {
+      d[i] += dd[i];
+      for (k = 0; k < 3; k++) len2 += pow(tang[k + 3 * i] * dd[i], 2);
+    }
+    if (len2 < 1.0e-24 * (1.0 + ref_math_dot(gap, gap))) break;
+  }
+  if (20 == iter) return REF_SUCCESS;
+
+  /* trust the expansion while curvature is a small part of the step */
+  first = 0.0;
+  second = 0.0;
+  for (k = 0; k < 3; k++) {
+    REF_DBL lin = 0.0, quad = 0.0;
+    for (i = 0; i < type; i++) {
+      lin += eval[3 + k + 3 * i] * d[i];
+      for (j = 0; j < type; j++)
+        quad += 0.5 * sec[k + 3 * second_index[i + 2 * j]] * d[i] * d[j];
+    }
+    first += lin * lin;
+    second += quad * quad;
+  }
+  if (second > 2.5e-3 * first) return REF_SUCCESS;
+
+  for (i = 0; i < type; i++) param[i] = center[i] + d[i];
+  *converged = REF_TRUE;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_geom_patch_trusted(REF_INT type, REF_DBL *center, REF_DBL *eval,
+                                  REF_DBL *param, REF_DBL *surface,
+                                  REF_DBL tolerance, REF_BOOL *trusted) {
+  REF_DBL d[2], patch, dist2;
+  REF_DBL *sec;
+  REF_INT i, j, k, second_index[4];
+
+  *trusted = REF_FALSE;
+  RAS(REF_GEOM_EDGE == type || REF_GEOM_FACE == type, "edge or face");
+  if (tolerance <= 0.0) return REF_SUCCESS;
+  second_index[0] = 0;
+  second_index[1] = 1;
+  second_index[2] = 1;
+  second_index[3] = 2;
+  sec = &(eval[3 + 3 * type]);
+
+  for (i = 0; i < type; i++) d[i] = param[i] - center[i];
+  dist2 = 0.0;
+  for (k = 0; k < 3; k++) {
+    patch = eval[k];
+    for (i = 0; i < type; i++) {
+      patch += eval[3 + k + 3 * i] * d[i];
+      for (j = 0; j < type; j++)
+        patch += 0.5 * sec[k + 3 * second_index[i + 2 * j]] * d[i] * d[j];
+    }
+    dist2 += pow(patch - surface[k], 2);
+  }
+  *trusted = (dist2 <= tolerance * tolerance);
+
+  return REF_SUCCESS;
+}
+
+/* the truncation error of the expansion is checked against the surface */
+static REF_STATUS ref_geom_patch_verify(REF_GEOM ref_geom, REF_INT type,
+                                        REF_INT id, REF_DBL *patch,
+                                        REF_DBL *param, REF_BOOL *trusted) {
+  REF_DBL surface[3], tolerance;
+
+  RSS(ref_egads_eval_at(ref_geom, type, id, param, surface, NULL), "eval");
+  RSS(ref_egads_tolerance(ref_geom, type, id, &tolerance), "tol");
+  RSS(ref_geom_patch_trusted(type, &(patch[1]), &(patch[3]), param, surface,
+                             tolerance, trusted),
+      "trusted");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_geom_inverse_eval(REF_GEOM ref_geom, REF_INT type, REF_INT id,
+                                 REF_DBL *xyz, REF_DBL *param) {
+  REF_INT slot, i;
+  REF_DBL *patch, trial[2];
+  REF_BOOL converged;
+
+  if (!ref_geom_model_loaded(ref_geom))
+    return ref_egads_inverse_eval(ref_geom, type, id, xyz, param);
+
+  slot = REF_EMPTY;
+  if (REF_GEOM_EDGE == type && 1 <= id && id <= ref_geom->nedge) slot = id - 1;
+  if (REF_GEOM_FACE == type && 1 <= id && id <= ref_geom->nface)
+    slot = ref_geom->nedge + id - 1;
+  if (REF_EMPTY == slot)
+    return ref_egads_inverse_eval(ref_geom, type, id, xyz, param);
+  if (NULL == ref_geom->patch)
+    ref_malloc_init(ref_geom->patch,
+                    REF_GEOM_PATCH_SIZE * (ref_geom->nedge + ref_geom->nface),
+                    REF_DBL, 0.0);
+  patch = &(ref_geom->patch[REF_GEOM_PATCH_SIZE * slot]);
+
+  if (patch[0] > 0.5) {
+    for (i = 0; i < type; i++) trial[i] = param[i];
+    RSS(ref_geom_patch_project(type, &(patch[1]), &(patch[3]), xyz, trial,
+                               &converged),
+        "cached patch");
+    if (converged)
+      RSS(ref_geom_patch_verify(ref_geom, type, id, patch, trial, &converged),
+          "verify cached");
+    if (converged) {
+      for (i = 0; i < type; i++) param[i] = trial[i];
+      (ref_geom->inverse_hit)++;
+      return REF_SUCCESS;
+    }
+  }
+
+  /* expand about the guess, neighbors of the last query are often close */
+  for (i = 0; i < type; i++) patch[1 + i] = param[i];
+  RSS(ref_egads_eval_at(ref_geom, type, id, &(patch[1]), &(patch[3]),
+                        &(patch[6])),
+      "expand patch");
+  patch[0] = 1.0;
+  for (i = 0; i < type; i++) trial[i] = param[i];
+  RSS(ref_geom_patch_project(type, &(patch[1]), &(patch[3]), xyz, trial,
+                             &converged),
+      "fresh patch");
+  if (converged)
+    RSS(ref_geom_patch_verify(ref_geom, type, id, patch, trial, &converged),
+        "verify fresh");
+  if (converged) {
+    for (i = 0; i < type; i++) param[i] = trial[i];
+    (ref_geom->inverse_refresh)++;
+    return REF_SUCCESS;
+  }
+
+  (ref_geom->inverse_miss)++;
+  return ref_egads_inverse_eval(ref_geom, type, id, xyz, param);
+}
+
+REF_STATUS ref_geom_inverse_eval_tattle(REF_GRID ref_grid) {
+  REF_GEOM ref_geom = ref_grid_geom(ref_grid);
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
+  REF_LONG local[3], total[3];
+
+  local[0] = ref_geom->inverse_hit;
+  local[1] = ref_geom->inverse_refresh;
+  local[2] = ref_geom->inverse_miss;
+  RSS(ref_mpi_sum(ref_mpi, local, total, 3, REF_LONG_TYPE), "sum");
+  if (ref_mpi_once(ref_mpi) && 0 < total[0] + total[1] + total[2])
+    printf("inverse eval %ld cached patch %ld new patch %ld kernel\n",
+           total[0], total[1], total[2]);
+
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_geom_eval(REF_GRID ref_grid, REF_INT geom,
+                                REF_DBL *xyz) {
+  REF_GEOM ref_geom = ref_grid_geom(ref_grid);
+  REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_INT i, type;
+  if (!ref_geom_surrogated(ref_geom)) {
+    RSS(ref_egads_eval(ref_geom, geom, xyz, NULL), "eval");
+    return REF_SUCCESS;
+  }
+  type = ref_geom_type(ref_geom, geom);
+  if (REF_GEOM_NODE == type) { /* topology nodes do not move */
+    for (i = 0; i < 3; i++)
+      xyz[i] = ref_node_xyz(ref_node, i, ref_geom_node(ref_geom, geom));
+    return REF_SUCCESS;
+  }
+  RSS(ref_surrogate_eval_at((REF_SURROGATE)(ref_geom->surrogate), type,
+                            ref_geom_id(ref_geom, geom),
+                            &(ref_geom_param(ref_geom, 0, geom)), xyz),
+      "surrogate eval");
+  return REF_SUCCESS;
+}
+
 static REF_STATUS ref_geom_eval_edge_face_uv(REF_GRID ref_grid,
                                              REF_INT edge_geom) {
   REF_CELL ref_cell = ref_grid_tri(ref_grid);
@@ -803,6 +1158,18 @@ static REF_STATUS ref_geom_eval_edge_face_uv(REF_GRID ref_grid,
         }
       }
     }
+  } else if (ref_geom_surrogated(ref_geom)) {
+    each_ref_adj_node_item_with_ref(ref_adj, node, geom_item, face_geom) {
+      if (REF_GEOM_FACE == ref_geom_type(ref_geom, face_geom)) {
+        faceid = ref_geom_id(ref_geom, face_geom);
+        RSS(ref_surrogate_inverse_eval(
+                (REF_SURROGATE)(ref_geom->surrogate), REF_GEOM_FACE, faceid,
+                ref_node_xyz_ptr(ref_grid_node(ref_grid), node), edgeuv),
+            "edge uv");
+        ref_geom_param(ref_geom, 0, face_geom) = edgeuv[0];
+        ref_geom_param(ref_geom, 1, face_geom) = edgeuv[1];
+      }
+    }
   } else {
     each_ref_adj_node_item_with_ref(ref_adj, node, geom_item, face_geom) {
       if (REF_GEOM_FACE == ref_geom_type(ref_geom, face_geom)) {
@@ -860,7 +1227,7 @@ REF_STATUS ref_geom_xyz_between(REF_GRID ref_grid, REF_INT node0, REF_INT node1,
         "cell uv");
     param[0] = 0.5 * (param0[0] + param1[0]);
     if (ref_geom_model_loaded(ref_geom)) {
-      RSB(ref_egads_inverse_eval(ref_geom, type, id, xyz, param),
+      RSB(ref_geom_inverse_eval(ref_geom, type, id, xyz, param),
           "inv eval edge", ref_geom_tec(ref_grid, "ref_geom_split_edge.tec"));
       /* enforce bounding box and use midpoint as full-back */
       if (param[0] < MIN(param0[0], param1[0]) ||
@@ -870,6 +1237,14 @@ REF_STATUS ref_geom_xyz_between(REF_GRID ref_grid, REF_INT node0, REF_INT node1,
       /* constrain xyz to geom, inverse_eval does not set */
       RSS(ref_egads_eval_at(ref_geom, type, id, param, xyz, NULL), "eval at");
     }
+    if (ref_geom_surrogated(ref_geom)) {
+      RSS(ref_surrogate_inverse_eval((REF_SURROGATE)(ref_geom->surrogate),
+                                     type, id, xyz, param),
+          "surrogate inv eval edge");
+      RSS(ref_surrogate_eval_at((REF_SURROGATE)(ref_geom->surrogate), type,
+                                id, param, xyz),
+          "surrogate eval at");
+    }
     return REF_SUCCESS;
   }
 
@@ -890,7 +1265,7 @@ REF_STATUS ref_geom_xyz_between(REF_GRID ref_grid, REF_INT node0, REF_INT node1,
   param[0] = 0.5 * (param0[0] + param1[0]);
   param[1] = 0.5 * (param0[1] + param1[1]);
   if (ref_geom_model_loaded(ref_geom)) {
-    RSB(ref_egads_inverse_eval(ref_geom, type, id, xyz, param), "inv eval face",
+    RSB(ref_geom_inverse_eval(ref_geom, type, id, xyz, param), "inv eval face",
         ref_geom_tec(ref_grid, "ref_geom_xyz_between_face.tec"));
     if (2 == ncell) { /* revisit in para */
       /* enforce bounding box of node0 and try midpoint */
@@ -906,6 +1281,15 @@ REF_STATUS ref_geom_xyz_between(REF_GRID ref_grid, REF_INT node0, REF_INT node1,
     RSS(ref_egads_eval_at(ref_geom, type, id, param, xyz, NULL), "eval at");
     return REF_SUCCESS;
   }
+  if (ref_geom_surrogated(ref_geom)) {
+    RSS(ref_surrogate_inverse_eval((REF_SURROGATE)(ref_geom->surrogate), type,
+                                   id, xyz, param),
+        "surrogate inv eval face");
+    RSS(ref_surrogate_eval_at((REF_SURROGATE)(ref_geom->surrogate), type, id,
+                              param, xyz),
+        "surrogate eval at");
+    return REF_SUCCESS;
+  }
 
   return REF_SUCCESS;
 }
@@ -952,8 +1336,8 @@ REF_STATUS ref_geom_add_between(REF_GRID ref_grid, REF_INT node0, REF_INT node1,
         "cell uv");
     param[0] = node0_weight * param0[0] + node1_weight * param1[0];
     if (ref_geom_model_loaded(ref_geom))
-      RSB(ref_egads_inverse_eval(ref_geom, type, id,
-                                 ref_node_xyz_ptr(ref_node, new_node), param),
+      RSB(ref_geom_inverse_eval(ref_geom, type, id,
+                                ref_node_xyz_ptr(ref_node, new_node), param),
           "inv eval edge", ref_geom_tec(ref_grid, "ref_geom_split_edge.tec"));
     /* enforce bounding box and use midpoint as full-back */
     if (param[0] < MIN(param0[0], param1[0]) ||
@@ -1035,8 +1419,8 @@ REF_STATUS ref_geom_add_between(REF_GRID ref_grid, REF_INT node0, REF_INT node1,
     param[0] = node0_weight * param0[0] + node1_weight * param1[0];
     param[1] = node0_weight * param0[1] + node1_weight * param1[1];
     if (ref_geom_model_loaded(ref_geom) && !has_edge_support) {
-      RSB(ref_egads_inverse_eval(ref_geom, type, id,
-                                 ref_node_xyz_ptr(ref_node, new_node), param),
+      RSB(ref_geom_inverse_eval(ref_geom, type, id,
+                                ref_node_xyz_ptr(ref_node, new_node), param),
           "inv eval face", ref_geom_tec(ref_grid, "ref_geom_split_face.tec"));
       /* enforce bounding box of node0 and try midpoint */
       RSS(ref_geom_tri_uv_bounding_box2(ref_grid, node0, node1, uv_min, uv_max),
@@ -1210,8 +1594,9 @@ REF_STATUS ref_geom_constrain(REF_GRID ref_grid, REF_INT node) {
   }
 
   if (have_geom_node) { /* update T of edges? update UV of (degen) faces? */
-    RSS(ref_egads_eval(ref_geom, node_geom, xyz, NULL), "eval edge");
+    RSS(ref_geom_eval(ref_grid, node_geom, xyz), "eval edge");
     node = ref_geom_node(ref_geom, node_geom);
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     ref_node_xyz(ref_node, 0, node) = xyz[0];
     ref_node_xyz(ref_node, 1, node) = xyz[1];
     ref_node_xyz(ref_node, 2, node) = xyz[2];
@@ -1230,8 +1615,9 @@ REF_STATUS ref_geom_constrain(REF_GRID ref_grid, REF_INT node) {
 
   /* edge geom, evaluate edge and update face uv */
   if (have_geom_edge) {
-    RSS(ref_egads_eval(ref_geom, edge_geom, xyz, NULL), "eval edge");
+    RSS(ref_geom_eval(ref_grid, edge_geom, xyz), "eval edge");
     node = ref_geom_node(ref_geom, edge_geom);
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     ref_node_xyz(ref_node, 0, node) = xyz[0];
     ref_node_xyz(ref_node, 1, node) = xyz[1];
     ref_node_xyz(ref_node, 2, node) = xyz[2];
@@ -1252,8 +1638,9 @@ REF_STATUS ref_geom_constrain(REF_GRID ref_grid, REF_INT node) {
 
   /* face geom, evaluate on face uv */
   if (have_geom_face) {
-    RSS(ref_egads_eval(ref_geom, face_geom, xyz, NULL), "eval face");
+    RSS(ref_geom_eval(ref_grid, face_geom, xyz), "eval face");
     node = ref_geom_node(ref_geom, face_geom);
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     ref_node_xyz(ref_node, 0, node) = xyz[0];
     ref_node_xyz(ref_node, 1, node) = xyz[1];
     ref_node_xyz(ref_node, 2, node) = xyz[2];
@@ -1393,6 +1780,20 @@ REF_STATUS ref_geom_tri_norm_deviation(REF_GRID ref_grid, REF_INT *nodes,
         "meshlink");
     return REF_SUCCESS;
   }
+  if (ref_geom_surrogated(ref_grid_geom(ref_grid))) {
+    id = nodes[ref_cell_node_per(ref_grid_tri(ref_grid))];
+    RSS(ref_node_tri_normal(ref_grid_node(ref_grid), nodes, tri_normal),
+        "tri normal");
+    status = ref_math_normalize(tri_normal);
+    if (REF_DIV_ZERO == status) return REF_SUCCESS;
+    RSS(status, "normalize");
+    RSS(ref_geom_tri_centroid(ref_grid, nodes, uv), "tri cent");
+    RSS(ref_surrogate_face_normal(
+            (REF_SURROGATE)(ref_grid_geom(ref_grid)->surrogate), id, uv, n),
+        "surrogate normal");
+    *dot_product = ref_math_dot(n, tri_normal);
+    return REF_SUCCESS;
+  }
 
   id = nodes[ref_cell_node_per(ref_grid_tri(ref_grid))];
   RSS(ref_node_tri_normal(ref_grid_node(ref_grid), nodes, tri_normal),
@@ -2160,6 +2561,7 @@ REF_STATUS ref_geom_edge_tec_zone(REF_GRID ref_grid, REF_INT id, FILE *file) {
       }
     }
   }
+  RSS(ref_dict_sort(ref_dict), "sort nodes");
   nnode = ref_dict_n(ref_dict);
   if (REF_EMPTY != jump_geom) nnode++;
 
@@ -2295,6 +2697,10 @@ REF_STATUS ref_geom_face_tec_zone(REF_GRID ref_grid, REF_INT id, FILE *file) {
     }
   }
 
+  RSS(ref_dict_sort(ref_dict), "sort nodes");
+  RSS(ref_dict_sort(ref_dict_jump), "sort jump");
+  RSS(ref_dict_sort(ref_dict_degen), "sort degen");
+
   nnode_sens0 = ref_dict_n(ref_dict);
   nnode_degen = ref_dict_n(ref_dict) + ref_dict_n(ref_dict_jump);
   nnode = ref_dict_n(ref_dict) + ref_dict_n(ref_dict_jump) +
@@ -2362,6 +2768,13 @@ REF_STATUS ref_geom_face_tec_zone(REF_GRID ref_grid, REF_INT id, FILE *file) {
     if (ref_geom_meshlinked(ref_geom)) {
       RSS(ref_meshlink_face_curvature(ref_grid, geom, &kr, r, &ks, s), "curve");
     }
+    if (ref_geom_surrogated(ref_geom)) {
+      RSS(ref_surrogate_face_curvature((REF_SURROGATE)(ref_geom->surrogate),
+                                       ref_geom_id(ref_geom, geom),
+                                       &(ref_geom_param(ref_geom, 0, geom)),
+                                       &kr, r, &ks, s),
+          "curve");
+    }
     kmax = MAX(ABS(kr), ABS(ks));
     kmin = MIN(ABS(kr), ABS(ks));
     fprintf(file, " %.16e %.16e %.16e %.16e %.16e %.16e %.16e\n", xyz[0],
@@ -2463,6 +2876,7 @@ REF_STATUS ref_geom_norm_tec_zone(REF_GRID ref_grid, REF_INT id, FILE *file) {
           "mark nodes");
     }
   }
+  RSS(ref_dict_sort(ref_dict), "sort nodes");
   nnode = ref_dict_n(ref_dict);
 
   ntri = 0;
@@ -2537,6 +2951,7 @@ static REF_STATUS ref_geom_curve_tec_zone(REF_GRID ref_grid, REF_INT id,
           "mark nodes");
     }
   }
+  RSS(ref_dict_sort(ref_dict), "sort nodes");
   nnode = ref_dict_n(ref_dict);
 
   ntri = 0;
@@ -2564,6 +2979,13 @@ static REF_STATUS ref_geom_curve_tec_zone(REF_GRID ref_grid, REF_INT id,
     if (ref_geom_meshlinked(ref_geom)) {
       RSS(ref_meshlink_face_curvature(ref_grid, geom, &kr, r, &ks, s), "curve");
     }
+    if (ref_geom_surrogated(ref_geom)) {
+      RSS(ref_surrogate_face_curvature((REF_SURROGATE)(ref_geom->surrogate),
+                                       ref_geom_id(ref_geom, geom),
+                                       &(ref_geom_param(ref_geom, 0, geom)),
+                                       &kr, r, &ks, s),
+          "curve");
+    }
     fprintf(file,
             " %.16e %.16e %.16e %.16e %.16e %.16e %.16e "
             "%.16e %.16e %.16e %.16e\n",
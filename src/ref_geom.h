@@ -38,6 +38,12 @@ typedef REF_GEOM_STRUCT *REF_GEOM;
 #define REF_GEOM_DESCR_DEGEN (4)
 #define REF_GEOM_DESCR_NODE (5)
 
+/* cached expansion: valid, center tuv[2], xyz[3], first[6], second[9] */
+#define REF_GEOM_PATCH_SIZE (21)
+
+/* per node geom sorted by type then id, longer lists fall back to ref_adj */
+#define REF_GEOM_INDEX_SIZE (6)
+
 END_C_DECLORATION
 
 #include "ref_adj.h"
@@ -59,6 +65,10 @@ struct REF_GEOM_STRUCT {
   REF_DBL tolerance_protection;
   REF_DBL gap_protection;
   REF_ADJ ref_adj;
+  REF_INT index_nnode;
+  REF_INT *index_mask; /* per node, bit (1 << type) set when present */
+  REF_INT *index_n;    /* per node, inline index valid when <= SIZE */
+  REF_INT *index;      /* REF_GEOM_INDEX_SIZE per node */
   REF_INT nnode, nedge, nface;
   REF_BOOL manifold;
   void *context;
@@ -70,6 +80,9 @@ struct REF_GEOM_STRUCT {
   REF_BYTE *cad_data;
   void *meshlink;
   void *meshlink_projection;
+  void *surrogate;
+  REF_DBL *patch; /* per edge then face id, see REF_GEOM_PATCH_SIZE */
+  REF_LONG inverse_hit, inverse_refresh, inverse_miss;
 };
 
 #define ref_geom_n(ref_geom) ((ref_geom)->n)
@@ -82,6 +95,10 @@ struct REF_GEOM_STRUCT {
 
 #define ref_geom_model_loaded(ref_geom) (NULL != (void *)((ref_geom)->solid))
 #define ref_geom_meshlinked(ref_geom) (NULL != (void *)((ref_geom)->meshlink))
+/* a discrete surrogate is only consulted without a CAD model */
+#define ref_geom_surrogated(ref_geom)                                    \
+  (!ref_geom_model_loaded(ref_geom) && !ref_geom_meshlinked(ref_geom) && \
+   NULL != (void *)((ref_geom)->surrogate))
 
 #define ref_geom_descr(ref_geom, attribute, geom) \
   ((ref_geom)->descr[(attribute) + REF_GEOM_DESCR_SIZE * (geom)])
@@ -207,6 +224,21 @@ REF_STATUS ref_geom_cell_tuv_supported(REF_GEOM ref_geom, REF_INT *nodes,
 REF_STATUS ref_geom_cell_tuv(REF_GEOM ref_geom, REF_INT node, REF_INT *nodes,
                              REF_INT type, REF_DBL *param, REF_INT *sens);
 
+/* closest point on the second order expansion at center from the guess in
+ * param, eval is xyz, first, and second derivatives as ref_egads_eval_at */
+REF_STATUS ref_geom_patch_project(REF_INT type, REF_DBL *center, REF_DBL *eval,
+                                  REF_DBL *xyz, REF_DBL *param,
+                                  REF_BOOL *converged);
+/* the expansion at param is within tolerance of the surface point there */
+REF_STATUS ref_geom_patch_trusted(REF_INT type, REF_DBL *center, REF_DBL *eval,
+                                  REF_DBL *param, REF_DBL *surface,
+                                  REF_DBL tolerance, REF_BOOL *trusted);
+/* inverse evaluation from the guess in param, tries the cached expansion
+ * of the edge or face first and calls the CAD kernel when it fails */
+REF_STATUS ref_geom_inverse_eval(REF_GEOM ref_geom, REF_INT type, REF_INT id,
+                                 REF_DBL *xyz, REF_DBL *param);
+REF_STATUS ref_geom_inverse_eval_tattle(REF_GRID ref_grid);
+
 REF_STATUS ref_geom_xyz_between(REF_GRID ref_grid, REF_INT node0, REF_INT node1,
                                 REF_DBL *xyz);
 REF_STATUS ref_geom_add_between(REF_GRID ref_grid, REF_INT node0, REF_INT node1,
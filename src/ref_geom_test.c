@@ -730,6 +730,85 @@ int main(int argc, char *argv[]) {
     RSS(ref_geom_free(ref_geom), "free");
   }
 
+  { /* find past the inline index on a crowded corner */
+    REF_GEOM ref_geom, copy;
+    REF_INT node, id, geom;
+    REF_DBL params[2];
+    REF_BOOL it_is;
+
+    RSS(ref_geom_create(&ref_geom), "create");
+
+    node = 3;
+    params[0] = 1.0;
+    params[1] = 2.0;
+    for (id = 9; id > 0; id--) {
+      RSS(ref_geom_add(ref_geom, node, REF_GEOM_FACE, id, params), "face");
+      RSS(ref_geom_add(ref_geom, node, REF_GEOM_EDGE, 10 + id, params), "e");
+    }
+    RSS(ref_geom_add(ref_geom, node, REF_GEOM_NODE, 4, NULL), "node");
+    REIS(19, ref_geom_n(ref_geom), "items");
+
+    RSS(ref_geom_find(ref_geom, node, REF_GEOM_FACE, 7, &geom), "find");
+    REIS(REF_GEOM_FACE, ref_geom_type(ref_geom, geom), "type");
+    REIS(7, ref_geom_id(ref_geom, geom), "id");
+    RSS(ref_geom_find(ref_geom, node, REF_GEOM_EDGE, 17, &geom), "find");
+    REIS(17, ref_geom_id(ref_geom, geom), "id");
+    REIS(REF_NOT_FOUND, ref_geom_find(ref_geom, node, REF_GEOM_EDGE, 7, &geom),
+         "no edge");
+    REIS(REF_NOT_FOUND,
+         ref_geom_find(ref_geom, node + 1, REF_GEOM_FACE, 7, &geom), "empty");
+    RSS(ref_geom_is_a(ref_geom, node, REF_GEOM_NODE, &it_is), "is a");
+    RAS(it_is, "expected node");
+
+    RSS(ref_geom_deep_copy(&copy, ref_geom), "deep copy");
+    RSS(ref_geom_find(copy, node, REF_GEOM_FACE, 2, &geom), "copy find");
+    REIS(2, ref_geom_id(copy, geom), "id");
+    RSS(ref_geom_free(copy), "free");
+
+    RSS(ref_geom_remove_all(ref_geom, node), "remove all");
+    REIS(0, ref_geom_n(ref_geom), "items");
+    REIS(REF_NOT_FOUND, ref_geom_find(ref_geom, node, REF_GEOM_FACE, 7, &geom),
+         "removed");
+    RSS(ref_geom_is_a(ref_geom, node, REF_GEOM_FACE, &it_is), "is a");
+    RAS(!it_is, "expected no face");
+
+    RSS(ref_geom_free(ref_geom), "free");
+  }
+
+  { /* pack releases storage and keeps lookups */
+    REF_GEOM ref_geom;
+    REF_INT node, geom, max, o2n[2000];
+    REF_DBL params[2];
+
+    RSS(ref_geom_create(&ref_geom), "create");
+    params[1] = 0.0;
+    for (node = 0; node < 2000; node++) {
+      params[0] = (REF_DBL)node;
+      RSS(ref_geom_add(ref_geom, node, REF_GEOM_EDGE, 1, params), "edge");
+    }
+    max = ref_geom_max(ref_geom);
+    for (node = 0; node < 2000; node++) {
+      o2n[node] = REF_EMPTY;
+      if (0 != node % 10) {
+        RSS(ref_geom_remove_all(ref_geom, node), "rm");
+      } else {
+        o2n[node] = node / 10;
+      }
+    }
+    RSS(ref_geom_pack(ref_geom, o2n), "pack");
+    REIS(200, ref_geom_n(ref_geom), "items");
+    RAS(ref_geom_max(ref_geom) < max, "expected smaller storage");
+    RSS(ref_geom_find(ref_geom, 37, REF_GEOM_EDGE, 1, &geom), "find");
+    RWDS(370.0, ref_geom_param(ref_geom, 0, geom), -1.0, "t");
+    REIS(REF_NOT_FOUND, ref_geom_find(ref_geom, 370, REF_GEOM_EDGE, 1, &geom),
+         "old node");
+    params[0] = 1.0;
+    RSS(ref_geom_add(ref_geom, 200, REF_GEOM_EDGE, 1, params), "add after");
+    REIS(201, ref_geom_n(ref_geom), "items");
+
+    RSS(ref_geom_free(ref_geom), "free");
+  }
+
   { /* determine unique id */
     REF_GEOM ref_geom;
     REF_INT node;
@@ -789,6 +868,99 @@ int main(int argc, char *argv[]) {
     RWDS(0.25, drsduv[3], tol, "dsdv");
   }
 
+  { /* patch project on an exactly quadratic paraboloid */
+    REF_DBL center[2] = {0.0, 0.0};
+    REF_DBL eval[18] = {0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0,
+                        0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+    REF_DBL xyz[3], uv[2], surf[3], gap[3];
+    REF_BOOL converged;
+    xyz[0] = 0.01;
+    xyz[1] = 0.02;
+    xyz[2] = 0.3;
+    uv[0] = 0.0;
+    uv[1] = 0.0;
+    RSS(ref_geom_patch_project(REF_GEOM_FACE, center, eval, xyz, uv,
+                               &converged),
+        "proj");
+    RAS(converged, "near center");
+    surf[0] = uv[0];
+    surf[1] = uv[1];
+    surf[2] = 0.5 * (uv[0] * uv[0] + uv[1] * uv[1]);
+    gap[0] = surf[0] - xyz[0];
+    gap[1] = surf[1] - xyz[1];
+    gap[2] = surf[2] - xyz[2];
+    /* gap is orthogonal to x_u = (1,0,u) and x_v = (0,1,v) */
+    RWDS(0.0, gap[0] + gap[2] * uv[0], 1.0e-12, "x_u");
+    RWDS(0.0, gap[1] + gap[2] * uv[1], 1.0e-12, "x_v");
+
+    xyz[0] = 5.0;
+    xyz[1] = 0.0;
+    xyz[2] = 0.0;
+    uv[0] = 0.0;
+    uv[1] = 0.0;
+    RSS(ref_geom_patch_project(REF_GEOM_FACE, center, eval, xyz, uv,
+                               &converged),
+        "proj");
+    RAS(!converged, "outside trust of expansion");
+    RWDS(0.0, uv[0], -1.0, "param untouched");
+  }
+
+  { /* patch trusted, cache hit on the paraboloid and fallback off it */
+    REF_DBL center[2] = {0.0, 0.0};
+    REF_DBL eval[18] = {0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0,
+                        0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+    REF_DBL uv[2] = {0.1, 0.2};
+    REF_DBL surface[3];
+    REF_BOOL trusted;
+    surface[0] = uv[0];
+    surface[1] = uv[1];
+    surface[2] = 0.5 * (uv[0] * uv[0] + uv[1] * uv[1]);
+    RSS(ref_geom_patch_trusted(REF_GEOM_FACE, center, eval, uv, surface,
+                               1.0e-10, &trusted),
+        "trusted");
+    RAS(trusted, "quadratic surface is exact");
+    RSS(ref_geom_patch_trusted(REF_GEOM_FACE, center, eval, uv, surface, -1.0,
+                               &trusted),
+        "trusted");
+    RAS(!trusted, "unknown tolerance");
+    /* quartic term the expansion misses */
+    surface[2] += pow(uv[0], 4);
+    RSS(ref_geom_patch_trusted(REF_GEOM_FACE, center, eval, uv, surface,
+                               1.0e-5, &trusted),
+        "trusted");
+    RAS(!trusted, "truncation error exceeds tolerance");
+  }
+
+  { /* patch trusted on a parabola edge */
+    REF_DBL center[1] = {1.0};
+    REF_DBL eval[9] = {1.0, 1.0, 0.0, 1.0, 2.0, 0.0, 0.0, 2.0, 0.0};
+    REF_DBL t = 1.5;
+    REF_DBL surface[3] = {1.5, 2.25, 0.0};
+    REF_BOOL trusted;
+    RSS(ref_geom_patch_trusted(REF_GEOM_EDGE, center, eval, &t, surface,
+                               1.0e-12, &trusted),
+        "trusted");
+    RAS(trusted, "y = x^2 is exact");
+    surface[1] += 1.0e-3;
+    RSS(ref_geom_patch_trusted(REF_GEOM_EDGE, center, eval, &t, surface,
+                               1.0e-4, &trusted),
+        "trusted");
+    RAS(!trusted, "moved surface");
+  }
+
+  { /* patch project on a line */
+    REF_DBL center[1] = {1.0};
+    REF_DBL eval[9] = {1.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    REF_DBL xyz[3] = {1.6, 1.0, 2.0};
+    REF_DBL t = 1.0;
+    REF_BOOL converged;
+    RSS(ref_geom_patch_project(REF_GEOM_EDGE, center, eval, xyz, &t,
+                               &converged),
+        "proj");
+    RAS(converged, "straight");
+    RWDS(1.3, t, 1.0e-12, "t");
+  }
+
   { /* egads lite data is zero size and null */
     REF_GEOM ref_geom;
     RSS(ref_geom_create(&ref_geom), "create");
@@ -53,6 +53,11 @@ REF_STATUS ref_grid_create(REF_GRID *ref_grid_ptr, REF_MPI ref_mpi) {
   RSS(ref_adapt_create(&(ref_grid->adapt)), "adapt create");
   ref_grid_interp(ref_grid) = NULL;
 
+  RSS(ref_arena_create(&ref_grid_arena(ref_grid)), "arena create");
+  ref_node_arena(ref_grid_node(ref_grid)) = ref_grid_arena(ref_grid);
+  ref_grid_perf(ref_grid) = NULL;
+  ref_grid_counts(ref_grid) = NULL;
+
   ref_grid_partitioner(ref_grid) = REF_MIGRATE_RECOMMENDED;
   ref_grid_partitioner_seed(ref_grid) = 0;
 
@@ -103,6 +108,11 @@ REF_STATUS ref_grid_deep_copy(REF_GRID *ref_grid_ptr, REF_GRID original) {
 
   ref_grid_interp(ref_grid) = NULL;
 
+  RSS(ref_arena_create(&ref_grid_arena(ref_grid)), "arena create");
+  ref_node_arena(ref_grid_node(ref_grid)) = ref_grid_arena(ref_grid);
+  ref_grid_perf(ref_grid) = NULL;
+  ref_grid_counts(ref_grid) = NULL;
+
   ref_grid_partitioner(ref_grid) = ref_grid_partitioner(original);
   ref_grid_partitioner_seed(ref_grid) = 0;
 
@@ -157,6 +167,9 @@ REF_STATUS ref_grid_free(REF_GRID ref_grid) {
     RSS(ref_interp_free(ref_grid->interp), "interp free");
   }
 
+  if (NULL != (void *)ref_grid_counts(ref_grid))
+    RSS(ref_perf_free(ref_grid_counts(ref_grid)), "counts free");
+  RSS(ref_arena_free(ref_grid_arena(ref_grid)), "arena free");
   RSS(ref_adapt_free(ref_grid->adapt), "adapt free");
   RSS(ref_gather_free(ref_grid_gather(ref_grid)), "gather free");
   RSS(ref_geom_free(ref_grid_geom(ref_grid)), "geom free");
@@ -27,6 +27,7 @@ typedef REF_GRID_STRUCT *REF_GRID;
 END_C_DECLORATION
 
 #include "ref_adapt.h"
+#include "ref_arena.h"
 #include "ref_cell.h"
 #include "ref_gather.h"
 #include "ref_geom.h"
@@ -34,6 +35,7 @@ END_C_DECLORATION
 #include "ref_migrate.h"
 #include "ref_mpi.h"
 #include "ref_node.h"
+#include "ref_perf.h"
 
 BEGIN_C_DECLORATION
 
@@ -49,6 +51,11 @@ struct REF_GRID_STRUCT {
 
   REF_INTERP interp;
 
+  REF_ARENA arena;
+
+  REF_PERF perf;   /* NULL unless recording, not owned */
+  REF_PERF counts; /* instrument counts without a report, owned */
+
   REF_MIGRATE_PARTIONER partitioner;
   REF_INT partitioner_seed;
 
@@ -85,6 +92,9 @@ REF_STATUS ref_grid_pack(REF_GRID ref_grid);
 #define ref_grid_gather(ref_grid) ((ref_grid)->gather)
 #define ref_grid_adapt(ref_grid, param) (((ref_grid)->adapt)->param)
 #define ref_grid_interp(ref_grid) ((ref_grid)->interp)
+#define ref_grid_arena(ref_grid) ((ref_grid)->arena)
+#define ref_grid_perf(ref_grid) ((ref_grid)->perf)
+#define ref_grid_counts(ref_grid) ((ref_grid)->counts)
 #define ref_grid_background(ref_grid)  \
   ((NULL == ref_grid_interp(ref_grid)) \
        ? NULL                          \
@@ -0,0 +1,237 @@
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "ref_hash.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ref_malloc.h"
+
+#define REF_HASH_INITIAL_MAX (16)
+
+/* keep at most half of the slots used */
+#define ref_hash_full(n, max) (2 * (n) > (max))
+
+static REF_INT ref_hash_home(REF_GLOB key, REF_INT max) {
+  REF_ULONG mix = (REF_ULONG)key;
+  /* 64 bit finalizer from MurmurHash3 */
+  mix ^= mix >> 33;
+  mix *= 0xff51afd7ed558ccdUL;
+  mix ^= mix >> 33;
+  mix *= 0xc4ceb9fe1a85ec53UL;
+  mix ^= mix >> 33;
+  return (REF_INT)(mix & (REF_ULONG)(max - 1));
+}
+
+static REF_INT ref_hash_slot(REF_INT max, REF_GLOB *keys, REF_BOOL *used,
+                             REF_GLOB key) {
+  REF_INT slot;
+  slot = ref_hash_home(key, max);
+  while (used[slot] && key != keys[slot]) slot = (slot + 1) & (max - 1);
+  return slot;
+}
+
+static void ref_hash_vacate(REF_INT max, REF_GLOB *keys, REF_INT *values,
+                            REF_BOOL *used, REF_INT slot) {
+  REF_INT hole, next, home;
+  REF_BOOL move;
+
+  hole = slot;
+  used[hole] = REF_FALSE;
+  next = hole;
+  while (REF_TRUE) {
+    next = (next + 1) & (max - 1);
+    if (!used[next]) break;
+    home = ref_hash_home(keys[next], max);
+    /* move back unless home lies cyclically in (hole, next] */
+    if (hole < next) {
+      move = (home <= hole || home > next);
+    } else {
+      move = (home <= hole && home > next);
+    }
+    if (move) {
+      keys[hole] = keys[next];
+      values[hole] = values[next];
+      used[hole] = REF_TRUE;
+      used[next] = REF_FALSE;
+      hole = next;
+    }
+  }
+}
+
+static REF_STATUS ref_hash_resize(REF_INT *max, REF_GLOB **keys,
+                                  REF_INT **values, REF_BOOL **used,
+                                  REF_INT new_max) {
+  REF_GLOB *new_keys;
+  REF_INT *new_values;
+  REF_BOOL *new_used;
+  REF_INT i, slot;
+
+  ref_malloc(new_keys, new_max, REF_GLOB);
+  ref_malloc(new_values, new_max, REF_INT);
+  ref_malloc_init(new_used, new_max, REF_BOOL, REF_FALSE);
+
+  for (i = 0; i < (*max); i++) {
+    if (!(*used)[i]) continue;
+    slot = ref_hash_slot(new_max, new_keys, new_used, (*keys)[i]);
+    new_keys[slot] = (*keys)[i];
+    new_values[slot] = (*values)[i];
+    new_used[slot] = REF_TRUE;
+  }
+
+  ref_free(*keys);
+  *keys = new_keys;
+  ref_free(*values);
+  *values = new_values;
+  ref_free(*used);
+  *used = new_used;
+  *max = new_max;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_hash_create(REF_HASH *ref_hash_ptr) {
+  REF_HASH ref_hash;
+
+  ref_malloc(*ref_hash_ptr, 1, REF_HASH_STRUCT);
+  ref_hash = (*ref_hash_ptr);
+
+  ref_hash_n(ref_hash) = 0;
+  ref_hash_max(ref_hash) = REF_HASH_INITIAL_MAX;
+
+  ref_malloc(ref_hash->key, ref_hash_max(ref_hash), REF_GLOB);
+  ref_malloc(ref_hash->value, ref_hash_max(ref_hash), REF_INT);
+  ref_malloc_init(ref_hash->used, ref_hash_max(ref_hash), REF_BOOL,
+                  REF_FALSE);
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_hash_free(REF_HASH ref_hash) {
+  if (NULL == (void *)ref_hash) return REF_NULL;
+  ref_free(ref_hash->used);
+  ref_free(ref_hash->value);
+  ref_free(ref_hash->key);
+  ref_free(ref_hash);
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_hash_deep_copy(REF_HASH *ref_hash_ptr, REF_HASH original) {
+  REF_HASH ref_hash;
+  REF_INT i;
+
+  ref_malloc(*ref_hash_ptr, 1, REF_HASH_STRUCT);
+  ref_hash = (*ref_hash_ptr);
+
+  ref_hash_n(ref_hash) = ref_hash_n(original);
+  ref_hash_max(ref_hash) = ref_hash_max(original);
+
+  ref_malloc(ref_hash->key, ref_hash_max(ref_hash), REF_GLOB);
+  ref_malloc(ref_hash->value, ref_hash_max(ref_hash), REF_INT);
+  ref_malloc(ref_hash->used, ref_hash_max(ref_hash), REF_BOOL);
+  for (i = 0; i < ref_hash_max(ref_hash); i++) {
+    ref_hash->key[i] = original->key[i];
+    ref_hash->value[i] = original->value[i];
+    ref_hash->used[i] = original->used[i];
+  }
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_hash_reserve(REF_HASH ref_hash, REF_INT n) {
+  REF_INT new_max;
+
+  new_max = ref_hash_max(ref_hash);
+  while (ref_hash_full(n, new_max)) new_max *= 2;
+  if (new_max == ref_hash_max(ref_hash)) return REF_SUCCESS;
+
+  RSS(ref_hash_resize(&ref_hash_max(ref_hash), &(ref_hash->key),
+                      &(ref_hash->value), &(ref_hash->used), new_max),
+      "resize");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_hash_clear(REF_HASH ref_hash) {
+  REF_INT i;
+
+  ref_hash_n(ref_hash) = 0;
+  for (i = 0; i < ref_hash_max(ref_hash); i++) ref_hash->used[i] = REF_FALSE;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_hash_store(REF_HASH ref_hash, REF_GLOB key, REF_INT value) {
+  REF_INT slot;
+
+  slot = ref_hash_slot(ref_hash_max(ref_hash), ref_hash->key, ref_hash->used,
+                       key);
+  if (ref_hash->used[slot]) {
+    ref_hash->value[slot] = value;
+    return REF_SUCCESS;
+  }
+
+  if (ref_hash_full(ref_hash_n(ref_hash) + 1, ref_hash_max(ref_hash))) {
+    RSS(ref_hash_reserve(ref_hash, ref_hash_n(ref_hash) + 1), "grow");
+    slot = ref_hash_slot(ref_hash_max(ref_hash), ref_hash->key,
+                         ref_hash->used, key);
+  }
+
+  ref_hash->key[slot] = key;
+  ref_hash->value[slot] = value;
+  ref_hash->used[slot] = REF_TRUE;
+  ref_hash_n(ref_hash)++;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_hash_value(REF_HASH ref_hash, REF_GLOB key, REF_INT *value) {
+  REF_INT slot;
+
+  slot = ref_hash_slot(ref_hash_max(ref_hash), ref_hash->key, ref_hash->used,
+                       key);
+  if (!ref_hash->used[slot]) return REF_NOT_FOUND;
+
+  *value = ref_hash->value[slot];
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_hash_remove(REF_HASH ref_hash, REF_GLOB key) {
+  REF_INT slot;
+
+  slot = ref_hash_slot(ref_hash_max(ref_hash), ref_hash->key, ref_hash->used,
+                       key);
+  if (!ref_hash->used[slot]) return REF_NOT_FOUND;
+
+  ref_hash_vacate(ref_hash_max(ref_hash), ref_hash->key, ref_hash->value,
+                  ref_hash->used, slot);
+  ref_hash_n(ref_hash)--;
+
+  return REF_SUCCESS;
+}
+
+REF_BOOL ref_hash_has_key(REF_HASH ref_hash, REF_GLOB key) {
+  REF_INT slot;
+
+  slot = ref_hash_slot(ref_hash_max(ref_hash), ref_hash->key, ref_hash->used,
+                       key);
+
+  return ref_hash->used[slot];
+}
@@ -0,0 +1,59 @@
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef REF_HASH_H
+#define REF_HASH_H
+
+#include "ref_defs.h"
+
+BEGIN_C_DECLORATION
+typedef struct REF_HASH_STRUCT REF_HASH_STRUCT;
+typedef REF_HASH_STRUCT *REF_HASH;
+END_C_DECLORATION
+
+BEGIN_C_DECLORATION
+
+/* open addressing with linear probing, max slots is a power of two,
+ * and removal shifts the probe chain back (no tombstones).
+ * REF_INT keys promote to REF_GLOB, so one table serves both. */
+
+struct REF_HASH_STRUCT {
+  REF_INT n, max;
+  REF_GLOB *key;
+  REF_INT *value;
+  REF_BOOL *used;
+};
+
+REF_STATUS ref_hash_create(REF_HASH *ref_hash);
+REF_STATUS ref_hash_free(REF_HASH ref_hash);
+REF_STATUS ref_hash_deep_copy(REF_HASH *ref_hash, REF_HASH original);
+
+#define ref_hash_n(ref_hash) ((ref_hash)->n)
+#define ref_hash_max(ref_hash) ((ref_hash)->max)
+
+REF_STATUS ref_hash_reserve(REF_HASH ref_hash, REF_INT n);
+REF_STATUS ref_hash_clear(REF_HASH ref_hash);
+
+REF_STATUS ref_hash_store(REF_HASH ref_hash, REF_GLOB key, REF_INT value);
+REF_STATUS ref_hash_value(REF_HASH ref_hash, REF_GLOB key, REF_INT *value);
+REF_STATUS ref_hash_remove(REF_HASH ref_hash, REF_GLOB key);
+REF_BOOL ref_hash_has_key(REF_HASH ref_hash, REF_GLOB key);
+
+END_C_DECLORATION
+
+#endif /* REF_HASH_H */
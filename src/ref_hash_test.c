@@ -0,0 +1,124 @@
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "ref_hash.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(void) {
+  REF_HASH ref_hash;
+
+  {
+    REIS(REF_NULL, ref_hash_free(NULL), "dont free NULL");
+    RSS(ref_hash_create(&ref_hash), "create");
+    REIS(0, ref_hash_n(ref_hash), "init zero");
+    RSS(ref_hash_free(ref_hash), "free");
+  }
+
+  { /* store, update, retrieve, missing */
+    REF_INT value;
+    RSS(ref_hash_create(&ref_hash), "create");
+    RSS(ref_hash_store(ref_hash, 2, 5), "store");
+    RSS(ref_hash_store(ref_hash, -7, 3), "store");
+    RSS(ref_hash_store(ref_hash, 2, 9), "store");
+    REIS(2, ref_hash_n(ref_hash), "two keys");
+    RSS(ref_hash_value(ref_hash, 2, &value), "retrieve");
+    REIS(9, value, "latest value");
+    RSS(ref_hash_value(ref_hash, -7, &value), "retrieve");
+    REIS(3, value, "negative key");
+    value = 11;
+    REIS(REF_NOT_FOUND, ref_hash_value(ref_hash, 4, &value), "missing");
+    REIS(11, value, "untouched");
+    REIS(REF_TRUE, ref_hash_has_key(ref_hash, 2), "has");
+    REIS(REF_FALSE, ref_hash_has_key(ref_hash, 4), "has not");
+    RSS(ref_hash_free(ref_hash), "free");
+  }
+
+  { /* glob key beyond int range */
+    REF_GLOB big;
+    REF_INT value;
+    big = (REF_GLOB)REF_INT_MAX;
+    big = big * 3;
+    RSS(ref_hash_create(&ref_hash), "create");
+    RSS(ref_hash_store(ref_hash, big, 1), "store");
+    RSS(ref_hash_store(ref_hash, big + 1, 2), "store");
+    RSS(ref_hash_value(ref_hash, big, &value), "retrieve");
+    REIS(1, value, "big");
+    RSS(ref_hash_value(ref_hash, big + 1, &value), "retrieve");
+    REIS(2, value, "big+1");
+    RSS(ref_hash_free(ref_hash), "free");
+  }
+
+  { /* grow, remove every other, keep the rest reachable */
+    REF_INT key, value, n = 5000;
+    RSS(ref_hash_create(&ref_hash), "create");
+    for (key = 0; key < n; key++) {
+      RSS(ref_hash_store(ref_hash, 16 * key, key), "store");
+    }
+    REIS(n, ref_hash_n(ref_hash), "all stored");
+    RAS(2 * ref_hash_n(ref_hash) <= ref_hash_max(ref_hash), "load");
+    for (key = 0; key < n; key += 2) {
+      RSS(ref_hash_remove(ref_hash, 16 * key), "remove");
+    }
+    REIS(REF_NOT_FOUND, ref_hash_remove(ref_hash, 0), "removed twice");
+    REIS(n / 2, ref_hash_n(ref_hash), "half left");
+    for (key = 0; key < n; key++) {
+      if (0 == key % 2) {
+        REIS(REF_FALSE, ref_hash_has_key(ref_hash, 16 * key), "removed");
+      } else {
+        RSS(ref_hash_value(ref_hash, 16 * key, &value), "retrieve");
+        REIS(key, value, "kept");
+      }
+    }
+    RSS(ref_hash_free(ref_hash), "free");
+  }
+
+  { /* reserve and clear keep storage */
+    REF_INT key, max;
+    RSS(ref_hash_create(&ref_hash), "create");
+    RSS(ref_hash_reserve(ref_hash, 1000), "reserve");
+    max = ref_hash_max(ref_hash);
+    RAS(2000 <= max, "reserved");
+    for (key = 0; key < 1000; key++) {
+      RSS(ref_hash_store(ref_hash, key, key), "store");
+    }
+    REIS(max, ref_hash_max(ref_hash), "no regrow");
+    RSS(ref_hash_clear(ref_hash), "clear");
+    REIS(0, ref_hash_n(ref_hash), "empty");
+    REIS(max, ref_hash_max(ref_hash), "kept storage");
+    REIS(REF_FALSE, ref_hash_has_key(ref_hash, 10), "cleared");
+    RSS(ref_hash_free(ref_hash), "free");
+  }
+
+  { /* deep copy */
+    REF_HASH deep_copy;
+    REF_INT value;
+    RSS(ref_hash_create(&ref_hash), "create");
+    RSS(ref_hash_store(ref_hash, 2, 5), "store");
+    RSS(ref_hash_deep_copy(&deep_copy, ref_hash), "copy");
+    RSS(ref_hash_free(ref_hash), "free");
+    RSS(ref_hash_value(deep_copy, 2, &value), "retrieve");
+    REIS(5, value, "copied");
+    RSS(ref_hash_free(deep_copy), "free");
+  }
+
+  return 0;
+}
@@ -374,46 +374,58 @@ REF_STATUS ref_histogram_print_stat(REF_HISTOGRAM ref_histogram) {
 
 REF_STATUS ref_histogram_add_ratio(REF_HISTOGRAM ref_histogram,
                                    REF_GRID ref_grid) {
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
   REF_EDGE ref_edge;
   REF_INT edge, part;
-  REF_DBL ratio;
+  REF_DBL *ratio;
+  REF_STATUS status;
 
   RSS(ref_edge_create(&ref_edge, ref_grid), "make edges");
 
+  /* negative ratio marks edges of other parts */
+  ref_malloc(ratio, ref_edge_n(ref_edge), REF_DBL);
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi)) \
+    schedule(static) private(part) reduction(max : status)
+#endif
   for (edge = 0; edge < ref_edge_n(ref_edge); edge++) {
-    RSS(ref_edge_part(ref_edge, edge, &part), "edge part");
-    if (part == ref_mpi_rank(ref_grid_mpi(ref_grid))) {
-      RSS(ref_node_ratio(ref_grid_node(ref_grid),
-                         ref_edge_e2n(ref_edge, 0, edge),
-                         ref_edge_e2n(ref_edge, 1, edge), &ratio),
-          "rat");
-      RSB(ref_histogram_add(ref_histogram, ratio), "add", {
-        printf("ratio %e at %f %f %f\n", ratio,
-               ref_node_xyz(ref_grid_node(ref_grid), 0,
-                            ref_edge_e2n(ref_edge, 0, edge)),
-               ref_node_xyz(ref_grid_node(ref_grid), 1,
-                            ref_edge_e2n(ref_edge, 0, edge)),
-               ref_node_xyz(ref_grid_node(ref_grid), 2,
-                            ref_edge_e2n(ref_edge, 0, edge)));
-      });
+    ratio[edge] = -1.0;
+    if (REF_SUCCESS != ref_edge_part(ref_edge, edge, &part)) {
+      status = REF_FAILURE;
+      continue;
     }
+    if (part != ref_mpi_rank(ref_mpi)) continue;
+    if (REF_SUCCESS != ref_node_ratio(ref_grid_node(ref_grid),
+                                      ref_edge_e2n(ref_edge, 0, edge),
+                                      ref_edge_e2n(ref_edge, 1, edge),
+                                      &(ratio[edge])))
+      status = REF_FAILURE;
   }
+  RSS(status, "rat");
 
-  RSS(ref_histogram_gather(ref_histogram, ref_grid_mpi(ref_grid)), "gather");
+  for (edge = 0; edge < ref_edge_n(ref_edge); edge++) {
+    if (ratio[edge] < 0.0) continue;
+    RSB(ref_histogram_add(ref_histogram, ratio[edge]), "add", {
+      printf("ratio %e at %f %f %f\n", ratio[edge],
+             ref_node_xyz(ref_grid_node(ref_grid), 0,
+                          ref_edge_e2n(ref_edge, 0, edge)),
+             ref_node_xyz(ref_grid_node(ref_grid), 1,
+                          ref_edge_e2n(ref_edge, 0, edge)),
+             ref_node_xyz(ref_grid_node(ref_grid), 2,
+                          ref_edge_e2n(ref_edge, 0, edge)));
+    });
+  }
+
+  RSS(ref_histogram_gather(ref_histogram, ref_mpi), "gather");
 
   for (edge = 0; edge < ref_edge_n(ref_edge); edge++) {
-    RSS(ref_edge_part(ref_edge, edge, &part), "edge part");
-    if (part == ref_mpi_rank(ref_grid_mpi(ref_grid))) {
-      RSS(ref_node_ratio(ref_grid_node(ref_grid),
-                         ref_edge_e2n(ref_edge, 0, edge),
-                         ref_edge_e2n(ref_edge, 1, edge), &ratio),
-          "rat");
-      RSS(ref_histogram_add_stat(ref_histogram, ratio), "add");
-    }
+    if (ratio[edge] < 0.0) continue;
+    RSS(ref_histogram_add_stat(ref_histogram, ratio[edge]), "add");
   }
-  RSS(ref_histogram_gather_stat(ref_histogram, ref_grid_mpi(ref_grid)),
-      "gather");
+  RSS(ref_histogram_gather_stat(ref_histogram, ref_mpi), "gather");
 
+  ref_free(ratio);
   RSS(ref_edge_free(ref_edge), "free edge");
 
   return REF_SUCCESS;
@@ -421,31 +433,52 @@ REF_STATUS ref_histogram_add_ratio(REF_HISTOGRAM ref_histogram,
 
 REF_STATUS ref_histogram_add_quality(REF_HISTOGRAM ref_histogram,
                                      REF_GRID ref_grid) {
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
+  REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_CELL ref_cell;
   REF_INT cell;
   REF_INT nodes[REF_CELL_MAX_SIZE_PER];
-  REF_DBL quality;
+  REF_DBL *quality;
+  REF_BOOL twod;
+  REF_STATUS status;
 
-  if (ref_grid_twod(ref_grid) || ref_grid_surf(ref_grid)) {
+  twod = (ref_grid_twod(ref_grid) || ref_grid_surf(ref_grid));
+  if (twod) {
     ref_cell = ref_grid_tri(ref_grid);
   } else {
     ref_cell = ref_grid_tet(ref_grid);
   }
-  each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
-    if (ref_node_part(ref_grid_node(ref_grid), nodes[0]) ==
-        ref_mpi_rank(ref_grid_mpi(ref_grid))) {
-      if (ref_grid_twod(ref_grid) || ref_grid_surf(ref_grid)) {
-        RSS(ref_node_tri_quality(ref_grid_node(ref_grid), nodes, &quality),
-            "qual");
-      } else {
-        RSS(ref_node_tet_quality(ref_grid_node(ref_grid), nodes, &quality),
-            "qual");
-      }
-      if (quality > 0.0) RSS(ref_histogram_add(ref_histogram, quality), "add");
+
+  /* only positive quality of local cells is added, zero skips the cell */
+  ref_malloc(quality, ref_cell_max(ref_cell), REF_DBL);
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi)) \
+    schedule(static) private(nodes) reduction(max : status)
+#endif
+  for (cell = 0; cell < ref_cell_max(ref_cell); cell++) {
+    quality[cell] = 0.0;
+    if (REF_SUCCESS != ref_cell_nodes(ref_cell, cell, nodes)) continue;
+    if (ref_node_part(ref_node, nodes[0]) != ref_mpi_rank(ref_mpi)) continue;
+    if (twod) {
+      if (REF_SUCCESS !=
+          ref_node_tri_quality(ref_node, nodes, &(quality[cell])))
+        status = REF_FAILURE;
+    } else {
+      if (REF_SUCCESS !=
+          ref_node_tet_quality(ref_node, nodes, &(quality[cell])))
+        status = REF_FAILURE;
     }
   }
+  RSS(status, "qual");
 
-  RSS(ref_histogram_gather(ref_histogram, ref_grid_mpi(ref_grid)), "gather");
+  for (cell = 0; cell < ref_cell_max(ref_cell); cell++) {
+    if (quality[cell] > 0.0)
+      RSS(ref_histogram_add(ref_histogram, quality[cell]), "add");
+  }
+  ref_free(quality);
+
+  RSS(ref_histogram_gather(ref_histogram, ref_mpi), "gather");
 
   return REF_SUCCESS;
 }
@@ -161,6 +161,7 @@ int main(int argc, char *argv[]) {
       ref_node_xyz(ref_node, 1, node) += dy;
       ref_node_xyz(ref_node, 2, node) += dz;
     }
+    RSS(ref_node_index_invalidate(ref_node), "moved");
   }
 
   rotate_pos = REF_EMPTY;
@@ -184,6 +185,7 @@ int main(int argc, char *argv[]) {
       ref_node_xyz(ref_node, 2, node) =
           x * sin(rotate_rad) + z * cos(rotate_rad);
     }
+    RSS(ref_node_index_invalidate(ref_node), "moved");
   }
 
   scale_pos = REF_EMPTY;
@@ -290,6 +292,7 @@ int main(int argc, char *argv[]) {
       ref_node_xyz(ref_node, 1, node) *= scale;
       ref_node_xyz(ref_node, 2, node) *= scale;
     }
+    RSS(ref_node_index_invalidate(ref_node), "moved");
   }
 
   RSS(ref_gather_by_extension(ref_grid, "inflated.b8.ugrid"), "b8");
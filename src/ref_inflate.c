@@ -107,6 +107,7 @@ REF_STATUS ref_inflate_face(REF_GRID ref_grid, REF_DICT faceids,
 
   REF_BOOL debug = REF_FALSE;
 
+  RSS(ref_dict_sort(faceids), "sort faceids");
   ref_malloc_init(face_normal, 3 * ref_dict_n(faceids), REF_DBL, -1.0);
 
   /* determine each faceids normal, only needed if my part has a tri */
@@ -25,7 +25,9 @@
 
 #include "ref_malloc.h"
 #include "ref_math.h"
+#include "ref_migrate.h"
 #include "ref_search.h"
+#include "ref_sort.h"
 
 #define MAX_NODE_LIST (200)
 
@@ -146,31 +148,54 @@ static REF_STATUS ref_interp_bounding_sphere3(REF_NODE ref_node, REF_INT *nodes,
   return REF_SUCCESS;
 }
 
-static REF_STATUS ref_interp_create_search(REF_INTERP ref_interp) {
+static REF_STATUS ref_interp_search_cells(REF_INTERP ref_interp,
+                                          REF_CELL ref_cell,
+                                          REF_SEARCH *ref_search) {
   REF_GRID from_grid = ref_interp_from_grid(ref_interp);
   REF_NODE from_node = ref_grid_node(from_grid);
-  REF_CELL from_tet = ref_grid_tet(from_grid);
-  REF_CELL from_tri = ref_grid_tri(from_grid);
   REF_INT cell, nodes[REF_CELL_MAX_SIZE_PER];
-  REF_DBL center[3], radius;
+  REF_INT n, *item;
+  REF_DBL *center, *radius;
+
+  ref_malloc(item, ref_cell_n(ref_cell), REF_INT);
+  ref_malloc(center, 3 * ref_cell_n(ref_cell), REF_DBL);
+  ref_malloc(radius, ref_cell_n(ref_cell), REF_DBL);
+  n = 0;
+  each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
+    if (3 == ref_cell_node_per(ref_cell)) {
+      RSS(ref_interp_bounding_sphere3(from_node, nodes, &(center[3 * n]),
+                                      &(radius[n])),
+          "b");
+    } else {
+      RSS(ref_interp_bounding_sphere4(from_node, nodes, &(center[3 * n]),
+                                      &(radius[n])),
+          "b");
+    }
+    radius[n] *= ref_interp_search_donor_scale(ref_interp);
+    item[n] = cell;
+    n++;
+  }
+  RSS(ref_search_create(ref_search, n), "create search");
+  RSS(ref_search_bulk(*ref_search, n, item, center, radius), "bulk");
+  ref_free(radius);
+  ref_free(center);
+  ref_free(item);
+
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_interp_create_search(REF_INTERP ref_interp) {
+  REF_GRID from_grid = ref_interp_from_grid(ref_interp);
   REF_SEARCH ref_search;
 
   if (ref_grid_twod(from_grid)) {
-    RSS(ref_search_create(&ref_search, ref_cell_n(from_tri)), "create search");
-    each_ref_cell_valid_cell_with_nodes(from_tri, cell, nodes) {
-      RSS(ref_interp_bounding_sphere3(from_node, nodes, center, &radius), "b");
-      RSS(ref_search_insert(ref_search, cell, center,
-                            ref_interp_search_donor_scale(ref_interp) * radius),
-          "ins");
-    }
+    RSS(ref_interp_search_cells(ref_interp, ref_grid_tri(from_grid),
+                                &ref_search),
+        "tri search");
   } else {
-    RSS(ref_search_create(&ref_search, ref_cell_n(from_tet)), "create search");
-    each_ref_cell_valid_cell_with_nodes(from_tet, cell, nodes) {
-      RSS(ref_interp_bounding_sphere4(from_node, nodes, center, &radius), "b");
-      RSS(ref_search_insert(ref_search, cell, center,
-                            ref_interp_search_donor_scale(ref_interp) * radius),
-          "ins");
-    }
+    RSS(ref_interp_search_cells(ref_interp, ref_grid_tet(from_grid),
+                                &ref_search),
+        "tet search");
   }
   ref_interp_search(ref_interp) = ref_search;
 
@@ -192,6 +217,7 @@ REF_STATUS ref_interp_create(REF_INTERP *ref_interp_ptr, REF_GRID from_grid,
 
   ref_interp->instrument = REF_FALSE;
   ref_interp->continuously = REF_FALSE;
+  ref_interp->ordered = REF_FALSE;
   ref_interp->n_walk = 0;
   ref_interp->n_terminated = 0;
   ref_interp->walk_steps = 0;
@@ -199,6 +225,7 @@ REF_STATUS ref_interp_create(REF_INTERP *ref_interp_ptr, REF_GRID from_grid,
   ref_interp->n_geom_fail = 0;
   ref_interp->n_tree = 0;
   ref_interp->tree_cells = 0;
+  ref_interp->n_fallback = 0;
   ref_interp_max(ref_interp) = max;
   ref_malloc_init(ref_interp->agent_hired, max, REF_BOOL, REF_FALSE);
   ref_malloc_init(ref_interp->cell, max, REF_INT, REF_EMPTY);
@@ -529,8 +556,10 @@ static REF_STATUS ref_update_agent_tet_seed(REF_INTERP ref_interp, REF_INT id,
     /* if it is off proc */
     if (!ref_node_owned(ref_node, node0) && !ref_node_owned(ref_node, node1) &&
         !ref_node_owned(ref_node, node2)) {
-      /* pick at pseudo random */
-      node = face_nodes[rand() % 3];
+      /* pick by step and cell, repeatable when walks are threaded */
+      node = face_nodes[(ref_agent_step(ref_agents, id) +
+                         ref_agent_seed(ref_agents, id)) %
+                        3];
       ref_agent_part(ref_agents, id) = ref_node_part(ref_node, node);
       ref_agent_seed(ref_agents, id) = REF_EMPTY;
       ref_agent_global(ref_agents, id) = ref_node_global(ref_node, node);
@@ -570,9 +599,12 @@ static REF_STATUS ref_update_agent_tri_seed(REF_INTERP ref_interp, REF_INT id,
   if (1 == ncell) {
     /* if it is off proc */
     if (!ref_node_owned(ref_node, node0) && !ref_node_owned(ref_node, node1)) {
-      /* pick at pseudo random */
+      /* pick by step and cell, repeatable when walks are threaded */
       node = node0;
-      if (1 == rand() % 2) node = node1;
+      if (1 == (ref_agent_step(ref_agents, id) +
+                ref_agent_seed(ref_agents, id)) %
+                   2)
+        node = node1;
       ref_agent_part(ref_agents, id) = ref_node_part(ref_node, node);
       ref_agent_seed(ref_agents, id) = REF_EMPTY;
       ref_agent_global(ref_agents, id) = ref_node_global(ref_node, node);
@@ -843,13 +875,88 @@ static REF_STATUS ref_interp_push_onto_queue(REF_INTERP ref_interp,
   return REF_SUCCESS;
 }
 
+static REF_STATUS ref_interp_walk_agents(REF_INTERP ref_interp) {
+  REF_MPI ref_mpi = ref_interp_mpi(ref_interp);
+  REF_AGENTS ref_agents = ref_interp->ref_agents;
+  REF_INT id;
+  REF_STATUS status;
+
+  /* walks only modify their own agent, threads take slices of agents */
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi)) \
+    schedule(dynamic, 64) reduction(max : status)
+#endif
+  for (id = 0; id < ref_agents_max(ref_agents); id++) {
+    if (REF_AGENT_WALKING == ref_agent_mode(ref_agents, id) &&
+        ref_agent_part(ref_agents, id) == ref_mpi_rank(ref_mpi)) {
+      if (REF_SUCCESS != ref_interp_walk_agent(ref_interp, id))
+        status = REF_FAILURE;
+    }
+  }
+  RSS(status, "walking");
+
+  return REF_SUCCESS;
+}
+
+/* record agents that are home and done, enclosing agents queue neighbors */
+static REF_STATUS ref_interp_settle_agents(REF_INTERP ref_interp) {
+  REF_NODE to_node = ref_grid_node(ref_interp_to_grid(ref_interp));
+  REF_MPI ref_mpi = ref_interp_mpi(ref_interp);
+  REF_AGENTS ref_agents = ref_interp->ref_agents;
+  REF_INT i, id, node;
+
+  each_active_ref_agent(ref_agents, id) {
+    if ((REF_AGENT_AT_BOUNDARY == ref_agent_mode(ref_agents, id) ||
+         REF_AGENT_TERMINATED == ref_agent_mode(ref_agents, id)) &&
+        ref_agent_home(ref_agents, id) == ref_mpi_rank(ref_mpi)) {
+      node = ref_agent_node(ref_agents, id);
+      RAS(ref_node_valid(to_node, node), "not vaild");
+      RAS(ref_node_owned(to_node, node), "ghost, not owned");
+      REIS(REF_EMPTY, ref_interp->cell[node], "already found?");
+      RAS(ref_interp->agent_hired[node], "should have an agent");
+      if (REF_AGENT_TERMINATED == ref_agent_mode(ref_agents, id)) {
+        (ref_interp->walk_steps) += (ref_agent_step(ref_agents, id) + 1);
+        (ref_interp->n_terminated)++;
+      }
+      ref_interp->agent_hired[node] = REF_FALSE; /* but nore more */
+      RSS(ref_agents_remove(ref_agents, id), "no longer neeeded");
+    }
+  }
+
+  each_active_ref_agent(ref_agents, id) {
+    if (REF_AGENT_ENCLOSING == ref_agent_mode(ref_agents, id) &&
+        ref_agent_home(ref_agents, id) == ref_mpi_rank(ref_mpi)) {
+      node = ref_agent_node(ref_agents, id);
+      RAS(ref_node_valid(to_node, node), "not vaild");
+      RAS(ref_node_owned(to_node, node), "ghost, not owned");
+      REIS(REF_EMPTY, ref_interp->cell[node], "already found?");
+      RAS(ref_interp->agent_hired[node], "should have an agent");
+
+      ref_interp->cell[node] = ref_agent_seed(ref_agents, id);
+      ref_interp->part[node] = ref_agent_part(ref_agents, id);
+      for (i = 0; i < 4; i++)
+        ref_interp->bary[i + 4 * node] = ref_agent_bary(ref_agents, i, id);
+      (ref_interp->walk_steps) += (ref_agent_step(ref_agents, id) + 1);
+      (ref_interp->n_walk)++;
+
+      ref_interp->agent_hired[node] = REF_FALSE; /* but nore more */
+      RSS(ref_agents_remove(ref_agents, id), "no longer neeeded");
+      RSS(ref_interp_push_onto_queue(ref_interp, node), "push");
+    }
+  }
+
+  return REF_SUCCESS;
+}
+
 static REF_STATUS ref_interp_process_agents(REF_INTERP ref_interp) {
   REF_NODE from_node = ref_grid_node(ref_interp_from_grid(ref_interp));
   REF_NODE to_node = ref_grid_node(ref_interp_to_grid(ref_interp));
   REF_CELL from_cell = ref_grid_tet(ref_interp_from_grid(ref_interp));
   REF_MPI ref_mpi = ref_interp_mpi(ref_interp);
   REF_AGENTS ref_agents = ref_interp->ref_agents;
-  REF_INT i, id, node;
+  REF_MPI_REQUEST count_request;
+  REF_INT id, node;
   REF_INT n_agents;
   REF_INT sweep = 0;
 
@@ -857,22 +964,27 @@ static REF_STATUS ref_interp_process_agents(REF_INTERP ref_interp) {
     from_cell = ref_grid_tri(ref_interp_from_grid(ref_interp));
 
   n_agents = ref_agents_n(ref_agents);
-  RSS(ref_mpi_allsum(ref_mpi, &n_agents, 1, REF_INT_TYPE), "sum");
+  RSS(ref_mpi_iallsum(ref_mpi, &n_agents, 1, REF_INT_TYPE, &count_request),
+      "post count");
+
+  while (REF_TRUE) {
+    /* the agent count of the last sweep is reduced while walking,
+     * no agents anywhere means this walk had nothing to do */
+    RSS(ref_interp_walk_agents(ref_interp), "walk");
+    RSS(ref_mpi_wait(ref_mpi, &count_request), "count");
+    if (0 == n_agents) break;
 
-  while (n_agents > 0) {
     if (ref_interp->instrument && ref_mpi_once(ref_interp->ref_mpi))
       printf(" %2d sweep", sweep);
     if (ref_interp->instrument) ref_agents_population(ref_agents, "agent pop");
     sweep++;
 
-    each_active_ref_agent(ref_agents, id) {
-      if (REF_AGENT_WALKING == ref_agent_mode(ref_agents, id) &&
-          ref_agent_part(ref_agents, id) == ref_mpi_rank(ref_mpi)) {
-        RSS(ref_interp_walk_agent(ref_interp, id), "walking");
-      }
-    }
-
-    RSS(ref_agents_migrate(ref_agents), "send it");
+    /* agents for other parts are in flight while local agents are settled
+     * and the neighbors they queue are walked */
+    RSS(ref_agents_migrate_begin(ref_agents), "send it");
+    RSS(ref_interp_settle_agents(ref_interp), "settle local");
+    RSS(ref_interp_walk_agents(ref_interp), "walk queued");
+    RSS(ref_agents_migrate_end(ref_agents), "receive it");
 
     each_active_ref_agent(ref_agents, id) {
       if (REF_AGENT_HOP_PART == ref_agent_mode(ref_agents, id) &&
@@ -902,48 +1014,11 @@ static REF_STATUS ref_interp_process_agents(REF_INTERP ref_interp) {
       }
     }
 
-    each_active_ref_agent(ref_agents, id) {
-      if ((REF_AGENT_AT_BOUNDARY == ref_agent_mode(ref_agents, id) ||
-           REF_AGENT_TERMINATED == ref_agent_mode(ref_agents, id)) &&
-          ref_agent_home(ref_agents, id) == ref_mpi_rank(ref_mpi)) {
-        node = ref_agent_node(ref_agents, id);
-        RAS(ref_node_valid(to_node, node), "not vaild");
-        RAS(ref_node_owned(to_node, node), "ghost, not owned");
-        REIS(REF_EMPTY, ref_interp->cell[node], "already found?");
-        RAS(ref_interp->agent_hired[node], "should have an agent");
-        if (REF_AGENT_TERMINATED == ref_agent_mode(ref_agents, id)) {
-          (ref_interp->walk_steps) += (ref_agent_step(ref_agents, id) + 1);
-          (ref_interp->n_terminated)++;
-        }
-        ref_interp->agent_hired[node] = REF_FALSE; /* but nore more */
-        RSS(ref_agents_remove(ref_agents, id), "no longer neeeded");
-      }
-    }
-
-    each_active_ref_agent(ref_agents, id) {
-      if (REF_AGENT_ENCLOSING == ref_agent_mode(ref_agents, id) &&
-          ref_agent_home(ref_agents, id) == ref_mpi_rank(ref_mpi)) {
-        node = ref_agent_node(ref_agents, id);
-        RAS(ref_node_valid(to_node, node), "not vaild");
-        RAS(ref_node_owned(to_node, node), "ghost, not owned");
-        REIS(REF_EMPTY, ref_interp->cell[node], "already found?");
-        RAS(ref_interp->agent_hired[node], "should have an agent");
-
-        ref_interp->cell[node] = ref_agent_seed(ref_agents, id);
-        ref_interp->part[node] = ref_agent_part(ref_agents, id);
-        for (i = 0; i < 4; i++)
-          ref_interp->bary[i + 4 * node] = ref_agent_bary(ref_agents, i, id);
-        (ref_interp->walk_steps) += (ref_agent_step(ref_agents, id) + 1);
-        (ref_interp->n_walk)++;
-
-        ref_interp->agent_hired[node] = REF_FALSE; /* but nore more */
-        RSS(ref_agents_remove(ref_agents, id), "no longer neeeded");
-        RSS(ref_interp_push_onto_queue(ref_interp, node), "push");
-      }
-    }
+    RSS(ref_interp_settle_agents(ref_interp), "settle arrived");
 
     n_agents = ref_agents_n(ref_agents);
-    RSS(ref_mpi_allsum(ref_mpi, &n_agents, 1, REF_INT_TYPE), "sum");
+    RSS(ref_mpi_iallsum(ref_mpi, &n_agents, 1, REF_INT_TYPE, &count_request),
+        "post count");
   }
 
   RSS(ref_mpi_allsum(ref_mpi, &(ref_interp->walk_steps), 1, REF_INT_TYPE),
@@ -1142,6 +1217,71 @@ static REF_STATUS ref_interp_geom_nodes(REF_INTERP ref_interp) {
   return REF_SUCCESS;
 }
 
+/* candidates of each point are independent, so threads search with
+ * private lists and write disjoint entries of best_cell and best_bary */
+static REF_STATUS ref_interp_touching_best(REF_INTERP ref_interp,
+                                           REF_INT total_node,
+                                           REF_DBL *global_xyz,
+                                           REF_INT *best_cell,
+                                           REF_DBL *best_bary) {
+  REF_GRID from_grid = ref_interp_from_grid(ref_interp);
+  REF_MPI ref_mpi = ref_interp_mpi(ref_interp);
+  REF_SEARCH ref_search = ref_interp_search(ref_interp);
+  REF_LIST ref_list;
+  REF_DBL bary[4];
+  REF_INT node, tree_cells;
+  REF_STATUS status;
+
+  tree_cells = 0;
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(ref_mpi_nthread(ref_mpi)) private( \
+    ref_list, bary, node) reduction(+ : tree_cells) reduction(max : status)
+#endif
+  {
+    ref_list = NULL;
+    if (REF_SUCCESS != ref_list_create(&ref_list)) status = REF_FAILURE;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+    for (node = 0; node < total_node; node++) {
+      best_cell[node] = REF_EMPTY;
+      best_bary[node] = 1.0e20; /* negative for min, until use max*/
+      if (NULL == ref_list) continue;
+      if (REF_SUCCESS !=
+          ref_search_touching(ref_search, ref_list, &(global_xyz[3 * node]),
+                              ref_interp_search_fuzz(ref_interp)))
+        status = REF_FAILURE;
+      if (ref_list_n(ref_list) > 0) {
+        if (ref_grid_twod(from_grid)) {
+          if (REF_SUCCESS != ref_interp_enclosing_tri_in_list(
+                                 from_grid, ref_list, &(global_xyz[3 * node]),
+                                 &(best_cell[node]), bary))
+            status = REF_FAILURE;
+        } else {
+          if (REF_SUCCESS != ref_interp_enclosing_tet_in_list(
+                                 from_grid, ref_list, &(global_xyz[3 * node]),
+                                 &(best_cell[node]), bary))
+            status = REF_FAILURE;
+        }
+        if (REF_EMPTY != best_cell[node]) {
+          /* negative for min, until use max*/
+          best_bary[node] =
+              -MIN(MIN(bary[0], bary[1]), MIN(bary[2], bary[3]));
+        }
+      }
+      tree_cells += ref_list_n(ref_list);
+      if (REF_SUCCESS != ref_list_erase(ref_list)) status = REF_FAILURE;
+    }
+    if (NULL != ref_list && REF_SUCCESS != ref_list_free(ref_list))
+      status = REF_FAILURE;
+  }
+  RSS(status, "touching candidates");
+  (ref_interp->tree_cells) += tree_cells;
+
+  return REF_SUCCESS;
+}
+
 static REF_STATUS ref_interp_tree(REF_INTERP ref_interp,
                                   REF_BOOL *increase_fuzz) {
   REF_GRID from_grid = ref_interp_from_grid(ref_interp);
@@ -1150,9 +1290,6 @@ static REF_STATUS ref_interp_tree(REF_INTERP ref_interp,
   REF_NODE from_node = ref_grid_node(from_grid);
   REF_CELL from_cell = ref_grid_tet(from_grid);
   REF_NODE to_node = ref_grid_node(to_grid);
-  REF_SEARCH ref_search = ref_interp_search(ref_interp);
-  REF_DBL bary[4];
-  REF_LIST ref_list;
   REF_INT nodes[REF_CELL_MAX_SIZE_PER];
   REF_INT node, *best_node, *best_cell, *from_proc;
   REF_DBL *best_bary;
@@ -1171,8 +1308,6 @@ static REF_STATUS ref_interp_tree(REF_INTERP ref_interp,
 
   *increase_fuzz = REF_FALSE;
 
-  RSS(ref_list_create(&ref_list), "create list");
-
   ntarget = 0;
   each_ref_node_valid_node(to_node, node) {
     if (!ref_node_owned(to_node, node) || REF_EMPTY != ref_interp->cell[node])
@@ -1203,35 +1338,10 @@ static REF_STATUS ref_interp_tree(REF_INTERP ref_interp,
   ref_malloc(best_node, total_node, REF_INT);
   ref_malloc(best_cell, total_node, REF_INT);
   ref_malloc(from_proc, total_node, REF_INT);
-  for (node = 0; node < total_node; node++) {
-    best_node[node] = global_node[node];
-    best_cell[node] = REF_EMPTY;
-    best_bary[node] = 1.0e20; /* negative for min, until use max*/
-    RSS(ref_search_touching(ref_search, ref_list, &(global_xyz[3 * node]),
-                            ref_interp_search_fuzz(ref_interp)),
-        "tch");
-    if (ref_list_n(ref_list) > 0) {
-      if (ref_grid_twod(from_grid)) {
-        RSS(ref_interp_enclosing_tri_in_list(from_grid, ref_list,
-                                             &(global_xyz[3 * node]),
-                                             &(best_cell[node]), bary),
-            "best in list");
-      } else {
-        RSS(ref_interp_enclosing_tet_in_list(from_grid, ref_list,
-                                             &(global_xyz[3 * node]),
-                                             &(best_cell[node]), bary),
-            "best in list");
-      }
-      if (REF_EMPTY != best_cell[node]) {
-        /* negative for min, until use max*/
-        best_bary[node] = -MIN(MIN(bary[0], bary[1]), MIN(bary[2], bary[3]));
-      }
-    } else {
-      best_cell[node] = REF_EMPTY;
-    }
-    (ref_interp->tree_cells) += ref_list_n(ref_list);
-    RSS(ref_list_erase(ref_list), "reset list");
-  }
+  for (node = 0; node < total_node; node++) best_node[node] = global_node[node];
+  RSS(ref_interp_touching_best(ref_interp, total_node, global_xyz, best_cell,
+                               best_bary),
+      "best touching");
 
   /* negative for min, until use max*/
   RSS(ref_mpi_allminwho(ref_mpi, best_bary, from_proc, total_node), "who");
@@ -1330,8 +1440,6 @@ static REF_STATUS ref_interp_tree(REF_INTERP ref_interp,
   ref_free(local_xyz);
   ref_free(local_node);
 
-  RSS(ref_list_free(ref_list), "free list");
-
   if (!(*increase_fuzz)) {
     each_ref_node_valid_node(to_node, node) {
       if (!ref_node_owned(to_node, node) || REF_EMPTY != ref_interp->cell[node])
@@ -1526,9 +1634,6 @@ static REF_STATUS ref_interp_seed_tree(REF_INTERP ref_interp) {
   REF_NODE from_node = ref_grid_node(from_grid);
   REF_CELL from_tet = ref_grid_tet(from_grid);
   REF_NODE to_node = ref_grid_node(to_grid);
-  REF_SEARCH ref_search = ref_interp_search(ref_interp);
-  REF_DBL bary[4];
-  REF_LIST ref_list;
   REF_INT nodes[REF_CELL_MAX_SIZE_PER];
   REF_INT node, *best_node, *best_cell, *from_proc;
   REF_DBL *best_bary;
@@ -1543,8 +1648,6 @@ static REF_STATUS ref_interp_seed_tree(REF_INTERP ref_interp) {
   REF_DBL *send_bary, *recv_bary;
   REF_INT i, item;
 
-  RSS(ref_list_create(&ref_list), "create list");
-
   ntarget = 0;
   each_ref_node_valid_node(to_node, node) {
     if (!ref_node_owned(to_node, node) || REF_EMPTY != ref_interp->cell[node])
@@ -1595,28 +1698,10 @@ static REF_STATUS ref_interp_seed_tree(REF_INTERP ref_interp) {
   ref_malloc(best_node, total_node, REF_INT);
   ref_malloc(best_cell, total_node, REF_INT);
   ref_malloc(from_proc, total_node, REF_INT);
-  for (node = 0; node < total_node; node++) {
-    best_node[node] = global_node[node];
-    best_cell[node] = REF_EMPTY;
-    best_bary[node] = 1.0e20; /* negative for min, until use max*/
-    RSS(ref_search_touching(ref_search, ref_list, &(global_xyz[3 * node]),
-                            ref_interp_search_fuzz(ref_interp)),
-        "tch");
-    if (ref_list_n(ref_list) > 0) {
-      RSS(ref_interp_enclosing_tet_in_list(from_grid, ref_list,
-                                           &(global_xyz[3 * node]),
-                                           &(best_cell[node]), bary),
-          "best in list");
-      if (REF_EMPTY != best_cell[node]) {
-        /* negative for min, until use max*/
-        best_bary[node] = -MIN(MIN(bary[0], bary[1]), MIN(bary[2], bary[3]));
-      }
-    } else {
-      best_cell[node] = REF_EMPTY;
-    }
-    (ref_interp->tree_cells) += ref_list_n(ref_list);
-    RSS(ref_list_erase(ref_list), "reset list");
-  }
+  for (node = 0; node < total_node; node++) best_node[node] = global_node[node];
+  RSS(ref_interp_touching_best(ref_interp, total_node, global_xyz, best_cell,
+                               best_bary),
+      "best touching");
 
   /* negative for min, until use max*/
   RSS(ref_mpi_allminwho(ref_mpi, best_bary, from_proc, total_node), "who");
@@ -1703,8 +1788,116 @@ static REF_STATUS ref_interp_seed_tree(REF_INTERP ref_interp) {
   ref_free(local_xyz);
   ref_free(local_node);
 
+  return REF_SUCCESS;
+}
+
+/* receptors are visited in Morton order so each walk starts from the
+ * donor of the previous receptor, misses are left to agents and tree */
+static REF_STATUS ref_interp_ordered_walk(REF_INTERP ref_interp) {
+  REF_GRID from_grid = ref_interp_from_grid(ref_interp);
+  REF_MPI ref_mpi = ref_interp_mpi(ref_interp);
+  REF_NODE to_node = ref_grid_node(ref_interp_to_grid(ref_interp));
+  REF_AGENTS ref_agents = ref_interp->ref_agents;
+  REF_SEARCH ref_search = ref_interp_search(ref_interp);
+  REF_LIST ref_list;
+  REF_INT n, item, node, i, id, seed;
+  REF_INT *receptor, *order;
+  REF_GLOB *key;
+  REF_DBL lo[3], hi[3], scale[3], bary[4];
+  REF_UINT ijk[3];
+
+  for (i = 0; i < 3; i++) {
+    lo[i] = REF_DBL_MAX;
+    hi[i] = -REF_DBL_MAX;
+  }
+  n = 0;
+  each_ref_node_valid_node(to_node, node) {
+    if (!ref_node_owned(to_node, node) || REF_EMPTY != ref_interp->cell[node] ||
+        ref_interp->agent_hired[node])
+      continue;
+    for (i = 0; i < 3; i++) {
+      lo[i] = MIN(lo[i], ref_node_xyz(to_node, i, node));
+      hi[i] = MAX(hi[i], ref_node_xyz(to_node, i, node));
+    }
+    n++;
+  }
+  /* 21 bits per direction fills the 63 bit morton id */
+  for (i = 0; i < 3; i++) {
+    scale[i] = 0.0;
+    if (hi[i] > lo[i]) scale[i] = 2097151.0 / (hi[i] - lo[i]);
+  }
+
+  ref_malloc(receptor, n, REF_INT);
+  ref_malloc(key, n, REF_GLOB);
+  ref_malloc(order, n, REF_INT);
+  n = 0;
+  each_ref_node_valid_node(to_node, node) {
+    if (!ref_node_owned(to_node, node) || REF_EMPTY != ref_interp->cell[node] ||
+        ref_interp->agent_hired[node])
+      continue;
+    for (i = 0; i < 3; i++)
+      ijk[i] = (REF_UINT)(scale[i] * (ref_node_xyz(to_node, i, node) - lo[i]));
+    receptor[n] = node;
+    key[n] = (REF_GLOB)ref_migrate_morton_id(ijk[0], ijk[1], ijk[2]);
+    n++;
+  }
+  RSS(ref_sort_radix_glob(n, key, order), "sort morton");
+
+  RSS(ref_list_create(&ref_list), "create list");
+  seed = REF_EMPTY;
+  for (item = 0; item < n; item++) {
+    node = receptor[order[item]];
+    if (REF_EMPTY == seed) {
+      RSS(ref_search_touching(ref_search, ref_list,
+                              ref_node_xyz_ptr(to_node, node),
+                              ref_interp_search_fuzz(ref_interp)),
+          "tch");
+      if (ref_list_n(ref_list) > 0) {
+        if (ref_grid_twod(from_grid)) {
+          RSS(ref_interp_enclosing_tri_in_list(
+                  from_grid, ref_list, ref_node_xyz_ptr(to_node, node), &seed,
+                  bary),
+              "best in list");
+        } else {
+          RSS(ref_interp_enclosing_tet_in_list(
+                  from_grid, ref_list, ref_node_xyz_ptr(to_node, node), &seed,
+                  bary),
+              "best in list");
+        }
+      }
+      RSS(ref_list_erase(ref_list), "reset list");
+    }
+    if (REF_EMPTY == seed) {
+      (ref_interp->n_fallback)++;
+      continue;
+    }
+    RSS(ref_agents_push(ref_agents, node, ref_mpi_rank(ref_mpi), seed,
+                        ref_node_xyz_ptr(to_node, node), &id),
+        "push");
+    ref_interp->agent_hired[node] = REF_TRUE;
+    RSS(ref_interp_walk_agent(ref_interp, id), "walk");
+    if (REF_AGENT_ENCLOSING != ref_agent_mode(ref_agents, id)) {
+      /* hop, boundary, and terminated agents are left for process agents */
+      (ref_interp->n_fallback)++;
+      seed = REF_EMPTY;
+      continue;
+    }
+    ref_interp->cell[node] = ref_agent_seed(ref_agents, id);
+    ref_interp->part[node] = ref_agent_part(ref_agents, id);
+    for (i = 0; i < 4; i++)
+      ref_interp->bary[i + 4 * node] = ref_agent_bary(ref_agents, i, id);
+    (ref_interp->walk_steps) += (ref_agent_step(ref_agents, id) + 1);
+    (ref_interp->n_walk)++;
+    ref_interp->agent_hired[node] = REF_FALSE;
+    seed = ref_agent_seed(ref_agents, id);
+    RSS(ref_agents_remove(ref_agents, id), "found");
+  }
   RSS(ref_list_free(ref_list), "free list");
 
+  ref_free(order);
+  ref_free(key);
+  ref_free(receptor);
+
   return REF_SUCCESS;
 }
 
@@ -1720,6 +1913,12 @@ REF_STATUS ref_interp_locate(REF_INTERP ref_interp) {
   if (ref_interp->instrument)
     RSS(ref_mpi_stopwatch_stop(ref_mpi, "geom"), "locate clock");
 
+  if (ref_interp_ordered(ref_interp)) {
+    RSS(ref_interp_ordered_walk(ref_interp), "ordered");
+    if (ref_interp->instrument)
+      RSS(ref_mpi_stopwatch_stop(ref_mpi, "ordered"), "locate clock");
+  }
+
   RSS(ref_interp_process_agents(ref_interp), "drain");
   if (ref_interp->instrument)
     RSS(ref_mpi_stopwatch_stop(ref_mpi, "drain"), "locate clock");
@@ -1819,12 +2018,9 @@ REF_STATUS ref_interp_locate_nearest(REF_INTERP ref_interp) {
   REF_GRID from_grid = ref_interp_from_grid(ref_interp);
 
   REF_CELL from_tri = ref_grid_tri(from_grid);
-  REF_NODE from_node = ref_grid_node(from_grid);
 
   REF_BOOL increase_fuzz;
   REF_SEARCH ref_search;
-  REF_INT cell, nodes[REF_CELL_MAX_SIZE_PER];
-  REF_DBL center[3], radius;
 
   if (ref_interp->instrument)
     RSS(ref_mpi_stopwatch_start(ref_mpi), "locate clock");
@@ -1843,13 +2039,8 @@ REF_STATUS ref_interp_locate_nearest(REF_INTERP ref_interp) {
     RSS(ref_mpi_stopwatch_stop(ref_mpi, "tree"), "locate clock");
 
   if (increase_fuzz) {
-    RSS(ref_search_create(&ref_search, ref_cell_n(from_tri)), "create search");
-    each_ref_cell_valid_cell_with_nodes(from_tri, cell, nodes) {
-      RSS(ref_interp_bounding_sphere3(from_node, nodes, center, &radius), "b");
-      RSS(ref_search_insert(ref_search, cell, center,
-                            ref_interp_search_donor_scale(ref_interp) * radius),
-          "ins");
-    }
+    RSS(ref_interp_search_cells(ref_interp, from_tri, &ref_search),
+        "tri search");
     RSS(ref_interp_nearest_tri_in_tree(ref_interp, ref_search), "near tri");
     RSS(ref_search_free(ref_search), "free search");
   }
@@ -2043,22 +2234,29 @@ REF_STATUS ref_interp_locate_between(REF_INTERP ref_interp, REF_INT node0,
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_interp_scalar(REF_INTERP ref_interp, REF_INT leading_dim,
-                             REF_DBL *from_scalar, REF_DBL *to_scalar) {
+REF_STATUS ref_interp_plan_create(REF_INTERP_PLAN *ref_interp_plan_ptr,
+                                  REF_INTERP ref_interp) {
+  REF_INTERP_PLAN ref_interp_plan;
   REF_GRID to_grid = ref_interp_to_grid(ref_interp);
   REF_GRID from_grid = ref_interp_from_grid(ref_interp);
   REF_NODE to_node = ref_grid_node(to_grid);
   REF_MPI ref_mpi = ref_grid_mpi(to_grid);
   REF_CELL from_cell = ref_grid_tet(from_grid);
-  REF_INT node, ibary, im;
+  REF_INT node, ibary, part;
   REF_INT nodes[REF_CELL_MAX_SIZE_PER];
-  REF_INT receptor, n_recept, donation, n_donor;
-  REF_DBL *recept_scalar, *donor_scalar, *recept_bary, *donor_bary;
+  REF_INT n_recept, donation, n_donor;
+  REF_DBL *recept_bary, *donor_bary;
   REF_INT *donor_node, *donor_ret, *donor_cell;
   REF_INT *recept_proc, *recept_ret, *recept_node, *recept_cell;
 
   if (ref_grid_twod(from_grid)) from_cell = ref_grid_tri(from_grid);
 
+  ref_malloc(*ref_interp_plan_ptr, 1, REF_INTERP_PLAN_STRUCT);
+  ref_interp_plan = (*ref_interp_plan_ptr);
+  ref_interp_plan->ref_mpi = ref_mpi;
+  ref_interp_plan->from_node = ref_grid_node(from_grid);
+  ref_interp_plan->to_node = to_node;
+
   n_recept = 0;
   each_ref_node_valid_node(to_node, node) {
     if (ref_node_owned(to_node, node)) {
@@ -2106,48 +2304,259 @@ REF_STATUS ref_interp_scalar(REF_INTERP ref_interp, REF_INT leading_dim,
   ref_free(recept_cell);
   ref_free(recept_bary);
 
-  ref_malloc(donor_scalar, leading_dim * n_donor, REF_DBL);
-
+  ref_interp_plan->n_donor = n_donor;
+  ref_malloc(ref_interp_plan->donor_node, 4 * n_donor, REF_INT);
+  ref_interp_plan->donor_bary = donor_bary;
+  ref_malloc_init(ref_interp_plan->donor_size, ref_mpi_n(ref_mpi), REF_INT, 0);
   for (donation = 0; donation < n_donor; donation++) {
     RSS(ref_cell_nodes(from_cell, donor_cell[donation], nodes),
         "node needs to be localized");
     for (ibary = 0; ibary < 4; ibary++) {
-      for (im = 0; im < leading_dim; im++) {
-        donor_scalar[im + leading_dim * donation] = 0.0;
-        for (ibary = 0; ibary < 4; ibary++) {
-          donor_scalar[im + leading_dim * donation] +=
-              donor_bary[ibary + 4 * donation] *
-              from_scalar[im + leading_dim * nodes[ibary]];
-        }
-      }
+      ref_interp_plan->donor_node[ibary + 4 * donation] = nodes[ibary];
+    }
+    if (3 == ref_cell_node_per(from_cell)) { /* nodes[3] is the faceid */
+      ref_interp_plan->donor_node[3 + 4 * donation] = nodes[0];
+      donor_bary[3 + 4 * donation] = 0.0;
     }
+    /* blindsend delivers grouped by source rank, in rank order */
+    if (0 < donation)
+      RAS(donor_ret[donation - 1] <= donor_ret[donation],
+          "donations not grouped by receptor rank");
+    ref_interp_plan->donor_size[donor_ret[donation]]++;
   }
   ref_free(donor_cell);
-  ref_free(donor_bary);
 
-  RSS(ref_mpi_blindsend(ref_mpi, donor_ret, (void *)donor_scalar, leading_dim,
-                        n_donor, (void **)(&recept_scalar), &n_recept,
-                        REF_DBL_TYPE),
-      "blind send bary");
+  /* the return trip is a fixed alltoallv, record its receive order */
   RSS(ref_mpi_blindsend(ref_mpi, donor_ret, (void *)donor_node, 1, n_donor,
-                        (void **)(&recept_node), &n_recept, REF_INT_TYPE),
+                        (void **)(&(ref_interp_plan->recept_node)),
+                        &(ref_interp_plan->n_recept), REF_INT_TYPE),
       "blind send node");
-  ref_free(donor_scalar);
   ref_free(donor_node);
   ref_free(donor_ret);
 
-  for (receptor = 0; receptor < n_recept; receptor++) {
-    node = recept_node[receptor];
-    for (im = 0; im < leading_dim; im++) {
-      to_scalar[im + leading_dim * node] =
-          recept_scalar[im + leading_dim * receptor];
+  ref_malloc_init(ref_interp_plan->recept_size, ref_mpi_n(ref_mpi), REF_INT, 0);
+  if (ref_mpi_para(ref_mpi)) {
+    RSS(ref_mpi_alltoall(ref_mpi, ref_interp_plan->donor_size,
+                         ref_interp_plan->recept_size, REF_INT_TYPE),
+        "alltoall sizes");
+  } else {
+    each_ref_mpi_part(ref_mpi, part) {
+      ref_interp_plan->recept_size[part] = ref_interp_plan->donor_size[part];
     }
   }
 
-  ref_free(recept_node);
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_interp_plan_free(REF_INTERP_PLAN ref_interp_plan) {
+  if (NULL == (void *)ref_interp_plan) return REF_NULL;
+  ref_free(ref_interp_plan->recept_size);
+  ref_free(ref_interp_plan->recept_node);
+  ref_free(ref_interp_plan->donor_size);
+  ref_free(ref_interp_plan->donor_bary);
+  ref_free(ref_interp_plan->donor_node);
+  ref_free(ref_interp_plan);
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_interp_plan_return(REF_INTERP_PLAN ref_interp_plan,
+                                         void *donor_data, void *recept_data,
+                                         REF_INT ldim, REF_TYPE type) {
+  REF_MPI ref_mpi = ref_interp_plan->ref_mpi;
+  REF_INT i;
+
+  if (ref_mpi_para(ref_mpi)) {
+    RSS(ref_mpi_alltoallv(ref_mpi, donor_data, ref_interp_plan->donor_size,
+                          recept_data, ref_interp_plan->recept_size, ldim,
+                          type),
+        "alltoallv");
+    return REF_SUCCESS;
+  }
+
+  switch (type) {
+    case REF_DBL_TYPE:
+      for (i = 0; i < ldim * ref_interp_plan->n_donor; i++)
+        ((REF_DBL *)recept_data)[i] = ((REF_DBL *)donor_data)[i];
+      break;
+    case REF_GLOB_TYPE:
+      for (i = 0; i < ldim * ref_interp_plan->n_donor; i++)
+        ((REF_GLOB *)recept_data)[i] = ((REF_GLOB *)donor_data)[i];
+      break;
+    default:
+      RSS(REF_IMPLEMENT, "data type");
+  }
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_interp_plan_apply_fields(REF_INTERP_PLAN ref_interp_plan,
+                                        REF_INT nfield, REF_INT *leading_dim,
+                                        REF_DBL **from_scalar,
+                                        REF_DBL **to_scalar) {
+  REF_MPI ref_mpi = ref_interp_plan->ref_mpi;
+  REF_NODE to_node = ref_interp_plan->to_node;
+  REF_INT n_donor = ref_interp_plan->n_donor;
+  REF_INT n_recept = ref_interp_plan->n_recept;
+  REF_INT *donor_node = ref_interp_plan->donor_node;
+  REF_DBL *donor_bary = ref_interp_plan->donor_bary;
+  REF_INT field, offset, total, ldim;
+  REF_INT node, ibary, im, receptor, donation;
+  REF_DBL *donor_scalar, *recept_scalar, *ghost;
+
+  total = 0;
+  for (field = 0; field < nfield; field++) total += leading_dim[field];
+
+  ref_malloc(donor_scalar, total * n_donor, REF_DBL);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi)) \
+    schedule(static) private(field, offset, ldim, im, ibary)
+#endif
+  for (donation = 0; donation < n_donor; donation++) {
+    offset = 0;
+    for (field = 0; field < nfield; field++) {
+      ldim = leading_dim[field];
+      for (im = 0; im < ldim; im++) {
+        donor_scalar[offset + im + total * donation] = 0.0;
+        for (ibary = 0; ibary < 4; ibary++) {
+          donor_scalar[offset + im + total * donation] +=
+              donor_bary[ibary + 4 * donation] *
+              from_scalar[field][im + ldim * donor_node[ibary + 4 * donation]];
+        }
+      }
+      offset += ldim;
+    }
+  }
+
+  ref_malloc(recept_scalar, total * n_recept, REF_DBL);
+  RSS(ref_interp_plan_return(ref_interp_plan, donor_scalar, recept_scalar,
+                             total, REF_DBL_TYPE),
+      "return");
+  ref_free(donor_scalar);
+
+  for (receptor = 0; receptor < n_recept; receptor++) {
+    node = ref_interp_plan->recept_node[receptor];
+    offset = 0;
+    for (field = 0; field < nfield; field++) {
+      ldim = leading_dim[field];
+      for (im = 0; im < ldim; im++) {
+        to_scalar[field][im + ldim * node] =
+            recept_scalar[offset + im + total * receptor];
+      }
+      offset += ldim;
+    }
+  }
   ref_free(recept_scalar);
 
-  RSS(ref_node_ghost_dbl(to_node, to_scalar, leading_dim), "ghost");
+  if (1 == nfield) {
+    RSS(ref_node_ghost_dbl(to_node, to_scalar[0], leading_dim[0]), "ghost");
+    return REF_SUCCESS;
+  }
+
+  if (!ref_mpi_para(ref_mpi)) return REF_SUCCESS;
+
+  /* interleave fields to update all ghosts with one exchange */
+  ref_malloc_init(ghost, total * ref_node_max(to_node), REF_DBL, 0.0);
+  each_ref_node_valid_node(to_node, node) {
+    if (!ref_node_owned(to_node, node)) continue;
+    offset = 0;
+    for (field = 0; field < nfield; field++) {
+      ldim = leading_dim[field];
+      for (im = 0; im < ldim; im++)
+        ghost[offset + im + total * node] = to_scalar[field][im + ldim * node];
+      offset += ldim;
+    }
+  }
+  RSS(ref_node_ghost_dbl(to_node, ghost, total), "ghost");
+  each_ref_node_valid_node(to_node, node) {
+    if (ref_node_owned(to_node, node)) continue;
+    offset = 0;
+    for (field = 0; field < nfield; field++) {
+      ldim = leading_dim[field];
+      for (im = 0; im < ldim; im++)
+        to_scalar[field][im + ldim * node] = ghost[offset + im + total * node];
+      offset += ldim;
+    }
+  }
+  ref_free(ghost);
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_interp_plan_apply(REF_INTERP_PLAN ref_interp_plan,
+                                 REF_INT leading_dim, REF_DBL *from_scalar,
+                                 REF_DBL *to_scalar) {
+  RSS(ref_interp_plan_apply_fields(ref_interp_plan, 1, &leading_dim,
+                                   &from_scalar, &to_scalar),
+      "apply");
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_interp_plan_matrix(REF_INTERP_PLAN ref_interp_plan,
+                                  REF_INT **row_ptr_ptr, REF_GLOB **col_ptr,
+                                  REF_DBL **weight_ptr) {
+  REF_NODE from_node = ref_interp_plan->from_node;
+  REF_NODE to_node = ref_interp_plan->to_node;
+  REF_INT n_donor = ref_interp_plan->n_donor;
+  REF_INT n_recept = ref_interp_plan->n_recept;
+  REF_INT ibary, donation, receptor, node, entry;
+  REF_GLOB *donor_global, *recept_global;
+  REF_DBL *recept_bary;
+  REF_INT *row_ptr;
+
+  ref_malloc(donor_global, 4 * n_donor, REF_GLOB);
+  for (donation = 0; donation < n_donor; donation++) {
+    for (ibary = 0; ibary < 4; ibary++) {
+      donor_global[ibary + 4 * donation] = ref_node_global(
+          from_node, ref_interp_plan->donor_node[ibary + 4 * donation]);
+    }
+  }
+  ref_malloc(recept_global, 4 * n_recept, REF_GLOB);
+  RSS(ref_interp_plan_return(ref_interp_plan, donor_global, recept_global, 4,
+                             REF_GLOB_TYPE),
+      "return globals");
+  ref_free(donor_global);
+  ref_malloc(recept_bary, 4 * n_recept, REF_DBL);
+  RSS(ref_interp_plan_return(ref_interp_plan, ref_interp_plan->donor_bary,
+                             recept_bary, 4, REF_DBL_TYPE),
+      "return bary");
+
+  ref_malloc_init(*row_ptr_ptr, ref_node_max(to_node) + 1, REF_INT, 0);
+  row_ptr = *row_ptr_ptr;
+  for (receptor = 0; receptor < n_recept; receptor++) {
+    node = ref_interp_plan->recept_node[receptor];
+    for (ibary = 0; ibary < 4; ibary++)
+      if (0.0 != recept_bary[ibary + 4 * receptor]) row_ptr[node + 1]++;
+  }
+  for (node = 0; node < ref_node_max(to_node); node++)
+    row_ptr[node + 1] += row_ptr[node];
+
+  ref_malloc(*col_ptr, row_ptr[ref_node_max(to_node)], REF_GLOB);
+  ref_malloc(*weight_ptr, row_ptr[ref_node_max(to_node)], REF_DBL);
+  for (receptor = 0; receptor < n_recept; receptor++) {
+    node = ref_interp_plan->recept_node[receptor];
+    entry = row_ptr[node];
+    for (ibary = 0; ibary < 4; ibary++) {
+      if (0.0 == recept_bary[ibary + 4 * receptor]) continue;
+      (*col_ptr)[entry] = recept_global[ibary + 4 * receptor];
+      (*weight_ptr)[entry] = recept_bary[ibary + 4 * receptor];
+      entry++;
+    }
+  }
+  ref_free(recept_bary);
+  ref_free(recept_global);
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_interp_scalar(REF_INTERP ref_interp, REF_INT leading_dim,
+                             REF_DBL *from_scalar, REF_DBL *to_scalar) {
+  REF_INTERP_PLAN ref_interp_plan;
+
+  RSS(ref_interp_plan_create(&ref_interp_plan, ref_interp), "plan");
+  RSS(ref_interp_plan_apply(ref_interp_plan, leading_dim, from_scalar,
+                            to_scalar),
+      "apply");
+  RSS(ref_interp_plan_free(ref_interp_plan), "free plan");
 
   return REF_SUCCESS;
 }
@@ -2435,18 +2844,22 @@ REF_STATUS ref_interp_stats(REF_INTERP ref_interp) {
   REF_MPI ref_mpi = ref_interp_mpi(ref_interp);
   REF_NODE to_node = ref_grid_node(to_grid);
   REF_INT extrapolate = 0;
-  REF_INT node;
+  REF_INT node, n_fallback;
   REF_DBL this_bary, max_error, min_bary;
 
+  n_fallback = ref_interp->n_fallback;
+  RSS(ref_mpi_allsum(ref_mpi, &n_fallback, 1, REF_INT_TYPE), "sum");
   if (ref_mpi_once(ref_mpi)) {
     if (ref_interp->n_tree > 0)
       printf("tree search: %d found, %.2f avg cells\n", ref_interp->n_tree,
              (REF_DBL)ref_interp->tree_cells / (REF_DBL)ref_interp->n_tree);
     if (ref_interp->n_walk > 0 || ref_interp->n_terminated > 0)
-      printf("walks: %d successful, %.2f avg cells, %d terminated\n",
-             ref_interp->n_walk,
+      printf("walks: %d successful, %d steps, %.2f avg cells, %d terminated\n",
+             ref_interp->n_walk, ref_interp->walk_steps,
              (REF_DBL)ref_interp->walk_steps / (REF_DBL)ref_interp->n_walk,
              ref_interp->n_terminated);
+    if (ref_interp_ordered(ref_interp))
+      printf("ordered walks: %d fell back to agents or tree\n", n_fallback);
     printf("geom nodes: %d failed, %d successful\n", ref_interp->n_geom_fail,
            ref_interp->n_geom);
   }
@@ -2776,14 +3189,23 @@ REF_STATUS ref_interp_plt(REF_GRID ref_grid, const char *filename,
   REF_SEARCH ref_search;
   REF_DBL radius, position[3], dist, best_dist;
   REF_INT best, item;
+  REF_INT n, *items;
+  REF_DBL *xyz, *radii;
 
-  RSS(ref_search_create(&ref_search, ref_node_n(ref_node)), "create search");
+  ref_malloc(items, ref_node_n(ref_node), REF_INT);
+  ref_malloc(xyz, 3 * ref_node_n(ref_node), REF_DBL);
+  ref_malloc_init(radii, ref_node_n(ref_node), REF_DBL, 0.0);
+  n = 0;
   each_ref_node_valid_node(ref_node, node) {
-    radius = 0.0;
-    RSS(ref_search_insert(ref_search, node, ref_node_xyz_ptr(ref_node, node),
-                          radius),
-        "ins");
-  }
+    items[n] = node;
+    for (i = 0; i < 3; i++) xyz[i + 3 * n] = ref_node_xyz(ref_node, i, node);
+    n++;
+  }
+  RSS(ref_search_create(&ref_search, n), "create search");
+  RSS(ref_search_bulk(ref_search, n, items, xyz, radii), "bulk");
+  ref_free(radii);
+  ref_free(xyz);
+  ref_free(items);
 
   if (ref_mpi_once(ref_mpi)) {
     file = fopen(filename, "r");
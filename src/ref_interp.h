@@ -25,6 +25,8 @@
 BEGIN_C_DECLORATION
 typedef struct REF_INTERP_STRUCT REF_INTERP_STRUCT;
 typedef REF_INTERP_STRUCT *REF_INTERP;
+typedef struct REF_INTERP_PLAN_STRUCT REF_INTERP_PLAN_STRUCT;
+typedef REF_INTERP_PLAN_STRUCT *REF_INTERP_PLAN;
 END_C_DECLORATION
 
 #include "ref_grid.h"
@@ -41,6 +43,7 @@ struct REF_INTERP_STRUCT {
   REF_GRID to_grid;
   REF_BOOL instrument;
   REF_BOOL continuously;
+  REF_BOOL ordered;
   REF_INT n_walk;
   REF_INT n_terminated;
   REF_INT walk_steps;
@@ -48,6 +51,7 @@ struct REF_INTERP_STRUCT {
   REF_INT n_geom_fail;
   REF_INT n_tree;
   REF_INT tree_cells;
+  REF_INT n_fallback;
   REF_INT max;
   REF_BOOL *agent_hired;
   REF_INT *cell;
@@ -62,6 +66,22 @@ struct REF_INTERP_STRUCT {
   REF_SEARCH ref_search;
 };
 
+/* located interpolant compiled for repeated transfer: donor nodes and
+ * clipped barycentrics on the donor rank, and the fixed alltoallv
+ * counts that return donated values to the receptor rank */
+struct REF_INTERP_PLAN_STRUCT {
+  REF_MPI ref_mpi;
+  REF_NODE from_node;
+  REF_NODE to_node;
+  REF_INT n_donor;
+  REF_INT *donor_node;
+  REF_DBL *donor_bary;
+  REF_INT *donor_size;
+  REF_INT n_recept;
+  REF_INT *recept_node;
+  REF_INT *recept_size;
+};
+
 #define ref_interp_from_grid(ref_interp) ((ref_interp)->from_grid)
 #define ref_interp_to_grid(ref_interp) ((ref_interp)->to_grid)
 #define ref_interp_mpi(ref_interp) ((ref_interp)->ref_mpi)
@@ -71,6 +91,8 @@ struct REF_INTERP_STRUCT {
   ((ref_interp)->bary[(j) + 4 * (node)])
 #define ref_interp_max(ref_interp) ((ref_interp)->max)
 #define ref_interp_continuously(ref_interp) ((ref_interp)->continuously)
+/* locate walks receptors in Morton order from the previous donor */
+#define ref_interp_ordered(ref_interp) ((ref_interp)->ordered)
 #define ref_interp_search(ref_interp) ((ref_interp)->ref_search)
 #define ref_interp_search_fuzz(ref_interp) ((ref_interp)->search_fuzz)
 #define ref_interp_search_donor_scale(ref_interp) \
@@ -101,6 +123,22 @@ REF_STATUS ref_interp_locate_between(REF_INTERP ref_interp, REF_INT node0,
 REF_STATUS ref_interp_scalar(REF_INTERP ref_interp, REF_INT leading_dim,
                              REF_DBL *from_scalar, REF_DBL *to_scalar);
 
+REF_STATUS ref_interp_plan_create(REF_INTERP_PLAN *ref_interp_plan,
+                                  REF_INTERP ref_interp);
+REF_STATUS ref_interp_plan_free(REF_INTERP_PLAN ref_interp_plan);
+REF_STATUS ref_interp_plan_apply(REF_INTERP_PLAN ref_interp_plan,
+                                 REF_INT leading_dim, REF_DBL *from_scalar,
+                                 REF_DBL *to_scalar);
+/* nfield arrays with their own leading_dim in one exchange */
+REF_STATUS ref_interp_plan_apply_fields(REF_INTERP_PLAN ref_interp_plan,
+                                        REF_INT nfield, REF_INT *leading_dim,
+                                        REF_DBL **from_scalar,
+                                        REF_DBL **to_scalar);
+/* CSR over local to nodes (ghost rows empty), columns are from globals */
+REF_STATUS ref_interp_plan_matrix(REF_INTERP_PLAN ref_interp_plan,
+                                  REF_INT **row_ptr, REF_GLOB **col,
+                                  REF_DBL **weight);
+
 REF_STATUS ref_interp_face_only(REF_INTERP ref_interp, REF_INT faceid,
                                 REF_INT leading_dim, REF_DBL *from_scalar,
                                 REF_DBL *to_scalar);
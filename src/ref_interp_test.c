@@ -1331,6 +1331,226 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(from), "free");
   }
 
+  { /* plan applied to two fields matches interp scalar, matrix rows */
+    REF_GRID from, to;
+    char even[] = "ref_interp_test_even.meshb";
+    char odd[] = "ref_interp_test_odd.meshb";
+    REF_INTERP ref_interp;
+    REF_INTERP_PLAN ref_interp_plan;
+    REF_DBL *from_xyz, *to_xyz, *from_sum, *to_sum, *expected;
+    REF_DBL *from_fields[2], *to_fields[2], *weight, total, value;
+    REF_INT ldims[2] = {3, 1};
+    REF_INT node, i, entry, local, *row_ptr;
+    REF_GLOB *col;
+
+    if (ref_mpi_once(ref_mpi)) {
+      REF_GRID ref_grid;
+
+      RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+      RSS(ref_split_edge_pattern(ref_grid, 0, 2), "split");
+      RSS(ref_export_by_extension(ref_grid, even), "export");
+      RSS(ref_grid_free(ref_grid), "free");
+
+      RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+      RSS(ref_split_edge_pattern(ref_grid, 1, 2), "split");
+      RSS(ref_export_by_extension(ref_grid, odd), "export");
+      RSS(ref_grid_free(ref_grid), "free");
+    }
+    RSS(ref_part_by_extension(&from, ref_mpi, even), "import");
+    RSS(ref_part_by_extension(&to, ref_mpi, odd), "import");
+    if (ref_mpi_once(ref_mpi)) {
+      REIS(0, remove(even), "test clean up");
+      REIS(0, remove(odd), "test clean up");
+    }
+
+    ref_malloc(from_xyz, 3 * ref_node_max(ref_grid_node(from)), REF_DBL);
+    ref_malloc(from_sum, ref_node_max(ref_grid_node(from)), REF_DBL);
+    ref_malloc_init(to_xyz, 3 * ref_node_max(ref_grid_node(to)), REF_DBL, 0.0);
+    ref_malloc_init(to_sum, ref_node_max(ref_grid_node(to)), REF_DBL, 0.0);
+    ref_malloc_init(expected, 3 * ref_node_max(ref_grid_node(to)), REF_DBL,
+                    0.0);
+    each_ref_node_valid_node(ref_grid_node(from), node) {
+      from_sum[node] = 0.0;
+      for (i = 0; i < 3; i++) {
+        from_xyz[i + 3 * node] = ref_node_xyz(ref_grid_node(from), i, node);
+        from_sum[node] += from_xyz[i + 3 * node];
+      }
+    }
+
+    RSS(ref_interp_create(&ref_interp, from, to), "make interp");
+    RSS(ref_interp_locate(ref_interp), "map");
+    RSS(ref_interp_scalar(ref_interp, 3, from_xyz, expected), "interp");
+
+    RSS(ref_interp_plan_create(&ref_interp_plan, ref_interp), "plan");
+    from_fields[0] = from_xyz;
+    from_fields[1] = from_sum;
+    to_fields[0] = to_xyz;
+    to_fields[1] = to_sum;
+    RSS(ref_interp_plan_apply_fields(ref_interp_plan, 2, ldims, from_fields,
+                                     to_fields),
+        "apply");
+    each_ref_node_valid_node(ref_grid_node(to), node) {
+      for (i = 0; i < 3; i++) {
+        RWDS(expected[i + 3 * node], to_xyz[i + 3 * node], -1, "xyz");
+      }
+      RWDS(expected[0 + 3 * node] + expected[1 + 3 * node] +
+               expected[2 + 3 * node],
+           to_sum[node], -1, "sum");
+    }
+
+    RSS(ref_interp_plan_matrix(ref_interp_plan, &row_ptr, &col, &weight),
+        "matrix");
+    each_ref_node_valid_node(ref_grid_node(to), node) {
+      if (!ref_node_owned(ref_grid_node(to), node)) {
+        REIS(row_ptr[node], row_ptr[node + 1], "ghost row not empty");
+        continue;
+      }
+      total = 0.0;
+      value = 0.0;
+      for (entry = row_ptr[node]; entry < row_ptr[node + 1]; entry++) {
+        total += weight[entry];
+        if (!ref_mpi_para(ref_mpi)) {
+          RSS(ref_node_local(ref_grid_node(from), col[entry], &local), "g2l");
+          value += weight[entry] * from_xyz[0 + 3 * local];
+        }
+      }
+      RWDS(1.0, total, -1, "weights sum to one");
+      if (!ref_mpi_para(ref_mpi))
+        RWDS(expected[0 + 3 * node], value, -1, "matrix times x");
+    }
+    ref_free(weight);
+    ref_free(col);
+    ref_free(row_ptr);
+    RSS(ref_interp_plan_free(ref_interp_plan), "free plan");
+
+    RSS(ref_interp_free(ref_interp), "free");
+    ref_free(expected);
+    ref_free(to_sum);
+    ref_free(to_xyz);
+    ref_free(from_sum);
+    ref_free(from_xyz);
+    RSS(ref_grid_free(to), "free");
+    RSS(ref_grid_free(from), "free");
+  }
+
+  { /* morton ordered receptors walk from previous donor */
+    REF_GRID from, to;
+    char even[] = "ref_interp_test_even.meshb";
+    char odd[] = "ref_interp_test_odd.meshb";
+    REF_INTERP ref_interp;
+    REF_DBL max_error, min_bary;
+    REF_INT node;
+
+    if (ref_mpi_once(ref_mpi)) {
+      REF_GRID ref_grid;
+
+      RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+      RSS(ref_split_edge_pattern(ref_grid, 0, 2), "split");
+      RSS(ref_export_by_extension(ref_grid, even), "export");
+      RSS(ref_grid_free(ref_grid), "free");
+
+      RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+      RSS(ref_split_edge_pattern(ref_grid, 1, 2), "split");
+      RSS(ref_export_by_extension(ref_grid, odd), "export");
+      RSS(ref_grid_free(ref_grid), "free");
+    }
+    RSS(ref_part_by_extension(&from, ref_mpi, even), "import");
+    RSS(ref_part_by_extension(&to, ref_mpi, odd), "import");
+    if (ref_mpi_once(ref_mpi)) {
+      REIS(0, remove(even), "test clean up");
+      REIS(0, remove(odd), "test clean up");
+    }
+    RSS(ref_interp_shift_cube_interior(ref_grid_node(to)), "shift");
+
+    RSS(ref_interp_create(&ref_interp, from, to), "make interp");
+    ref_interp_ordered(ref_interp) = REF_TRUE;
+    RSS(ref_interp_locate(ref_interp), "map");
+    each_ref_node_valid_node(ref_grid_node(to), node) {
+      if (ref_node_owned(ref_grid_node(to), node))
+        RUS(REF_EMPTY, ref_interp->cell[node], "not located");
+    }
+    if (!ref_mpi_para(ref_mpi)) {
+      REIS(66, ref_interp->n_tree, "tree count");
+      RAS(ref_interp->n_fallback <= ref_interp->n_tree, "more fallback");
+    }
+    RSS(ref_interp_min_bary(ref_interp, &min_bary), "min bary");
+    RAS(-0.241 < min_bary, "large extrapolation");
+    RSS(ref_interp_max_error(ref_interp, &max_error), "err");
+    RAS(9.0e-16 > max_error, "large interp error");
+    RSS(ref_interp_free(ref_interp), "interp free");
+
+    RSS(ref_grid_free(to), "free");
+    RSS(ref_grid_free(from), "free");
+  }
+
+  { /* threaded locate matches serial locate */
+    REF_GRID from, to;
+    char even[] = "ref_interp_test_even.meshb";
+    char odd[] = "ref_interp_test_odd.meshb";
+    REF_INTERP ref_interp;
+    REF_INT *serial_cell, *serial_part;
+    REF_DBL *serial_bary;
+    REF_INT node, i, n_walk, n_tree;
+
+    if (ref_mpi_once(ref_mpi)) {
+      REF_GRID ref_grid;
+
+      RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+      RSS(ref_split_edge_pattern(ref_grid, 0, 2), "split");
+      RSS(ref_export_by_extension(ref_grid, even), "export");
+      RSS(ref_grid_free(ref_grid), "free");
+
+      RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+      RSS(ref_split_edge_pattern(ref_grid, 1, 2), "split");
+      RSS(ref_export_by_extension(ref_grid, odd), "export");
+      RSS(ref_grid_free(ref_grid), "free");
+    }
+    RSS(ref_part_by_extension(&from, ref_mpi, even), "import");
+    RSS(ref_part_by_extension(&to, ref_mpi, odd), "import");
+    if (ref_mpi_once(ref_mpi)) {
+      REIS(0, remove(even), "test clean up");
+      REIS(0, remove(odd), "test clean up");
+    }
+    RSS(ref_interp_shift_cube_interior(ref_grid_node(to)), "shift");
+
+    RSS(ref_interp_create(&ref_interp, from, to), "make interp");
+    RSS(ref_interp_locate(ref_interp), "map");
+    ref_malloc(serial_cell, ref_node_max(ref_grid_node(to)), REF_INT);
+    ref_malloc(serial_part, ref_node_max(ref_grid_node(to)), REF_INT);
+    ref_malloc(serial_bary, 4 * ref_node_max(ref_grid_node(to)), REF_DBL);
+    for (node = 0; node < ref_node_max(ref_grid_node(to)); node++) {
+      serial_cell[node] = ref_interp->cell[node];
+      serial_part[node] = ref_interp->part[node];
+      for (i = 0; i < 4; i++)
+        serial_bary[i + 4 * node] = ref_interp->bary[i + 4 * node];
+    }
+    n_walk = ref_interp->n_walk;
+    n_tree = ref_interp->n_tree;
+    RSS(ref_interp_free(ref_interp), "interp free");
+
+    RSS(ref_mpi_threads(ref_mpi, 4), "four threads");
+    RSS(ref_interp_create(&ref_interp, from, to), "make interp");
+    RSS(ref_interp_locate(ref_interp), "map");
+    REIS(n_walk, ref_interp->n_walk, "walk count");
+    REIS(n_tree, ref_interp->n_tree, "tree count");
+    each_ref_node_valid_node(ref_grid_node(to), node) {
+      if (!ref_node_owned(ref_grid_node(to), node)) continue;
+      REIS(serial_cell[node], ref_interp->cell[node], "cell");
+      REIS(serial_part[node], ref_interp->part[node], "part");
+      for (i = 0; i < 4; i++)
+        RWDS(serial_bary[i + 4 * node], ref_interp->bary[i + 4 * node], -1,
+             "bary");
+    }
+    RSS(ref_interp_free(ref_interp), "interp free");
+    RSS(ref_mpi_threads(ref_mpi, 1), "one thread");
+
+    ref_free(serial_bary);
+    ref_free(serial_part);
+    ref_free(serial_cell);
+    RSS(ref_grid_free(to), "free");
+    RSS(ref_grid_free(from), "free");
+  }
+
   { /* integrate scalar */
     char grid[] = "ref_interp_test.meshb";
     REF_GRID ref_grid;
@@ -23,6 +23,24 @@
 
 #include "ref_malloc.h"
 
+/* below this length a linear contains scan is faster than hashing */
+#define REF_LIST_HASH_MIN (32)
+
+static REF_STATUS ref_list_count(REF_LIST ref_list, REF_INT item,
+                                 REF_INT delta) {
+  REF_INT count;
+  if (NULL == ref_list->counts) return REF_SUCCESS;
+  count = 0;
+  (void)ref_hash_value(ref_list->counts, item, &count);
+  count += delta;
+  if (0 < count) {
+    RSS(ref_hash_store(ref_list->counts, item, count), "store");
+  } else {
+    RSS(ref_hash_remove(ref_list->counts, item), "remove");
+  }
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_list_create(REF_LIST *ref_list_ptr) {
   REF_LIST ref_list;
 
@@ -34,12 +52,14 @@ REF_STATUS ref_list_create(REF_LIST *ref_list_ptr) {
   ref_list_max(ref_list) = 10;
 
   ref_malloc(ref_list->value, ref_list_max(ref_list), REF_INT);
+  ref_list->counts = NULL;
 
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_list_free(REF_LIST ref_list) {
   if (NULL == (void *)ref_list) return REF_NULL;
+  if (NULL != ref_list->counts) RSS(ref_hash_free(ref_list->counts), "hash");
   ref_free(ref_list->value);
   ref_free(ref_list);
   return REF_SUCCESS;
@@ -58,6 +78,7 @@ REF_STATUS ref_list_deep_copy(REF_LIST *ref_list_ptr, REF_LIST original) {
   ref_malloc(ref_list->value, ref_list_max(ref_list), REF_INT);
   for (i = 0; i < ref_list_n(ref_list); i++)
     ref_list->value[i] = original->value[i];
+  ref_list->counts = NULL;
 
   return REF_SUCCESS;
 }
@@ -84,6 +105,8 @@ REF_STATUS ref_list_push(REF_LIST ref_list, REF_INT last) {
 
   ref_list_n(ref_list)++;
 
+  RSS(ref_list_count(ref_list, last, 1), "count");
+
   return REF_SUCCESS;
 }
 
@@ -96,6 +119,8 @@ REF_STATUS ref_list_pop(REF_LIST ref_list, REF_INT *last) {
   ref_list_n(ref_list)--;
   *last = ref_list->value[ref_list_n(ref_list)];
 
+  RSS(ref_list_count(ref_list, *last, -1), "count");
+
   return REF_SUCCESS;
 }
 
@@ -112,6 +137,8 @@ REF_STATUS ref_list_shift(REF_LIST ref_list, REF_INT *first) {
   for (i = 0; i < ref_list_n(ref_list); i++)
     ref_list->value[i] = ref_list->value[i + 1];
 
+  RSS(ref_list_count(ref_list, *first, -1), "count");
+
   return REF_SUCCESS;
 }
 
@@ -128,6 +155,8 @@ REF_STATUS ref_list_delete(REF_LIST ref_list, REF_INT item) {
 
   if (to == ref_list_n(ref_list)) return REF_NOT_FOUND;
 
+  RSS(ref_list_count(ref_list, item, to - ref_list_n(ref_list)), "count");
+
   ref_list_n(ref_list) = to;
 
   return REF_SUCCESS;
@@ -135,6 +164,7 @@ REF_STATUS ref_list_delete(REF_LIST ref_list, REF_INT item) {
 
 REF_STATUS ref_list_erase(REF_LIST ref_list) {
   ref_list_n(ref_list) = 0;
+  if (NULL != ref_list->counts) RSS(ref_hash_clear(ref_list->counts), "clear");
 
   return REF_SUCCESS;
 }
@@ -145,6 +175,17 @@ REF_STATUS ref_list_contains(REF_LIST ref_list, REF_INT item,
 
   *contains = REF_FALSE;
 
+  if (NULL == ref_list->counts && REF_LIST_HASH_MIN < ref_list_n(ref_list)) {
+    RSS(ref_hash_create(&(ref_list->counts)), "create");
+    RSS(ref_hash_reserve(ref_list->counts, ref_list_n(ref_list)), "reserve");
+    for (i = 0; i < ref_list_n(ref_list); i++)
+      RSS(ref_list_count(ref_list, ref_list->value[i], 1), "count");
+  }
+  if (NULL != ref_list->counts) {
+    *contains = ref_hash_has_key(ref_list->counts, item);
+    return REF_SUCCESS;
+  }
+
   for (i = 0; i < ref_list_n(ref_list); i++)
     if (ref_list->value[i] == item) {
       *contains = REF_TRUE;
@@ -20,6 +20,7 @@
 #define REF_LIST_H
 
 #include "ref_defs.h"
+#include "ref_hash.h"
 
 BEGIN_C_DECLORATION
 typedef struct REF_LIST_STRUCT REF_LIST_STRUCT;
@@ -27,9 +28,11 @@ typedef REF_LIST_STRUCT *REF_LIST;
 END_C_DECLORATION
 
 BEGIN_C_DECLORATION
+/* counts of each value, built by the first contains on a long list */
 struct REF_LIST_STRUCT {
   REF_INT n, max;
   REF_INT *value;
+  REF_HASH counts;
 };
 
 REF_STATUS ref_list_create(REF_LIST *ref_list);
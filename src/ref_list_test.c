@@ -135,6 +135,38 @@ int main(int argc, char *argv[]) {
     RSS(ref_list_free(ref_list), "free");
   }
 
+  { /* contains on a long list tracks push, pop, shift, delete */
+    REF_INT item;
+    REF_BOOL contains;
+    RSS(ref_list_create(&ref_list), "create");
+    for (item = 0; item < 100; item++) {
+      RSS(ref_list_push(ref_list, item), "add");
+    }
+    RSS(ref_list_push(ref_list, 50), "add twice");
+    RSS(ref_list_contains(ref_list, 99, &contains), "have");
+    REIS(REF_TRUE, contains, "does have");
+    RSS(ref_list_pop(ref_list, &item), "pop");
+    RSS(ref_list_pop(ref_list, &item), "pop");
+    REIS(99, item, "popped");
+    RSS(ref_list_contains(ref_list, 99, &contains), "have");
+    REIS(REF_FALSE, contains, "popped");
+    RSS(ref_list_contains(ref_list, 50, &contains), "have");
+    REIS(REF_TRUE, contains, "one of two left");
+    RSS(ref_list_shift(ref_list, &item), "shift");
+    RSS(ref_list_contains(ref_list, 0, &contains), "have");
+    REIS(REF_FALSE, contains, "shifted");
+    RSS(ref_list_delete(ref_list, 7), "delete");
+    RSS(ref_list_contains(ref_list, 7, &contains), "have");
+    REIS(REF_FALSE, contains, "deleted");
+    RSS(ref_list_push(ref_list, 7), "add");
+    RSS(ref_list_contains(ref_list, 7, &contains), "have");
+    REIS(REF_TRUE, contains, "pushed back");
+    RSS(ref_list_erase(ref_list), "erase");
+    RSS(ref_list_contains(ref_list, 7, &contains), "have");
+    REIS(REF_FALSE, contains, "erased");
+    RSS(ref_list_free(ref_list), "free");
+  }
+
   RSS(ref_mpi_free(ref_mpi), "mpi free");
   RSS(ref_mpi_stop(), "stop");
 
@@ -414,6 +414,7 @@ REF_STATUS ref_meshlink_mapbc(REF_GRID ref_grid, const char *mapbc_name) {
                        ref_geom_id(ref_geom, geom)),
         "mark all face assoc with id");
   }
+  RSS(ref_dict_sort(ref_dict), "sort faceids");
 
   file = fopen(mapbc_name, "w");
   if (NULL == (void *)file) printf("unable to open %s\n", mapbc_name);
@@ -479,6 +480,7 @@ REF_STATUS ref_meshlink_constrain(REF_GRID ref_grid, REF_INT node) {
                                 uv, entity_name, REF_MESHLINK_MAX_STRING_SIZE),
            "info");
 
+      RSS(ref_node_index_invalidate(ref_node), "moved");
       ref_node_xyz(ref_node, 0, node) = projected_point[0];
       ref_node_xyz(ref_node, 1, node) = projected_point[1];
       ref_node_xyz(ref_node, 2, node) = projected_point[2];
@@ -509,6 +511,7 @@ REF_STATUS ref_meshlink_constrain(REF_GRID ref_grid, REF_INT node) {
             ML_getProjectionInfo(geom_kernel, projection_data, projected_point,
                                  uv, entity_name, REF_MESHLINK_MAX_STRING_SIZE),
             "info");
+        RSS(ref_node_index_invalidate(ref_node), "moved");
         ref_node_xyz(ref_node, 0, node) = projected_point[0];
         ref_node_xyz(ref_node, 1, node) = projected_point[1];
         ref_node_xyz(ref_node, 2, node) = projected_point[2];
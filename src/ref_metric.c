@@ -36,8 +36,211 @@
 #include "ref_node.h"
 #include "ref_phys.h"
 #include "ref_sort.h"
+#include "ref_surrogate.h"
 
 #define REF_METRIC_MAX_DEGREE (1000)
+/* equations reconstructed together, bounds the opt goal workspace */
+#define REF_METRIC_OPT_GOAL_CHUNK (8)
+
+REF_STATUS ref_metric_pipe_create(REF_METRIC_PIPE *ref_metric_pipe_ptr) {
+  REF_METRIC_PIPE ref_metric_pipe;
+
+  ref_malloc(*ref_metric_pipe_ptr, 1, REF_METRIC_PIPE_STRUCT);
+  ref_metric_pipe = (*ref_metric_pipe_ptr);
+  ref_metric_pipe->n = 0;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_metric_pipe_free(REF_METRIC_PIPE ref_metric_pipe) {
+  if (NULL == (void *)ref_metric_pipe) return REF_NULL;
+  ref_free(ref_metric_pipe);
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_metric_pipe_add(REF_METRIC_PIPE ref_metric_pipe,
+                               REF_METRIC_STAGE_TYPE type, REF_DBL param0,
+                               REF_DBL param1, REF_DBL *field) {
+  REF_INT stage = ref_metric_pipe->n;
+  RAS(stage < REF_METRIC_PIPE_MAX_STAGE, "too many stages");
+  RAS(0 <= (REF_INT)type && type < REF_METRIC_STAGE_LAST, "stage type");
+  ref_metric_pipe->type[stage] = type;
+  ref_metric_pipe->param[0 + 2 * stage] = param0;
+  ref_metric_pipe->param[1 + 2 * stage] = param1;
+  ref_metric_pipe->field[stage] = field;
+  ref_metric_pipe->n++;
+  return REF_SUCCESS;
+}
+
+static REF_DBL ref_metric_buffer_hmin(REF_NODE ref_node, REF_INT node,
+                                      REF_DBL rmax, REF_DBL xmax) {
+  REF_DBL r, exponent, s, t, smin, smax, emin, emax;
+
+  r = sqrt(ref_node_xyz(ref_node, 0, node) * ref_node_xyz(ref_node, 0, node) +
+           ref_node_xyz(ref_node, 1, node) * ref_node_xyz(ref_node, 1, node) +
+           ref_node_xyz(ref_node, 2, node) * ref_node_xyz(ref_node, 2, node));
+
+  smin = 0.5;
+  smax = 0.9;
+  emin = -4.0;
+  emax = -1.0;
+
+  s = MIN(1.0, r / xmax);
+
+  t = MIN(s / smin, 1.0);
+  exponent = -15.0 * (1.0 - t) + emin * t;
+
+  if (smin < s && s < smax) {
+    t = (s - smin) / (smax - smin);
+    exponent = (emin) * (1.0 - t) + (emax) * (t);
+  }
+
+  if (smax <= s) {
+    exponent = emax;
+  }
+
+  return rmax * pow(10.0, exponent);
+}
+
+/* consecutive eigenvalue stages share one decomposition */
+static REF_STATUS ref_metric_pipe_node(REF_METRIC_PIPE ref_metric_pipe,
+                                       REF_GRID ref_grid, REF_INT node,
+                                       REF_DBL *m) {
+  REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_BOOL twod = ref_grid_twod(ref_grid);
+  REF_DBL diag_system[12];
+  REF_BOOL diag = REF_FALSE;
+  REF_INT stage, i;
+  REF_DBL *param, det, eig, eig_floor, eig_ceiling, hmin;
+
+  for (stage = 0; stage < ref_metric_pipe->n; stage++) {
+    param = &(ref_metric_pipe->param[2 * stage]);
+    switch (ref_metric_pipe->type[stage]) {
+      case REF_METRIC_STAGE_ROUNDOFF:
+      case REF_METRIC_STAGE_LIMIT_H:
+      case REF_METRIC_STAGE_BUFFER:
+        if (!diag) RSS(ref_matrix_diag_m(m, diag_system), "eigen decomp");
+        diag = REF_TRUE;
+        break;
+      case REF_METRIC_STAGE_TWOD:
+      case REF_METRIC_STAGE_LOCAL_SCALE:
+      case REF_METRIC_STAGE_WEIGHT:
+      case REF_METRIC_STAGE_SCALE:
+      case REF_METRIC_STAGE_LAST:
+        if (diag) RSS(ref_matrix_form_m(diag_system, m), "reform m");
+        diag = REF_FALSE;
+        break;
+    }
+    eig_floor = 0.0;
+    eig_ceiling = -1.0;
+    switch (ref_metric_pipe->type[stage]) {
+      case REF_METRIC_STAGE_TWOD:
+        if (twod) {
+          m[2] = 0.0;
+          m[4] = 0.0;
+          m[5] = 1.0;
+        }
+        break;
+      case REF_METRIC_STAGE_ROUNDOFF:
+        RSS(ref_recon_roundoff_floor(ref_grid, node, &eig_floor), "eig_floor");
+        break;
+      case REF_METRIC_STAGE_LOCAL_SCALE:
+        RSS(ref_matrix_det_m(m, &det), "det_m local hess scale");
+        if (det > 0.0) {
+          eig = pow(det, -1.0 / ((REF_DBL)(2 * (REF_INT)param[0] +
+                                           (twod ? 2 : 3))));
+          for (i = 0; i < 6; i++) m[i] *= eig;
+        }
+        break;
+      case REF_METRIC_STAGE_WEIGHT:
+        /* weight in now length scale, convert to eigenvalue */
+        eig = ref_metric_pipe->field[stage][node];
+        if (eig > 0.0) {
+          for (i = 0; i < 6; i++) m[i] /= (eig * eig);
+        }
+        break;
+      case REF_METRIC_STAGE_SCALE:
+        for (i = 0; i < 6; i++) m[i] *= param[0];
+        break;
+      case REF_METRIC_STAGE_LIMIT_H:
+        if (param[0] > 0.0) eig_ceiling = 1.0 / (param[0] * param[0]);
+        if (param[1] > 0.0) eig_floor = 1.0 / (param[1] * param[1]);
+        break;
+      case REF_METRIC_STAGE_BUFFER:
+        hmin = ref_metric_buffer_hmin(ref_node, node, param[0], param[1]);
+        if (ref_math_divisible(1.0, hmin * hmin))
+          eig_ceiling = 1.0 / (hmin * hmin);
+        break;
+      case REF_METRIC_STAGE_LAST:
+        THROW("stage type");
+    }
+    if (diag && eig_ceiling > 0.0) {
+      for (i = 0; i < 3; i++)
+        ref_matrix_eig(diag_system, i) =
+            MIN(ref_matrix_eig(diag_system, i), eig_ceiling);
+    }
+    if (diag && eig_floor > 0.0) {
+      for (i = 0; i < 3; i++)
+        ref_matrix_eig(diag_system, i) =
+            MAX(ref_matrix_eig(diag_system, i), eig_floor);
+    }
+  }
+  if (diag) RSS(ref_matrix_form_m(diag_system, m), "reform m");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_metric_pipe_sweep(REF_METRIC_PIPE ref_metric_pipe,
+                                 REF_DBL *metric, REF_GRID ref_grid) {
+  REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_BOOL local = REF_TRUE;
+  REF_INT stage, node;
+  REF_STATUS status;
+
+  for (stage = 0; stage < ref_metric_pipe->n; stage++) {
+    if (REF_METRIC_STAGE_ROUNDOFF == ref_metric_pipe->type[stage])
+      local = REF_FALSE;
+  }
+
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_grid_mpi(ref_grid))) \
+    schedule(static) reduction(max : status)
+#endif
+  for (node = 0; node < ref_node_max(ref_node); node++) {
+    if (!ref_node_valid(ref_node, node)) continue;
+    if (REF_SUCCESS !=
+        ref_metric_pipe_node(ref_metric_pipe, ref_grid, node,
+                             &(metric[6 * node])))
+      status = REF_FAILURE;
+  }
+  RSS(status, "pipe stages");
+
+  /* ghost stencils are incomplete, take the owner value */
+  if (!local) RSS(ref_node_ghost_dbl(ref_node, metric, 6), "update ghosts");
+
+  return REF_SUCCESS;
+}
+
+/* local scaling with optional length scale weight */
+static REF_STATUS ref_metric_pipe_local_scale(REF_METRIC_PIPE ref_metric_pipe,
+                                              REF_DBL *weight,
+                                              REF_INT p_norm) {
+  RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_TWOD, 0.0, 0.0,
+                          NULL),
+      "twod");
+  RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_LOCAL_SCALE,
+                          (REF_DBL)p_norm, 0.0, NULL),
+      "local scale");
+  RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_TWOD, 0.0, 0.0,
+                          NULL),
+      "twod");
+  if (NULL != weight)
+    RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_WEIGHT, 0.0, 0.0,
+                            weight),
+        "weight");
+  return REF_SUCCESS;
+}
 
 REF_STATUS ref_metric_show(REF_DBL *m) {
   printf(" %18.10e %18.10e %18.10e\n", m[0], m[1], m[2]);
@@ -526,102 +729,29 @@ REF_STATUS ref_metric_interpolate(REF_INTERP ref_interp) {
   REF_GRID from_grid = ref_interp_from_grid(ref_interp);
   REF_NODE to_node = ref_grid_node(to_grid);
   REF_NODE from_node = ref_grid_node(from_grid);
-  REF_MPI ref_mpi = ref_interp_mpi(ref_interp);
-  REF_CELL from_cell = ref_grid_tet(from_grid);
-  REF_INT node, ibary, im;
-  REF_INT nodes[REF_CELL_MAX_SIZE_PER];
-  REF_DBL log_parent_m[4][6];
-  REF_INT receptor, n_recept, donation, n_donor;
-  REF_DBL *recept_log_m, *donor_log_m, *recept_bary, *donor_bary;
-  REF_INT *donor_node, *donor_ret, *donor_cell;
-  REF_INT *recept_proc, *recept_ret, *recept_node, *recept_cell;
-
-  if (ref_grid_twod(from_grid)) from_cell = ref_grid_tri(from_grid);
+  REF_INTERP_PLAN ref_interp_plan;
+  REF_INT node;
+  REF_DBL *from_log_m, *to_log_m;
 
-  n_recept = 0;
-  each_ref_node_valid_node(to_node, node) {
-    if (ref_node_owned(to_node, node)) {
-      n_recept++;
-    }
+  ref_malloc_init(from_log_m, 6 * ref_node_max(from_node), REF_DBL, 0.0);
+  each_ref_node_valid_node(from_node, node) {
+    RSS(ref_node_metric_get_log(from_node, node, &(from_log_m[6 * node])),
+        "log(parentM)");
   }
+  ref_malloc_init(to_log_m, 6 * ref_node_max(to_node), REF_DBL, 0.0);
 
-  ref_malloc(recept_bary, 4 * n_recept, REF_DBL);
-  ref_malloc(recept_cell, n_recept, REF_INT);
-  ref_malloc(recept_node, n_recept, REF_INT);
-  ref_malloc(recept_ret, n_recept, REF_INT);
-  ref_malloc(recept_proc, n_recept, REF_INT);
+  RSS(ref_interp_plan_create(&ref_interp_plan, ref_interp), "plan");
+  RSS(ref_interp_plan_apply(ref_interp_plan, 6, from_log_m, to_log_m),
+      "apply");
+  RSS(ref_interp_plan_free(ref_interp_plan), "free plan");
 
-  n_recept = 0;
   each_ref_node_valid_node(to_node, node) {
-    if (ref_node_owned(to_node, node)) {
-      RUS(REF_EMPTY, ref_interp->cell[node], "node needs to be localized");
-      RSS(ref_node_clip_bary4(&(ref_interp->bary[4 * node]),
-                              &(recept_bary[4 * n_recept])),
-          "clip");
-      recept_proc[n_recept] = ref_interp->part[node];
-      recept_cell[n_recept] = ref_interp->cell[node];
-      recept_node[n_recept] = node;
-      recept_ret[n_recept] = ref_mpi_rank(ref_mpi);
-      n_recept++;
-    }
-  }
-
-  RSS(ref_mpi_blindsend(ref_mpi, recept_proc, (void *)recept_cell, 1, n_recept,
-                        (void **)(&donor_cell), &n_donor, REF_INT_TYPE),
-      "blind send cell");
-  RSS(ref_mpi_blindsend(ref_mpi, recept_proc, (void *)recept_ret, 1, n_recept,
-                        (void **)(&donor_ret), &n_donor, REF_INT_TYPE),
-      "blind send ret");
-  RSS(ref_mpi_blindsend(ref_mpi, recept_proc, (void *)recept_node, 1, n_recept,
-                        (void **)(&donor_node), &n_donor, REF_INT_TYPE),
-      "blind send node");
-  RSS(ref_mpi_blindsend(ref_mpi, recept_proc, (void *)recept_bary, 4, n_recept,
-                        (void **)(&donor_bary), &n_donor, REF_DBL_TYPE),
-      "blind send bary");
-
-  ref_free(recept_proc);
-  ref_free(recept_ret);
-  ref_free(recept_node);
-  ref_free(recept_cell);
-  ref_free(recept_bary);
-
-  ref_malloc(donor_log_m, 6 * n_donor, REF_DBL);
-
-  for (donation = 0; donation < n_donor; donation++) {
-    RSS(ref_cell_nodes(from_cell, donor_cell[donation], nodes),
-        "node needs to be localized");
-    for (ibary = 0; ibary < 4; ibary++)
-      RSS(ref_node_metric_get_log(from_node, nodes[ibary], log_parent_m[ibary]),
-          "log(parentM)");
-    for (im = 0; im < 6; im++) {
-      donor_log_m[im + 6 * donation] = 0.0;
-      for (ibary = 0; ibary < 4; ibary++) {
-        donor_log_m[im + 6 * donation] +=
-            donor_bary[ibary + 4 * donation] * log_parent_m[ibary][im];
-      }
-    }
-  }
-  ref_free(donor_cell);
-  ref_free(donor_bary);
-
-  RSS(ref_mpi_blindsend(ref_mpi, donor_ret, (void *)donor_log_m, 6, n_donor,
-                        (void **)(&recept_log_m), &n_recept, REF_DBL_TYPE),
-      "blind send bary");
-  RSS(ref_mpi_blindsend(ref_mpi, donor_ret, (void *)donor_node, 1, n_donor,
-                        (void **)(&recept_node), &n_recept, REF_INT_TYPE),
-      "blind send node");
-  ref_free(donor_log_m);
-  ref_free(donor_node);
-  ref_free(donor_ret);
-
-  for (receptor = 0; receptor < n_recept; receptor++) {
-    node = recept_node[receptor];
-    RSS(ref_node_metric_set_log(to_node, node, &(recept_log_m[6 * receptor])),
+    RSS(ref_node_metric_set_log(to_node, node, &(to_log_m[6 * node])),
         "set received log met");
   }
 
-  ref_free(recept_node);
-  ref_free(recept_log_m);
+  ref_free(to_log_m);
+  ref_free(from_log_m);
 
   return REF_SUCCESS;
 }
@@ -673,7 +803,8 @@ REF_STATUS ref_metric_metric_space_gradation(REF_DBL *metric, REF_GRID ref_grid,
 
   RSS(ref_edge_create(&ref_edge, ref_grid), "orig edges");
 
-  ref_malloc(metric_orig, 6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+  ref_arena_malloc(ref_grid_arena(ref_grid), metric_orig,
+                   6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
 
   each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
     for (i = 0; i < 6; i++) metric_orig[i + 6 * node] = metric[i + 6 * node];
@@ -733,7 +864,7 @@ REF_STATUS ref_metric_metric_space_gradation(REF_DBL *metric, REF_GRID ref_grid,
     }
   }
 
-  ref_free(metric_orig);
+  ref_arena_release(ref_grid_arena(ref_grid), metric_orig);
 
   ref_edge_free(ref_edge);
 
@@ -742,8 +873,9 @@ REF_STATUS ref_metric_metric_space_gradation(REF_DBL *metric, REF_GRID ref_grid,
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_metric_mixed_space_gradation(REF_DBL *metric, REF_GRID ref_grid,
-                                            REF_DBL r, REF_DBL t) {
+static REF_STATUS ref_metric_mixed_space_gradation_frames(REF_DBL *metric,
+                                                         REF_GRID ref_grid,
+                                                         REF_DBL r, REF_DBL t) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_EDGE ref_edge;
   REF_DBL *metric_orig;
@@ -762,7 +894,8 @@ REF_STATUS ref_metric_mixed_space_gradation(REF_DBL *metric, REF_GRID ref_grid,
 
   RSS(ref_edge_create(&ref_edge, ref_grid), "orig edges");
 
-  ref_malloc(metric_orig, 6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+  ref_arena_malloc(ref_grid_arena(ref_grid), metric_orig,
+                   6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
 
   each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
     for (i = 0; i < 6; i++) metric_orig[i + 6 * node] = metric[i + 6 * node];
@@ -827,7 +960,7 @@ REF_STATUS ref_metric_mixed_space_gradation(REF_DBL *metric, REF_GRID ref_grid,
     }
   }
 
-  ref_free(metric_orig);
+  ref_arena_release(ref_grid_arena(ref_grid), metric_orig);
 
   ref_edge_free(ref_edge);
 
@@ -836,37 +969,26 @@ REF_STATUS ref_metric_mixed_space_gradation(REF_DBL *metric, REF_GRID ref_grid,
   return REF_SUCCESS;
 }
 
+REF_STATUS ref_metric_mixed_space_gradation(REF_DBL *metric, REF_GRID ref_grid,
+                                            REF_DBL r, REF_DBL t) {
+  REF_ARENA ref_arena = ref_grid_arena(ref_grid);
+  REF_INT mark;
+  RSS(ref_arena_mark(ref_arena, &mark), "mark");
+  RSB(ref_metric_mixed_space_gradation_frames(metric, ref_grid, r, t),
+      "mixed gradation", { ref_arena_unwind(ref_arena, mark); });
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_metric_gradation_at_complexity(REF_DBL *metric,
                                               REF_GRID ref_grid,
                                               REF_DBL gradation,
                                               REF_DBL complexity) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_INT relaxations;
-  REF_DBL current_complexity;
-  REF_DBL complexity_scale;
-  REF_INT node, i;
-
-  complexity_scale = 2.0 / 3.0;
-  if (ref_grid_twod(ref_grid)) {
-    complexity_scale = 1.0;
-  }
+  REF_INT node;
 
   for (relaxations = 0; relaxations < 20; relaxations++) {
-    RSS(ref_metric_complexity(metric, ref_grid, &current_complexity), "cmp");
-    if (!ref_math_divisible(complexity, current_complexity)) {
-      return REF_DIV_ZERO;
-    }
-    each_ref_node_valid_node(ref_node, node) {
-      for (i = 0; i < 6; i++) {
-        metric[i + 6 * node] *=
-            pow(complexity / current_complexity, complexity_scale);
-      }
-      if (ref_grid_twod(ref_grid)) {
-        metric[2 + 6 * node] = 0.0;
-        metric[4 + 6 * node] = 0.0;
-        metric[5 + 6 * node] = 1.0;
-      }
-    }
+    RAISE(ref_metric_set_complexity(metric, ref_grid, complexity));
     if (gradation < 1.0) {
       RSS(ref_metric_mixed_space_gradation(metric, ref_grid, -1.0, -1.0),
           "gradation");
@@ -882,21 +1004,7 @@ REF_STATUS ref_metric_gradation_at_complexity(REF_DBL *metric,
       }
     }
   }
-  RSS(ref_metric_complexity(metric, ref_grid, &current_complexity), "cmp");
-  if (!ref_math_divisible(complexity, current_complexity)) {
-    return REF_DIV_ZERO;
-  }
-  each_ref_node_valid_node(ref_node, node) {
-    for (i = 0; i < 6; i++) {
-      metric[i + 6 * node] *=
-          pow(complexity / current_complexity, complexity_scale);
-    }
-    if (ref_grid_twod(ref_grid)) {
-      metric[2 + 6 * node] = 0.0;
-      metric[4 + 6 * node] = 0.0;
-      metric[5 + 6 * node] = 1.0;
-    }
-  }
+  RAISE(ref_metric_set_complexity(metric, ref_grid, complexity));
 
   return REF_SUCCESS;
 }
@@ -1033,7 +1141,7 @@ REF_STATUS ref_metric_from_curvature(REF_DBL *metric, REF_GRID ref_grid) {
 
   if (ref_geom_model_loaded(ref_geom)) {
     RSS(ref_egads_diagonal(ref_geom, REF_EMPTY, &hmax), "egads bbox diag");
-  } else if (ref_geom_meshlinked(ref_geom)) {
+  } else if (ref_geom_meshlinked(ref_geom) || ref_geom_surrogated(ref_geom)) {
     RSS(ref_node_bounding_box_diagonal(ref_node, &hmax), "bbox diag");
   } else {
     printf("\nNo geometry model, did you forget to load it?\n\n");
@@ -1086,6 +1194,12 @@ REF_STATUS ref_metric_from_curvature(REF_DBL *metric, REF_GRID ref_grid) {
       } else if (ref_geom_meshlinked(ref_geom)) {
         RSS(ref_meshlink_face_curvature(ref_grid, geom, &kr, r, &ks, s),
             "curve");
+      } else if (ref_geom_surrogated(ref_geom)) {
+        RSS(ref_surrogate_face_curvature((REF_SURROGATE)(ref_geom->surrogate),
+                                         ref_geom_id(ref_geom, geom),
+                                         &(ref_geom_param(ref_geom, 0, geom)),
+                                         &kr, r, &ks, s),
+            "curve");
       } else {
         continue;
       }
@@ -1147,6 +1261,12 @@ REF_STATUS ref_metric_from_curvature(REF_DBL *metric, REF_GRID ref_grid) {
         RSS(ref_egads_edge_curvature(ref_geom, geom, &kr, r), "curve");
       } else if (ref_geom_meshlinked(ref_geom)) {
         RSS(ref_meshlink_edge_curvature(ref_grid, geom, &kr, r), "curve");
+      } else if (ref_geom_surrogated(ref_geom)) {
+        RSS(ref_surrogate_edge_curvature((REF_SURROGATE)(ref_geom->surrogate),
+                                         ref_geom_id(ref_geom, geom),
+                                         &(ref_geom_param(ref_geom, 0, geom)),
+                                         &kr, r),
+            "curve");
       } else {
         continue;
       }
@@ -1517,26 +1637,53 @@ REF_STATUS ref_metric_complexity(REF_DBL *metric, REF_GRID ref_grid,
                                  REF_DBL *complexity) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_CELL ref_cell = ref_grid_tet(ref_grid);
-  REF_INT cell_node, cell, nodes[REF_CELL_MAX_SIZE_PER];
-  REF_DBL volume, det;
+  REF_INT cell_node, cell, node, nodes[REF_CELL_MAX_SIZE_PER];
+  REF_DBL volume, det, *density, total;
+  REF_STATUS status;
   if (ref_grid_twod(ref_grid)) ref_cell = ref_grid_tri(ref_grid);
-  *complexity = 0.0;
-  each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
+
+  /* one determinant per node, not per cell corner */
+  ref_malloc(density, ref_node_max(ref_node), REF_DBL);
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_grid_mpi(ref_grid))) \
+    schedule(static) private(det) reduction(max : status)
+#endif
+  for (node = 0; node < ref_node_max(ref_node); node++) {
+    density[node] = 0.0;
+    if (!ref_node_valid(ref_node, node) || !ref_node_owned(ref_node, node))
+      continue;
+    if (REF_SUCCESS != ref_matrix_det_m(&(metric[6 * node]), &det)) {
+      status = REF_FAILURE;
+      continue;
+    }
+    if (det > 0.0) density[node] = sqrt(det);
+  }
+  RSS(status, "det");
+
+  total = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_grid_mpi(ref_grid))) \
+    schedule(static) private(nodes, volume, cell_node)                      \
+    reduction(+ : total) reduction(max : status)
+#endif
+  for (cell = 0; cell < ref_cell_max(ref_cell); cell++) {
+    if (REF_SUCCESS != ref_cell_nodes(ref_cell, cell, nodes)) continue;
     if (ref_grid_twod(ref_grid)) {
-      RSS(ref_node_tri_area(ref_node, nodes, &volume), "area");
+      if (REF_SUCCESS != ref_node_tri_area(ref_node, nodes, &volume))
+        status = REF_FAILURE;
     } else {
-      RSS(ref_node_tet_vol(ref_node, nodes, &volume), "vol");
+      if (REF_SUCCESS != ref_node_tet_vol(ref_node, nodes, &volume))
+        status = REF_FAILURE;
     }
     for (cell_node = 0; cell_node < ref_cell_node_per(ref_cell); cell_node++) {
-      if (ref_node_owned(ref_node, nodes[cell_node])) {
-        RSS(ref_matrix_det_m(&(metric[6 * nodes[cell_node]]), &det), "det");
-        if (det > 0.0) {
-          (*complexity) +=
-              sqrt(det) * volume / ((REF_DBL)ref_cell_node_per(ref_cell));
-        }
-      }
+      total += density[nodes[cell_node]] * volume /
+               ((REF_DBL)ref_cell_node_per(ref_cell));
     }
   }
+  RSS(status, "vol");
+  ref_free(density);
+  *complexity = total;
   RSS(ref_mpi_allsum(ref_grid_mpi(ref_grid), complexity, 1, REF_DBL_TYPE),
       "dbl sum");
 
@@ -1545,8 +1692,7 @@ REF_STATUS ref_metric_complexity(REF_DBL *metric, REF_GRID ref_grid,
 
 REF_STATUS ref_metric_set_complexity(REF_DBL *metric, REF_GRID ref_grid,
                                      REF_DBL target_complexity) {
-  REF_NODE ref_node = ref_grid_node(ref_grid);
-  REF_INT i, node;
+  REF_METRIC_PIPE ref_metric_pipe;
   REF_DBL current_complexity;
   REF_DBL complexity_scale;
 
@@ -1559,50 +1705,38 @@ REF_STATUS ref_metric_set_complexity(REF_DBL *metric, REF_GRID ref_grid,
   if (!ref_math_divisible(target_complexity, current_complexity)) {
     return REF_DIV_ZERO;
   }
-  each_ref_node_valid_node(ref_node, node) {
-    for (i = 0; i < 6; i++) {
-      metric[i + 6 * node] *=
-          pow(target_complexity / current_complexity, complexity_scale);
-    }
-    if (ref_grid_twod(ref_grid)) {
-      metric[2 + 6 * node] = 0.0;
-      metric[4 + 6 * node] = 0.0;
-      metric[5 + 6 * node] = 1.0;
-    }
-  }
+  RSS(ref_metric_pipe_create(&ref_metric_pipe), "pipe");
+  RSS(ref_metric_pipe_add(
+          ref_metric_pipe, REF_METRIC_STAGE_SCALE,
+          pow(target_complexity / current_complexity, complexity_scale), 0.0,
+          NULL),
+      "scale");
+  RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_TWOD, 0.0, 0.0,
+                          NULL),
+      "twod");
+  RSS(ref_metric_pipe_sweep(ref_metric_pipe, metric, ref_grid), "sweep");
+  RSS(ref_metric_pipe_free(ref_metric_pipe), "pipe");
 
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_metric_limit_h(REF_DBL *metric, REF_GRID ref_grid, REF_DBL hmin,
                               REF_DBL hmax) {
-  REF_DBL diag_system[12];
-  REF_DBL eig;
-  REF_INT node;
-  each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
-    RSS(ref_matrix_diag_m(&(metric[6 * node]), diag_system), "eigen decomp");
-    if (hmin > 0.0) {
-      eig = 1.0 / (hmin * hmin);
-      ref_matrix_eig(diag_system, 0) = MIN(ref_matrix_eig(diag_system, 0), eig);
-      ref_matrix_eig(diag_system, 1) = MIN(ref_matrix_eig(diag_system, 1), eig);
-      ref_matrix_eig(diag_system, 2) = MIN(ref_matrix_eig(diag_system, 2), eig);
-    }
-    if (hmax > 0.0) {
-      eig = 1.0 / (hmax * hmax);
-      ref_matrix_eig(diag_system, 0) = MAX(ref_matrix_eig(diag_system, 0), eig);
-      ref_matrix_eig(diag_system, 1) = MAX(ref_matrix_eig(diag_system, 1), eig);
-      ref_matrix_eig(diag_system, 2) = MAX(ref_matrix_eig(diag_system, 2), eig);
-    }
-    RSS(ref_matrix_form_m(diag_system, &(metric[6 * node])), "reform m");
-  }
+  REF_METRIC_PIPE ref_metric_pipe;
+  RSS(ref_metric_pipe_create(&ref_metric_pipe), "pipe");
+  RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_LIMIT_H, hmin,
+                          hmax, NULL),
+      "limit h");
+  RSS(ref_metric_pipe_sweep(ref_metric_pipe, metric, ref_grid), "sweep");
+  RSS(ref_metric_pipe_free(ref_metric_pipe), "pipe");
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_metric_limit_h_at_complexity(REF_DBL *metric, REF_GRID ref_grid,
                                             REF_DBL hmin, REF_DBL hmax,
                                             REF_DBL target_complexity) {
-  REF_NODE ref_node = ref_grid_node(ref_grid);
-  REF_INT i, node, relaxations;
+  REF_METRIC_PIPE ref_metric_pipe;
+  REF_INT relaxations;
   REF_DBL current_complexity;
 
   /* global scaling and h limits */
@@ -1611,112 +1745,131 @@ REF_STATUS ref_metric_limit_h_at_complexity(REF_DBL *metric, REF_GRID ref_grid,
     if (!ref_math_divisible(target_complexity, current_complexity)) {
       return REF_DIV_ZERO;
     }
-    each_ref_node_valid_node(ref_node, node) for (i = 0; i < 6; i++) {
-      metric[i + 6 * node] *=
-          pow(target_complexity / current_complexity, 2.0 / 3.0);
-    }
-    RSS(ref_metric_limit_h(metric, ref_grid, hmin, hmax), "limit h");
+    RSS(ref_metric_pipe_create(&ref_metric_pipe), "pipe");
+    RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_SCALE,
+                            pow(target_complexity / current_complexity,
+                                2.0 / 3.0),
+                            0.0, NULL),
+        "scale");
+    RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_LIMIT_H, hmin,
+                            hmax, NULL),
+        "limit h");
+    RSS(ref_metric_pipe_sweep(ref_metric_pipe, metric, ref_grid), "sweep");
+    RSS(ref_metric_pipe_free(ref_metric_pipe), "pipe");
   }
 
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_metric_buffer(REF_DBL *metric, REF_GRID ref_grid) {
+static REF_STATUS ref_metric_buffer_extent(REF_GRID ref_grid, REF_DBL *rmax,
+                                           REF_DBL *xmax) {
   REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
   REF_NODE ref_node = ref_grid_node(ref_grid);
-  REF_DBL diag_system[12];
-  REF_DBL eig;
   REF_INT node;
-  REF_DBL r, rmax, x, xmax, exponent, hmin, s, t, smin, smax, emin, emax;
+  REF_DBL r, x, local_rmax, local_xmax;
 
-  xmax = -1.0e-100;
-  rmax = 0.0;
+  local_xmax = -1.0e-100;
+  local_rmax = 0.0;
   each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
     r = sqrt(ref_node_xyz(ref_node, 0, node) * ref_node_xyz(ref_node, 0, node) +
              ref_node_xyz(ref_node, 1, node) * ref_node_xyz(ref_node, 1, node) +
              ref_node_xyz(ref_node, 2, node) * ref_node_xyz(ref_node, 2, node));
-    rmax = MAX(rmax, r);
-    xmax = MAX(xmax, ref_node_xyz(ref_node, 0, node));
+    local_rmax = MAX(local_rmax, r);
+    local_xmax = MAX(local_xmax, ref_node_xyz(ref_node, 0, node));
   }
-  r = rmax;
-  RSS(ref_mpi_max(ref_mpi, &r, &rmax, REF_DBL_TYPE), "mpi max");
-  RSS(ref_mpi_bcast(ref_mpi, &rmax, 1, REF_DBL_TYPE), "bcast");
-  x = xmax;
-  RSS(ref_mpi_max(ref_mpi, &x, &xmax, REF_DBL_TYPE), "mpi max");
-  RSS(ref_mpi_bcast(ref_mpi, &xmax, 1, REF_DBL_TYPE), "bcast");
-
-  each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
-    RSS(ref_matrix_diag_m(&(metric[6 * node]), diag_system), "eigen decomp");
-
-    r = sqrt(ref_node_xyz(ref_node, 0, node) * ref_node_xyz(ref_node, 0, node) +
-             ref_node_xyz(ref_node, 1, node) * ref_node_xyz(ref_node, 1, node) +
-             ref_node_xyz(ref_node, 2, node) * ref_node_xyz(ref_node, 2, node));
-
-    smin = 0.5;
-    smax = 0.9;
-    emin = -4.0;
-    emax = -1.0;
-
-    s = MIN(1.0, r / xmax);
-
-    t = MIN(s / smin, 1.0);
-    exponent = -15.0 * (1.0 - t) + emin * t;
+  r = local_rmax;
+  RSS(ref_mpi_max(ref_mpi, &r, rmax, REF_DBL_TYPE), "mpi max");
+  RSS(ref_mpi_bcast(ref_mpi, rmax, 1, REF_DBL_TYPE), "bcast");
+  x = local_xmax;
+  RSS(ref_mpi_max(ref_mpi, &x, xmax, REF_DBL_TYPE), "mpi max");
+  RSS(ref_mpi_bcast(ref_mpi, xmax, 1, REF_DBL_TYPE), "bcast");
 
-    if (smin < s && s < smax) {
-      t = (s - smin) / (smax - smin);
-      exponent = (emin) * (1.0 - t) + (emax) * (t);
-    }
-
-    if (smax <= s) {
-      exponent = emax;
-    }
+  return REF_SUCCESS;
+}
 
-    hmin = rmax * pow(10.0, exponent);
+static REF_STATUS ref_metric_buffer_within(REF_DBL *metric, REF_GRID ref_grid,
+                                           REF_DBL rmax, REF_DBL xmax) {
+  REF_METRIC_PIPE ref_metric_pipe;
+  RSS(ref_metric_pipe_create(&ref_metric_pipe), "pipe");
+  RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_BUFFER, rmax, xmax,
+                          NULL),
+      "buffer");
+  RSS(ref_metric_pipe_sweep(ref_metric_pipe, metric, ref_grid), "sweep");
+  RSS(ref_metric_pipe_free(ref_metric_pipe), "pipe");
+  return REF_SUCCESS;
+}
 
-    if (ref_math_divisible(1.0, hmin * hmin)) {
-      eig = 1.0 / (hmin * hmin);
-      ref_matrix_eig(diag_system, 0) = MIN(ref_matrix_eig(diag_system, 0), eig);
-      ref_matrix_eig(diag_system, 1) = MIN(ref_matrix_eig(diag_system, 1), eig);
-      ref_matrix_eig(diag_system, 2) = MIN(ref_matrix_eig(diag_system, 2), eig);
-    }
+REF_STATUS ref_metric_buffer(REF_DBL *metric, REF_GRID ref_grid) {
+  REF_DBL rmax, xmax;
 
-    RSS(ref_matrix_form_m(diag_system, &(metric[6 * node])), "reform m");
-  }
+  RSS(ref_metric_buffer_extent(ref_grid, &rmax, &xmax), "extent");
+  RSS(ref_metric_buffer_within(metric, ref_grid, rmax, xmax), "buffer");
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_metric_buffer_at_complexity(REF_DBL *metric, REF_GRID ref_grid,
                                            REF_DBL target_complexity) {
-  REF_NODE ref_node = ref_grid_node(ref_grid);
-  REF_INT i, node, relaxations;
-  REF_DBL current_complexity;
+  REF_METRIC_PIPE ref_metric_pipe;
+  REF_INT relaxations;
+  REF_DBL current_complexity, rmax, xmax;
 
-  /* global scaling and buffer */
+  /* global scaling and buffer, the scale of one relaxation is fused with
+   * the buffer of the next */
+  RSS(ref_metric_buffer_extent(ref_grid, &rmax, &xmax), "extent");
+  RSS(ref_metric_buffer_within(metric, ref_grid, rmax, xmax), "buffer");
   for (relaxations = 0; relaxations < 10; relaxations++) {
-    RSS(ref_metric_buffer(metric, ref_grid), "buffer");
     RSS(ref_metric_complexity(metric, ref_grid, &current_complexity), "cmp");
     if (!ref_math_divisible(target_complexity, current_complexity)) {
       return REF_DIV_ZERO;
     }
-    each_ref_node_valid_node(ref_node, node) for (i = 0; i < 6; i++) {
-      metric[i + 6 * node] *=
-          pow(target_complexity / current_complexity, 2.0 / 3.0);
+    RSS(ref_metric_pipe_create(&ref_metric_pipe), "pipe");
+    RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_SCALE,
+                            pow(target_complexity / current_complexity,
+                                2.0 / 3.0),
+                            0.0, NULL),
+        "scale");
+    if (relaxations < 9) {
+      RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_BUFFER, rmax,
+                              xmax, NULL),
+          "buffer");
     }
+    RSS(ref_metric_pipe_sweep(ref_metric_pipe, metric, ref_grid), "sweep");
+    RSS(ref_metric_pipe_free(ref_metric_pipe), "pipe");
   }
 
   return REF_SUCCESS;
 }
 
+/* reconstructed and locally scaled Hessian ahead of the global complexity
+ * scaling, reused when several complexities are requested */
+REF_STATUS ref_metric_lp_scale(REF_DBL *metric, REF_GRID ref_grid,
+                               REF_DBL *scalar, REF_DBL *weight,
+                               REF_RECON_RECONSTRUCTION reconstruction,
+                               REF_INT p_norm) {
+  REF_METRIC_PIPE ref_metric_pipe;
+  RSS(ref_recon_hessian(ref_grid, scalar, metric, reconstruction), "recon");
+  /* floor metric eignvalues based on grid size and solution jitter,
+   * then local scale lp norm in the same sweep */
+  RSS(ref_metric_pipe_create(&ref_metric_pipe), "pipe");
+  RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_ROUNDOFF, 0.0, 0.0,
+                          NULL),
+      "roundoff");
+  RSS(ref_metric_pipe_local_scale(ref_metric_pipe, weight, p_norm),
+      "local scale");
+  RSS(ref_metric_pipe_sweep(ref_metric_pipe, metric, ref_grid), "sweep");
+  RSS(ref_metric_pipe_free(ref_metric_pipe), "pipe");
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_metric_lp(REF_DBL *metric, REF_GRID ref_grid, REF_DBL *scalar,
                          REF_DBL *weight,
                          REF_RECON_RECONSTRUCTION reconstruction,
                          REF_INT p_norm, REF_DBL gradation,
                          REF_DBL target_complexity) {
-  RSS(ref_recon_hessian(ref_grid, scalar, metric, reconstruction), "recon");
-  RSS(ref_recon_roundoff_limit(metric, ref_grid),
-      "floor metric eignvalues based on grid size and solution jitter");
-  RSS(ref_metric_local_scale(metric, weight, ref_grid, p_norm),
-      "local scale lp norm");
+  RSS(ref_metric_lp_scale(metric, ref_grid, scalar, weight, reconstruction,
+                          p_norm),
+      "lp scale");
   RSS(ref_metric_gradation_at_complexity(metric, ref_grid, gradation,
                                          target_complexity),
       "gradation at complexity");
@@ -1757,6 +1910,7 @@ REF_STATUS ref_metric_moving_multiscale(REF_DBL *metric, REF_GRID ref_grid,
   ref_free(x);
 
   ref_malloc(xyz, 3 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+  RSS(ref_node_index_invalidate(ref_node), "moved");
   each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
     for (i = 0; i < 3; i++) {
       xyz[i + 3 * node] = ref_node_xyz(ref_node, i, node);
@@ -1765,6 +1919,7 @@ REF_STATUS ref_metric_moving_multiscale(REF_DBL *metric, REF_GRID ref_grid,
     }
   }
   RSS(ref_recon_hessian(ref_grid, scalar, hess, reconstruction), "recon");
+  RSS(ref_node_index_invalidate(ref_node), "moved");
   each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
     for (i = 0; i < 3; i++) {
       ref_node_xyz(ref_node, i, node) = xyz[i + 3 * node];
@@ -1817,51 +1972,12 @@ REF_STATUS ref_metric_eig_bal(REF_DBL *metric, REF_GRID ref_grid,
 
 REF_STATUS ref_metric_local_scale(REF_DBL *metric, REF_DBL *weight,
                                   REF_GRID ref_grid, REF_INT p_norm) {
-  REF_NODE ref_node = ref_grid_node(ref_grid);
-  REF_INT i, node;
-  REF_INT dimension;
-  REF_DBL det, exponent;
-
-  dimension = 3;
-  if (ref_grid_twod(ref_grid)) {
-    dimension = 2;
-  }
-
-  if (ref_grid_twod(ref_grid)) {
-    each_ref_node_valid_node(ref_node, node) {
-      metric[2 + 6 * node] = 0.0;
-      metric[4 + 6 * node] = 0.0;
-      metric[5 + 6 * node] = 1.0;
-    }
-  }
-
-  /* local scaling */
-  exponent = -1.0 / ((REF_DBL)(2 * p_norm + dimension));
-  each_ref_node_valid_node(ref_node, node) {
-    RSS(ref_matrix_det_m(&(metric[6 * node]), &det), "det_m local hess scale");
-    if (det > 0.0) {
-      for (i = 0; i < 6; i++) metric[i + 6 * node] *= pow(det, exponent);
-    }
-  }
-
-  if (ref_grid_twod(ref_grid)) {
-    each_ref_node_valid_node(ref_node, node) {
-      metric[2 + 6 * node] = 0.0;
-      metric[4 + 6 * node] = 0.0;
-      metric[5 + 6 * node] = 1.0;
-    }
-  }
-
-  /* weight in now length scale, convert to eigenvalue */
-  if (NULL != weight) {
-    each_ref_node_valid_node(ref_node, node) {
-      if (weight[node] > 0.0) {
-        for (i = 0; i < 6; i++)
-          metric[i + 6 * node] /= (weight[node] * weight[node]);
-      }
-    }
-  }
-
+  REF_METRIC_PIPE ref_metric_pipe;
+  RSS(ref_metric_pipe_create(&ref_metric_pipe), "pipe");
+  RSS(ref_metric_pipe_local_scale(ref_metric_pipe, weight, p_norm),
+      "local scale");
+  RSS(ref_metric_pipe_sweep(ref_metric_pipe, metric, ref_grid), "sweep");
+  RSS(ref_metric_pipe_free(ref_metric_pipe), "pipe");
   return REF_SUCCESS;
 }
 
@@ -1881,27 +1997,41 @@ REF_STATUS ref_metric_opt_goal(REF_DBL *metric, REF_GRID ref_grid,
     for (i = 0; i < 6; i++) metric[i + 6 * node] = 0.0;
   }
 
-  for (var = 0; var < nequations; var++) {
+  {
     REF_DBL *lam, *grad_lam, *flux, *hess_flux;
-    ref_malloc_init(lam, ref_node_max(ref_node), REF_DBL, 0.0);
-    ref_malloc_init(grad_lam, 3 * ref_node_max(ref_node), REF_DBL, 0.0);
-    ref_malloc_init(flux, ref_node_max(ref_node), REF_DBL, 0.0);
-    ref_malloc_init(hess_flux, 6 * ref_node_max(ref_node), REF_DBL, 0.0);
-    each_ref_node_valid_node(ref_node, node) {
-      lam[node] = solution[var + ldim * node];
-    }
-    RSS(ref_recon_gradient(ref_grid, lam, grad_lam, reconstruction),
-        "grad_lam");
-
-    for (dir = 0; dir < 3; dir++) {
+    REF_INT first, nchunk;
+    /* reconstruct a fixed number of equations and directions at a time,
+     * peak memory does not grow with the number of equations */
+    nchunk = MIN(nequations, REF_METRIC_OPT_GOAL_CHUNK);
+    ref_malloc(lam, nchunk * ref_node_max(ref_node), REF_DBL);
+    ref_malloc(grad_lam, 3 * nchunk * ref_node_max(ref_node), REF_DBL);
+    ref_malloc(flux, 3 * nchunk * ref_node_max(ref_node), REF_DBL);
+    ref_malloc(hess_flux, 18 * nchunk * ref_node_max(ref_node), REF_DBL);
+    for (first = 0; first < nequations; first += nchunk) {
+      REF_INT n = MIN(nchunk, nequations - first);
+      for (i = 0; i < n * ref_node_max(ref_node); i++) lam[i] = 0.0;
+      for (i = 0; i < 3 * n * ref_node_max(ref_node); i++) flux[i] = 0.0;
       each_ref_node_valid_node(ref_node, node) {
-        flux[node] = solution[var + nequations * (1 + dir) + ldim * node];
+        for (var = 0; var < n; var++) {
+          lam[var + n * node] = solution[first + var + ldim * node];
+          for (dir = 0; dir < 3; dir++)
+            flux[dir + 3 * var + 3 * n * node] =
+                solution[first + var + nequations * (1 + dir) + ldim * node];
+        }
       }
-      RSS(ref_recon_hessian(ref_grid, flux, hess_flux, reconstruction), "hess");
+      RSS(ref_recon_gradients(ref_grid, n, lam, grad_lam, reconstruction),
+          "grad_lam");
+      RSS(ref_recon_hessians(ref_grid, 3 * n, flux, hess_flux, reconstruction),
+          "hess");
       each_ref_node_valid_node(ref_node, node) {
-        for (i = 0; i < 6; i++)
-          metric[i + 6 * node] +=
-              ABS(grad_lam[dir + 3 * node]) * hess_flux[i + 6 * node];
+        for (var = 0; var < n; var++) {
+          for (dir = 0; dir < 3; dir++) {
+            for (i = 0; i < 6; i++)
+              metric[i + 6 * node] +=
+                  ABS(grad_lam[dir + 3 * var + 3 * n * node]) *
+                  hess_flux[i + 6 * (dir + 3 * var) + 18 * n * node];
+          }
+        }
       }
     }
     ref_free(hess_flux);
@@ -1933,12 +2063,16 @@ REF_STATUS ref_metric_belme_gfe(REF_DBL *metric, REF_GRID ref_grid,
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_INT var, dir, node, i;
   REF_INT nequ;
-  REF_DBL state[5], node_flux[5], direction[3];
+  REF_INT start, n, k, batch[REF_PHYS_SOA_BATCH];
+  REF_DBL state[5 * REF_PHYS_SOA_BATCH], node_flux[5 * REF_PHYS_SOA_BATCH];
+  REF_DBL direction[3];
   REF_DBL *lam, *grad_lam, *flux, *hess_flux;
+  /* one variable at a time with its three flux directions reconstructed
+   * together, peak memory is that of a single variable */
   ref_malloc_init(lam, ref_node_max(ref_node), REF_DBL, 0.0);
   ref_malloc_init(grad_lam, 3 * ref_node_max(ref_node), REF_DBL, 0.0);
-  ref_malloc_init(flux, ref_node_max(ref_node), REF_DBL, 0.0);
-  ref_malloc_init(hess_flux, 6 * ref_node_max(ref_node), REF_DBL, 0.0);
+  ref_malloc_init(flux, 3 * ref_node_max(ref_node), REF_DBL, 0.0);
+  ref_malloc_init(hess_flux, 18 * ref_node_max(ref_node), REF_DBL, 0.0);
 
   nequ = ldim / 2;
 
@@ -1946,25 +2080,42 @@ REF_STATUS ref_metric_belme_gfe(REF_DBL *metric, REF_GRID ref_grid,
     each_ref_node_valid_node(ref_node, node) {
       lam[node] = prim_dual[var + 1 * nequ + ldim * node];
     }
-    RSS(ref_recon_gradient(ref_grid, lam, grad_lam, reconstruction),
-        "grad_lam");
-    for (dir = 0; dir < 3; dir++) {
-      each_ref_node_valid_node(ref_node, node) {
+    for (start = 0; start < ref_node_max(ref_node);
+         start += REF_PHYS_SOA_BATCH) {
+      n = 0;
+      for (node = start;
+           node < MIN(start + REF_PHYS_SOA_BATCH, ref_node_max(ref_node));
+           node++) {
+        if (ref_node_valid(ref_node, node)) {
+          batch[n] = node;
+          n++;
+        }
+      }
+      for (k = 0; k < n; k++) {
+        for (i = 0; i < 5; i++) {
+          state[k + n * i] = prim_dual[var + 0 * nequ + ldim * batch[k]];
+        }
+      }
+      for (dir = 0; dir < 3; dir++) {
         direction[0] = 0.0;
         direction[1] = 0.0;
         direction[2] = 0.0;
         direction[dir] = 1.0;
-        for (i = 0; i < 5; i++) {
-          state[i] = prim_dual[var + 0 * nequ + ldim * node];
+        RSS(ref_phys_euler_soa(n, state, direction, node_flux), "euler");
+        for (k = 0; k < n; k++) {
+          flux[dir + 3 * batch[k]] = node_flux[k + n * var];
         }
-        RSS(ref_phys_euler(state, direction, node_flux), "euler");
-        flux[node] = node_flux[var];
       }
-      RSS(ref_recon_hessian(ref_grid, flux, hess_flux, reconstruction), "hess");
-      each_ref_node_valid_node(ref_node, node) {
+    }
+    RSS(ref_recon_gradient(ref_grid, lam, grad_lam, reconstruction),
+        "grad_lam");
+    RSS(ref_recon_hessians(ref_grid, 3, flux, hess_flux, reconstruction),
+        "hess");
+    each_ref_node_valid_node(ref_node, node) {
+      for (dir = 0; dir < 3; dir++) {
         for (i = 0; i < 6; i++) {
-          metric[i + 6 * node] +=
-              ABS(grad_lam[dir + 3 * node]) * hess_flux[i + 6 * node];
+          metric[i + 6 * node] += ABS(grad_lam[dir + 3 * node]) *
+                                  hess_flux[i + 6 * dir + 18 * node];
         }
       }
     }
@@ -1982,6 +2133,51 @@ REF_STATUS ref_metric_belme_gfe(REF_DBL *metric, REF_GRID ref_grid,
   return REF_SUCCESS;
 }
 
+/* laminar (Sutherland) and Spalart-Allmaras eddy viscosity of the nodes,
+ * the eddy viscosity is zero without a turbulence variable */
+static REF_STATUS ref_metric_viscosity(REF_NODE ref_node, REF_INT ldim,
+                                       REF_DBL *prim_dual,
+                                       REF_DBL reference_temp, REF_DBL *mu,
+                                       REF_DBL *mu_t) {
+  REF_INT nequ = ldim / 2;
+  REF_INT start, n, k, node, batch[REF_PHYS_SOA_BATCH];
+  REF_DBL turb[REF_PHYS_SOA_BATCH], rho[REF_PHYS_SOA_BATCH];
+  REF_DBL nu[REF_PHYS_SOA_BATCH], eddy[REF_PHYS_SOA_BATCH];
+  REF_DBL gamma = 1.4;
+  REF_DBL sutherland_constant = 110.56;
+  REF_DBL sutherland_temp = sutherland_constant / reference_temp;
+  REF_DBL t;
+
+  for (start = 0; start < ref_node_max(ref_node); start += REF_PHYS_SOA_BATCH) {
+    n = 0;
+    for (node = start;
+         node < MIN(start + REF_PHYS_SOA_BATCH, ref_node_max(ref_node));
+         node++) {
+      if (ref_node_valid(ref_node, node)) {
+        batch[n] = node;
+        n++;
+      }
+    }
+    for (k = 0; k < n; k++) {
+      node = batch[k];
+      t = gamma * prim_dual[4 + ldim * node] / prim_dual[0 + ldim * node];
+      mu[node] = (1.0 + sutherland_temp) / (t + sutherland_temp) * t * sqrt(t);
+      mu_t[node] = 0.0;
+    }
+    if (6 != nequ) continue;
+    for (k = 0; k < n; k++) {
+      node = batch[k];
+      rho[k] = prim_dual[0 + ldim * node];
+      turb[k] = prim_dual[5 + ldim * node];
+      nu[k] = mu[node] / rho[k];
+    }
+    RSS(ref_phys_mut_sa_soa(n, turb, rho, nu, eddy), "eddy viscosity");
+    for (k = 0; k < n; k++) mu_t[batch[k]] = eddy[k];
+  }
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_metric_belme_gu(REF_DBL *metric, REF_GRID ref_grid, REF_INT ldim,
                                REF_DBL *prim_dual, REF_DBL mach, REF_DBL re,
                                REF_DBL reference_temp,
@@ -1996,13 +2192,10 @@ REF_STATUS ref_metric_belme_gu(REF_DBL *metric, REF_GRID ref_grid, REF_INT ldim,
   REF_DBL diag_system[12];
   REF_DBL weight;
   REF_DBL gamma = 1.4;
-  REF_DBL sutherland_constant = 110.56;
-  REF_DBL sutherland_temp;
-  REF_DBL t, mu;
+  REF_DBL t, mu, *mu_lam, *mu_t;
   REF_DBL pr = 0.72;
   REF_DBL turbulent_pr = 0.90;
   REF_DBL thermal_conductivity;
-  REF_DBL rho, turb, mu_t;
 
   nequ = ldim / 2;
 
@@ -2014,6 +2207,11 @@ REF_STATUS ref_metric_belme_gu(REF_DBL *metric, REF_GRID ref_grid, REF_INT ldim,
   ref_malloc_init(hess_u, 6 * ref_node_max(ref_node), REF_DBL, 0.0);
   ref_malloc_init(grad_u, 3 * ref_node_max(ref_node), REF_DBL, 0.0);
   ref_malloc_init(omega, 9 * ref_node_max(ref_node), REF_DBL, 0.0);
+  ref_malloc_init(mu_lam, ref_node_max(ref_node), REF_DBL, 0.0);
+  ref_malloc_init(mu_t, ref_node_max(ref_node), REF_DBL, 0.0);
+  RSS(ref_metric_viscosity(ref_node, ldim, prim_dual, reference_temp, mu_lam,
+                           mu_t),
+      "viscosity");
 
   for (var = 0; var < 5; var++) {
     each_ref_node_valid_node(ref_node, node) {
@@ -2065,15 +2263,7 @@ REF_STATUS ref_metric_belme_gu(REF_DBL *metric, REF_GRID ref_grid, REF_INT ldim,
     weight += (w1 * u1 + w2 * u2 + w3 * u3) * sr_lam[4 + 5 * node];
     weight += (5.0 / 3.0) *
               ABS(omega[1 + 2 * 3 + 9 * node] - omega[2 + 1 * 3 + 9 * node]);
-    t = gamma * prim_dual[4 + ldim * node] / prim_dual[0 + ldim * node];
-    sutherland_temp = sutherland_constant / reference_temp;
-    mu = (1.0 + sutherland_temp) / (t + sutherland_temp) * t * sqrt(t);
-    if (6 == nequ) {
-      rho = prim_dual[0 + ldim * node];
-      turb = prim_dual[5 + ldim * node];
-      RSS(ref_phys_mut_sa(turb, rho, mu / rho, &mu_t), "eddy viscosity");
-      mu += mu_t;
-    }
+    mu = mu_lam[node] + mu_t[node];
     weight *= mach / re * mu;
     RAS(weight >= 0.0, "negative weight u1");
     for (i = 0; i < 6; i++) {
@@ -2101,15 +2291,7 @@ REF_STATUS ref_metric_belme_gu(REF_DBL *metric, REF_GRID ref_grid, REF_INT ldim,
     weight += (w1 * u1 + w2 * u2 + w3 * u3) * sr_lam[4 + 5 * node];
     weight += (5.0 / 3.0) *
               ABS(omega[2 + 0 * 3 + 9 * node] - omega[0 + 2 * 3 + 9 * node]);
-    t = gamma * prim_dual[4 + ldim * node] / prim_dual[0 + ldim * node];
-    sutherland_temp = sutherland_constant / reference_temp;
-    mu = (1.0 + sutherland_temp) / (t + sutherland_temp) * t * sqrt(t);
-    if (6 == nequ) {
-      rho = prim_dual[0 + ldim * node];
-      turb = prim_dual[5 + ldim * node];
-      RSS(ref_phys_mut_sa(turb, rho, mu / rho, &mu_t), "eddy viscosity");
-      mu += mu_t;
-    }
+    mu = mu_lam[node] + mu_t[node];
     weight *= mach / re * mu;
     RAS(weight >= 0.0, "negative weight u2");
     for (i = 0; i < 6; i++) {
@@ -2137,15 +2319,7 @@ REF_STATUS ref_metric_belme_gu(REF_DBL *metric, REF_GRID ref_grid, REF_INT ldim,
     weight += (w1 * u1 + w2 * u2 + w3 * u3) * sr_lam[4 + 5 * node];
     weight += (5.0 / 3.0) *
               ABS(omega[0 + 1 * 3 + 9 * node] - omega[1 + 0 * 3 + 9 * node]);
-    t = gamma * prim_dual[4 + ldim * node] / prim_dual[0 + ldim * node];
-    sutherland_temp = sutherland_constant / reference_temp;
-    mu = (1.0 + sutherland_temp) / (t + sutherland_temp) * t * sqrt(t);
-    if (6 == nequ) {
-      rho = prim_dual[0 + ldim * node];
-      turb = prim_dual[5 + ldim * node];
-      RSS(ref_phys_mut_sa(turb, rho, mu / rho, &mu_t), "eddy viscosity");
-      mu += mu_t;
-    }
+    mu = mu_lam[node] + mu_t[node];
     weight *= mach / re * mu;
     RAS(weight >= 0.0, "negative weight u2");
     for (i = 0; i < 6; i++) {
@@ -2160,24 +2334,16 @@ REF_STATUS ref_metric_belme_gu(REF_DBL *metric, REF_GRID ref_grid, REF_INT ldim,
   }
   RSS(ref_recon_hessian(ref_grid, u, hess_u, reconstruction), "hess_u");
   each_ref_node_valid_node(ref_node, node) {
-    t = gamma * prim_dual[4 + ldim * node] / prim_dual[0 + ldim * node];
-    sutherland_temp = sutherland_constant / reference_temp;
-    mu = (1.0 + sutherland_temp) / (t + sutherland_temp) * t * sqrt(t);
-    thermal_conductivity = mu / (pr * (gamma - 1.0));
-    if (6 == nequ) {
-      rho = prim_dual[0 + ldim * node];
-      turb = prim_dual[5 + ldim * node];
-      RSS(ref_phys_mut_sa(turb, rho, mu / rho, &mu_t), "eddy viscosity");
-      thermal_conductivity =
-          (mu / (pr * (gamma - 1.0)) + mu_t / (turbulent_pr * (gamma - 1.0)));
-      mu += mu_t;
-    }
+    thermal_conductivity = (mu_lam[node] / (pr * (gamma - 1.0)) +
+                            mu_t[node] / (turbulent_pr * (gamma - 1.0)));
     for (i = 0; i < 6; i++) {
       metric[i + 6 * node] += 18.0 * mach / re * thermal_conductivity *
                               sr_lam[4 + 5 * node] * hess_u[i + 6 * node];
     }
   }
 
+  ref_free(mu_t);
+  ref_free(mu_lam);
   ref_free(omega);
   ref_free(grad_u);
   ref_free(hess_u);
@@ -2196,7 +2362,9 @@ REF_STATUS ref_metric_cons_euler_g(REF_DBL *g, REF_GRID ref_grid, REF_INT ldim,
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_INT var, dir, node, i;
   REF_INT nequ;
-  REF_DBL state[5], dflux_dcons[25], direction[3];
+  REF_INT start, n, k, batch[REF_PHYS_SOA_BATCH];
+  REF_DBL state[5 * REF_PHYS_SOA_BATCH];
+  REF_DBL dflux_dcons[25 * REF_PHYS_SOA_BATCH], direction[3];
   REF_DBL *lam, *grad_lam;
 
   nequ = ldim / 2;
@@ -2210,19 +2378,33 @@ REF_STATUS ref_metric_cons_euler_g(REF_DBL *g, REF_GRID ref_grid, REF_INT ldim,
     }
     RSS(ref_recon_gradient(ref_grid, lam, grad_lam, reconstruction),
         "grad_lam");
-    for (dir = 0; dir < 3; dir++) {
-      each_ref_node_valid_node(ref_node, node) {
+    for (start = 0; start < ref_node_max(ref_node);
+         start += REF_PHYS_SOA_BATCH) {
+      n = 0;
+      for (node = start;
+           node < MIN(start + REF_PHYS_SOA_BATCH, ref_node_max(ref_node));
+           node++) {
+        if (ref_node_valid(ref_node, node)) {
+          batch[n] = node;
+          n++;
+        }
+      }
+      for (k = 0; k < n; k++) {
+        for (i = 0; i < 5; i++) {
+          state[k + n * i] = prim_dual[var + 0 * nequ + ldim * batch[k]];
+        }
+      }
+      for (dir = 0; dir < 3; dir++) {
         direction[0] = 0.0;
         direction[1] = 0.0;
         direction[2] = 0.0;
         direction[dir] = 1.0;
+        RSS(ref_phys_euler_jac_soa(n, state, direction, dflux_dcons), "euler");
         for (i = 0; i < 5; i++) {
-          state[i] = prim_dual[var + 0 * nequ + ldim * node];
-        }
-        RSS(ref_phys_euler_jac(state, direction, dflux_dcons), "euler");
-        for (i = 0; i < 5; i++) {
-          g[i + 5 * node] +=
-              dflux_dcons[var + i * 5] * grad_lam[dir + 3 * node];
+          for (k = 0; k < n; k++) {
+            g[i + 5 * batch[k]] += dflux_dcons[k + n * (var + i * 5)] *
+                                   grad_lam[dir + 3 * batch[k]];
+          }
         }
       }
     }
@@ -2243,13 +2425,11 @@ REF_STATUS ref_metric_cons_viscous_g(REF_DBL *g, REF_GRID ref_grid,
   REF_INT nequ;
   REF_DBL *lam, *rhou1star, *rhou2star, *rhou3star, *rhoestar;
   REF_DBL gamma = 1.4;
-  REF_DBL sutherland_constant = 110.56;
-  REF_DBL sutherland_temp;
-  REF_DBL t, mu, u1, u2, u3, q2, e;
+  REF_DBL mu, *mu_lam, *mu_t, u1, u2, u3, q2, e;
   REF_DBL pr = 0.72;
   REF_DBL turbulent_pr = 0.90;
   REF_DBL thermal_conductivity;
-  REF_DBL rho, turb, mu_t;
+  REF_DBL rho;
   REF_DBL frhou1, frhou2, frhou3, frhoe;
   REF_INT xx = 0, xy = 1, xz = 2, yy = 3, yz = 4, zz = 5;
 
@@ -2283,6 +2463,12 @@ REF_STATUS ref_metric_cons_viscous_g(REF_DBL *g, REF_GRID ref_grid,
   RSS(ref_recon_signed_hessian(ref_grid, lam, rhoestar, reconstruction), "h4");
   ref_free(lam);
 
+  ref_malloc_init(mu_lam, ref_node_max(ref_node), REF_DBL, 0.0);
+  ref_malloc_init(mu_t, ref_node_max(ref_node), REF_DBL, 0.0);
+  RSS(ref_metric_viscosity(ref_node, ldim, prim_dual, reference_temp, mu_lam,
+                           mu_t),
+      "viscosity");
+
   each_ref_node_valid_node(ref_node, node) {
     rho = prim_dual[0 + ldim * node];
     u1 = prim_dual[1 + ldim * node];
@@ -2290,17 +2476,9 @@ REF_STATUS ref_metric_cons_viscous_g(REF_DBL *g, REF_GRID ref_grid,
     u3 = prim_dual[3 + ldim * node];
     q2 = u1 * u1 + u2 * u2 + u3 * u3;
     e = prim_dual[4 + ldim * node] / (gamma - 1.0) + 0.5 * rho * q2;
-    t = gamma * prim_dual[4 + ldim * node] / prim_dual[0 + ldim * node];
-    sutherland_temp = sutherland_constant / reference_temp;
-    mu = (1.0 + sutherland_temp) / (t + sutherland_temp) * t * sqrt(t);
-    thermal_conductivity = mu / (pr * (gamma - 1.0));
-    if (6 == nequ) {
-      turb = prim_dual[5 + ldim * node];
-      RSS(ref_phys_mut_sa(turb, rho, mu / rho, &mu_t), "eddy viscosity");
-      thermal_conductivity =
-          (mu / (pr * (gamma - 1.0)) + mu_t / (turbulent_pr * (gamma - 1.0)));
-      mu += mu_t;
-    }
+    thermal_conductivity = (mu_lam[node] / (pr * (gamma - 1.0)) +
+                            mu_t[node] / (turbulent_pr * (gamma - 1.0)));
+    mu = mu_lam[node] + mu_t[node];
     mu *= mach / re;
     thermal_conductivity *= mach / re;
 
@@ -2343,6 +2521,8 @@ REF_STATUS ref_metric_cons_viscous_g(REF_DBL *g, REF_GRID ref_grid,
     g[4 + 5 * node] += frhoe;
   }
 
+  ref_free(mu_t);
+  ref_free(mu_lam);
   ref_free(rhoestar);
   ref_free(rhou3star);
   ref_free(rhou2star);
@@ -2360,22 +2540,25 @@ REF_STATUS ref_metric_cons_assembly(REF_DBL *metric, REF_DBL *g,
   REF_DBL state[5], conserved[5];
   REF_DBL *cons, *hess_cons;
 
-  ref_malloc_init(cons, ref_node_max(ref_node), REF_DBL, 0.0);
-  ref_malloc_init(hess_cons, 6 * ref_node_max(ref_node), REF_DBL, 0.0);
+  ref_malloc_init(cons, 5 * ref_node_max(ref_node), REF_DBL, 0.0);
+  ref_malloc_init(hess_cons, 30 * ref_node_max(ref_node), REF_DBL, 0.0);
 
-  for (var = 0; var < 5; var++) {
-    each_ref_node_valid_node(ref_node, node) {
+  each_ref_node_valid_node(ref_node, node) {
+    for (var = 0; var < 5; var++) {
       for (i = 0; i < 5; i++) {
         state[i] = prim_dual[var + ldim * node];
       }
       RSS(ref_phys_make_conserved(state, conserved), "prim2cons");
-      cons[node] = conserved[var];
+      cons[var + 5 * node] = conserved[var];
     }
-    RSS(ref_recon_hessian(ref_grid, cons, hess_cons, reconstruction), "hess");
-    each_ref_node_valid_node(ref_node, node) {
+  }
+  RSS(ref_recon_hessians(ref_grid, 5, cons, hess_cons, reconstruction),
+      "hess");
+  each_ref_node_valid_node(ref_node, node) {
+    for (var = 0; var < 5; var++) {
       for (i = 0; i < 6; i++) {
         metric[i + 6 * node] +=
-            ABS(g[var + 5 * node]) * hess_cons[i + 6 * node];
+            ABS(g[var + 5 * node]) * hess_cons[i + 6 * var + 30 * node];
       }
     }
   }
@@ -22,6 +22,17 @@
 #include "ref_defs.h"
 
 BEGIN_C_DECLORATION
+typedef enum REF_METRIC_STAGE_TYPES { /* 0 */ REF_METRIC_STAGE_TWOD,
+                                      /* 1 */ REF_METRIC_STAGE_ROUNDOFF,
+                                      /* 2 */ REF_METRIC_STAGE_LOCAL_SCALE,
+                                      /* 3 */ REF_METRIC_STAGE_WEIGHT,
+                                      /* 4 */ REF_METRIC_STAGE_SCALE,
+                                      /* 5 */ REF_METRIC_STAGE_LIMIT_H,
+                                      /* 6 */ REF_METRIC_STAGE_BUFFER,
+                                      /* 7 */ REF_METRIC_STAGE_LAST
+} REF_METRIC_STAGE_TYPE;
+typedef struct REF_METRIC_PIPE_STRUCT REF_METRIC_PIPE_STRUCT;
+typedef REF_METRIC_PIPE_STRUCT *REF_METRIC_PIPE;
 END_C_DECLORATION
 
 #include "ref_grid.h"
@@ -30,6 +41,24 @@ END_C_DECLORATION
 
 BEGIN_C_DECLORATION
 
+#define REF_METRIC_PIPE_MAX_STAGE (8)
+
+/* pointwise stages applied to each node in a single sweep */
+struct REF_METRIC_PIPE_STRUCT {
+  REF_INT n;
+  REF_METRIC_STAGE_TYPE type[REF_METRIC_PIPE_MAX_STAGE];
+  REF_DBL param[2 * REF_METRIC_PIPE_MAX_STAGE];
+  REF_DBL *field[REF_METRIC_PIPE_MAX_STAGE];
+};
+
+REF_STATUS ref_metric_pipe_create(REF_METRIC_PIPE *ref_metric_pipe);
+REF_STATUS ref_metric_pipe_free(REF_METRIC_PIPE ref_metric_pipe);
+REF_STATUS ref_metric_pipe_add(REF_METRIC_PIPE ref_metric_pipe,
+                               REF_METRIC_STAGE_TYPE type, REF_DBL param0,
+                               REF_DBL param1, REF_DBL *field);
+REF_STATUS ref_metric_pipe_sweep(REF_METRIC_PIPE ref_metric_pipe,
+                                 REF_DBL *metric, REF_GRID ref_grid);
+
 REF_STATUS ref_metric_show(REF_DBL *metric);
 REF_STATUS ref_metric_inspect(REF_NODE ref_node);
 
@@ -88,6 +117,10 @@ REF_STATUS ref_metric_limit_h_at_complexity(REF_DBL *metric, REF_GRID ref_grid,
 REF_STATUS ref_metric_buffer(REF_DBL *metric, REF_GRID ref_grid);
 REF_STATUS ref_metric_buffer_at_complexity(REF_DBL *metric, REF_GRID ref_grid,
                                            REF_DBL complexity);
+REF_STATUS ref_metric_lp_scale(REF_DBL *metric, REF_GRID ref_grid,
+                               REF_DBL *scalar, REF_DBL *weight,
+                               REF_RECON_RECONSTRUCTION reconstruction,
+                               REF_INT p_norm);
 REF_STATUS ref_metric_lp(REF_DBL *metric, REF_GRID ref_grid, REF_DBL *scalar,
                          REF_DBL *weight,
                          REF_RECON_RECONSTRUCTION reconstruction,
@@ -2110,6 +2110,62 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
+  { /* fused roundoff, local scale and limit sweep matches separate passes */
+    REF_GRID ref_grid;
+    REF_NODE ref_node;
+    REF_METRIC_PIPE ref_metric_pipe;
+    REF_INT node, i;
+    REF_DBL *fused, *metric, *weight;
+    REF_DBL tol = -1.0;
+
+    RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+    ref_node = ref_grid_node(ref_grid);
+    ref_malloc(fused, 6 * ref_node_max(ref_node), REF_DBL);
+    ref_malloc(metric, 6 * ref_node_max(ref_node), REF_DBL);
+    ref_malloc(weight, ref_node_max(ref_node), REF_DBL);
+    each_ref_node_valid_node(ref_node, node) {
+      metric[0 + 6 * node] = 1.0 + ref_node_xyz(ref_node, 0, node);
+      metric[1 + 6 * node] = 0.1;
+      metric[2 + 6 * node] = 0.0;
+      metric[3 + 6 * node] = 1.0e-20;
+      metric[4 + 6 * node] = 0.0;
+      metric[5 + 6 * node] = 4.0 + ref_node_xyz(ref_node, 2, node);
+      weight[node] = 0.5 + ref_node_xyz(ref_node, 1, node);
+      for (i = 0; i < 6; i++) fused[i + 6 * node] = metric[i + 6 * node];
+    }
+
+    RSS(ref_recon_roundoff_limit(metric, ref_grid), "roundoff");
+    RSS(ref_metric_local_scale(metric, weight, ref_grid, 2), "local scale");
+    RSS(ref_metric_limit_h(metric, ref_grid, 0.1, 10.0), "limit h");
+
+    RSS(ref_metric_pipe_create(&ref_metric_pipe), "pipe");
+    RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_ROUNDOFF, 0.0,
+                            0.0, NULL),
+        "roundoff");
+    RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_LOCAL_SCALE, 2.0,
+                            0.0, NULL),
+        "local scale");
+    RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_WEIGHT, 0.0, 0.0,
+                            weight),
+        "weight");
+    RSS(ref_metric_pipe_add(ref_metric_pipe, REF_METRIC_STAGE_LIMIT_H, 0.1,
+                            10.0, NULL),
+        "limit h");
+    RSS(ref_metric_pipe_sweep(ref_metric_pipe, fused, ref_grid), "sweep");
+    RSS(ref_metric_pipe_free(ref_metric_pipe), "pipe");
+
+    each_ref_node_valid_node(ref_node, node) {
+      for (i = 0; i < 6; i++)
+        RWDS(metric[i + 6 * node], fused[i + 6 * node], tol, "fused");
+    }
+
+    ref_free(weight);
+    ref_free(metric);
+    ref_free(fused);
+
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
   if (!ref_mpi_para(ref_mpi)) { /* lp for small variation */
     REF_GRID ref_grid;
     REF_NODE ref_node;
@@ -2134,6 +2190,52 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
+  if (!ref_mpi_para(ref_mpi)) { /* one lp scale shared by a ladder */
+    REF_GRID ref_grid;
+    REF_NODE ref_node;
+    REF_INT node, i, rung, nrung;
+    REF_DBL *scalar, *hess, *metric;
+    REF_DBL complexity[REF_ARGS_MAX_LADDER], current;
+    char filename[1024];
+
+    RSS(ref_args_ladder("500,1000", &nrung, complexity), "ladder");
+    REIS(2, nrung, "rungs");
+    RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+    ref_node = ref_grid_node(ref_grid);
+    ref_malloc(scalar, ref_node_max(ref_node), REF_DBL);
+    ref_malloc(hess, 6 * ref_node_max(ref_node), REF_DBL);
+    ref_malloc(metric, 6 * ref_node_max(ref_node), REF_DBL);
+    each_ref_node_valid_node(ref_node, node) {
+      scalar[node] = 0.5 + 0.01 * pow(ref_node_xyz(ref_node, 0, node), 2) +
+                     0.02 * pow(ref_node_xyz(ref_node, 1, node), 2) +
+                     0.03 * pow(ref_node_xyz(ref_node, 2, node), 2);
+    }
+    RSS(ref_metric_lp_scale(hess, ref_grid, scalar, NULL,
+                            REF_RECON_L2PROJECTION, 2),
+        "lp scale");
+    for (rung = 0; rung < nrung; rung++) {
+      each_ref_node_valid_node(ref_node, node) {
+        for (i = 0; i < 6; i++) metric[i + 6 * node] = hess[i + 6 * node];
+      }
+      RSS(ref_metric_gradation_at_complexity(metric, ref_grid, -1.0,
+                                             complexity[rung]),
+          "gradation at complexity");
+      RSS(ref_metric_complexity(metric, ref_grid, &current), "cmp");
+      RWDS(complexity[rung], current, 1.0e-8 * complexity[rung],
+           "rung complexity");
+      RSS(ref_args_rung_filename(filename, sizeof(filename), "metric.solb",
+                                 rung, nrung),
+          "rung filename");
+      REIS(0, strcmp(0 == rung ? "metric-1.solb" : "metric-2.solb", filename),
+           "rung filename");
+    }
+    ref_free(metric);
+    ref_free(hess);
+    ref_free(scalar);
+
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
   if (!ref_mpi_para(ref_mpi)) { /* lp for no variation */
     REF_GRID ref_grid;
     REF_INT node;
@@ -2213,6 +2315,57 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
+  { /* opt goal of more equations than one chunk matches one chunk */
+    REF_GRID ref_grid;
+    REF_NODE ref_node;
+    REF_INT node, var, dir, i;
+    REF_DBL *five, *ten, *metric, *twice, value;
+    REF_INT p = 2;
+    REF_DBL gradation = -1.0, complexity = 1000.0;
+
+    RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+    ref_node = ref_grid_node(ref_grid);
+    ref_malloc(five, 20 * ref_node_max(ref_node), REF_DBL);
+    ref_malloc(ten, 40 * ref_node_max(ref_node), REF_DBL);
+    each_ref_node_valid_node(ref_node, node) {
+      for (var = 0; var < 5; var++) {
+        value = (1.0 + var) *
+                sin(ref_math_pi *
+                    (ref_node_xyz(ref_node, 0, node) + 0.1 * var));
+        five[var + 20 * node] = value;
+        ten[var + 40 * node] = value;
+        ten[5 + var + 40 * node] = value;
+        for (dir = 0; dir < 3; dir++) {
+          value = cos(ref_math_pi * (1.0 + var) *
+                      ref_node_xyz(ref_node, dir, node)) *
+                  ref_node_xyz(ref_node, (dir + 1) % 3, node);
+          five[var + 5 * (1 + dir) + 20 * node] = value;
+          ten[var + 10 * (1 + dir) + 40 * node] = value;
+          ten[5 + var + 10 * (1 + dir) + 40 * node] = value;
+        }
+      }
+    }
+    ref_malloc(metric, 6 * ref_node_max(ref_node), REF_DBL);
+    ref_malloc(twice, 6 * ref_node_max(ref_node), REF_DBL);
+    RSS(ref_metric_opt_goal(metric, ref_grid, 5, five, REF_RECON_L2PROJECTION,
+                            p, gradation, complexity),
+        "five");
+    RSS(ref_metric_opt_goal(twice, ref_grid, 10, ten, REF_RECON_L2PROJECTION,
+                            p, gradation, complexity),
+        "ten");
+    each_ref_node_valid_node(ref_node, node) {
+      for (i = 0; i < 6; i++) {
+        RWDS(metric[i + 6 * node], twice[i + 6 * node],
+             1.0e-8 * MAX(1.0, ABS(metric[i + 6 * node])), "scale invariant");
+      }
+    }
+    ref_free(twice);
+    ref_free(metric);
+    ref_free(ten);
+    ref_free(five);
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
   { /* parse interior box floor spacing */
     char *args[] = {
         "--uniform", "box", "floor", "2", "-1", "0", "0", "0", "1", "1", "1",
@@ -1574,6 +1574,9 @@ REF_STATUS ref_migrate_to_balance(REF_GRID ref_grid) {
   REF_INT node;
   REF_INT *node_part;
 
+  RSS(ref_mpi_trace_begin(ref_grid_mpi(ref_grid), "migrate to balance"),
+      "trace");
+
   RSS(ref_node_synchronize_globals(ref_node), "sync global nodes");
   RSS(ref_node_collect_ghost_age(ref_node), "collect ghost age");
 
@@ -1594,6 +1597,8 @@ REF_STATUS ref_migrate_to_balance(REF_GRID ref_grid) {
   }
   ref_free(node_part);
 
+  RSS(ref_mpi_trace_end(ref_grid_mpi(ref_grid)), "trace");
+
   return REF_SUCCESS;
 }
 
@@ -28,6 +28,10 @@
 #include "mpi.h"
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "ref_malloc.h"
 #include "ref_math.h"
 #include "ref_mpi.h"
@@ -55,6 +59,13 @@
 
 #define ref_mpi_comm(ref_mpi) (*((MPI_Comm *)(ref_mpi->comm)))
 
+#define ref_mpi_count_bytes(ref_mpi, datatype, n)                           \
+  {                                                                         \
+    int ref_mpi_count_bytes_size;                                           \
+    MPI_Type_size((datatype), &ref_mpi_count_bytes_size);                   \
+    (ref_mpi)->bytes += (REF_LONG)ref_mpi_count_bytes_size * (REF_LONG)(n); \
+  }
+
 #define ref_mpi_debugging(ref_mpi) (ref_mpi_once(ref_mpi) && (ref_mpi)->debug)
 
 #define ref_mpi_where_am_i(ref_mpi) \
@@ -63,6 +74,9 @@
 
 #endif
 
+/* stopwatch phases and barriers get their own track beside the threads */
+#define REF_MPI_TRACE_STOPWATCH_TRACK (-1)
+
 REF_STATUS ref_mpi_create_from_comm(REF_MPI *ref_mpi_ptr, void *comm_ptr) {
   REF_MPI ref_mpi;
   clock_t ticks;
@@ -80,6 +94,9 @@ REF_STATUS ref_mpi_create_from_comm(REF_MPI *ref_mpi_ptr, void *comm_ptr) {
   ref_mpi->start_time = ref_mpi->first_time;
 
   ref_mpi->debug = REF_FALSE;
+  ref_mpi->nthread = 1;
+  ref_mpi->bytes = 0;
+  ref_mpi->trace = NULL;
 
 #ifdef HAVE_MPI
   {
@@ -160,8 +177,20 @@ REF_STATUS ref_mpi_join_comm(REF_MPI split_mpi) {
   return REF_SUCCESS;
 }
 
+static REF_STATUS ref_mpi_trace_free(REF_MPI_TRACE trace) {
+  if (NULL == (void *)trace) return REF_NULL;
+  ref_free(trace->name);
+  ref_free(trace->thread);
+  ref_free(trace->duration);
+  ref_free(trace->start);
+  ref_free(trace);
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_mpi_free(REF_MPI ref_mpi) {
   if (NULL == (void *)ref_mpi) return REF_NULL;
+  if (ref_mpi_tracing(ref_mpi))
+    RSS(ref_mpi_trace_free(ref_mpi->trace), "trace free");
   ref_free(ref_mpi->comm);
   ref_free(ref_mpi);
   return REF_SUCCESS;
@@ -180,13 +209,17 @@ REF_STATUS ref_mpi_deep_copy(REF_MPI *ref_mpi_ptr, REF_MPI original) {
   ref_mpi->start_time = original->start_time;
 
   ref_mpi->debug = original->debug;
+  ref_mpi->nthread = original->nthread;
+  ref_mpi->bytes = 0;
+  ref_mpi->trace = NULL;
 
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_mpi_start(int argc, char *argv[]) {
 #ifdef HAVE_MPI
-  MPI_Init(&argc, &argv);
+  int provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
 #else
   SUPRESS_UNUSED_COMPILER_WARNING(argc);
   SUPRESS_UNUSED_COMPILER_WARNING(argv);
@@ -203,6 +236,35 @@ REF_STATUS ref_mpi_stop(void) {
   return REF_SUCCESS;
 }
 
+REF_STATUS ref_mpi_threads(REF_MPI ref_mpi, REF_INT nthread) {
+  RAB(0 < nthread, "thread count must be positive",
+      { printf("nthread %d\n", nthread); });
+#ifdef _OPENMP
+  nthread = MIN(nthread, omp_get_thread_limit());
+#ifdef HAVE_MPI
+  {
+    int provided, running;
+    REIS(MPI_SUCCESS, MPI_Initialized(&running), "running?");
+    if (running) {
+      MPI_Query_thread(&provided);
+      if (provided < MPI_THREAD_FUNNELED) {
+        if (ref_mpi_once(ref_mpi) && 1 < nthread)
+          printf("MPI_THREAD_FUNNELED not provided, threads ignored\n");
+        nthread = 1;
+      }
+    }
+  }
+#endif
+#else
+  if (ref_mpi_once(ref_mpi) && 1 < nthread)
+    printf("compiled without OpenMP, threads ignored\n");
+  nthread = 1;
+#endif
+  ref_mpi->nthread = nthread;
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_mpi_int_size_type(REF_SIZE size, REF_TYPE *type) {
   *type = REF_UNKNOWN_TYPE;
   switch (size) {
@@ -221,6 +283,40 @@ REF_STATUS ref_mpi_int_size_type(REF_SIZE size, REF_TYPE *type) {
   return REF_SUCCESS;
 }
 
+static REF_STATUS ref_mpi_trace_event(REF_MPI ref_mpi, const char *name,
+                                      REF_DBL start, REF_DBL duration,
+                                      REF_INT thread, REF_INT *event) {
+  REF_MPI_TRACE trace = ref_mpi->trace;
+  char *event_name;
+  REF_INT i;
+
+  if (trace->n >= trace->max) {
+    RAS(trace->max < REF_INT_MAX / REF_MPI_TRACE_NAME - 1000,
+        "too many trace events");
+    trace->max += 1000;
+    ref_realloc(trace->start, trace->max, REF_DBL);
+    ref_realloc(trace->duration, trace->max, REF_DBL);
+    ref_realloc(trace->thread, trace->max, REF_INT);
+    ref_realloc(trace->name, REF_MPI_TRACE_NAME * trace->max, char);
+  }
+
+  *event = trace->n;
+  trace->start[*event] = start - trace->origin;
+  trace->duration[*event] = duration;
+  trace->thread[*event] = thread;
+  event_name = &(trace->name[REF_MPI_TRACE_NAME * (*event)]);
+  for (i = 0; i < REF_MPI_TRACE_NAME - 1 && '\0' != name[i]; i++) {
+    event_name[i] = name[i];
+    /* keep the name a plain JSON string */
+    if ('"' == name[i] || '\\' == name[i] || ' ' > name[i])
+      event_name[i] = ' ';
+  }
+  event_name[i] = '\0';
+  trace->n++;
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_mpi_stopwatch_start(REF_MPI ref_mpi) {
 #ifdef HAVE_MPI
   if (ref_mpi_para(ref_mpi)) MPI_Barrier(ref_mpi_comm(ref_mpi));
@@ -241,6 +337,18 @@ REF_STATUS ref_mpi_stopwatch_stop(REF_MPI ref_mpi, const char *message) {
   before_barrier = (REF_DBL)MPI_Wtime() - ref_mpi->start_time;
   if (ref_mpi_para(ref_mpi)) MPI_Barrier(ref_mpi_comm(ref_mpi));
   after_barrier = (REF_DBL)MPI_Wtime();
+  if (ref_mpi_tracing(ref_mpi)) {
+    REF_INT event;
+    RSS(ref_mpi_trace_event(ref_mpi, message, ref_mpi->start_time,
+                            before_barrier, REF_MPI_TRACE_STOPWATCH_TRACK,
+                            &event),
+        "phase");
+    RSS(ref_mpi_trace_event(
+            ref_mpi, "barrier", ref_mpi->start_time + before_barrier,
+            after_barrier - ref_mpi->start_time - before_barrier,
+            REF_MPI_TRACE_STOPWATCH_TRACK, &event),
+        "barrier");
+  }
   elapsed = after_barrier - ref_mpi->first_time;
   after_barrier = after_barrier - ref_mpi->start_time;
   RSS(ref_mpi_min(ref_mpi, &before_barrier, &first, REF_DBL_TYPE), "min");
@@ -254,6 +362,14 @@ REF_STATUS ref_mpi_stopwatch_stop(REF_MPI ref_mpi, const char *message) {
 #else
   clock_t ticks;
   ticks = clock();
+  if (ref_mpi_tracing(ref_mpi)) {
+    REF_INT event;
+    RSS(ref_mpi_trace_event(
+            ref_mpi, message, ref_mpi->start_time,
+            ((REF_DBL)ticks) / ((REF_DBL)CLOCKS_PER_SEC) - ref_mpi->start_time,
+            REF_MPI_TRACE_STOPWATCH_TRACK, &event),
+        "phase");
+  }
   printf("%9.4f: %10.6f (%10.6f) %6.2f%% %s\n",
          ((REF_DBL)ticks) / ((REF_DBL)CLOCKS_PER_SEC) - ref_mpi->first_time,
          ((REF_DBL)ticks) / ((REF_DBL)CLOCKS_PER_SEC) - ref_mpi->start_time,
@@ -266,6 +382,171 @@ REF_STATUS ref_mpi_stopwatch_stop(REF_MPI ref_mpi, const char *message) {
   return REF_SUCCESS;
 }
 
+REF_STATUS ref_mpi_wtime(REF_MPI ref_mpi, REF_DBL *seconds) {
+#ifdef HAVE_MPI
+  SUPRESS_UNUSED_COMPILER_WARNING(ref_mpi);
+  *seconds = (REF_DBL)MPI_Wtime();
+#else
+  clock_t ticks;
+  SUPRESS_UNUSED_COMPILER_WARNING(ref_mpi);
+  ticks = clock();
+  *seconds = ((REF_DBL)ticks) / ((REF_DBL)CLOCKS_PER_SEC);
+#endif
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_mpi_trace_start(REF_MPI ref_mpi) {
+  REF_MPI_TRACE trace;
+
+  RAS(!ref_mpi_tracing(ref_mpi), "trace already started");
+  ref_malloc(trace, 1, REF_MPI_TRACE_STRUCT);
+  trace->n = 0;
+  trace->max = 0;
+  trace->start = NULL;
+  trace->duration = NULL;
+  trace->thread = NULL;
+  trace->name = NULL;
+  trace->depth = 0;
+  ref_mpi->trace = trace;
+
+#ifdef HAVE_MPI
+  if (ref_mpi_para(ref_mpi)) MPI_Barrier(ref_mpi_comm(ref_mpi));
+#endif
+  RSS(ref_mpi_wtime(ref_mpi, &(trace->origin)), "origin");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_mpi_trace_begin(REF_MPI ref_mpi, const char *name) {
+  REF_MPI_TRACE trace = ref_mpi->trace;
+  REF_DBL now;
+  REF_INT thread = 0, event;
+
+  if (NULL == trace) return REF_SUCCESS;
+  RAS(trace->depth < REF_MPI_TRACE_DEPTH, "trace spans nested too deep");
+#ifdef _OPENMP
+  thread = omp_get_thread_num();
+#endif
+  RSS(ref_mpi_wtime(ref_mpi, &now), "now");
+  RSS(ref_mpi_trace_event(ref_mpi, name, now, -1.0, thread, &event), "event");
+  trace->open[trace->depth] = event;
+  trace->depth++;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_mpi_trace_end(REF_MPI ref_mpi) {
+  REF_MPI_TRACE trace = ref_mpi->trace;
+  REF_DBL now;
+  REF_INT event;
+
+  if (NULL == trace) return REF_SUCCESS;
+  RAS(0 < trace->depth, "trace end without begin");
+  RSS(ref_mpi_wtime(ref_mpi, &now), "now");
+  trace->depth--;
+  event = trace->open[trace->depth];
+  trace->duration[event] = now - trace->origin - trace->start[event];
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_mpi_trace_dump(REF_MPI ref_mpi, const char *filename) {
+  REF_MPI_TRACE trace = ref_mpi->trace;
+  FILE *file = NULL;
+  REF_DBL now;
+  REF_DBL *start, *duration;
+  REF_INT *thread;
+  char *name;
+  REF_INT part, n, event, depth;
+
+  RNS(trace, "trace not started");
+
+  /* spans still open are cut off at the dump */
+  RSS(ref_mpi_wtime(ref_mpi, &now), "now");
+  for (depth = 0; depth < trace->depth; depth++) {
+    event = trace->open[depth];
+    trace->duration[event] = now - trace->origin - trace->start[event];
+  }
+
+  if (ref_mpi_once(ref_mpi)) {
+    file = fopen(filename, "w");
+    if (NULL == (void *)file) printf("unable to open %s\n", filename);
+    RNS(file, "unable to open file");
+    fprintf(file, "{\"traceEvents\":[\n");
+  }
+
+  each_ref_mpi_part(ref_mpi, part) {
+    if (ref_mpi_once(ref_mpi)) {
+      if (0 == part) {
+        n = trace->n;
+        start = trace->start;
+        duration = trace->duration;
+        thread = trace->thread;
+        name = trace->name;
+      } else {
+        RSS(ref_mpi_recv(ref_mpi, &n, 1, REF_INT_TYPE, part), "recv n");
+        ref_malloc(start, n, REF_DBL);
+        ref_malloc(duration, n, REF_DBL);
+        ref_malloc(thread, n, REF_INT);
+        ref_malloc(name, REF_MPI_TRACE_NAME * n, char);
+        if (0 < n) {
+          RSS(ref_mpi_recv(ref_mpi, start, n, REF_DBL_TYPE, part), "start");
+          RSS(ref_mpi_recv(ref_mpi, duration, n, REF_DBL_TYPE, part), "dur");
+          RSS(ref_mpi_recv(ref_mpi, thread, n, REF_INT_TYPE, part), "thread");
+          RSS(ref_mpi_recv(ref_mpi, name, REF_MPI_TRACE_NAME * n,
+                           REF_BYTE_TYPE, part),
+              "name");
+        }
+      }
+      fprintf(file,
+              "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+              "\"args\":{\"name\":\"rank %d\"}}",
+              (0 == part ? "" : ",\n"), part, part);
+      fprintf(file,
+              ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+              "\"tid\":%d,\"args\":{\"name\":\"stopwatch\"}}",
+              part, REF_MPI_TRACE_STOPWATCH_TRACK);
+      for (event = 0; event < n; event++) {
+        fprintf(file,
+                ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,"
+                "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                &(name[REF_MPI_TRACE_NAME * event]), part, thread[event],
+                1.0e6 * start[event], 1.0e6 * duration[event]);
+      }
+      if (0 != part) {
+        ref_free(name);
+        ref_free(thread);
+        ref_free(duration);
+        ref_free(start);
+      }
+    } else {
+      if (part == ref_mpi_rank(ref_mpi)) {
+        n = trace->n;
+        RSS(ref_mpi_send(ref_mpi, &n, 1, REF_INT_TYPE, 0), "send n");
+        if (0 < n) {
+          RSS(ref_mpi_send(ref_mpi, trace->start, n, REF_DBL_TYPE, 0),
+              "start");
+          RSS(ref_mpi_send(ref_mpi, trace->duration, n, REF_DBL_TYPE, 0),
+              "dur");
+          RSS(ref_mpi_send(ref_mpi, trace->thread, n, REF_INT_TYPE, 0),
+              "thread");
+          RSS(ref_mpi_send(ref_mpi, trace->name, REF_MPI_TRACE_NAME * n,
+                           REF_BYTE_TYPE, 0),
+              "name");
+        }
+      }
+    }
+  }
+
+  if (ref_mpi_once(ref_mpi)) {
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(file);
+  }
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_mpi_bcast(REF_MPI ref_mpi, void *data, REF_INT n,
                          REF_TYPE type) {
 #ifdef HAVE_MPI
@@ -297,6 +578,7 @@ REF_STATUS ref_mpi_send(REF_MPI ref_mpi, void *data, REF_INT n, REF_TYPE type,
   tag = ref_mpi_n(ref_mpi) * dest + ref_mpi_rank(ref_mpi);
 
   MPI_Send(data, n, datatype, dest, tag, ref_mpi_comm(ref_mpi));
+  ref_mpi_count_bytes(ref_mpi, datatype, n);
 
   return REF_SUCCESS;
 #else
@@ -342,7 +624,10 @@ REF_STATUS ref_mpi_alltoall(REF_MPI ref_mpi, void *send, void *recv,
 
   ref_type_mpi_type(type, datatype);
 
+  RSS(ref_mpi_trace_begin(ref_mpi, "alltoall"), "trace");
   MPI_Alltoall(send, 1, datatype, recv, 1, datatype, ref_mpi_comm(ref_mpi));
+  RSS(ref_mpi_trace_end(ref_mpi), "trace");
+  ref_mpi_count_bytes(ref_mpi, datatype, ref_mpi_n(ref_mpi));
 #else
   switch (type) {
     case REF_INT_TYPE:
@@ -408,8 +693,13 @@ REF_STATUS ref_mpi_alltoallv(REF_MPI ref_mpi, void *send, REF_INT *send_size,
     recv_disp[part] = recv_disp[part - 1] + recv_size_n[part - 1];
   }
 
+  RSS(ref_mpi_trace_begin(ref_mpi, "alltoallv"), "trace");
   MPI_Alltoallv(send, send_size_n, send_disp, datatype, recv, recv_size_n,
                 recv_disp, datatype, ref_mpi_comm(ref_mpi));
+  RSS(ref_mpi_trace_end(ref_mpi), "trace");
+  each_ref_mpi_part(ref_mpi, part) {
+    ref_mpi_count_bytes(ref_mpi, datatype, send_size_n[part]);
+  }
 
   free(recv_disp);
   free(send_disp);
@@ -761,6 +1051,268 @@ REF_STATUS ref_mpi_allconcat(REF_MPI ref_mpi, REF_INT ldim, REF_INT my_size,
   return REF_SUCCESS;
 }
 
+static REF_STATUS ref_mpi_copy(void *from, void *to, REF_INT n,
+                               REF_TYPE type) {
+  REF_INT i;
+  switch (type) {
+    case REF_INT_TYPE:
+      for (i = 0; i < n; i++) ((REF_INT *)to)[i] = ((REF_INT *)from)[i];
+      break;
+    case REF_LONG_TYPE:
+      for (i = 0; i < n; i++) ((REF_LONG *)to)[i] = ((REF_LONG *)from)[i];
+      break;
+    case REF_DBL_TYPE:
+      for (i = 0; i < n; i++) ((REF_DBL *)to)[i] = ((REF_DBL *)from)[i];
+      break;
+    case REF_BYTE_TYPE:
+      for (i = 0; i < n; i++) ((REF_BYTE *)to)[i] = ((REF_BYTE *)from)[i];
+      break;
+    default:
+      RSS(REF_IMPLEMENT, "data type");
+  }
+  return REF_SUCCESS;
+}
+
+#ifdef HAVE_MPI
+#define ref_mpi_request_mpi(ref_mpi_request) \
+  (*((MPI_Request *)((ref_mpi_request)->request)))
+
+static REF_STATUS ref_mpi_request_create(REF_MPI_REQUEST *request_ptr) {
+  REF_MPI_REQUEST request;
+  ref_malloc(*request_ptr, 1, REF_MPI_REQUEST_STRUCT);
+  request = *request_ptr;
+  ref_malloc(request->request, 1, MPI_Request);
+  ref_mpi_request_mpi(request) = MPI_REQUEST_NULL;
+  request->sizes = NULL;
+  return REF_SUCCESS;
+}
+#endif
+
+static REF_STATUS ref_mpi_request_free(REF_MPI_REQUEST request) {
+  if (NULL == (void *)request) return REF_NULL;
+  ref_free(request->sizes);
+  ref_free(request->request);
+  ref_free(request);
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_mpi_ibcast(REF_MPI ref_mpi, void *data, REF_INT n,
+                          REF_TYPE type, REF_MPI_REQUEST *request) {
+  *request = NULL;
+#ifdef HAVE_MPI
+  {
+    MPI_Datatype datatype;
+
+    if (!ref_mpi_para(ref_mpi)) return REF_SUCCESS;
+
+    ref_type_mpi_type(type, datatype);
+
+    RSS(ref_mpi_request_create(request), "create request");
+    ref_mpi_where_am_i(ref_mpi);
+    MPI_Ibcast(data, n, datatype, 0, ref_mpi_comm(ref_mpi),
+               &ref_mpi_request_mpi(*request));
+  }
+#else
+  SUPRESS_UNUSED_COMPILER_WARNING(ref_mpi);
+  SUPRESS_UNUSED_COMPILER_WARNING(data);
+  SUPRESS_UNUSED_COMPILER_WARNING(n);
+  SUPRESS_UNUSED_COMPILER_WARNING(type);
+#endif
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_mpi_isend(REF_MPI ref_mpi, void *data, REF_INT n, REF_TYPE type,
+                         REF_INT dest, REF_MPI_REQUEST *request) {
+  *request = NULL;
+#ifdef HAVE_MPI
+  {
+    MPI_Datatype datatype;
+    REF_INT tag;
+
+    ref_type_mpi_type(type, datatype);
+
+    tag = ref_mpi_n(ref_mpi) * dest + ref_mpi_rank(ref_mpi);
+
+    RSS(ref_mpi_request_create(request), "create request");
+    MPI_Isend(data, n, datatype, dest, tag, ref_mpi_comm(ref_mpi),
+              &ref_mpi_request_mpi(*request));
+    ref_mpi_count_bytes(ref_mpi, datatype, n);
+  }
+  return REF_SUCCESS;
+#else
+  SUPRESS_UNUSED_COMPILER_WARNING(ref_mpi);
+  SUPRESS_UNUSED_COMPILER_WARNING(data);
+  SUPRESS_UNUSED_COMPILER_WARNING(n);
+  SUPRESS_UNUSED_COMPILER_WARNING(type);
+  SUPRESS_UNUSED_COMPILER_WARNING(dest);
+  return REF_IMPLEMENT;
+#endif
+}
+
+REF_STATUS ref_mpi_irecv(REF_MPI ref_mpi, void *data, REF_INT n, REF_TYPE type,
+                         REF_INT source, REF_MPI_REQUEST *request) {
+  *request = NULL;
+#ifdef HAVE_MPI
+  {
+    MPI_Datatype datatype;
+    REF_INT tag;
+
+    ref_type_mpi_type(type, datatype);
+
+    tag = ref_mpi_n(ref_mpi) * ref_mpi_rank(ref_mpi) + source;
+
+    RSS(ref_mpi_request_create(request), "create request");
+    MPI_Irecv(data, n, datatype, source, tag, ref_mpi_comm(ref_mpi),
+              &ref_mpi_request_mpi(*request));
+  }
+  return REF_SUCCESS;
+#else
+  SUPRESS_UNUSED_COMPILER_WARNING(ref_mpi);
+  SUPRESS_UNUSED_COMPILER_WARNING(data);
+  SUPRESS_UNUSED_COMPILER_WARNING(n);
+  SUPRESS_UNUSED_COMPILER_WARNING(type);
+  SUPRESS_UNUSED_COMPILER_WARNING(source);
+  return REF_IMPLEMENT;
+#endif
+}
+
+REF_STATUS ref_mpi_ialltoallv(REF_MPI ref_mpi, void *send, REF_INT *send_size,
+                              void *recv, REF_INT *recv_size, REF_INT n,
+                              REF_TYPE type, REF_MPI_REQUEST *request) {
+  *request = NULL;
+
+  if (!ref_mpi_para(ref_mpi)) {
+    REIS(send_size[0], recv_size[0], "sequential send and recv size differ");
+    RAS(ref_math_int_multipliable(n, send_size[0]), "int overflow send_size");
+    RSS(ref_mpi_copy(send, recv, n * send_size[0], type), "copy");
+    return REF_SUCCESS;
+  }
+
+#ifdef HAVE_MPI
+  {
+    MPI_Datatype datatype;
+    REF_INT *send_size_n, *recv_size_n;
+    REF_INT *send_disp, *recv_disp;
+    REF_INT part;
+
+    ref_type_mpi_type(type, datatype);
+
+    RSS(ref_mpi_request_create(request), "create request");
+    ref_malloc((*request)->sizes, 4 * ref_mpi_n(ref_mpi), REF_INT);
+    send_size_n = &((*request)->sizes[0 * ref_mpi_n(ref_mpi)]);
+    recv_size_n = &((*request)->sizes[1 * ref_mpi_n(ref_mpi)]);
+    send_disp = &((*request)->sizes[2 * ref_mpi_n(ref_mpi)]);
+    recv_disp = &((*request)->sizes[3 * ref_mpi_n(ref_mpi)]);
+
+    each_ref_mpi_part(ref_mpi, part) {
+      RAS(0 <= send_size[part], "negative send_size");
+      RAS(ref_math_int_multipliable(n, send_size[part]),
+          "int overflow send_size_n");
+      send_size_n[part] = n * send_size[part];
+      RAS(0 <= recv_size[part], "negative recv_size");
+      RAS(ref_math_int_multipliable(n, recv_size[part]),
+          "int overflow recv_size_n");
+      recv_size_n[part] = n * recv_size[part];
+    }
+
+    send_disp[0] = 0;
+    recv_disp[0] = 0;
+    each_ref_mpi_worker(ref_mpi, part) {
+      RAS(ref_math_int_addable(send_disp[part - 1], send_size_n[part - 1]),
+          "int overflow send_disp");
+      send_disp[part] = send_disp[part - 1] + send_size_n[part - 1];
+      RAS(ref_math_int_addable(recv_disp[part - 1], recv_size_n[part - 1]),
+          "int overflow recv_disp");
+      recv_disp[part] = recv_disp[part - 1] + recv_size_n[part - 1];
+    }
+
+    ref_mpi_where_am_i(ref_mpi);
+    MPI_Ialltoallv(send, send_size_n, send_disp, datatype, recv, recv_size_n,
+                   recv_disp, datatype, ref_mpi_comm(ref_mpi),
+                   &ref_mpi_request_mpi(*request));
+    each_ref_mpi_part(ref_mpi, part) {
+      ref_mpi_count_bytes(ref_mpi, datatype, send_size_n[part]);
+    }
+  }
+#endif
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_mpi_iallsum(REF_MPI ref_mpi, void *value, REF_INT n,
+                           REF_TYPE type, REF_MPI_REQUEST *request) {
+  *request = NULL;
+#ifdef HAVE_MPI
+  {
+    MPI_Datatype datatype;
+
+    if (!ref_mpi_para(ref_mpi)) return REF_SUCCESS;
+
+    ref_type_mpi_type(type, datatype);
+
+    RSS(ref_mpi_request_create(request), "create request");
+    ref_mpi_where_am_i(ref_mpi);
+    MPI_Iallreduce(MPI_IN_PLACE, value, n, datatype, MPI_SUM,
+                   ref_mpi_comm(ref_mpi), &ref_mpi_request_mpi(*request));
+  }
+#else
+  SUPRESS_UNUSED_COMPILER_WARNING(ref_mpi);
+  SUPRESS_UNUSED_COMPILER_WARNING(value);
+  SUPRESS_UNUSED_COMPILER_WARNING(n);
+  SUPRESS_UNUSED_COMPILER_WARNING(type);
+#endif
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_mpi_wait(REF_MPI ref_mpi, REF_MPI_REQUEST *request) {
+  SUPRESS_UNUSED_COMPILER_WARNING(ref_mpi);
+  if (NULL == (void *)(*request)) return REF_SUCCESS;
+#ifdef HAVE_MPI
+  {
+    MPI_Status status;
+    REIS(MPI_SUCCESS, MPI_Wait(&ref_mpi_request_mpi(*request), &status),
+         "wait");
+  }
+#endif
+  RSS(ref_mpi_request_free(*request), "free request");
+  *request = NULL;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_mpi_waitall(REF_MPI ref_mpi, REF_INT n,
+                           REF_MPI_REQUEST *requests) {
+  REF_INT i;
+  for (i = 0; i < n; i++) {
+    RSS(ref_mpi_wait(ref_mpi, &(requests[i])), "wait");
+  }
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_mpi_test(REF_MPI ref_mpi, REF_MPI_REQUEST *request,
+                        REF_BOOL *complete) {
+  SUPRESS_UNUSED_COMPILER_WARNING(ref_mpi);
+  *complete = REF_TRUE;
+  if (NULL == (void *)(*request)) return REF_SUCCESS;
+#ifdef HAVE_MPI
+  {
+    MPI_Status status;
+    int flag;
+    REIS(MPI_SUCCESS,
+         MPI_Test(&ref_mpi_request_mpi(*request), &flag, &status), "test");
+    *complete = (flag ? REF_TRUE : REF_FALSE);
+  }
+#endif
+  if (*complete) {
+    RSS(ref_mpi_request_free(*request), "free request");
+    *request = NULL;
+  }
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_mpi_allminwho(REF_MPI ref_mpi, REF_DBL *val, REF_INT *who,
                              REF_INT n) {
   REF_INT i;
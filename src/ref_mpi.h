@@ -25,6 +25,10 @@
 BEGIN_C_DECLORATION
 typedef struct REF_MPI_STRUCT REF_MPI_STRUCT;
 typedef REF_MPI_STRUCT *REF_MPI;
+typedef struct REF_MPI_REQUEST_STRUCT REF_MPI_REQUEST_STRUCT;
+typedef REF_MPI_REQUEST_STRUCT *REF_MPI_REQUEST;
+typedef struct REF_MPI_TRACE_STRUCT REF_MPI_TRACE_STRUCT;
+typedef REF_MPI_TRACE_STRUCT *REF_MPI_TRACE;
 typedef int REF_TYPE;
 #define REF_UNKNOWN_TYPE (0)
 #define REF_INT_TYPE (1)
@@ -41,12 +45,41 @@ struct REF_MPI_STRUCT {
   REF_DBL start_time;
   REF_DBL first_time;
   REF_BOOL debug;
+  REF_INT nthread;
+  REF_LONG bytes;
+  REF_MPI_TRACE trace;
+};
+
+/* in flight until ref_mpi_wait, buffers must not be touched */
+struct REF_MPI_REQUEST_STRUCT {
+  void *request;  /* MPI_Request */
+  REF_INT *sizes; /* alltoallv sizes and displacements held until wait */
+};
+
+#define REF_MPI_TRACE_NAME (48)
+#define REF_MPI_TRACE_DEPTH (32)
+
+/* timeline of spans on this rank, events in the order recorded */
+struct REF_MPI_TRACE_STRUCT {
+  REF_DBL origin;
+  REF_INT n, max;
+  REF_DBL *start;    /* seconds since origin */
+  REF_DBL *duration; /* negative until the span ends */
+  REF_INT *thread;
+  char *name; /* REF_MPI_TRACE_NAME characters per event */
+  REF_INT depth;
+  REF_INT open[REF_MPI_TRACE_DEPTH];
 };
 
 #define ref_mpi_n(ref_mpi) ((ref_mpi)->n)
 #define ref_mpi_rank(ref_mpi) ((ref_mpi)->id)
 #define ref_mpi_para(ref_mpi) ((ref_mpi)->n > 1)
 #define ref_mpi_once(ref_mpi) (0 == (ref_mpi)->id)
+#define ref_mpi_nthread(ref_mpi) ((ref_mpi)->nthread)
+#define ref_mpi_threaded(ref_mpi) ((ref_mpi)->nthread > 1)
+/* bytes this rank has sent with send, isend, alltoall(v), ialltoallv */
+#define ref_mpi_bytes(ref_mpi) ((ref_mpi)->bytes)
+#define ref_mpi_tracing(ref_mpi) (NULL != (ref_mpi)->trace)
 
 #define each_ref_mpi_part(ref_mpi, part) \
   for ((part) = 0; (part) < ref_mpi_n(ref_mpi); (part)++)
@@ -67,14 +100,29 @@ REF_STATUS ref_mpi_join_comm(REF_MPI split_mpi);
 REF_STATUS ref_mpi_free(REF_MPI ref_mpi);
 REF_STATUS ref_mpi_deep_copy(REF_MPI *ref_mpi, REF_MPI original);
 
+/* MPI_THREAD_FUNNELED, only the main thread makes MPI calls */
 REF_STATUS ref_mpi_start(int argc, char *argv[]);
 REF_STATUS ref_mpi_stop(void);
 
+/* OpenMP threads per rank for threaded loops, limited to 1 without OpenMP */
+REF_STATUS ref_mpi_threads(REF_MPI ref_mpi, REF_INT nthread);
+
 REF_STATUS ref_mpi_int_size_type(REF_SIZE size, REF_TYPE *type);
 
 REF_STATUS ref_mpi_stopwatch_start(REF_MPI ref_mpi);
 REF_STATUS ref_mpi_stopwatch_stop(REF_MPI ref_mpi, const char *message);
 
+/* local wall clock seconds, no barrier */
+REF_STATUS ref_mpi_wtime(REF_MPI ref_mpi, REF_DBL *seconds);
+
+/* collective, the barrier gives every rank a common time origin */
+REF_STATUS ref_mpi_trace_start(REF_MPI ref_mpi);
+/* main thread only, spans nest, no-op unless tracing */
+REF_STATUS ref_mpi_trace_begin(REF_MPI ref_mpi, const char *name);
+REF_STATUS ref_mpi_trace_end(REF_MPI ref_mpi);
+/* collective, rank 0 writes all ranks in Chrome trace event JSON */
+REF_STATUS ref_mpi_trace_dump(REF_MPI ref_mpi, const char *filename);
+
 REF_STATUS ref_mpi_bcast(REF_MPI ref_mpi, void *data, REF_INT n, REF_TYPE type);
 
 REF_STATUS ref_mpi_send(REF_MPI ref_mpi, void *data, REF_INT n, REF_TYPE type,
@@ -110,6 +158,26 @@ REF_STATUS ref_mpi_allconcat(REF_MPI ref_mpi, REF_INT ldim, REF_INT my_size,
                              REF_INT **source, void **concatenated,
                              REF_TYPE type);
 
+REF_STATUS ref_mpi_ibcast(REF_MPI ref_mpi, void *data, REF_INT n,
+                          REF_TYPE type, REF_MPI_REQUEST *request);
+REF_STATUS ref_mpi_isend(REF_MPI ref_mpi, void *data, REF_INT n, REF_TYPE type,
+                         REF_INT dest, REF_MPI_REQUEST *request);
+REF_STATUS ref_mpi_irecv(REF_MPI ref_mpi, void *data, REF_INT n, REF_TYPE type,
+                         REF_INT source, REF_MPI_REQUEST *request);
+REF_STATUS ref_mpi_ialltoallv(REF_MPI ref_mpi, void *send, REF_INT *send_size,
+                              void *recv, REF_INT *recv_size, REF_INT n,
+                              REF_TYPE type, REF_MPI_REQUEST *request);
+REF_STATUS ref_mpi_iallsum(REF_MPI ref_mpi, void *value, REF_INT n,
+                           REF_TYPE type, REF_MPI_REQUEST *request);
+
+/* frees request and sets it to NULL, NULL requests are complete */
+REF_STATUS ref_mpi_wait(REF_MPI ref_mpi, REF_MPI_REQUEST *request);
+REF_STATUS ref_mpi_waitall(REF_MPI ref_mpi, REF_INT n,
+                           REF_MPI_REQUEST *requests);
+/* frees request and sets it to NULL when complete */
+REF_STATUS ref_mpi_test(REF_MPI ref_mpi, REF_MPI_REQUEST *request,
+                        REF_BOOL *complete);
+
 REF_STATUS ref_mpi_allminwho(REF_MPI ref_mpi, REF_DBL *val, REF_INT *who,
                              REF_INT n);
 
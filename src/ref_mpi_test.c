@@ -50,6 +50,16 @@ int main(int argc, char *argv[]) {
     REIS(REF_LONG_TYPE, type, "expected long");
   }
 
+  /* threads */
+  {
+    REIS(1, ref_mpi_nthread(ref_mpi), "serial by default");
+    RSS(ref_mpi_threads(ref_mpi, 2), "two threads");
+    RAS(1 <= ref_mpi_nthread(ref_mpi) && ref_mpi_nthread(ref_mpi) <= 2,
+        "thread count");
+    RSS(ref_mpi_threads(ref_mpi, 1), "one thread");
+    REIS(1, ref_mpi_nthread(ref_mpi), "one thread");
+  }
+
   /* bcast */
   {
     REF_INT bc;
@@ -81,6 +91,111 @@ int main(int argc, char *argv[]) {
     ref_free(a_size);
   }
 
+  /* ibcast */
+  {
+    REF_INT bc;
+    REF_MPI_REQUEST request;
+
+    bc = REF_EMPTY;
+    if (ref_mpi_once(ref_mpi)) bc = 7;
+    RSS(ref_mpi_ibcast(ref_mpi, &bc, 1, REF_INT_TYPE, &request), "ibcast");
+    RSS(ref_mpi_wait(ref_mpi, &request), "wait");
+    RAS(NULL == (void *)request, "request not freed");
+    REIS(7, bc, "bc wrong");
+  }
+
+  /* iallsum */
+  {
+    REF_INT value[2];
+    REF_DBL dbl;
+    REF_MPI_REQUEST requests[2];
+    REF_BOOL complete;
+
+    value[0] = 1;
+    value[1] = ref_mpi_rank(ref_mpi);
+    dbl = 0.5;
+    RSS(ref_mpi_iallsum(ref_mpi, value, 2, REF_INT_TYPE, &(requests[0])),
+        "iallsum int");
+    RSS(ref_mpi_iallsum(ref_mpi, &dbl, 1, REF_DBL_TYPE, &(requests[1])),
+        "iallsum dbl");
+    RSS(ref_mpi_waitall(ref_mpi, 2, requests), "waitall");
+    REIS(ref_mpi_n(ref_mpi), value[0], "int sum");
+    REIS(ref_mpi_n(ref_mpi) * (ref_mpi_n(ref_mpi) - 1) / 2, value[1],
+         "int sum");
+    RWDS(0.5 * (REF_DBL)ref_mpi_n(ref_mpi), dbl, -1.0, "dbl sum");
+
+    RSS(ref_mpi_test(ref_mpi, &(requests[0]), &complete), "test");
+    RAS(complete, "null request should be complete");
+  }
+
+  /* ialltoallv, rank+1 from each part */
+  {
+    REF_INT ldim = 2;
+    REF_INT part, i, l, total;
+    REF_INT *a_size, *b_size;
+    REF_INT *send, *recv;
+    REF_MPI_REQUEST request;
+    REF_BOOL complete;
+
+    ref_malloc(a_size, ref_mpi_n(ref_mpi), REF_INT);
+    ref_malloc(b_size, ref_mpi_n(ref_mpi), REF_INT);
+    each_ref_mpi_part(ref_mpi, part) a_size[part] = part + 1;
+    each_ref_mpi_part(ref_mpi, part) b_size[part] = ref_mpi_rank(ref_mpi) + 1;
+
+    total = 0;
+    each_ref_mpi_part(ref_mpi, part) total += a_size[part];
+    ref_malloc(send, ldim * total, REF_INT);
+    for (i = 0; i < ldim * total; i++) send[i] = ref_mpi_rank(ref_mpi);
+    total = 0;
+    each_ref_mpi_part(ref_mpi, part) total += b_size[part];
+    ref_malloc_init(recv, ldim * total, REF_INT, REF_EMPTY);
+
+    RSS(ref_mpi_ialltoallv(ref_mpi, send, a_size, recv, b_size, ldim,
+                           REF_INT_TYPE, &request),
+        "ialltoallv");
+    complete = REF_FALSE;
+    while (!complete) {
+      RSS(ref_mpi_test(ref_mpi, &request, &complete), "test");
+    }
+    RAS(NULL == (void *)request, "request not freed");
+
+    total = 0;
+    each_ref_mpi_part(ref_mpi, part) {
+      for (i = 0; i < b_size[part]; i++) {
+        for (l = 0; l < ldim; l++) {
+          REIS(part, recv[l + ldim * total], "recv mismatch");
+        }
+        total++;
+      }
+    }
+
+    ref_free(recv);
+    ref_free(send);
+    ref_free(b_size);
+    ref_free(a_size);
+  }
+
+  if (ref_mpi_para(ref_mpi)) { /* isend irecv ring */
+    REF_INT next, prev;
+    REF_DBL send[2], recv[2];
+    REF_MPI_REQUEST requests[2];
+
+    next = (ref_mpi_rank(ref_mpi) + 1) % ref_mpi_n(ref_mpi);
+    prev = (ref_mpi_rank(ref_mpi) + ref_mpi_n(ref_mpi) - 1) %
+           ref_mpi_n(ref_mpi);
+    send[0] = (REF_DBL)ref_mpi_rank(ref_mpi);
+    send[1] = 2.0;
+    recv[0] = -1.0;
+    recv[1] = -1.0;
+    RSS(ref_mpi_irecv(ref_mpi, recv, 2, REF_DBL_TYPE, prev, &(requests[0])),
+        "irecv");
+    RSS(ref_mpi_isend(ref_mpi, send, 2, REF_DBL_TYPE, next, &(requests[1])),
+        "isend");
+    RSS(ref_mpi_waitall(ref_mpi, 2, requests), "waitall");
+    RWDS((REF_DBL)prev, recv[0], -1.0, "recv prev");
+    RWDS(2.0, recv[1], -1.0, "recv const");
+  }
+
   /* allconcat */
   {
     REF_INT ldim = 2;
@@ -462,6 +577,47 @@ int main(int argc, char *argv[]) {
     ref_free(items);
   }
 
+  { /* trace spans */
+    char filename[] = "ref_mpi_test_trace.json";
+    REF_MPI_TRACE trace;
+    FILE *file;
+    char line[1024];
+
+    RAS(!ref_mpi_tracing(ref_mpi), "off by default");
+    RSS(ref_mpi_trace_begin(ref_mpi, "ignored"), "no-op begin");
+    RSS(ref_mpi_trace_end(ref_mpi), "no-op end");
+
+    RSS(ref_mpi_trace_start(ref_mpi), "start");
+    RAS(ref_mpi_tracing(ref_mpi), "on");
+    REIS(REF_FAILURE, ref_mpi_trace_end(ref_mpi), "end without begin");
+    RSS(ref_mpi_trace_begin(ref_mpi, "outer"), "begin");
+    RSS(ref_mpi_trace_begin(ref_mpi, "say \"inner\""), "begin");
+    RSS(ref_mpi_trace_end(ref_mpi), "end");
+    RSS(ref_mpi_stopwatch_stop(ref_mpi, "phase"), "phase");
+    RSS(ref_mpi_trace_end(ref_mpi), "end");
+
+    trace = ref_mpi->trace;
+    REIS(0, trace->depth, "balanced");
+    RAS(3 <= trace->n, "outer, inner, and phase");
+    REIS(0, strcmp("outer", &(trace->name[0])), "outer name");
+    REIS(0, strcmp("say  inner ", &(trace->name[REF_MPI_TRACE_NAME])),
+         "quotes removed");
+    REIS(0, strcmp("phase", &(trace->name[2 * REF_MPI_TRACE_NAME])),
+         "phase name");
+    RAS(trace->duration[1] >= 0.0, "inner ended");
+    RAS(trace->duration[0] >= trace->duration[1], "outer holds inner");
+
+    RSS(ref_mpi_trace_dump(ref_mpi, filename), "dump");
+    if (ref_mpi_once(ref_mpi)) {
+      file = fopen(filename, "r");
+      RNS(file, "unable to open file");
+      RNS(fgets(line, 1024, file), "first line");
+      REIS(0, strcmp("{\"traceEvents\":[\n", line), "trace event header");
+      fclose(file);
+      REIS(0, remove(filename), "test clean up");
+    }
+  }
+
   RSS(ref_mpi_free(ref_mpi), "mpi free");
   RSS(ref_mpi_stop(), "stop");
 
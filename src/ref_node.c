@@ -64,6 +64,8 @@ REF_STATUS ref_node_create(REF_NODE *ref_node_ptr, REF_MPI ref_mpi) {
   ref_node->aux = NULL;
 
   ref_node_mpi(ref_node) = ref_mpi; /* reference only */
+  ref_node_arena(ref_node) = NULL; /* reference only */
+  ref_node->point_index = NULL;
 
   ref_node_n_unused(ref_node) = 0;
   ref_node_max_unused(ref_node) = 10;
@@ -86,6 +88,7 @@ REF_STATUS ref_node_create(REF_NODE *ref_node_ptr, REF_MPI ref_mpi) {
 
 REF_STATUS ref_node_free(REF_NODE ref_node) {
   if (NULL == (void *)ref_node) return REF_NULL;
+  RSS(ref_node_index_invalidate(ref_node), "free index");
   ref_free(ref_node->unused_global);
   /* ref_mpi reference only */
   ref_free(ref_node->aux);
@@ -147,6 +150,8 @@ REF_STATUS ref_node_deep_copy(REF_NODE *ref_node_ptr, REF_NODE original) {
   }
 
   ref_node_mpi(ref_node) = ref_node_mpi(original); /* reference only */
+  ref_node_arena(ref_node) = NULL;                  /* reference only */
+  ref_node->point_index = NULL;
 
   ref_node->n_unused = original->n_unused;
   ref_node->max_unused = original->max_unused;
@@ -171,6 +176,7 @@ REF_STATUS ref_node_deep_copy(REF_NODE *ref_node_ptr, REF_NODE original) {
 REF_STATUS ref_node_pack(REF_NODE ref_node, REF_INT *o2n, REF_INT *n2o) {
   REF_INT i, node;
   REF_NODE copy;
+  RSS(ref_node_index_invalidate(ref_node), "renumbered");
   RSS(ref_node_deep_copy(&copy, ref_node), "make a copy first");
 
   for (node = 0; node < ref_node_n(ref_node); node++)
@@ -281,6 +287,7 @@ static REF_STATUS ref_node_add_core(REF_NODE ref_node, REF_GLOB global,
   REF_INT orig, chunk, extra;
 
   if (global < 0) RSS(REF_INVALID, "invalid global node");
+  RSS(ref_node_index_invalidate(ref_node), "added");
 
   if (REF_EMPTY == ref_node->blank) {
     orig = ref_node_max(ref_node);
@@ -383,7 +390,7 @@ REF_STATUS ref_node_add_many(REF_NODE ref_node, REF_INT n,
 
   ref_malloc(sorted, nadd, REF_INT);
 
-  RSS(ref_sort_heap_glob(nadd, global, sorted), "heap");
+  RSS(ref_sort_radix_glob(nadd, global, sorted), "radix");
 
   j = 0;
   for (i = 1; i < nadd; i++) {
@@ -412,6 +419,7 @@ REF_STATUS ref_node_add_many(REF_NODE ref_node, REF_INT n,
 REF_STATUS ref_node_remove(REF_NODE ref_node, REF_INT node) {
   REF_INT location, sorted_node;
   if (!ref_node_valid(ref_node, node)) return REF_INVALID;
+  RSS(ref_node_index_invalidate(ref_node), "removed");
 
   RSS(ref_sort_search_glob(ref_node_n(ref_node), ref_node->sorted_global,
                            ref_node->global[node], &location),
@@ -439,6 +447,7 @@ REF_STATUS ref_node_remove(REF_NODE ref_node, REF_INT node) {
 
 REF_STATUS ref_node_remove_invalidates_sorted(REF_NODE ref_node, REF_INT node) {
   if (!ref_node_valid(ref_node, node)) return REF_INVALID;
+  RSS(ref_node_index_invalidate(ref_node), "removed");
 
   RSS(ref_node_push_unused(ref_node, ref_node->global[node]),
       "store unused global");
@@ -454,6 +463,7 @@ REF_STATUS ref_node_remove_invalidates_sorted(REF_NODE ref_node, REF_INT node) {
 REF_STATUS ref_node_remove_without_global(REF_NODE ref_node, REF_INT node) {
   REF_INT location, sorted_node;
   if (!ref_node_valid(ref_node, node)) return REF_INVALID;
+  RSS(ref_node_index_invalidate(ref_node), "removed");
 
   RSS(ref_sort_search_glob(ref_node_n(ref_node), ref_node->sorted_global,
                            ref_node->global[node], &location),
@@ -479,6 +489,7 @@ REF_STATUS ref_node_remove_without_global(REF_NODE ref_node, REF_INT node) {
 REF_STATUS ref_node_remove_without_global_invalidates_sorted(REF_NODE ref_node,
                                                              REF_INT node) {
   if (!ref_node_valid(ref_node, node)) return REF_INVALID;
+  RSS(ref_node_index_invalidate(ref_node), "removed");
 
   ref_node->global[node] = ref_node->blank;
   ref_node->blank = index2next(node);
@@ -500,9 +511,9 @@ REF_STATUS ref_node_rebuild_sorted_global(REF_NODE ref_node) {
     nnode++;
   }
 
-  RSS(ref_sort_heap_glob(ref_node_n(ref_node), ref_node->sorted_global,
-                         ref_node->sorted_local),
-      "heap");
+  RSS(ref_sort_radix_glob(ref_node_n(ref_node), ref_node->sorted_global,
+                          ref_node->sorted_local),
+      "radix");
 
   for (node = 0; node < ref_node_n(ref_node); node++) {
     ref_node->sorted_local[node] = pack[ref_node->sorted_local[node]];
@@ -856,6 +867,7 @@ REF_STATUS ref_node_compact(REF_NODE ref_node, REF_INT **o2n_ptr,
 }
 
 REF_STATUS ref_node_ghost_real(REF_NODE ref_node) {
+  RSS(ref_node_index_invalidate(ref_node), "ghost xyz");
   RSS(ref_node_ghost_dbl(ref_node, ref_node->real, REF_NODE_REAL_PER),
       "ghost dbl");
   if (ref_node_naux(ref_node) > 0)
@@ -877,6 +889,8 @@ REF_STATUS ref_node_ghost_int(REF_NODE ref_node, REF_INT *vector,
 
   if (!ref_mpi_para(ref_mpi)) return REF_SUCCESS;
 
+  RSS(ref_mpi_trace_begin(ref_mpi, "ghost int"), "trace");
+
   ref_malloc_init(a_size, ref_mpi_n(ref_mpi), REF_INT, 0);
   ref_malloc_init(b_size, ref_mpi_n(ref_mpi), REF_INT, 0);
 
@@ -963,6 +977,8 @@ REF_STATUS ref_node_ghost_int(REF_NODE ref_node, REF_INT *vector,
   free(b_size);
   free(a_size);
 
+  RSS(ref_mpi_trace_end(ref_mpi), "trace");
+
   return REF_SUCCESS;
 }
 
@@ -979,6 +995,8 @@ REF_STATUS ref_node_ghost_glob(REF_NODE ref_node, REF_GLOB *vector,
 
   if (!ref_mpi_para(ref_mpi)) return REF_SUCCESS;
 
+  RSS(ref_mpi_trace_begin(ref_mpi, "ghost glob"), "trace");
+
   ref_malloc_init(a_size, ref_mpi_n(ref_mpi), REF_INT, 0);
   ref_malloc_init(b_size, ref_mpi_n(ref_mpi), REF_INT, 0);
 
@@ -1065,12 +1083,15 @@ REF_STATUS ref_node_ghost_glob(REF_NODE ref_node, REF_GLOB *vector,
   free(b_size);
   free(a_size);
 
+  RSS(ref_mpi_trace_end(ref_mpi), "trace");
+
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_node_ghost_dbl(REF_NODE ref_node, REF_DBL *vector,
-                              REF_INT ldim) {
+static REF_STATUS ref_node_ghost_dbl_frames(REF_NODE ref_node,
+                                            REF_DBL *vector, REF_INT ldim) {
   REF_MPI ref_mpi = ref_node_mpi(ref_node);
+  REF_ARENA ref_arena = ref_node_arena(ref_node);
   REF_INT *a_size, *b_size;
   REF_INT a_total, b_total;
   REF_GLOB *a_global, *b_global;
@@ -1081,8 +1102,10 @@ REF_STATUS ref_node_ghost_dbl(REF_NODE ref_node, REF_DBL *vector,
 
   if (!ref_mpi_para(ref_mpi)) return REF_SUCCESS;
 
-  ref_malloc_init(a_size, ref_mpi_n(ref_mpi), REF_INT, 0);
-  ref_malloc_init(b_size, ref_mpi_n(ref_mpi), REF_INT, 0);
+  RSS(ref_mpi_trace_begin(ref_mpi, "ghost dbl"), "trace");
+
+  ref_arena_malloc_init(ref_arena, a_size, ref_mpi_n(ref_mpi), REF_INT, 0);
+  ref_arena_malloc_init(ref_arena, b_size, ref_mpi_n(ref_mpi), REF_INT, 0);
 
   each_ref_node_valid_node(ref_node, node) {
     if (ref_mpi_rank(ref_mpi) != ref_node_part(ref_node, node)) {
@@ -1095,13 +1118,13 @@ REF_STATUS ref_node_ghost_dbl(REF_NODE ref_node, REF_DBL *vector,
 
   a_total = 0;
   each_ref_mpi_part(ref_mpi, part) a_total += a_size[part];
-  ref_malloc(a_global, a_total, REF_GLOB);
+  ref_arena_malloc(ref_arena, a_global, a_total, REF_GLOB);
 
   b_total = 0;
   each_ref_mpi_part(ref_mpi, part) b_total += b_size[part];
-  ref_malloc(b_global, b_total, REF_GLOB);
+  ref_arena_malloc(ref_arena, b_global, b_total, REF_GLOB);
 
-  ref_malloc(a_next, ref_mpi_n(ref_mpi), REF_INT);
+  ref_arena_malloc(ref_arena, a_next, ref_mpi_n(ref_mpi), REF_INT);
   a_next[0] = 0;
   each_ref_mpi_worker(ref_mpi, part) a_next[part] =
       a_next[part - 1] + a_size[part - 1];
@@ -1119,8 +1142,8 @@ REF_STATUS ref_node_ghost_dbl(REF_NODE ref_node, REF_DBL *vector,
       "alltoallv global");
 
   if (a_total < REF_INT_MAX / ldim && b_total < REF_INT_MAX / ldim) {
-    ref_malloc(a_vector, ldim * a_total, REF_DBL);
-    ref_malloc(b_vector, ldim * b_total, REF_DBL);
+    ref_arena_malloc(ref_arena, a_vector, ldim * a_total, REF_DBL);
+    ref_arena_malloc(ref_arena, b_vector, ldim * b_total, REF_DBL);
     for (node = 0; node < b_total; node++) {
       RSS(ref_node_local(ref_node, b_global[node], &local), "g2l");
       for (i = 0; i < ldim; i++)
@@ -1136,11 +1159,11 @@ REF_STATUS ref_node_ghost_dbl(REF_NODE ref_node, REF_DBL *vector,
       for (i = 0; i < ldim; i++)
         vector[i + ldim * local] = a_vector[i + ldim * node];
     }
-    free(b_vector);
-    free(a_vector);
+    ref_arena_release(ref_arena, b_vector);
+    ref_arena_release(ref_arena, a_vector);
   } else {
-    ref_malloc(a_vector, a_total, REF_DBL);
-    ref_malloc(b_vector, b_total, REF_DBL);
+    ref_arena_malloc(ref_arena, a_vector, a_total, REF_DBL);
+    ref_arena_malloc(ref_arena, b_vector, b_total, REF_DBL);
     for (i = 0; i < ldim; i++) {
       for (node = 0; node < b_total; node++) {
         RSS(ref_node_local(ref_node, b_global[node], &local), "g2l");
@@ -1156,18 +1179,30 @@ REF_STATUS ref_node_ghost_dbl(REF_NODE ref_node, REF_DBL *vector,
         vector[i + ldim * local] = a_vector[node];
       }
     }
-    free(b_vector);
-    free(a_vector);
+    ref_arena_release(ref_arena, b_vector);
+    ref_arena_release(ref_arena, a_vector);
   }
-  free(a_next);
-  free(b_global);
-  free(a_global);
-  free(b_size);
-  free(a_size);
+  ref_arena_release(ref_arena, a_next);
+  ref_arena_release(ref_arena, b_global);
+  ref_arena_release(ref_arena, a_global);
+  ref_arena_release(ref_arena, b_size);
+  ref_arena_release(ref_arena, a_size);
+
+  RSS(ref_mpi_trace_end(ref_mpi), "trace");
 
   return REF_SUCCESS;
 }
 
+REF_STATUS ref_node_ghost_dbl(REF_NODE ref_node, REF_DBL *vector,
+                              REF_INT ldim) {
+  REF_ARENA ref_arena = ref_node_arena(ref_node);
+  REF_INT mark;
+  RSS(ref_arena_mark(ref_arena, &mark), "mark");
+  RSB(ref_node_ghost_dbl_frames(ref_node, vector, ldim), "ghost dbl",
+      { ref_arena_unwind(ref_arena, mark); });
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_node_localize_ghost_int(REF_NODE ref_node, REF_INT *scalar) {
   REF_MPI ref_mpi = ref_node_mpi(ref_node);
   REF_INT *a_size, *b_size;
@@ -3025,22 +3060,125 @@ REF_STATUS ref_node_tri_grad_nodes(REF_NODE ref_node, REF_INT *nodes,
   return REF_SUCCESS;
 }
 
+REF_STATUS ref_node_index_invalidate(REF_NODE ref_node) {
+  if (NULL != (void *)ref_node->point_index) {
+    RSS(ref_search_free(ref_node->point_index), "free index");
+    ref_node->point_index = NULL;
+  }
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_node_index(REF_NODE ref_node, REF_SEARCH *ref_search) {
+  REF_INT n, node, i, *item;
+  REF_DBL *position, *radius;
+
+  if (NULL == (void *)ref_node->point_index) {
+    ref_malloc(item, ref_node_n(ref_node), REF_INT);
+    ref_malloc(position, 3 * ref_node_n(ref_node), REF_DBL);
+    ref_malloc_init(radius, ref_node_n(ref_node), REF_DBL, 0.0);
+    n = 0;
+    each_ref_node_valid_node(ref_node, node) {
+      item[n] = node;
+      for (i = 0; i < 3; i++)
+        position[i + 3 * n] = ref_node_xyz(ref_node, i, node);
+      n++;
+    }
+    RSS(ref_search_create(&(ref_node->point_index), n), "create index");
+    RSS(ref_search_bulk(ref_node->point_index, n, item, position, radius),
+        "build index");
+    ref_free(radius);
+    ref_free(position);
+    ref_free(item);
+  }
+  *ref_search = ref_node->point_index;
+
+  return REF_SUCCESS;
+}
+
+static REF_DBL ref_node_xyz_distance(REF_NODE ref_node, REF_INT node,
+                                     REF_DBL *xyz) {
+  return sqrt(pow(xyz[0] - ref_node_xyz(ref_node, 0, node), 2) +
+              pow(xyz[1] - ref_node_xyz(ref_node, 1, node), 2) +
+              pow(xyz[2] - ref_node_xyz(ref_node, 2, node), 2));
+}
+
 REF_STATUS ref_node_nearest_xyz(REF_NODE ref_node, REF_DBL *xyz,
                                 REF_INT *closest_node, REF_DBL *distance) {
-  REF_INT node;
+  REF_SEARCH ref_search;
+  REF_LIST ref_list;
+  REF_INT item, node;
   REF_DBL dist;
   *closest_node = REF_EMPTY;
   *distance = 1.0e100;
-  each_ref_node_valid_node(ref_node, node) {
-    dist = pow(xyz[0] - ref_node_xyz(ref_node, 0, node), 2) +
-           pow(xyz[1] - ref_node_xyz(ref_node, 1, node), 2) +
-           pow(xyz[2] - ref_node_xyz(ref_node, 2, node), 2);
-    if (dist < *distance) {
+  if (0 == ref_node_n(ref_node)) return REF_SUCCESS;
+  RSS(ref_node_index(ref_node, &ref_search), "index");
+  RSS(ref_list_create(&ref_list), "create list");
+  RSS(ref_search_nearest_candidates(ref_search, ref_list, xyz), "candidates");
+  each_ref_list_item(ref_list, item) {
+    node = ref_list_value(ref_list, item);
+    dist = ref_node_xyz_distance(ref_node, node, xyz);
+    /* lowest index among equidistant nodes, as the scan did */
+    if (dist < *distance || (dist == *distance && node < *closest_node)) {
       *closest_node = node;
       *distance = dist;
     }
   }
-  *distance = sqrt(*distance);
+  RSS(ref_list_free(ref_list), "free list");
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_node_nearest_k(REF_NODE ref_node, REF_DBL *xyz, REF_INT k,
+                              REF_INT *nfound, REF_INT *nodes,
+                              REF_DBL *distances) {
+  REF_SEARCH ref_search;
+  REF_LIST ref_list;
+  REF_INT i, item, n, *order;
+  REF_DBL radius, reach, *dist;
+
+  *nfound = 0;
+  if (k < 1 || 0 == ref_node_n(ref_node)) return REF_SUCCESS;
+  RSS(ref_node_index(ref_node, &ref_search), "index");
+
+  /* the root ball bounds every node, grow radius until k are inside */
+  reach = 0.0;
+  for (i = 0; i < 3; i++) reach += pow(xyz[i] - ref_search->pos[i], 2);
+  reach = sqrt(reach) + ref_search->children_ball[0];
+  RSS(ref_search_trim_radius(ref_search, xyz, &radius), "nearest radius");
+  radius = MAX(radius, 1.0e-3 * reach);
+  RSS(ref_list_create(&ref_list), "create list");
+  while (REF_TRUE) {
+    RSS(ref_search_touching(ref_search, ref_list, xyz, radius), "touch");
+    if (ref_list_n(ref_list) >= k || radius >= reach) break;
+    RSS(ref_list_erase(ref_list), "reset");
+    radius *= 2.0;
+  }
+
+  n = ref_list_n(ref_list);
+  ref_malloc(dist, n, REF_DBL);
+  ref_malloc(order, n, REF_INT);
+  each_ref_list_item(ref_list, item) {
+    dist[item] = ref_node_xyz_distance(ref_node,
+                                       ref_list_value(ref_list, item), xyz);
+  }
+  RSS(ref_sort_heap_dbl(n, dist, order), "sort distance");
+  *nfound = MIN(k, n);
+  for (item = 0; item < *nfound; item++) {
+    nodes[item] = ref_list_value(ref_list, order[item]);
+    distances[item] = dist[order[item]];
+  }
+  ref_free(order);
+  ref_free(dist);
+  RSS(ref_list_free(ref_list), "free list");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_node_within_radius(REF_NODE ref_node, REF_DBL *xyz,
+                                  REF_DBL radius, REF_LIST ref_list) {
+  REF_SEARCH ref_search;
+  if (0 == ref_node_n(ref_node)) return REF_SUCCESS;
+  RSS(ref_node_index(ref_node, &ref_search), "index");
+  RSS(ref_search_touching(ref_search, ref_list, xyz, radius), "touch");
   return REF_SUCCESS;
 }
 
@@ -26,7 +26,10 @@ typedef struct REF_NODE_STRUCT REF_NODE_STRUCT;
 typedef REF_NODE_STRUCT *REF_NODE;
 END_C_DECLORATION
 
+#include "ref_arena.h"
+#include "ref_list.h"
 #include "ref_mpi.h"
+#include "ref_search.h"
 
 BEGIN_C_DECLORATION
 
@@ -42,6 +45,8 @@ struct REF_NODE_STRUCT {
   REF_INT naux;
   REF_DBL *aux;
   REF_MPI ref_mpi;
+  REF_ARENA ref_arena;
+  REF_SEARCH point_index;
   REF_INT n_unused, max_unused;
   REF_GLOB *unused_global;
   REF_GLOB old_n_global, new_n_global;
@@ -99,6 +104,7 @@ struct REF_NODE_STRUCT {
   ((ref_node)->aux[(iaux) + ref_node_naux(ref_node) * (node)])
 
 #define ref_node_mpi(ref_node) ((ref_node)->ref_mpi)
+#define ref_node_arena(ref_node) ((ref_node)->ref_arena)
 
 #define ref_node_n_unused(ref_node) ((ref_node)->n_unused)
 #define ref_node_max_unused(ref_node) ((ref_node)->max_unused)
@@ -244,8 +250,19 @@ REF_STATUS ref_node_tet_grad_nodes(REF_NODE ref_node, REF_INT *nodes,
 REF_STATUS ref_node_tri_grad_nodes(REF_NODE ref_node, REF_INT *nodes,
                                    REF_DBL *scalar, REF_DBL *gradient);
 
+/* point queries use a search tree of valid node xyz built at first use,
+ * add, remove, pack, and ghost update discard it, code that writes
+ * ref_node_xyz of existing nodes calls ref_node_index_invalidate */
+REF_STATUS ref_node_index_invalidate(REF_NODE ref_node);
 REF_STATUS ref_node_nearest_xyz(REF_NODE ref_node, REF_DBL *xyz,
                                 REF_INT *closest_node, REF_DBL *distance);
+/* up to k nodes nearest first, nfound < k when fewer valid nodes */
+REF_STATUS ref_node_nearest_k(REF_NODE ref_node, REF_DBL *xyz, REF_INT k,
+                              REF_INT *nfound, REF_INT *nodes,
+                              REF_DBL *distances);
+/* appends nodes within radius (inclusive) of xyz */
+REF_STATUS ref_node_within_radius(REF_NODE ref_node, REF_DBL *xyz,
+                                  REF_DBL radius, REF_LIST ref_list);
 
 REF_STATUS ref_node_bounding_box_diagonal(REF_NODE ref_node, REF_DBL *diagonal);
 
@@ -2453,6 +2453,79 @@ int main(int argc, char *argv[]) {
          "diagonal expected");
   }
 
+  { /* indexed nearest queries match a scan of the nodes */
+    REF_NODE ref_node;
+    REF_LIST ref_list;
+    REF_INT i, j, node, closest, nfound, nodes[20], item;
+    REF_DBL xyz[3], distance, distances[20], dist;
+    REF_BOOL inside;
+    RSS(ref_node_create(&ref_node, ref_mpi), "create");
+    for (i = 0; i < 4; i++) {
+      for (j = 0; j < 4; j++) {
+        RSS(ref_node_add(ref_node, i + 4 * j, &node), "add");
+        ref_node_xyz(ref_node, 0, node) = (REF_DBL)i;
+        ref_node_xyz(ref_node, 1, node) = (REF_DBL)j;
+        ref_node_xyz(ref_node, 2, node) = 0.1 * (REF_DBL)(i * j);
+      }
+    }
+    RSS(ref_node_remove(ref_node, 5), "hole");
+    xyz[0] = 1.1;
+    xyz[1] = 1.2;
+    xyz[2] = 0.0;
+    RSS(ref_node_nearest_xyz(ref_node, xyz, &closest, &distance), "near");
+    REIS(6, closest, "5 removed, (1,2) closest");
+    RWDS(sqrt(0.1 * 0.1 + 0.8 * 0.8 + 0.2 * 0.2), distance, -1.0, "dist");
+
+    RSS(ref_node_nearest_k(ref_node, xyz, 5, &nfound, nodes, distances),
+        "k");
+    REIS(5, nfound, "found");
+    for (i = 0; i < nfound; i++) {
+      /* no node outside the answer is closer than the farthest found */
+      each_ref_node_valid_node(ref_node, node) {
+        dist = sqrt(pow(xyz[0] - ref_node_xyz(ref_node, 0, node), 2) +
+                    pow(xyz[1] - ref_node_xyz(ref_node, 1, node), 2) +
+                    pow(xyz[2] - ref_node_xyz(ref_node, 2, node), 2));
+        if (dist < distances[nfound - 1]) {
+          for (j = 0; j < nfound; j++)
+            if (nodes[j] == node) break;
+          RAS(j < nfound, "closer node missed");
+        }
+      }
+      if (i > 0) RAS(distances[i - 1] <= distances[i], "not sorted");
+    }
+    REIS(closest, nodes[0], "k nearest first");
+
+    RSS(ref_node_nearest_k(ref_node, xyz, 20, &nfound, nodes, distances),
+        "k");
+    REIS(15, nfound, "every valid node when k exceeds n");
+
+    RSS(ref_list_create(&ref_list), "list");
+    RSS(ref_node_within_radius(ref_node, xyz, 1.0, ref_list), "radius");
+    each_ref_node_valid_node(ref_node, node) {
+      dist = sqrt(pow(xyz[0] - ref_node_xyz(ref_node, 0, node), 2) +
+                  pow(xyz[1] - ref_node_xyz(ref_node, 1, node), 2) +
+                  pow(xyz[2] - ref_node_xyz(ref_node, 2, node), 2));
+      RSS(ref_list_contains(ref_list, node, &inside), "contains");
+      RAS((dist <= 1.0) == inside, "radius set");
+    }
+    RSS(ref_list_free(ref_list), "list");
+
+    /* moved node is found after invalidate */
+    ref_node_xyz(ref_node, 0, 15) = 1.1;
+    ref_node_xyz(ref_node, 1, 15) = 1.2;
+    ref_node_xyz(ref_node, 2, 15) = 0.0;
+    RSS(ref_node_index_invalidate(ref_node), "moved");
+    RSS(ref_node_nearest_xyz(ref_node, xyz, &closest, &distance), "near");
+    REIS(15, closest, "moved node");
+    RWDS(0.0, distance, -1.0, "on node");
+    item = REF_EMPTY;
+    RSS(ref_node_nearest_k(ref_node, xyz, 1, &nfound, &item, distances),
+        "k");
+    REIS(15, item, "moved node");
+
+    RSS(ref_node_free(ref_node), "free");
+  }
+
   RSS(ref_mpi_free(ref_mpi), "mpi free");
   RSS(ref_mpi_stop(), "stop");
 
@@ -0,0 +1,405 @@
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "ref_perf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include "ref_malloc.h"
+
+static const char *ref_perf_op_name[] = {"swap", "collapse", "split",
+                                         "smooth"};
+static const char *ref_perf_reason_name[] = {
+    "ratio", "quality",    "geometry", "mixed",
+    "ghost", "conformity", "cavity",   "degree"};
+
+REF_STATUS ref_perf_create(REF_PERF *ref_perf_ptr) {
+  REF_PERF ref_perf;
+  REF_INT i;
+
+  ref_malloc(*ref_perf_ptr, 1, REF_PERF_STRUCT);
+  ref_perf = (*ref_perf_ptr);
+
+  ref_perf->npass = 0;
+  ref_perf->max_pass = 10;
+  ref_malloc_init(ref_perf->time, REF_PERF_LAST_OP * ref_perf->max_pass,
+                  REF_DBL, 0.0);
+  ref_malloc_init(ref_perf->count,
+                  REF_PERF_NCOUNT * REF_PERF_LAST_OP * ref_perf->max_pass,
+                  REF_LONG, 0);
+  ref_malloc_init(ref_perf->memory, ref_perf->max_pass, REF_DBL, 0.0);
+  ref_malloc_init(ref_perf->check,
+                  REF_PERF_LAST_REASON * REF_PERF_LAST_OP * ref_perf->max_pass,
+                  REF_DBL, 0.0);
+
+  ref_perf->op = REF_PERF_LAST_OP;
+  ref_perf->timing = REF_TRUE;
+  ref_perf->start_time = 0.0;
+  ref_perf->lap = 0.0;
+  for (i = 0; i < REF_PERF_LAST_REASON; i++) ref_perf->lap_time[i] = 0.0;
+  ref_perf->start_bytes = 0;
+  ref_perf->start_node = 0;
+  ref_perf->start_cell = 0;
+  for (i = 0; i < REF_PERF_NCOUNT; i++) ref_perf->tally[i] = 0;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_perf_free(REF_PERF ref_perf) {
+  if (NULL == (void *)ref_perf) return REF_NULL;
+  ref_free(ref_perf->check);
+  ref_free(ref_perf->memory);
+  ref_free(ref_perf->count);
+  ref_free(ref_perf->time);
+  ref_free(ref_perf);
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_perf_pass(REF_PERF ref_perf) {
+  REF_INT old;
+
+  if (NULL == (void *)ref_perf) return REF_SUCCESS;
+  RAS(REF_PERF_LAST_OP == ref_perf->op, "pass started with operator running");
+
+  if (ref_perf->npass >= ref_perf->max_pass) {
+    old = ref_perf->max_pass;
+    ref_perf->max_pass += 10;
+    ref_realloc_init(ref_perf->time, REF_PERF_LAST_OP * old,
+                     REF_PERF_LAST_OP * ref_perf->max_pass, REF_DBL, 0.0);
+    ref_realloc_init(ref_perf->count, REF_PERF_NCOUNT * REF_PERF_LAST_OP * old,
+                     REF_PERF_NCOUNT * REF_PERF_LAST_OP * ref_perf->max_pass,
+                     REF_LONG, 0);
+    ref_realloc_init(ref_perf->memory, old, ref_perf->max_pass, REF_DBL, 0.0);
+    ref_realloc_init(
+        ref_perf->check, REF_PERF_LAST_REASON * REF_PERF_LAST_OP * old,
+        REF_PERF_LAST_REASON * REF_PERF_LAST_OP * ref_perf->max_pass, REF_DBL,
+        0.0);
+  }
+  ref_perf->npass++;
+
+  return REF_SUCCESS;
+}
+
+/* nodes include ghosts, cells are the elements the operators modify */
+static REF_STATUS ref_perf_local_size(REF_GRID ref_grid, REF_INT *nnode,
+                                      REF_INT *ncell) {
+  *nnode = ref_node_n(ref_grid_node(ref_grid));
+  if (ref_grid_twod(ref_grid) || ref_grid_surf(ref_grid)) {
+    *ncell = ref_cell_n(ref_grid_tri(ref_grid));
+  } else {
+    *ncell = ref_cell_n(ref_grid_tet(ref_grid));
+  }
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_perf_peak_memory(REF_DBL *megabytes) {
+  struct rusage usage;
+  *megabytes = 0.0;
+  REIS(0, getrusage(RUSAGE_SELF, &usage), "getrusage");
+#ifdef __APPLE__
+  *megabytes = (REF_DBL)usage.ru_maxrss / 1048576.0; /* bytes */
+#else
+  *megabytes = (REF_DBL)usage.ru_maxrss / 1024.0; /* kilobytes */
+#endif
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_perf_start(REF_GRID ref_grid, REF_PERF_OP op) {
+  REF_PERF ref_perf = ref_grid_perf(ref_grid);
+
+  RAS(0 <= op && op < REF_PERF_LAST_OP, "invalid operator");
+  RSS(ref_mpi_trace_begin(ref_grid_mpi(ref_grid), ref_perf_op_name[op]),
+      "trace");
+
+  if (NULL == (void *)ref_perf) return REF_SUCCESS;
+  RAS(REF_PERF_LAST_OP == ref_perf->op, "operator already running");
+
+  if (0 == ref_perf_npass(ref_perf)) RSS(ref_perf_pass(ref_perf), "first");
+
+  ref_perf->op = op;
+  RSS(ref_perf_local_size(ref_grid, &(ref_perf->start_node),
+                          &(ref_perf->start_cell)),
+      "size");
+  ref_perf->start_bytes = ref_mpi_bytes(ref_grid_mpi(ref_grid));
+  RSS(ref_mpi_wtime(ref_grid_mpi(ref_grid), &(ref_perf->start_time)), "time");
+  ref_perf->lap = ref_perf->start_time;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_perf_stop(REF_GRID ref_grid) {
+  REF_PERF ref_perf = ref_grid_perf(ref_grid);
+  REF_INT i, pass, nnode, ncell;
+  REF_PERF_OP op;
+  REF_DBL now, megabytes;
+
+  RSS(ref_mpi_trace_end(ref_grid_mpi(ref_grid)), "trace");
+
+  if (NULL == (void *)ref_perf) return REF_SUCCESS;
+  op = ref_perf->op;
+  RAS(REF_PERF_LAST_OP != op, "no operator running");
+  pass = ref_perf_npass(ref_perf) - 1;
+
+  RSS(ref_mpi_wtime(ref_grid_mpi(ref_grid), &now), "time");
+  ref_perf_time(ref_perf, op, pass) += now - ref_perf->start_time;
+
+  RSS(ref_perf_local_size(ref_grid, &nnode, &ncell), "size");
+  ref_perf->tally[REF_PERF_NODE] = (REF_LONG)(nnode - ref_perf->start_node);
+  ref_perf->tally[REF_PERF_CELL] = (REF_LONG)(ncell - ref_perf->start_cell);
+  ref_perf->tally[REF_PERF_BYTES] =
+      ref_mpi_bytes(ref_grid_mpi(ref_grid)) - ref_perf->start_bytes;
+  for (i = 0; i < REF_PERF_NCOUNT; i++) {
+    ref_perf_count(ref_perf, i, op, pass) += ref_perf->tally[i];
+    ref_perf->tally[i] = 0;
+  }
+  for (i = 0; i < REF_PERF_LAST_REASON; i++) {
+    ref_perf_check(ref_perf, i, op, pass) += ref_perf->lap_time[i];
+    ref_perf->lap_time[i] = 0.0;
+  }
+
+  RSS(ref_perf_peak_memory(&megabytes), "memory");
+  ref_perf_memory(ref_perf, pass) =
+      MAX(ref_perf_memory(ref_perf, pass), megabytes);
+
+  ref_perf->op = REF_PERF_LAST_OP;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_perf_lap(REF_GRID ref_grid, REF_PERF_REASON reason) {
+  REF_PERF ref_perf = ref_grid_perf(ref_grid);
+  REF_DBL now;
+
+  if (NULL == (void *)ref_perf) return REF_SUCCESS;
+  if (!ref_perf_timing(ref_perf)) return REF_SUCCESS;
+  if (REF_PERF_LAST_OP == ref_perf->op) return REF_SUCCESS;
+
+  RSS(ref_mpi_wtime(ref_grid_mpi(ref_grid), &now), "time");
+  if (0 <= reason && reason < REF_PERF_LAST_REASON)
+    ref_perf->lap_time[reason] += now - ref_perf->lap;
+  ref_perf->lap = now;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_perf_tattle(REF_PERF ref_perf, REF_MPI ref_mpi) {
+  REF_LONG count[REF_PERF_NCOUNT * REF_PERF_LAST_OP];
+  REF_LONG total[REF_PERF_NCOUNT * REF_PERF_LAST_OP];
+  REF_DBL check[REF_PERF_LAST_REASON * REF_PERF_LAST_OP];
+  REF_DBL check_max[REF_PERF_LAST_REASON * REF_PERF_LAST_OP];
+  REF_INT pass, op, i;
+
+  if (NULL == (void *)ref_perf) return REF_SUCCESS;
+  if (0 == ref_perf_npass(ref_perf)) return REF_SUCCESS;
+  pass = ref_perf_npass(ref_perf) - 1;
+
+  for (op = 0; op < REF_PERF_LAST_OP; op++) {
+    for (i = 0; i < REF_PERF_NCOUNT; i++)
+      count[i + REF_PERF_NCOUNT * op] = ref_perf_count(ref_perf, i, op, pass);
+    for (i = 0; i < REF_PERF_LAST_REASON; i++)
+      check[i + REF_PERF_LAST_REASON * op] =
+          ref_perf_check(ref_perf, i, op, pass);
+  }
+  RSS(ref_mpi_sum(ref_mpi, count, total, REF_PERF_NCOUNT * REF_PERF_LAST_OP,
+                  REF_LONG_TYPE),
+      "sum");
+  for (i = 0; i < REF_PERF_LAST_REASON * REF_PERF_LAST_OP; i++)
+    RSS(ref_mpi_max(ref_mpi, &(check[i]), &(check_max[i]), REF_DBL_TYPE),
+        "max");
+
+  if (ref_mpi_once(ref_mpi)) {
+    for (op = 0; op < REF_PERF_LAST_OP; op++) {
+      if (0 == total[REF_PERF_ATTEMPT + REF_PERF_NCOUNT * op]) continue;
+      printf("pass %d %-8s %10ld attempts %10ld successes\n", pass + 1,
+             ref_perf_op_name[op],
+             total[REF_PERF_ATTEMPT + REF_PERF_NCOUNT * op],
+             total[REF_PERF_SUCCESS + REF_PERF_NCOUNT * op]);
+      for (i = 0; i < REF_PERF_LAST_REASON; i++) {
+        if (0 == total[REF_PERF_REJECT + i + REF_PERF_NCOUNT * op] &&
+            0.0 >= check_max[i + REF_PERF_LAST_REASON * op])
+          continue;
+        if (ref_perf_timing(ref_perf)) {
+          printf("    %-10s %10ld rejections %10.6f max sec\n",
+                 ref_perf_reason_name[i],
+                 total[REF_PERF_REJECT + i + REF_PERF_NCOUNT * op],
+                 check_max[i + REF_PERF_LAST_REASON * op]);
+        } else {
+          printf("    %-10s %10ld rejections\n", ref_perf_reason_name[i],
+                 total[REF_PERF_REJECT + i + REF_PERF_NCOUNT * op]);
+        }
+      }
+    }
+    fflush(stdout);
+  }
+
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_perf_json_pass(FILE *file, REF_INT nproc, REF_DBL *tmin,
+                                     REF_DBL *tmax, REF_DBL *tsum,
+                                     REF_LONG *count, REF_DBL *cmax,
+                                     REF_DBL *memory) {
+  REF_INT op, reason;
+
+  fprintf(file, "\"peak_memory_mb\": {\"max\": %.3f, \"sum\": %.3f}", memory[0],
+          memory[1]);
+  for (op = 0; op < REF_PERF_LAST_OP; op++) {
+    fprintf(file, ",\n      \"%s\": {\n", ref_perf_op_name[op]);
+    fprintf(file, "        \"time\": ");
+    fprintf(file, "{\"min\": %.6f, \"max\": %.6f, \"avg\": %.6f},\n", tmin[op],
+            tmax[op], tsum[op] / (REF_DBL)nproc);
+    fprintf(file, "        \"attempts\": %ld, \"successes\": %ld,\n",
+            count[REF_PERF_ATTEMPT + REF_PERF_NCOUNT * op],
+            count[REF_PERF_SUCCESS + REF_PERF_NCOUNT * op]);
+    fprintf(file, "        \"rejections\": {");
+    for (reason = 0; reason < REF_PERF_LAST_REASON; reason++) {
+      fprintf(file, "%s\"%s\": %ld", (0 == reason ? "" : ", "),
+              ref_perf_reason_name[reason],
+              count[REF_PERF_REJECT + reason + REF_PERF_NCOUNT * op]);
+    }
+    fprintf(file, "},\n");
+    fprintf(file, "        \"predicate_time_max\": {");
+    for (reason = 0; reason < REF_PERF_LAST_REASON; reason++) {
+      fprintf(file, "%s\"%s\": %.6f", (0 == reason ? "" : ", "),
+              ref_perf_reason_name[reason],
+              cmax[reason + REF_PERF_LAST_REASON * op]);
+    }
+    fprintf(file, "},\n");
+    fprintf(file, "        \"nodes\": %ld, \"cells\": %ld, \"bytes\": %ld\n",
+            count[REF_PERF_NODE + REF_PERF_NCOUNT * op],
+            count[REF_PERF_CELL + REF_PERF_NCOUNT * op],
+            count[REF_PERF_BYTES + REF_PERF_NCOUNT * op]);
+    fprintf(file, "      }");
+  }
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_perf_report(REF_PERF ref_perf, REF_MPI ref_mpi,
+                           const char *filename) {
+  REF_INT npass, nrec, pass, op, i;
+  REF_DBL *time, *tmin, *tmax, *tsum;
+  REF_LONG *count, *total;
+  REF_DBL *check, *check_max;
+  REF_DBL *memory, *memory_max, *memory_sum;
+  FILE *file;
+
+  RNS(ref_perf, "perf NULL");
+  RAS(REF_PERF_LAST_OP == ref_perf->op, "report with operator running");
+
+  /* the record after the last pass accumulates every pass */
+  npass = ref_perf_npass(ref_perf);
+  nrec = REF_PERF_LAST_OP * (npass + 1);
+  ref_malloc_init(time, nrec, REF_DBL, 0.0);
+  ref_malloc_init(count, REF_PERF_NCOUNT * nrec, REF_LONG, 0);
+  ref_malloc_init(check, REF_PERF_LAST_REASON * nrec, REF_DBL, 0.0);
+  ref_malloc_init(memory, npass + 1, REF_DBL, 0.0);
+  for (pass = 0; pass < npass; pass++) {
+    for (op = 0; op < REF_PERF_LAST_OP; op++) {
+      time[op + REF_PERF_LAST_OP * pass] = ref_perf_time(ref_perf, op, pass);
+      time[op + REF_PERF_LAST_OP * npass] += ref_perf_time(ref_perf, op, pass);
+      for (i = 0; i < REF_PERF_NCOUNT; i++) {
+        count[i + REF_PERF_NCOUNT * (op + REF_PERF_LAST_OP * pass)] =
+            ref_perf_count(ref_perf, i, op, pass);
+        count[i + REF_PERF_NCOUNT * (op + REF_PERF_LAST_OP * npass)] +=
+            ref_perf_count(ref_perf, i, op, pass);
+      }
+      for (i = 0; i < REF_PERF_LAST_REASON; i++) {
+        check[i + REF_PERF_LAST_REASON * (op + REF_PERF_LAST_OP * pass)] =
+            ref_perf_check(ref_perf, i, op, pass);
+        check[i + REF_PERF_LAST_REASON * (op + REF_PERF_LAST_OP * npass)] +=
+            ref_perf_check(ref_perf, i, op, pass);
+      }
+    }
+    memory[pass] = ref_perf_memory(ref_perf, pass);
+    memory[npass] = MAX(memory[npass], ref_perf_memory(ref_perf, pass));
+  }
+
+  ref_malloc_init(tmin, nrec, REF_DBL, 0.0);
+  ref_malloc_init(tmax, nrec, REF_DBL, 0.0);
+  ref_malloc_init(tsum, nrec, REF_DBL, 0.0);
+  ref_malloc_init(total, REF_PERF_NCOUNT * nrec, REF_LONG, 0);
+  ref_malloc_init(check_max, REF_PERF_LAST_REASON * nrec, REF_DBL, 0.0);
+  ref_malloc_init(memory_max, npass + 1, REF_DBL, 0.0);
+  ref_malloc_init(memory_sum, npass + 1, REF_DBL, 0.0);
+  for (i = 0; i < nrec; i++) {
+    RSS(ref_mpi_min(ref_mpi, &(time[i]), &(tmin[i]), REF_DBL_TYPE), "min");
+    RSS(ref_mpi_max(ref_mpi, &(time[i]), &(tmax[i]), REF_DBL_TYPE), "max");
+  }
+  for (i = 0; i < REF_PERF_LAST_REASON * nrec; i++) {
+    RSS(ref_mpi_max(ref_mpi, &(check[i]), &(check_max[i]), REF_DBL_TYPE),
+        "max");
+  }
+  RSS(ref_mpi_sum(ref_mpi, time, tsum, nrec, REF_DBL_TYPE), "sum");
+  RSS(ref_mpi_sum(ref_mpi, count, total, REF_PERF_NCOUNT * nrec,
+                  REF_LONG_TYPE),
+      "sum");
+  for (pass = 0; pass <= npass; pass++) {
+    RSS(ref_mpi_max(ref_mpi, &(memory[pass]), &(memory_max[pass]),
+                    REF_DBL_TYPE),
+        "max");
+  }
+  RSS(ref_mpi_sum(ref_mpi, memory, memory_sum, npass + 1, REF_DBL_TYPE),
+      "sum");
+
+  if (ref_mpi_once(ref_mpi)) {
+    file = fopen(filename, "w");
+    if (NULL == (void *)file) printf("unable to open %s\n", filename);
+    RNS(file, "unable to open file");
+
+    fprintf(file, "{\n  \"ranks\": %d,\n  \"threads\": %d,\n",
+            ref_mpi_n(ref_mpi), ref_mpi_nthread(ref_mpi));
+    fprintf(file, "  \"passes\": [");
+    for (pass = 0; pass <= npass; pass++) {
+      REF_DBL peak[2];
+      i = REF_PERF_LAST_OP * pass;
+      peak[0] = memory_max[pass];
+      peak[1] = memory_sum[pass];
+      if (pass < npass) {
+        fprintf(file, "%s\n    {\n      \"pass\": %d,\n      ",
+                (0 == pass ? "" : ","), pass + 1);
+      } else {
+        fprintf(file, "\n  ],\n  \"total\":\n    {\n      ");
+      }
+      RSS(ref_perf_json_pass(file, ref_mpi_n(ref_mpi), &(tmin[i]), &(tmax[i]),
+                             &(tsum[i]), &(total[REF_PERF_NCOUNT * i]),
+                             &(check_max[REF_PERF_LAST_REASON * i]), peak),
+          "json pass");
+      fprintf(file, "\n    }");
+    }
+    fprintf(file, "\n}\n");
+
+    fclose(file);
+  }
+
+  ref_free(memory_sum);
+  ref_free(memory_max);
+  ref_free(check_max);
+  ref_free(total);
+  ref_free(tsum);
+  ref_free(tmax);
+  ref_free(tmin);
+  ref_free(memory);
+  ref_free(check);
+  ref_free(count);
+  ref_free(time);
+
+  return REF_SUCCESS;
+}
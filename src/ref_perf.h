@@ -0,0 +1,127 @@
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef REF_PERF_H
+#define REF_PERF_H
+
+#include "ref_defs.h"
+
+BEGIN_C_DECLORATION
+typedef struct REF_PERF_STRUCT REF_PERF_STRUCT;
+typedef REF_PERF_STRUCT *REF_PERF;
+typedef enum REF_PERF_OPS { /* 0 */ REF_PERF_SWAP,
+                            /* 1 */ REF_PERF_COLLAPSE,
+                            /* 2 */ REF_PERF_SPLIT,
+                            /* 3 */ REF_PERF_SMOOTH,
+                            /* 4 */ REF_PERF_LAST_OP
+} REF_PERF_OP;
+typedef enum REF_PERF_REASONS { /* 0 */ REF_PERF_RATIO,
+                                /* 1 */ REF_PERF_QUALITY,
+                                /* 2 */ REF_PERF_GEOMETRY,
+                                /* 3 */ REF_PERF_MIXED,
+                                /* 4 */ REF_PERF_GHOST,
+                                /* 5 */ REF_PERF_CONFORMITY,
+                                /* 6 */ REF_PERF_CAVITY,
+                                /* 7 */ REF_PERF_DEGREE,
+                                /* 8 */ REF_PERF_LAST_REASON
+} REF_PERF_REASON;
+END_C_DECLORATION
+
+#include "ref_grid.h"
+#include "ref_mpi.h"
+
+BEGIN_C_DECLORATION
+
+/* per adapt pass and operator counters, REF_PERF_NCOUNT per record */
+#define REF_PERF_ATTEMPT (0)
+#define REF_PERF_SUCCESS (1)
+#define REF_PERF_REJECT (2)
+#define REF_PERF_NODE (2 + REF_PERF_LAST_REASON)
+#define REF_PERF_CELL (3 + REF_PERF_LAST_REASON)
+#define REF_PERF_BYTES (4 + REF_PERF_LAST_REASON)
+#define REF_PERF_NCOUNT (5 + REF_PERF_LAST_REASON)
+
+/* Records operator wall time, outcomes, time in each rejection
+ * predicate, local node and cell changes, bytes sent and peak resident
+ * memory for each adapt pass. REF_GRID holds a reference that is NULL
+ * unless a report is requested or an instrumented adapt pass is counting,
+ * and every entry point is a no-op for a NULL perf. */
+
+struct REF_PERF_STRUCT {
+  REF_INT npass, max_pass;
+  REF_DBL *time;   /* [op + REF_PERF_LAST_OP * pass] seconds */
+  REF_LONG *count; /* [i + REF_PERF_NCOUNT * (op + ...)] */
+  REF_DBL *memory; /* [pass] peak resident MB */
+  REF_DBL *check;  /* [reason + REF_PERF_LAST_REASON * (op + ...)] seconds */
+  REF_PERF_OP op;  /* REF_PERF_LAST_OP when no operator is running */
+  REF_BOOL timing; /* predicate laps read the clock */
+  REF_DBL start_time;
+  REF_DBL lap;
+  REF_DBL lap_time[REF_PERF_LAST_REASON];
+  REF_LONG start_bytes;
+  REF_INT start_node, start_cell;
+  REF_LONG tally[REF_PERF_NCOUNT];
+};
+
+#define ref_perf_npass(ref_perf) ((ref_perf)->npass)
+#define ref_perf_timing(ref_perf) ((ref_perf)->timing)
+#define ref_perf_time(ref_perf, op, pass) \
+  ((ref_perf)->time[(op) + REF_PERF_LAST_OP * (pass)])
+#define ref_perf_count(ref_perf, i, op, pass) \
+  ((ref_perf)                                 \
+       ->count[(i) + REF_PERF_NCOUNT * ((op) + REF_PERF_LAST_OP * (pass))])
+#define ref_perf_memory(ref_perf, pass) ((ref_perf)->memory[(pass)])
+#define ref_perf_check(ref_perf, reason, op, pass)                       \
+  ((ref_perf)->check[(reason) + REF_PERF_LAST_REASON *                   \
+                                    ((op) + REF_PERF_LAST_OP * (pass))])
+
+/* outcome of one candidate of the running operator */
+#define ref_perf_tally(ref_perf, i)                             \
+  do {                                                          \
+    if (NULL != (void *)(ref_perf)) ((ref_perf)->tally[(i)])++; \
+  } while (0)
+#define ref_perf_attempt(ref_perf) ref_perf_tally(ref_perf, REF_PERF_ATTEMPT)
+#define ref_perf_success(ref_perf) ref_perf_tally(ref_perf, REF_PERF_SUCCESS)
+#define ref_perf_reject(ref_perf, reason) \
+  ref_perf_tally(ref_perf, REF_PERF_REJECT + (reason))
+
+REF_STATUS ref_perf_create(REF_PERF *ref_perf);
+REF_STATUS ref_perf_free(REF_PERF ref_perf);
+
+/* begins the next adapt pass */
+REF_STATUS ref_perf_pass(REF_PERF ref_perf);
+
+/* also a trace span of the operator when the grid mpi is tracing */
+REF_STATUS ref_perf_start(REF_GRID ref_grid, REF_PERF_OP op);
+REF_STATUS ref_perf_stop(REF_GRID ref_grid);
+
+/* charges the time since the previous lap to the predicate of reason,
+ * REF_PERF_LAST_REASON restarts the lap without charging it, a no-op
+ * unless timing */
+REF_STATUS ref_perf_lap(REF_GRID ref_grid, REF_PERF_REASON reason);
+
+/* collective, prints the outcomes and predicate times of the last pass */
+REF_STATUS ref_perf_tattle(REF_PERF ref_perf, REF_MPI ref_mpi);
+
+/* collective, rank 0 writes min/max/avg times and summed counts as JSON */
+REF_STATUS ref_perf_report(REF_PERF ref_perf, REF_MPI ref_mpi,
+                           const char *filename);
+
+END_C_DECLORATION
+
+#endif /* REF_PERF_H */
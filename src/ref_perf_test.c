@@ -0,0 +1,223 @@
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "ref_perf.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ref_adapt.h"
+#include "ref_fixture.h"
+#include "ref_grid.h"
+#include "ref_malloc.h"
+#include "ref_metric.h"
+#include "ref_migrate.h"
+#include "ref_mpi.h"
+#include "ref_node.h"
+
+int main(int argc, char *argv[]) {
+  REF_MPI ref_mpi;
+  RSS(ref_mpi_start(argc, argv), "start");
+  RSS(ref_mpi_create(&ref_mpi), "make mpi");
+
+  { /* create */
+    REF_PERF ref_perf;
+    REIS(REF_NULL, ref_perf_free(NULL), "dont free NULL");
+    RSS(ref_perf_create(&ref_perf), "create");
+    REIS(0, ref_perf_npass(ref_perf), "init zero");
+    RSS(ref_perf_free(ref_perf), "free");
+  }
+
+  { /* passes grow */
+    REF_PERF ref_perf;
+    REF_INT pass;
+    RSS(ref_perf_create(&ref_perf), "create");
+    for (pass = 0; pass < 25; pass++) RSS(ref_perf_pass(ref_perf), "pass");
+    REIS(25, ref_perf_npass(ref_perf), "passes");
+    REIS(0, ref_perf_count(ref_perf, REF_PERF_ATTEMPT, REF_PERF_SMOOTH, 24),
+         "last pass zero");
+    RSS(ref_perf_free(ref_perf), "free");
+  }
+
+  { /* NULL perf is a no-op */
+    REF_GRID ref_grid;
+    RSS(ref_fixture_tet_grid(&ref_grid, ref_mpi), "tet");
+    RAS(NULL == ref_grid_perf(ref_grid), "off by default");
+    RSS(ref_perf_pass(ref_grid_perf(ref_grid)), "pass");
+    RSS(ref_perf_start(ref_grid, REF_PERF_SPLIT), "start");
+    ref_perf_attempt(ref_grid_perf(ref_grid));
+    RSS(ref_perf_stop(ref_grid), "stop");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  { /* tally one operator */
+    REF_GRID ref_grid;
+    REF_PERF ref_perf;
+    REF_INT new_node;
+    RSS(ref_fixture_tet_grid(&ref_grid, ref_mpi), "tet");
+    RSS(ref_perf_create(&ref_perf), "create");
+    ref_grid_perf(ref_grid) = ref_perf;
+
+    RSS(ref_perf_start(ref_grid, REF_PERF_SPLIT), "start");
+    REIS(REF_FAILURE, ref_perf_start(ref_grid, REF_PERF_SPLIT), "nested");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_LAST_REASON), "restart lap");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_RATIO), "ratio lap");
+    ref_perf_attempt(ref_perf);
+    ref_perf_attempt(ref_perf);
+    ref_perf_success(ref_perf);
+    ref_perf_reject(ref_perf, REF_PERF_GHOST);
+    RSS(ref_node_add(ref_grid_node(ref_grid), 100, &new_node), "add");
+    RSS(ref_perf_stop(ref_grid), "stop");
+    REIS(REF_FAILURE, ref_perf_stop(ref_grid), "not running");
+
+    REIS(1, ref_perf_npass(ref_perf), "first pass implied");
+    REIS(2, ref_perf_count(ref_perf, REF_PERF_ATTEMPT, REF_PERF_SPLIT, 0),
+         "attempt");
+    REIS(1, ref_perf_count(ref_perf, REF_PERF_SUCCESS, REF_PERF_SPLIT, 0),
+         "success");
+    REIS(1,
+         ref_perf_count(ref_perf, REF_PERF_REJECT + REF_PERF_GHOST,
+                        REF_PERF_SPLIT, 0),
+         "ghost");
+    REIS(0,
+         ref_perf_count(ref_perf, REF_PERF_REJECT + REF_PERF_RATIO,
+                        REF_PERF_SPLIT, 0),
+         "ratio");
+    REIS(1, ref_perf_count(ref_perf, REF_PERF_NODE, REF_PERF_SPLIT, 0),
+         "node added");
+    REIS(0, ref_perf_count(ref_perf, REF_PERF_CELL, REF_PERF_SPLIT, 0),
+         "cells");
+    REIS(0, ref_perf_count(ref_perf, REF_PERF_ATTEMPT, REF_PERF_SWAP, 0),
+         "other op");
+    RAS(0.0 <= ref_perf_time(ref_perf, REF_PERF_SPLIT, 0), "time");
+    RAS(0.0 <= ref_perf_check(ref_perf, REF_PERF_RATIO, REF_PERF_SPLIT, 0),
+        "ratio lap time");
+    RAS(ref_perf_check(ref_perf, REF_PERF_RATIO, REF_PERF_SPLIT, 0) <=
+            ref_perf_time(ref_perf, REF_PERF_SPLIT, 0),
+        "lap within operator");
+    RWDS(0.0, ref_perf_check(ref_perf, REF_PERF_QUALITY, REF_PERF_SPLIT, 0),
+         -1.0, "no quality lap");
+    RAS(0.0 < ref_perf_memory(ref_perf, 0), "memory");
+
+    RSS(ref_perf_free(ref_perf), "free");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  { /* counts without timing skip the predicate clock */
+    REF_GRID ref_grid;
+    REF_PERF ref_perf;
+    RSS(ref_fixture_tet_grid(&ref_grid, ref_mpi), "tet");
+    RSS(ref_perf_create(&ref_perf), "create");
+    RAS(ref_perf_timing(ref_perf), "timing by default");
+    ref_perf_timing(ref_perf) = REF_FALSE;
+    ref_grid_perf(ref_grid) = ref_perf;
+    RSS(ref_perf_start(ref_grid, REF_PERF_COLLAPSE), "start");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_LAST_REASON), "restart lap");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_QUALITY), "quality lap");
+    ref_perf_attempt(ref_perf);
+    ref_perf_reject(ref_perf, REF_PERF_QUALITY);
+    RSS(ref_perf_stop(ref_grid), "stop");
+    REIS(1,
+         ref_perf_count(ref_perf, REF_PERF_REJECT + REF_PERF_QUALITY,
+                        REF_PERF_COLLAPSE, 0),
+         "counted");
+    RWDS(0.0, ref_perf_check(ref_perf, REF_PERF_QUALITY, REF_PERF_COLLAPSE, 0),
+         -1.0, "not timed");
+    RSS(ref_perf_free(ref_perf), "free");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  { /* instrumented adapt pass counts without an attached perf */
+    REF_GRID ref_grid;
+    REF_BOOL all_done;
+
+    RSS(ref_fixture_twod_brick_grid(&ref_grid, ref_mpi), "set up grid");
+    {
+      REF_DBL *metric;
+      ref_malloc(metric, 6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+      RSS(ref_metric_imply_from(metric, ref_grid), "from");
+      RSS(ref_metric_to_node(metric, ref_grid_node(ref_grid)), "to");
+      ref_free(metric);
+    }
+    RAS(ref_grid_adapt(ref_grid, instrument), "instrument by default");
+    RSS(ref_adapt_pass(ref_grid, &all_done), "pass");
+    RAS(NULL == ref_grid_perf(ref_grid), "pass counts detached");
+    RSS(ref_adapt_pass(ref_grid, &all_done), "pass");
+    RAS(NULL != (void *)ref_grid_counts(ref_grid), "counts kept");
+    REIS(2, ref_perf_npass(ref_grid_counts(ref_grid)), "one counts for both");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  { /* adapt pass outcomes add up and report */
+    REF_GRID ref_grid;
+    REF_PERF ref_perf;
+    REF_BOOL all_done;
+    REF_INT op, reason;
+    REF_LONG rejected;
+    char file[] = "ref_perf_test.json";
+
+    RSS(ref_fixture_twod_brick_grid(&ref_grid, ref_mpi), "set up grid");
+    RSS(ref_migrate_to_balance(ref_grid), "balance");
+    {
+      REF_DBL *metric;
+      ref_malloc(metric, 6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+      RSS(ref_metric_imply_from(metric, ref_grid), "from");
+      RSS(ref_metric_to_node(metric, ref_grid_node(ref_grid)), "to");
+      RSS(ref_node_ghost_real(ref_grid_node(ref_grid)), "ghost real");
+      ref_free(metric);
+    }
+    RSS(ref_perf_create(&ref_perf), "create");
+    ref_grid_perf(ref_grid) = ref_perf;
+
+    RSS(ref_adapt_pass(ref_grid, &all_done), "pass");
+    RSS(ref_adapt_pass(ref_grid, &all_done), "pass");
+    REIS(2, ref_perf_npass(ref_perf), "passes");
+    RAS(0 < ref_perf_count(ref_perf, REF_PERF_ATTEMPT, REF_PERF_SWAP, 0),
+        "swaps attempted");
+    for (op = 0; op < REF_PERF_LAST_OP; op++) {
+      rejected = 0;
+      for (reason = 0; reason < REF_PERF_LAST_REASON; reason++)
+        rejected += ref_perf_count(ref_perf, REF_PERF_REJECT + reason, op, 1);
+      REIS(ref_perf_count(ref_perf, REF_PERF_ATTEMPT, op, 1),
+           ref_perf_count(ref_perf, REF_PERF_SUCCESS, op, 1) + rejected,
+           "each attempt succeeds or is rejected");
+    }
+
+    RSS(ref_perf_report(ref_perf, ref_mpi, file), "report");
+    if (ref_mpi_once(ref_mpi)) {
+      FILE *f;
+      char line[1024];
+      f = fopen(file, "r");
+      RNS(f, "report not written");
+      RAS(NULL != fgets(line, 1024, f), "read");
+      REIS(0, strcmp("{\n", line), "json object");
+      fclose(f);
+      REIS(0, remove(file), "test clean up");
+    }
+
+    RSS(ref_perf_free(ref_perf), "free");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  RSS(ref_mpi_free(ref_mpi), "mpi free");
+  RSS(ref_mpi_stop(), "stop");
+
+  return 0;
+}
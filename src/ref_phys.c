@@ -22,6 +22,7 @@
 
 #include "ref_malloc.h"
 #include "ref_math.h"
+#include "ref_mpi.h"
 #include "ref_recon.h"
 
 REF_STATUS ref_phys_make_primitive(REF_DBL *conserved, REF_DBL *primitive) {
@@ -61,80 +62,103 @@ REF_STATUS ref_phys_make_conserved(REF_DBL *primitive, REF_DBL *conserved) {
 }
 
 REF_STATUS ref_phys_euler(REF_DBL *state, REF_DBL *direction, REF_DBL *flux) {
+  RSS(ref_phys_euler_soa(1, state, direction, flux), "euler");
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_phys_euler_soa(REF_INT n, REF_DBL *state, REF_DBL *direction,
+                              REF_DBL *flux) {
   REF_DBL rho, u, v, w, p, e, speed;
   REF_DBL gamma = 1.4;
+  REF_DBL nx, ny, nz;
+  REF_INT k;
+  nx = direction[0];
+  ny = direction[1];
+  nz = direction[2];
 
-  rho = state[0];
-  u = state[1];
-  v = state[2];
-  w = state[3];
-  p = state[4];
+  for (k = 0; k < n; k++) {
+    rho = state[k + 0 * n];
+    u = state[k + 1 * n];
+    v = state[k + 2 * n];
+    w = state[k + 3 * n];
+    p = state[k + 4 * n];
 
-  e = p / (gamma - 1.0) + 0.5 * rho * (u * u + v * v + w * w);
+    e = p / (gamma - 1.0) + 0.5 * rho * (u * u + v * v + w * w);
 
-  speed = u * direction[0] + v * direction[1] + w * direction[2];
+    speed = u * nx + v * ny + w * nz;
 
-  flux[0] = rho * speed;
-  flux[1] = rho * speed * u + p * direction[0];
-  flux[2] = rho * speed * v + p * direction[1];
-  flux[3] = rho * speed * w + p * direction[2];
-  flux[4] = speed * (e + p);
+    flux[k + 0 * n] = rho * speed;
+    flux[k + 1 * n] = rho * speed * u + p * nx;
+    flux[k + 2 * n] = rho * speed * v + p * ny;
+    flux[k + 3 * n] = rho * speed * w + p * nz;
+    flux[k + 4 * n] = speed * (e + p);
+  }
 
   return REF_SUCCESS;
 }
-/* I do like CFD, vol 2, page 77, (3.6.8) */
+
 REF_STATUS ref_phys_euler_jac(REF_DBL *state, REF_DBL *direction,
                               REF_DBL *dflux_dcons) {
+  RSS(ref_phys_euler_jac_soa(1, state, direction, dflux_dcons), "euler jac");
+  return REF_SUCCESS;
+}
+
+/* I do like CFD, vol 2, page 77, (3.6.8) */
+REF_STATUS ref_phys_euler_jac_soa(REF_INT n, REF_DBL *state,
+                                  REF_DBL *direction, REF_DBL *dflux_dcons) {
   REF_DBL rho, u, v, w, p, q2, e, qn;
   REF_DBL gamma = 1.4;
   REF_DBL K, H;
   REF_DBL nx, ny, nz;
+  REF_INT k;
   nx = direction[0];
   ny = direction[1];
   nz = direction[2];
-
-  rho = state[0];
-  u = state[1];
-  v = state[2];
-  w = state[3];
-  p = state[4];
-
   K = gamma - 1;
-  q2 = (u * u + v * v + w * w);
-  e = p / K + 0.5 * rho * q2;
-  H = (e + p) / rho;
-
-  qn = u * nx + v * ny + w * nz;
-
-  dflux_dcons[0 + 0 * 5] = 0.0;
-  dflux_dcons[1 + 0 * 5] = 0.5 * K * q2 * nx - u * qn;
-  dflux_dcons[2 + 0 * 5] = 0.5 * K * q2 * ny - v * qn;
-  dflux_dcons[3 + 0 * 5] = 0.5 * K * q2 * nz - w * qn;
-  dflux_dcons[4 + 0 * 5] = (0.5 * K * q2 - H) * qn;
-
-  dflux_dcons[0 + 1 * 5] = nx;
-  dflux_dcons[1 + 1 * 5] = u * nx - K * u * nx + qn;
-  dflux_dcons[2 + 1 * 5] = v * nx - K * u * ny;
-  dflux_dcons[3 + 1 * 5] = w * nx - K * u * nz;
-  dflux_dcons[4 + 1 * 5] = H * nx - K * u * qn;
-
-  dflux_dcons[0 + 2 * 5] = ny;
-  dflux_dcons[1 + 2 * 5] = u * ny - K * v * nx;
-  dflux_dcons[2 + 2 * 5] = v * ny - K * v * ny + qn;
-  dflux_dcons[3 + 2 * 5] = w * ny - K * v * nz;
-  dflux_dcons[4 + 2 * 5] = H * ny - K * v * qn;
-
-  dflux_dcons[0 + 3 * 5] = nz;
-  dflux_dcons[1 + 3 * 5] = u * nz - K * w * nx;
-  dflux_dcons[2 + 3 * 5] = v * nz - K * w * ny;
-  dflux_dcons[3 + 3 * 5] = w * nz - K * w * nz + qn;
-  dflux_dcons[4 + 3 * 5] = H * nz - K * w * qn;
-
-  dflux_dcons[0 + 4 * 5] = 0;
-  dflux_dcons[1 + 4 * 5] = K * nx;
-  dflux_dcons[2 + 4 * 5] = K * ny;
-  dflux_dcons[3 + 4 * 5] = K * nz;
-  dflux_dcons[4 + 4 * 5] = gamma * qn;
+
+  for (k = 0; k < n; k++) {
+    rho = state[k + 0 * n];
+    u = state[k + 1 * n];
+    v = state[k + 2 * n];
+    w = state[k + 3 * n];
+    p = state[k + 4 * n];
+
+    q2 = (u * u + v * v + w * w);
+    e = p / K + 0.5 * rho * q2;
+    H = (e + p) / rho;
+
+    qn = u * nx + v * ny + w * nz;
+
+    dflux_dcons[k + n * (0 + 0 * 5)] = 0.0;
+    dflux_dcons[k + n * (1 + 0 * 5)] = 0.5 * K * q2 * nx - u * qn;
+    dflux_dcons[k + n * (2 + 0 * 5)] = 0.5 * K * q2 * ny - v * qn;
+    dflux_dcons[k + n * (3 + 0 * 5)] = 0.5 * K * q2 * nz - w * qn;
+    dflux_dcons[k + n * (4 + 0 * 5)] = (0.5 * K * q2 - H) * qn;
+
+    dflux_dcons[k + n * (0 + 1 * 5)] = nx;
+    dflux_dcons[k + n * (1 + 1 * 5)] = u * nx - K * u * nx + qn;
+    dflux_dcons[k + n * (2 + 1 * 5)] = v * nx - K * u * ny;
+    dflux_dcons[k + n * (3 + 1 * 5)] = w * nx - K * u * nz;
+    dflux_dcons[k + n * (4 + 1 * 5)] = H * nx - K * u * qn;
+
+    dflux_dcons[k + n * (0 + 2 * 5)] = ny;
+    dflux_dcons[k + n * (1 + 2 * 5)] = u * ny - K * v * nx;
+    dflux_dcons[k + n * (2 + 2 * 5)] = v * ny - K * v * ny + qn;
+    dflux_dcons[k + n * (3 + 2 * 5)] = w * ny - K * v * nz;
+    dflux_dcons[k + n * (4 + 2 * 5)] = H * ny - K * v * qn;
+
+    dflux_dcons[k + n * (0 + 3 * 5)] = nz;
+    dflux_dcons[k + n * (1 + 3 * 5)] = u * nz - K * w * nx;
+    dflux_dcons[k + n * (2 + 3 * 5)] = v * nz - K * w * ny;
+    dflux_dcons[k + n * (3 + 3 * 5)] = w * nz - K * w * nz + qn;
+    dflux_dcons[k + n * (4 + 3 * 5)] = H * nz - K * w * qn;
+
+    dflux_dcons[k + n * (0 + 4 * 5)] = 0;
+    dflux_dcons[k + n * (1 + 4 * 5)] = K * nx;
+    dflux_dcons[k + n * (2 + 4 * 5)] = K * ny;
+    dflux_dcons[k + n * (3 + 4 * 5)] = K * nz;
+    dflux_dcons[k + n * (4 + 4 * 5)] = gamma * qn;
+  }
 
   return REF_SUCCESS;
 }
@@ -142,73 +166,114 @@ REF_STATUS ref_phys_euler_jac(REF_DBL *state, REF_DBL *direction,
 REF_STATUS ref_phys_viscous(REF_DBL *state, REF_DBL *grad, REF_DBL turb,
                             REF_DBL mach, REF_DBL re, REF_DBL reference_temp,
                             REF_DBL *dir, REF_DBL *flux) {
+  RSS(ref_phys_viscous_soa(1, state, grad, &turb, mach, re, reference_temp,
+                           dir, flux),
+      "viscous");
+  return REF_SUCCESS;
+}
+
+/* SA eddy viscosity of one state, zero unless turb, rho and nu are
+ * positive, sets div_zero when turb / nu is not divisible */
+static REF_DBL ref_phys_sa_mut(REF_DBL turb, REF_DBL rho, REF_DBL nu,
+                               REF_BOOL *div_zero) {
+  REF_DBL chi, chi3;
+  REF_DBL cv1 = 7.1;
+  REF_BOOL active;
+
+  active = (turb > 0.0 && rho > 0.0 && nu > 0.0);
+  if (active && !ref_math_divisible(turb, nu)) *div_zero = REF_TRUE;
+  chi = active ? turb / nu : 0.0;
+  chi3 = chi * chi * chi;
+  return active ? rho * turb * chi3 / (chi3 + cv1 * cv1 * cv1) : 0.0;
+}
+
+REF_STATUS ref_phys_viscous_soa(REF_INT n, REF_DBL *state, REF_DBL *grad,
+                                REF_DBL *turb, REF_DBL mach, REF_DBL re,
+                                REF_DBL reference_temp, REF_DBL *dir,
+                                REF_DBL *flux) {
   REF_DBL rho, u, v, w, p, mu, mu_t, t;
   REF_DBL gamma = 1.4;
   REF_DBL sutherland_constant = 110.56;
   REF_DBL sutherland_temp;
   REF_DBL pr = 0.72;
   REF_DBL turbulent_pr = 0.90;
-  REF_DBL tau[3][3], qdot[3];
+  REF_DBL tau[3][3], qdot[3], g[3][3], div;
   REF_INT i, j, k;
   REF_DBL thermal_conductivity, dtdx;
-
-  rho = state[0];
-  u = state[1];
-  v = state[2];
-  w = state[3];
-  p = state[4];
-  t = gamma * p / rho;
+  REF_BOOL div_zero = REF_FALSE;
 
   sutherland_temp = sutherland_constant / reference_temp;
-  mu = (1.0 + sutherland_temp) / (t + sutherland_temp) * t * sqrt(t);
 
-  RSS(ref_phys_mut_sa(turb, rho, mu / rho, &mu_t), "eddy viscosity");
-  thermal_conductivity =
-      -(mu / (pr * (gamma - 1.0)) + mu_t / (turbulent_pr * (gamma - 1.0)));
-  mu += mu_t;
+  for (k = 0; k < n; k++) {
+    rho = state[k + 0 * n];
+    u = state[k + 1 * n];
+    v = state[k + 2 * n];
+    w = state[k + 3 * n];
+    p = state[k + 4 * n];
+    t = gamma * p / rho;
+
+    mu = (1.0 + sutherland_temp) / (t + sutherland_temp) * t * sqrt(t);
+
+    mu_t = ref_phys_sa_mut(turb[k], rho, mu / rho, &div_zero);
 
-  mu *= mach / re;
-  thermal_conductivity *= mach / re;
+    thermal_conductivity =
+        -(mu / (pr * (gamma - 1.0)) + mu_t / (turbulent_pr * (gamma - 1.0)));
+    mu += mu_t;
 
-  for (i = 0; i < 3; i++) {
-    for (j = 0; j < 3; j++) {
-      tau[i][j] = mu * (grad[j + 3 * (1 + i)] + grad[i + 3 * (1 + j)]);
+    mu *= mach / re;
+    thermal_conductivity *= mach / re;
+
+    for (i = 0; i < 3; i++)
+      for (j = 0; j < 3; j++) g[i][j] = grad[k + n * (j + 3 * (1 + i))];
+    div = g[0][0] + g[1][1] + g[2][2];
+    for (i = 0; i < 3; i++) {
+      for (j = 0; j < 3; j++) {
+        tau[i][j] = mu * (g[i][j] + g[j][i]);
+      }
+      tau[i][i] += (-2.0 / 3.0) * mu * div;
     }
-    for (k = 0; k < 3; k++) {
-      tau[i][i] += (-2.0 / 3.0) * mu * grad[k + 3 * (1 + k)];
+
+    for (i = 0; i < 3; i++) {
+      /* t = gamma * p / rho quotient rule */
+      dtdx = gamma *
+             (grad[k + n * (i + 3 * 4)] * rho - p * grad[k + n * (i + 3 * 0)]) /
+             rho / rho;
+      qdot[i] = thermal_conductivity * dtdx;
     }
-  }
 
-  for (i = 0; i < 3; i++) {
-    /* t = gamma * p / rho quotient rule */
-    dtdx = gamma * (grad[i + 3 * 4] * rho - p * grad[i + 3 * 0]) / rho / rho;
-    qdot[i] = thermal_conductivity * dtdx;
+    flux[k + 0 * n] = 0.0;
+    flux[k + 1 * n] =
+        dir[0] * tau[0][0] + dir[1] * tau[0][1] + dir[2] * tau[0][2];
+    flux[k + 2 * n] =
+        dir[0] * tau[1][0] + dir[1] * tau[1][1] + dir[2] * tau[1][2];
+    flux[k + 3 * n] =
+        dir[0] * tau[2][0] + dir[1] * tau[2][1] + dir[2] * tau[2][2];
+    flux[k + 4 * n] =
+        dir[0] * (u * tau[0][0] + v * tau[0][1] + w * tau[0][2] - qdot[0]) +
+        dir[1] * (u * tau[1][0] + v * tau[1][1] + w * tau[1][2] - qdot[1]) +
+        dir[2] * (u * tau[2][0] + v * tau[2][1] + w * tau[2][2] - qdot[2]);
   }
-
-  flux[0] = 0.0;
-  flux[1] = dir[0] * tau[0][0] + dir[1] * tau[0][1] + dir[2] * tau[0][2];
-  flux[2] = dir[0] * tau[1][0] + dir[1] * tau[1][1] + dir[2] * tau[1][2];
-  flux[3] = dir[0] * tau[2][0] + dir[1] * tau[2][1] + dir[2] * tau[2][2];
-  flux[4] = dir[0] * (u * tau[0][0] + v * tau[0][1] + w * tau[0][2] - qdot[0]) +
-            dir[1] * (u * tau[1][0] + v * tau[1][1] + w * tau[1][2] - qdot[1]) +
-            dir[2] * (u * tau[2][0] + v * tau[2][1] + w * tau[2][2] - qdot[2]);
+  if (div_zero) RSS(REF_DIV_ZERO, "eddy viscosity");
 
   return REF_SUCCESS;
 }
 
 REF_STATUS ref_phys_mut_sa(REF_DBL turb, REF_DBL rho, REF_DBL nu,
                            REF_DBL *mut_sa) {
-  if (turb > 0.0 && rho > 0.0 && nu > 0.0) {
-    REF_DBL chi, chi3, fv1;
-    REF_DBL cv1 = 7.1;
-    if (!ref_math_divisible(turb, nu)) return REF_DIV_ZERO;
-    chi = turb / nu;
-    chi3 = pow(chi, 3);
-    fv1 = chi3 / (chi3 + pow(cv1, 3));
-    *mut_sa = rho * turb * fv1;
-  } else {
-    *mut_sa = 0.0;
+  RAISE(ref_phys_mut_sa_soa(1, &turb, &rho, &nu, mut_sa));
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_phys_mut_sa_soa(REF_INT n, REF_DBL *turb, REF_DBL *rho,
+                               REF_DBL *nu, REF_DBL *mut_sa) {
+  REF_INT k;
+  REF_BOOL div_zero = REF_FALSE;
+
+  for (k = 0; k < n; k++) {
+    mut_sa[k] = ref_phys_sa_mut(turb[k], rho[k], nu[k], &div_zero);
   }
+  if (div_zero) return REF_DIV_ZERO;
+
   return REF_SUCCESS;
 }
 
@@ -269,34 +334,75 @@ REF_STATUS ref_phys_read_mapbc(REF_DICT ref_dict, const char *mapbc_filename) {
   }
 */
 
+/* vol * gradient of the linear tet interpolant of s is
+ * sum_k coef[dir + 3 * k] * s_k, the face normals of ref_node_xyz_grad
+ * without the volume division, so one set serves every field */
+static void ref_phys_tet_vol_grad_coef(REF_DBL *xyzs[4], REF_DBL *coef) {
+  REF_INT face[3][3] = {{0, 3, 2}, {0, 1, 3}, {0, 2, 1}};
+  REF_DBL edge10[3], edge20[3], normal[3];
+  REF_INT k, dir;
+
+  for (dir = 0; dir < 3; dir++) coef[dir] = 0.0;
+  for (k = 0; k < 3; k++) {
+    for (dir = 0; dir < 3; dir++) {
+      edge10[dir] = xyzs[face[k][1]][dir] - xyzs[face[k][0]][dir];
+      edge20[dir] = xyzs[face[k][2]][dir] - xyzs[face[k][0]][dir];
+    }
+    ref_math_cross_product(edge10, edge20, normal);
+    for (dir = 0; dir < 3; dir++) {
+      coef[dir + 3 * (k + 1)] = -normal[dir] / 6.0;
+      coef[dir] += normal[dir] / 6.0;
+    }
+  }
+}
+
 REF_STATUS ref_phys_cc_fv_res(REF_GRID ref_grid, REF_INT nequ, REF_DBL *flux,
                               REF_DBL *res) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_CELL ref_cell = ref_grid_tet(ref_grid);
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
   REF_INT equ, dir, cell, cell_node, nodes[REF_CELL_MAX_SIZE_PER];
-  REF_DBL cell_vol, flux_grad[3];
-  REF_DBL tet_flux[4], *xyzs[4];
-
-  each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
-    each_ref_cell_cell_node(ref_cell, cell_node) {
-      xyzs[cell_node] = ref_node_xyz_ptr(ref_node, nodes[cell_node]);
-    }
-    RSS(ref_node_xyz_vol(xyzs, &cell_vol), "vol");
-    for (dir = 0; dir < 3; dir++) {
+  REF_INT ncolor, color, *color_first, *color_cell, i;
+  REF_DBL coef[12], div, *xyzs[4];
+  REF_STATUS status = REF_SUCCESS;
+
+  RSS(ref_cell_colors(ref_cell, ref_mpi_nthread(ref_mpi), &ncolor,
+                      &color_first, &color_cell),
+      "color");
+
+  for (color = 0; color < ncolor; color++) {
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi))            \
+    schedule(static) private(cell, nodes, cell_node, xyzs, coef, equ, dir, \
+                                 div) reduction(max : status)
+#endif
+    for (i = color_first[color]; i < color_first[color + 1]; i++) {
+      cell = color_cell[i];
+      if (REF_SUCCESS != ref_cell_nodes(ref_cell, cell, nodes)) {
+        status = REF_FAILURE;
+        continue;
+      }
+      each_ref_cell_cell_node(ref_cell, cell_node) {
+        xyzs[cell_node] = ref_node_xyz_ptr(ref_node, nodes[cell_node]);
+      }
+      ref_phys_tet_vol_grad_coef(xyzs, coef);
       for (equ = 0; equ < nequ; equ++) {
+        div = 0.0;
         each_ref_cell_cell_node(ref_cell, cell_node) {
-          tet_flux[cell_node] =
-              flux[equ + dir * nequ + 3 * nequ * nodes[cell_node]];
+          for (dir = 0; dir < 3; dir++) {
+            div += coef[dir + 3 * cell_node] *
+                   flux[equ + dir * nequ + 3 * nequ * nodes[cell_node]];
+          }
         }
-        RSS(ref_node_xyz_grad(xyzs, tet_flux, flux_grad), "grad");
         each_ref_cell_cell_node(ref_cell, cell_node) {
-          res[equ + nequ * nodes[cell_node]] +=
-              0.25 * flux_grad[dir] * cell_vol;
+          res[equ + nequ * nodes[cell_node]] += 0.25 * div;
         }
       }
     }
+    RSS(status, "cell nodes");
   }
 
+
   RSS(ref_node_ghost_dbl(ref_node, res, nequ), "ghost res");
 
   return REF_SUCCESS;
@@ -306,9 +412,11 @@ REF_STATUS ref_phys_cc_fv_embed(REF_GRID ref_grid, REF_INT nequ, REF_DBL *flux,
                                 REF_DBL *res) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_CELL ref_cell = ref_grid_tet(ref_grid);
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
   REF_INT i, equ, dir, cell, cell_node, cell_edge, nodes[REF_CELL_MAX_SIZE_PER];
-  REF_DBL cell_vol, flux_grad[3];
-  REF_DBL tet_flux[4], *xyzs[4];
+  REF_INT ncolor, color, *color_first, *color_cell, item;
+  REF_DBL coef[12], macro_coef[30], div;
+  REF_DBL *xyzs[4];
   REF_DBL macro_flux[10], macro_xyz[10][3];
   REF_INT m2n[8][4] = {{0, 4, 5, 6}, {1, 8, 7, 4}, {2, 7, 9, 6}, {3, 6, 9, 8},
                        {4, 6, 9, 5}, {7, 8, 9, 4}, {7, 9, 5, 4}, {8, 6, 9, 4}};
@@ -317,6 +425,7 @@ REF_STATUS ref_phys_cc_fv_embed(REF_GRID ref_grid, REF_INT nequ, REF_DBL *flux,
   REF_INT node;
   REF_DBL sdot0, sdot1, *direqu, *fluxgrad;
   REF_BOOL high_order = REF_TRUE;
+  REF_STATUS status = REF_SUCCESS;
   /* macro node [edge]
                                   3------9[5]--------2
                                  / \              . /
@@ -334,68 +443,99 @@ REF_STATUS ref_phys_cc_fv_embed(REF_GRID ref_grid, REF_INT nequ, REF_DBL *flux,
   ref_malloc(direqu, ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
   ref_malloc(fluxgrad, 3 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
 
-  for (dir = 0; dir < 3; dir++) {
-    for (equ = 0; equ < nequ; equ++) {
+  RSS(ref_cell_colors(ref_cell, ref_mpi_nthread(ref_mpi), &ncolor,
+                      &color_first, &color_cell),
+      "color");
+
+  for (equ = 0; equ < nequ; equ++) {
+    for (dir = 0; dir < 3; dir++) {
       each_ref_node_valid_node(ref_node, node) {
         direqu[node] = flux[equ + dir * nequ + 3 * nequ * node];
       }
       RSS(ref_recon_gradient(ref_grid, direqu, fluxgrad, recon), "grad");
-      each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
-        each_ref_cell_cell_node(ref_cell, cell_node) {
-          for (i = 0; i < 3; i++) {
-            macro_xyz[cell_node][i] =
-                ref_node_xyz(ref_node, i, nodes[cell_node]);
+      for (color = 0; color < ncolor; color++) {
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi))               \
+    schedule(static)                                                         \
+    private(cell, nodes, cell_node, cell_edge, i, n0, n1, macro, xyzs, coef, \
+                macro_coef, macro_xyz, macro_flux, sdot0, sdot1, div)        \
+    reduction(max : status)
+#endif
+        for (item = color_first[color]; item < color_first[color + 1];
+             item++) {
+          cell = color_cell[item];
+          if (REF_SUCCESS != ref_cell_nodes(ref_cell, cell, nodes)) {
+            status = REF_FAILURE;
+            continue;
           }
-        }
-        each_ref_cell_cell_edge(ref_cell, cell_edge) {
-          n0 = nodes[ref_cell_e2n_gen(ref_cell, 0, cell_edge)];
-          n1 = nodes[ref_cell_e2n_gen(ref_cell, 1, cell_edge)];
-          for (i = 0; i < 3; i++) {
-            macro_xyz[4 + cell_edge][i] = 0.5 * (ref_node_xyz(ref_node, i, n0) +
-                                                 ref_node_xyz(ref_node, i, n1));
+          each_ref_cell_cell_node(ref_cell, cell_node) {
+            for (i = 0; i < 3; i++) {
+              macro_xyz[cell_node][i] =
+                  ref_node_xyz(ref_node, i, nodes[cell_node]);
+            }
           }
-        }
-
-        each_ref_cell_cell_node(ref_cell, cell_node) {
-          i = equ + dir * nequ + 3 * nequ * nodes[cell_node];
-          macro_flux[cell_node] = flux[i];
-        }
-        each_ref_cell_cell_edge(ref_cell, cell_edge) {
-          n0 = nodes[ref_cell_e2n_gen(ref_cell, 0, cell_edge)];
-          n1 = nodes[ref_cell_e2n_gen(ref_cell, 1, cell_edge)];
-          macro_flux[4 + cell_edge] =
-              0.5 * (flux[equ + dir * nequ + 3 * nequ * n0] +
-                     flux[equ + dir * nequ + 3 * nequ * n1]);
-          sdot0 = 0.0;
-          sdot1 = 0.0;
-          for (i = 0; i < 3; i++) {
-            sdot0 += (ref_node_xyz(ref_node, i, n1) -
-                      ref_node_xyz(ref_node, i, n0)) *
-                     fluxgrad[i + 3 * n0];
-            sdot1 += (ref_node_xyz(ref_node, i, n1) -
-                      ref_node_xyz(ref_node, i, n0)) *
-                     fluxgrad[i + 3 * n1];
+          each_ref_cell_cell_edge(ref_cell, cell_edge) {
+            n0 = nodes[ref_cell_e2n_gen(ref_cell, 0, cell_edge)];
+            n1 = nodes[ref_cell_e2n_gen(ref_cell, 1, cell_edge)];
+            for (i = 0; i < 3; i++) {
+              macro_xyz[4 + cell_edge][i] =
+                  0.5 * (ref_node_xyz(ref_node, i, n0) +
+                         ref_node_xyz(ref_node, i, n1));
+            }
           }
-          if (high_order) macro_flux[4 + cell_edge] += 0.125 * (sdot0 - sdot1);
-        }
-        for (macro = 0; macro < 8; macro++) {
+          /* the 8 macro tets scatter to the same cell nodes, sum their
+           * geometry before applying the flux */
+          for (i = 0; i < 30; i++) macro_coef[i] = 0.0;
+          for (macro = 0; macro < 8; macro++) {
+            each_ref_cell_cell_node(ref_cell, cell_node) {
+              xyzs[cell_node] = macro_xyz[m2n[macro][cell_node]];
+            }
+            ref_phys_tet_vol_grad_coef(xyzs, coef);
+            each_ref_cell_cell_node(ref_cell, cell_node) {
+              for (i = 0; i < 3; i++) {
+                macro_coef[i + 3 * m2n[macro][cell_node]] +=
+                    coef[i + 3 * cell_node];
+              }
+            }
+          }
+
           each_ref_cell_cell_node(ref_cell, cell_node) {
-            xyzs[cell_node] = macro_xyz[m2n[macro][cell_node]];
-            tet_flux[cell_node] = macro_flux[m2n[macro][cell_node]];
+            macro_flux[cell_node] =
+                flux[equ + dir * nequ + 3 * nequ * nodes[cell_node]];
+          }
+          each_ref_cell_cell_edge(ref_cell, cell_edge) {
+            n0 = nodes[ref_cell_e2n_gen(ref_cell, 0, cell_edge)];
+            n1 = nodes[ref_cell_e2n_gen(ref_cell, 1, cell_edge)];
+            macro_flux[4 + cell_edge] =
+                0.5 * (flux[equ + dir * nequ + 3 * nequ * n0] +
+                       flux[equ + dir * nequ + 3 * nequ * n1]);
+            sdot0 = 0.0;
+            sdot1 = 0.0;
+            for (i = 0; i < 3; i++) {
+              sdot0 += (ref_node_xyz(ref_node, i, n1) -
+                        ref_node_xyz(ref_node, i, n0)) *
+                       fluxgrad[i + 3 * n0];
+              sdot1 += (ref_node_xyz(ref_node, i, n1) -
+                        ref_node_xyz(ref_node, i, n0)) *
+                       fluxgrad[i + 3 * n1];
+            }
+            if (high_order)
+              macro_flux[4 + cell_edge] += 0.125 * (sdot0 - sdot1);
           }
-          RSS(ref_node_xyz_vol(xyzs, &cell_vol), "vol");
-          RSS(ref_node_xyz_grad(xyzs, tet_flux, flux_grad), "grad");
+          div = 0.0;
+          for (i = 0; i < 10; i++)
+            div += macro_coef[dir + 3 * i] * macro_flux[i];
           each_ref_cell_cell_node(ref_cell, cell_node) {
-            res[equ + nequ * nodes[cell_node]] +=
-                0.25 * flux_grad[dir] * cell_vol;
+            res[equ + nequ * nodes[cell_node]] += 0.25 * div;
           }
         }
+        RSS(status, "cell nodes");
       }
     }
   }
 
-  ref_free(fluxgrad);
   ref_free(direqu);
+  ref_free(fluxgrad);
 
   RSS(ref_node_ghost_dbl(ref_node, res, nequ), "ghost res");
 
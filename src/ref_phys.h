@@ -37,6 +37,22 @@ REF_STATUS ref_phys_viscous(REF_DBL *state, REF_DBL *grad, REF_DBL turb,
                             REF_DBL *dir, REF_DBL *flux);
 REF_STATUS ref_phys_mut_sa(REF_DBL turb, REF_DBL rho, REF_DBL nu,
                            REF_DBL *mut_sa);
+
+/* batched variants, structure of arrays with variable i of state k at
+ * state[k + n * i], grad[k + n * (dir + 3 * i)], and
+ * dflux_dcons[k + n * (i + 5 * j)], one direction for the batch */
+#define REF_PHYS_SOA_BATCH (64)
+REF_STATUS ref_phys_euler_soa(REF_INT n, REF_DBL *state, REF_DBL *direction,
+                              REF_DBL *flux);
+REF_STATUS ref_phys_euler_jac_soa(REF_INT n, REF_DBL *state,
+                                  REF_DBL *direction, REF_DBL *dflux_dcons);
+REF_STATUS ref_phys_viscous_soa(REF_INT n, REF_DBL *state, REF_DBL *grad,
+                                REF_DBL *turb, REF_DBL mach, REF_DBL re,
+                                REF_DBL reference_temp, REF_DBL *dir,
+                                REF_DBL *flux);
+REF_STATUS ref_phys_mut_sa_soa(REF_INT n, REF_DBL *turb, REF_DBL *rho,
+                               REF_DBL *nu, REF_DBL *mut_sa);
+
 REF_STATUS ref_phys_convdiff(REF_DBL *state, REF_DBL *grad, REF_DBL diffusivity,
                              REF_DBL *dir, REF_DBL *flux);
 
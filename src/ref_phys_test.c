@@ -990,6 +990,68 @@ int main(int argc, char *argv[]) {
          "eddy viscosity from SA turb");
   }
 
+  { /* structure of arrays batch matches the per-state formulas */
+    REF_INT n = 3, k, i;
+    REF_DBL state[15], grad[45], turb[3], rho[3], nu[3];
+    REF_DBL flux[15], jac[75], direction[3] = {0.3, -0.5, 0.8};
+    REF_DBL mut_sa[3], tol = 1.0e-14;
+    /* evaluated one state at a time before the batches were introduced */
+    REF_DBL euler[15] = {-2.00000000000000178e-02, 2.10285714285714270e-01,
+                         -3.57142857142857151e-01, 5.73428571428571510e-01,
+                         -5.05000000000000518e-02, -8.25000000000000178e-02,
+                         2.09035714285714269e-01,  -3.66267857142857145e-01,
+                         5.87678571428571495e-01,  -1.91053125000000074e-01,
+                         -1.56000000000000000e-01, 2.20285714285714279e-01,
+                         -3.82742857142857162e-01, 6.03028571428571469e-01,
+                         -3.35660000000000125e-01};
+    /* d energy flux / d rho, d x-momentum flux / d x-momentum and
+     * d energy flux / d energy */
+    REF_DBL euler_jac[9] = {5.03000000000000530e-02, 1.59999999999999865e-02,
+                            -2.80000000000000214e-02, 1.73347159090909142e-01,
+                            -5.70000000000000090e-02, -1.05000000000000010e-01,
+                            2.79196666666666760e-01,  -1.30000000000000004e-01,
+                            -1.81999999999999995e-01};
+    REF_DBL viscous[15] = {0.0, 7.60000000000000259e-04,
+                           3.48000000000000045e-03, 3.19999999999999864e-04,
+                           7.42555555555555850e-03, 0.0,
+                           6.03903236922883691e-04, 2.86854037538369563e-03,
+                           3.77439523076802063e-04, 6.30680572751123741e-03,
+                           0.0, 7.56311934927777086e-04,
+                           3.78155967463888586e-03, 6.98134093779485907e-04,
+                           8.08687023451978154e-03};
+    REF_DBL eddy[3] = {0.0, 9.09880757024925666e-04, 1.72973453935752197e-02};
+    for (k = 0; k < n; k++) {
+      state[k + n * 0] = 1.0 + 0.1 * (REF_DBL)k;
+      state[k + n * 1] = 0.2 - 0.1 * (REF_DBL)k;
+      state[k + n * 2] = 0.05 * (REF_DBL)k;
+      state[k + n * 3] = -0.1;
+      state[k + n * 4] = 1.0 / 1.4 + 0.01 * (REF_DBL)k;
+      for (i = 0; i < 15; i++) grad[k + n * i] = 0.1 * (REF_DBL)(i - k);
+      turb[k] = 2.0 * (REF_DBL)k - 1.0;
+      rho[k] = state[k + n * 0];
+      nu[k] = 0.5 + (REF_DBL)k;
+    }
+    RSS(ref_phys_euler_soa(n, state, direction, flux), "euler");
+    RSS(ref_phys_euler_jac_soa(n, state, direction, jac), "jac");
+    for (k = 0; k < n; k++) {
+      for (i = 0; i < 5; i++)
+        RWDS(euler[i + 5 * k], flux[k + n * i], tol, "flux");
+      RWDS(euler_jac[0 + 3 * k], jac[k + n * (4 + 5 * 0)], tol, "dE/drho");
+      RWDS(euler_jac[1 + 3 * k], jac[k + n * (1 + 5 * 1)], tol, "dmx/dmx");
+      RWDS(euler_jac[2 + 3 * k], jac[k + n * (4 + 5 * 4)], tol, "dE/dE");
+    }
+    RSS(ref_phys_viscous_soa(n, state, grad, turb, 0.2, 100.0, 300.0,
+                             direction, flux),
+        "viscous");
+    RSS(ref_phys_mut_sa_soa(n, turb, rho, nu, mut_sa), "eddy viscosity");
+    for (k = 0; k < n; k++) {
+      for (i = 0; i < 5; i++)
+        RWDS(viscous[i + 5 * k], flux[k + n * i], tol, "flux");
+      RWDS(eddy[k], mut_sa[k], tol, "eddy viscosity");
+    }
+    RAS(0.0 == mut_sa[0] && mut_sa[1] > 0.0, "negative turb is laminar");
+  }
+
   if (!ref_mpi_para(ref_mpi)) {
     char file[] = "ref_phys_test.mapbc";
     FILE *f;
@@ -1051,6 +1113,105 @@ int main(int argc, char *argv[]) {
     REIS(0, remove(file), "test clean up");
   }
 
+  { /* threaded cell residual matches per field tet gradients */
+    REF_GRID ref_grid;
+    REF_NODE ref_node;
+    REF_CELL ref_cell;
+    REF_INT nequ = 2, equ, dir, node, cell, cell_node;
+    REF_INT nodes[REF_CELL_MAX_SIZE_PER];
+    REF_DBL *flux, *res, *expected, *xyzs[4], tet_flux[4], flux_grad[3], vol;
+
+    RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+    ref_node = ref_grid_node(ref_grid);
+    ref_cell = ref_grid_tet(ref_grid);
+    ref_malloc(flux, 3 * nequ * ref_node_max(ref_node), REF_DBL);
+    ref_malloc_init(res, nequ * ref_node_max(ref_node), REF_DBL, 0.0);
+    ref_malloc_init(expected, nequ * ref_node_max(ref_node), REF_DBL, 0.0);
+    each_ref_node_valid_node(ref_node, node) {
+      for (dir = 0; dir < 3; dir++) {
+        for (equ = 0; equ < nequ; equ++) {
+          flux[equ + dir * nequ + 3 * nequ * node] =
+              (REF_DBL)(1 + equ) * pow(ref_node_xyz(ref_node, dir, node), 2) +
+              (REF_DBL)dir * ref_node_xyz(ref_node, 0, node) *
+                  ref_node_xyz(ref_node, 1, node);
+        }
+      }
+    }
+    each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
+      each_ref_cell_cell_node(ref_cell, cell_node) {
+        xyzs[cell_node] = ref_node_xyz_ptr(ref_node, nodes[cell_node]);
+      }
+      RSS(ref_node_xyz_vol(xyzs, &vol), "vol");
+      for (dir = 0; dir < 3; dir++) {
+        for (equ = 0; equ < nequ; equ++) {
+          each_ref_cell_cell_node(ref_cell, cell_node) {
+            tet_flux[cell_node] =
+                flux[equ + dir * nequ + 3 * nequ * nodes[cell_node]];
+          }
+          RSS(ref_node_xyz_grad(xyzs, tet_flux, flux_grad), "grad");
+          each_ref_cell_cell_node(ref_cell, cell_node) {
+            expected[equ + nequ * nodes[cell_node]] +=
+                0.25 * flux_grad[dir] * vol;
+          }
+        }
+      }
+    }
+
+    RSS(ref_mpi_threads(ref_mpi, 4), "four threads");
+    RSS(ref_phys_cc_fv_res(ref_grid, nequ, flux, res), "res");
+    RSS(ref_mpi_threads(ref_mpi, 1), "one thread");
+    each_ref_node_valid_node(ref_node, node) {
+      for (equ = 0; equ < nequ; equ++) {
+        RWDS(expected[equ + nequ * node], res[equ + nequ * node], -1.0,
+             "res");
+      }
+    }
+
+    ref_free(expected);
+    ref_free(res);
+    ref_free(flux);
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  { /* threaded embedded residual matches one thread */
+    REF_GRID ref_grid;
+    REF_NODE ref_node;
+    REF_INT nequ = 2, equ, dir, node;
+    REF_DBL *flux, *res, *expected;
+
+    RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+    ref_node = ref_grid_node(ref_grid);
+    ref_malloc(flux, 3 * nequ * ref_node_max(ref_node), REF_DBL);
+    ref_malloc_init(res, nequ * ref_node_max(ref_node), REF_DBL, 0.0);
+    ref_malloc_init(expected, nequ * ref_node_max(ref_node), REF_DBL, 0.0);
+    each_ref_node_valid_node(ref_node, node) {
+      for (dir = 0; dir < 3; dir++) {
+        for (equ = 0; equ < nequ; equ++) {
+          flux[equ + dir * nequ + 3 * nequ * node] =
+              (REF_DBL)(1 + equ) * ref_node_xyz(ref_node, dir, node) +
+              (REF_DBL)dir * ref_node_xyz(ref_node, 2, node);
+        }
+      }
+    }
+
+    /* linear flux, the embedded macro tets reproduce the tet divergence */
+    RSS(ref_phys_cc_fv_res(ref_grid, nequ, flux, expected), "res");
+    RSS(ref_mpi_threads(ref_mpi, 4), "four threads");
+    RSS(ref_phys_cc_fv_embed(ref_grid, nequ, flux, res), "embed");
+    RSS(ref_mpi_threads(ref_mpi, 1), "one thread");
+    each_ref_node_valid_node(ref_node, node) {
+      for (equ = 0; equ < nequ; equ++) {
+        RWDS(expected[equ + nequ * node], res[equ + nequ * node], -1.0,
+             "embed");
+      }
+    }
+
+    ref_free(expected);
+    ref_free(res);
+    ref_free(flux);
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
   { /* brick zeroth */
     REF_GRID ref_grid;
     FILE *f;
@@ -29,584 +29,1000 @@
 #include "ref_math.h"
 #include "ref_matrix.h"
 #include "ref_node.h"
+#include "ref_sort.h"
 
 #define REF_RECON_MAX_DEGREE (1000)
 
-/* Alauzet and A. Loseille doi:10.1016/j.jcp.2009.09.020
- * section 2.2.4.1. A double L2-projection */
-REF_STATUS ref_recon_l2_projection_grad(REF_GRID ref_grid, REF_DBL *scalar,
-                                        REF_DBL *grad) {
+REF_STATUS ref_recon_op_create(REF_RECON_OP *ref_recon_op_ptr,
+                               REF_GRID ref_grid) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_RECON_OP ref_recon_op;
   REF_CELL ref_cell;
-  REF_INT i, node, cell, group, cell_node;
+  REF_INT group, cell, cell_node, node, other, item, entry, per, i;
   REF_INT nodes[REF_CELL_MAX_SIZE_PER];
-  REF_BOOL div_by_zero;
-  REF_DBL cell_vol, cell_grad[3];
-  REF_DBL *vol;
-
-  ref_malloc_init(vol, ref_node_max(ref_node), REF_DBL, 0.0);
-
-  each_ref_node_valid_node(ref_node, node) for (i = 0; i < 3; i++)
-      grad[i + 3 * node] = 0.0;
+  REF_INT *mark, *pos;
+  REF_DBL *unit, cell_vol, cell_grad[3 * REF_CELL_MAX_SIZE_PER];
 
   if (ref_grid_twod(ref_grid)) {
-    each_ref_cell_valid_cell_with_nodes(ref_grid_tri(ref_grid), cell, nodes) {
-      RSS(ref_node_tri_area(ref_node, nodes, &cell_vol), "vol");
-      RSS(ref_node_tri_grad_nodes(ref_node, nodes, scalar, cell_grad), "vol");
-      for (cell_node = 0; cell_node < 3; cell_node++)
-        for (i = 0; i < 3; i++)
-          grad[i + 3 * nodes[cell_node]] += cell_vol * cell_grad[i];
-      for (cell_node = 0; cell_node < 3; cell_node++)
-        vol[nodes[cell_node]] += cell_vol;
-    }
+    ref_cell = ref_grid_tri(ref_grid);
   } else {
     each_ref_grid_3d_ref_cell(ref_grid, group, ref_cell) {
-      each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
-        switch (ref_cell_node_per(ref_cell)) {
-          case 4:
-            RSS(ref_node_tet_vol(ref_node, nodes, &cell_vol), "vol");
-            RSS(ref_node_tet_grad_nodes(ref_node, nodes, scalar, cell_grad),
-                "grad");
-            for (cell_node = 0; cell_node < 4; cell_node++)
-              for (i = 0; i < 3; i++)
-                grad[i + 3 * nodes[cell_node]] += cell_vol * cell_grad[i];
-            for (cell_node = 0; cell_node < 4; cell_node++)
-              vol[nodes[cell_node]] += cell_vol;
-            break;
-          default:
-            RSS(REF_IMPLEMENT, "implement cell type");
-            break;
+      if (4 != ref_cell_node_per(ref_cell) && 0 < ref_cell_n(ref_cell))
+        RSS(REF_IMPLEMENT, "implement cell type");
+    }
+    ref_cell = ref_grid_tet(ref_grid);
+  }
+  per = ref_cell_node_per(ref_cell);
+
+  ref_malloc(*ref_recon_op_ptr, 1, REF_RECON_OP_STRUCT);
+  ref_recon_op = (*ref_recon_op_ptr);
+  ref_recon_op->ref_node = ref_node;
+  ref_recon_op->n = ref_node_max(ref_node);
+
+  /* count distinct stencil nodes of each owned row */
+  ref_malloc_init(mark, ref_node_max(ref_node), REF_INT, REF_EMPTY);
+  ref_malloc_init(pos, ref_node_max(ref_node), REF_INT, REF_EMPTY);
+  ref_malloc_init(ref_recon_op->first, ref_recon_op->n + 1, REF_INT, 0);
+  each_ref_node_valid_node(ref_node, node) {
+    if (!ref_node_owned(ref_node, node)) continue;
+    each_ref_cell_having_node(ref_cell, node, item, cell) {
+      for (cell_node = 0; cell_node < per; cell_node++) {
+        other = ref_cell_c2n(ref_cell, cell_node, cell);
+        if (node == mark[other]) continue;
+        mark[other] = node;
+        ref_recon_op->first[node + 1]++;
+      }
+    }
+  }
+  for (node = 0; node < ref_recon_op->n; node++)
+    ref_recon_op->first[node + 1] += ref_recon_op->first[node];
+
+  ref_malloc(ref_recon_op->node, ref_recon_op->first[ref_recon_op->n],
+             REF_INT);
+  ref_malloc_init(ref_recon_op->weight,
+                  3 * ref_recon_op->first[ref_recon_op->n], REF_DBL, 0.0);
+  ref_malloc_init(ref_recon_op->vol, ref_recon_op->n, REF_DBL, 0.0);
+  /* shape function gradients of each cell node from a unit scalar,
+   * recomputed per row instead of stored per cell */
+  ref_malloc_init(unit, ref_node_max(ref_node), REF_DBL, 0.0);
+  for (node = 0; node < ref_recon_op->n; node++) mark[node] = REF_EMPTY;
+  each_ref_node_valid_node(ref_node, node) {
+    if (!ref_node_owned(ref_node, node)) continue;
+    entry = ref_recon_op->first[node];
+    each_ref_cell_having_node(ref_cell, node, item, cell) {
+      RSS(ref_cell_nodes(ref_cell, cell, nodes), "cell nodes");
+      if (ref_grid_twod(ref_grid)) {
+        RSS(ref_node_tri_area(ref_node, nodes, &cell_vol), "vol");
+      } else {
+        RSS(ref_node_tet_vol(ref_node, nodes, &cell_vol), "vol");
+      }
+      ref_recon_op->vol[node] += cell_vol;
+      for (cell_node = 0; cell_node < per; cell_node++) {
+        unit[nodes[cell_node]] = 1.0;
+        if (ref_grid_twod(ref_grid)) {
+          RSS(ref_node_tri_grad_nodes(ref_node, nodes, unit,
+                                      &(cell_grad[3 * cell_node])),
+              "grad");
+        } else {
+          RSS(ref_node_tet_grad_nodes(ref_node, nodes, unit,
+                                      &(cell_grad[3 * cell_node])),
+              "grad");
         }
+        unit[nodes[cell_node]] = 0.0;
+      }
+      for (cell_node = 0; cell_node < per; cell_node++) {
+        other = ref_cell_c2n(ref_cell, cell_node, cell);
+        if (node != mark[other]) {
+          mark[other] = node;
+          pos[other] = entry;
+          ref_recon_op->node[entry] = other;
+          entry++;
+        }
+        for (i = 0; i < 3; i++)
+          ref_recon_op->weight[i + 3 * pos[other]] +=
+              cell_vol * cell_grad[i + 3 * cell_node];
       }
     }
+    REIS(ref_recon_op->first[node + 1], entry, "row count mismatch");
   }
 
+  ref_free(unit);
+  ref_free(pos);
+  ref_free(mark);
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_recon_op_free(REF_RECON_OP ref_recon_op) {
+  if (NULL == (void *)ref_recon_op) return REF_NULL;
+  ref_free(ref_recon_op->vol);
+  ref_free(ref_recon_op->weight);
+  ref_free(ref_recon_op->node);
+  ref_free(ref_recon_op->first);
+  ref_free(ref_recon_op);
+  return REF_SUCCESS;
+}
+
+/* Alauzet and A. Loseille doi:10.1016/j.jcp.2009.09.020
+ * section 2.2.4.1. A double L2-projection */
+REF_STATUS ref_recon_op_grad(REF_RECON_OP ref_recon_op, REF_INT nfield,
+                             REF_DBL *scalar, REF_DBL *grad) {
+  REF_NODE ref_node = ref_recon_op->ref_node;
+  REF_INT node, entry, field, i;
+  REF_DBL *weight, *value, sum[3];
+  REF_BOOL div_by_zero;
+
+  REIS(ref_recon_op->n, ref_node_max(ref_node), "operator built for old grid");
+
   div_by_zero = REF_FALSE;
-  each_ref_node_valid_node(ref_node, node) {
-    if (ref_math_divisible(grad[0 + 3 * node], vol[node]) &&
-        ref_math_divisible(grad[1 + 3 * node], vol[node]) &&
-        ref_math_divisible(grad[2 + 3 * node], vol[node])) {
-      for (i = 0; i < 3; i++) grad[i + 3 * node] /= vol[node];
-    } else {
-      div_by_zero = REF_TRUE;
-      for (i = 0; i < 3; i++) grad[i + 3 * node] = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) private(entry, field, i, weight, \
+    value, sum) num_threads(ref_mpi_nthread(ref_node_mpi(ref_node)))     \
+    reduction(|| : div_by_zero)
+#endif
+  for (node = 0; node < ref_recon_op->n; node++) {
+    if (!ref_node_valid(ref_node, node)) continue;
+    for (field = 0; field < nfield; field++) {
+      value = &(grad[3 * field + 3 * nfield * node]);
+      for (i = 0; i < 3; i++) value[i] = 0.0;
+      if (!ref_node_owned(ref_node, node)) continue;
+      for (i = 0; i < 3; i++) sum[i] = 0.0;
+      for (entry = ref_recon_op->first[node];
+           entry < ref_recon_op->first[node + 1]; entry++) {
+        weight = &(ref_recon_op->weight[3 * entry]);
+        for (i = 0; i < 3; i++)
+          sum[i] +=
+              weight[i] * scalar[field + nfield * ref_recon_op->node[entry]];
+      }
+      if (ref_math_divisible(sum[0], ref_recon_op->vol[node]) &&
+          ref_math_divisible(sum[1], ref_recon_op->vol[node]) &&
+          ref_math_divisible(sum[2], ref_recon_op->vol[node])) {
+        for (i = 0; i < 3; i++) value[i] = sum[i] / ref_recon_op->vol[node];
+      } else {
+        div_by_zero = REF_TRUE;
+      }
     }
   }
-  RSS(ref_mpi_all_or(ref_grid_mpi(ref_grid), &div_by_zero), "mpi all or");
-  RSS(ref_node_ghost_dbl(ref_node, grad, 3), "update ghosts");
-
-  ref_free(vol);
+  RSS(ref_mpi_all_or(ref_node_mpi(ref_node), &div_by_zero), "mpi all or");
+  RSS(ref_node_ghost_dbl(ref_node, grad, 3 * nfield), "update ghosts");
 
   return (div_by_zero ? REF_DIV_ZERO : REF_SUCCESS);
 }
 
+REF_STATUS ref_recon_l2_projection_grad(REF_GRID ref_grid, REF_DBL *scalar,
+                                        REF_DBL *grad) {
+  REF_RECON_OP ref_recon_op;
+  REF_STATUS status;
+
+  RSS(ref_recon_op_create(&ref_recon_op, ref_grid), "create op");
+  status = ref_recon_op_grad(ref_recon_op, 1, scalar, grad);
+  RXS(status, REF_DIV_ZERO, "op grad");
+  RSS(ref_recon_op_free(ref_recon_op), "free op");
+
+  return status;
+}
+
+/* the operator is assembled once for the gradient and its derivatives */
 static REF_STATUS ref_recon_l2_projection_hessian(REF_GRID ref_grid,
+                                                  REF_INT nfield,
                                                   REF_DBL *scalar,
                                                   REF_DBL *hessian) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
-  REF_INT i, node;
-  REF_DBL *grad, *dsdx, *gradx, *grady, *gradz;
-
-  ref_malloc_init(grad, 3 * ref_node_max(ref_node), REF_DBL, 0.0);
-  ref_malloc_init(dsdx, ref_node_max(ref_node), REF_DBL, 0.0);
-  ref_malloc_init(gradx, 3 * ref_node_max(ref_node), REF_DBL, 0.0);
-  ref_malloc_init(grady, 3 * ref_node_max(ref_node), REF_DBL, 0.0);
-  ref_malloc_init(gradz, 3 * ref_node_max(ref_node), REF_DBL, 0.0);
-
-  RSS(ref_recon_l2_projection_grad(ref_grid, scalar, grad), "l2 grad");
+  REF_RECON_OP ref_recon_op;
+  REF_INT field, node;
+  REF_DBL *grad, *grad2, *d2, *h;
 
-  i = 0;
-  each_ref_node_valid_node(ref_node, node) dsdx[node] = grad[i + 3 * node];
-  RSS(ref_recon_l2_projection_grad(ref_grid, dsdx, gradx), "gradx");
+  ref_malloc_init(grad, 3 * nfield * ref_node_max(ref_node), REF_DBL, 0.0);
+  ref_malloc_init(grad2, 9 * nfield * ref_node_max(ref_node), REF_DBL, 0.0);
 
-  i = 1;
-  each_ref_node_valid_node(ref_node, node) dsdx[node] = grad[i + 3 * node];
-  RSS(ref_recon_l2_projection_grad(ref_grid, dsdx, grady), "grady");
-
-  i = 2;
-  each_ref_node_valid_node(ref_node, node) dsdx[node] = grad[i + 3 * node];
-  RSS(ref_recon_l2_projection_grad(ref_grid, dsdx, gradz), "gradz");
+  RSS(ref_recon_op_create(&ref_recon_op, ref_grid), "create op");
+  RSS(ref_recon_op_grad(ref_recon_op, nfield, scalar, grad), "l2 grad");
+  RSS(ref_recon_op_grad(ref_recon_op, 3 * nfield, grad, grad2), "l2 grad2");
+  RSS(ref_recon_op_free(ref_recon_op), "free op");
 
   /* average off-diagonals */
   each_ref_node_valid_node(ref_node, node) {
-    hessian[0 + 6 * node] = gradx[0 + 3 * node];
-    hessian[1 + 6 * node] = 0.5 * (gradx[1 + 3 * node] + grady[0 + 3 * node]);
-    hessian[2 + 6 * node] = 0.5 * (gradx[2 + 3 * node] + gradz[0 + 3 * node]);
-    hessian[3 + 6 * node] = grady[1 + 3 * node];
-    hessian[4 + 6 * node] = 0.5 * (grady[2 + 3 * node] + gradz[1 + 3 * node]);
-    hessian[5 + 6 * node] = gradz[2 + 3 * node];
-  }
-
-  ref_free(gradz);
-  ref_free(grady);
-  ref_free(gradx);
-  ref_free(dsdx);
+    for (field = 0; field < nfield; field++) {
+      d2 = &(grad2[9 * field + 9 * nfield * node]);
+      h = &(hessian[6 * field + 6 * nfield * node]);
+      h[0] = d2[0 + 3 * 0];
+      h[1] = 0.5 * (d2[1 + 3 * 0] + d2[0 + 3 * 1]);
+      h[2] = 0.5 * (d2[2 + 3 * 0] + d2[0 + 3 * 2]);
+      h[3] = d2[1 + 3 * 1];
+      h[4] = 0.5 * (d2[2 + 3 * 1] + d2[1 + 3 * 2]);
+      h[5] = d2[2 + 3 * 2];
+    }
+  }
+
+  ref_free(grad2);
   ref_free(grad);
 
   return REF_SUCCESS;
 }
 
-static REF_STATUS ref_recon_kexact_with_aux(REF_GLOB center_global,
-                                            REF_CLOUD ref_cloud, REF_BOOL twod,
-                                            REF_DBL *gradient,
-                                            REF_DBL *hessian) {
-  REF_DBL geom[9], ab[90];
-  REF_DBL dx, dy, dz, dq;
-  REF_DBL *a, *q, *r;
-  REF_INT m, n;
-  REF_GLOB cloud_global;
-  REF_INT item, im, i, j;
-  REF_DBL xyzs[4];
-  REF_BOOL verbose = REF_FALSE;
-
-  RSS(ref_cloud_item(ref_cloud, center_global, &item), "missing center");
-  each_ref_cloud_aux(ref_cloud, i) {
-    xyzs[i] = ref_cloud_aux(ref_cloud, i, item);
-  }
-  /* solve A with QR factorization size m x n */
-  m = ref_cloud_n(ref_cloud) - 1; /* skip self */
-  if (twod) m += 4;               /* add z node node */
-  n = 9;
-  if (verbose)
-    printf("m %d at %f %f %f %f\n", m, xyzs[0], xyzs[1], xyzs[2], xyzs[3]);
-  if (m < n) {           /* underdetermined, will end badly */
-    return REF_DIV_ZERO; /* signal cloud growth required */
-  }
-  ref_malloc(a, m * n, REF_DBL);
-  ref_malloc(q, m * n, REF_DBL);
-  ref_malloc(r, n * n, REF_DBL);
-  i = 0;
-  if (twod) {
-    dx = 0;
-    dy = 0;
-    dz = 1;
-    geom[0] = 0.5 * dx * dx;
-    geom[1] = dx * dy;
-    geom[2] = dx * dz;
-    geom[3] = 0.5 * dy * dy;
-    geom[4] = dy * dz;
-    geom[5] = 0.5 * dz * dz;
-    geom[6] = dx;
-    geom[7] = dy;
-    geom[8] = dz;
-    for (j = 0; j < n; j++) {
-      a[i + m * j] = geom[j];
-      if (verbose) printf(" %12.4e", geom[j]);
-    }
-    if (verbose) printf(" %f %f %f %d\n", dx, dy, dz, i);
-    i++;
-    dx = 0;
-    dy = 0;
-    dz = 2;
-    geom[0] = 0.5 * dx * dx;
-    geom[1] = dx * dy;
-    geom[2] = dx * dz;
-    geom[3] = 0.5 * dy * dy;
-    geom[4] = dy * dz;
-    geom[5] = 0.5 * dz * dz;
-    geom[6] = dx;
-    geom[7] = dy;
-    geom[8] = dz;
-    for (j = 0; j < n; j++) {
-      a[i + m * j] = geom[j];
-      if (verbose) printf(" %12.4e", geom[j]);
-    }
-    if (verbose) printf(" %f %f %f %d\n", dx, dy, dz, i);
-    i++;
-    dx = 1;
-    dy = 0;
-    dz = 1;
-    geom[0] = 0.5 * dx * dx;
-    geom[1] = dx * dy;
-    geom[2] = dx * dz;
-    geom[3] = 0.5 * dy * dy;
-    geom[4] = dy * dz;
-    geom[5] = 0.5 * dz * dz;
-    geom[6] = dx;
-    geom[7] = dy;
-    geom[8] = dz;
-    for (j = 0; j < n; j++) {
-      a[i + m * j] = geom[j];
-      if (verbose) printf(" %12.4e", geom[j]);
-    }
-    if (verbose) printf(" %f %f %f %d\n", dx, dy, dz, i);
-    i++;
-    dx = 0;
-    dy = 1;
-    dz = 1;
-    geom[0] = 0.5 * dx * dx;
-    geom[1] = dx * dy;
-    geom[2] = dx * dz;
-    geom[3] = 0.5 * dy * dy;
-    geom[4] = dy * dz;
-    geom[5] = 0.5 * dz * dz;
-    geom[6] = dx;
-    geom[7] = dy;
-    geom[8] = dz;
-    for (j = 0; j < n; j++) {
-      a[i + m * j] = geom[j];
-      if (verbose) printf(" %12.4e", geom[j]);
-    }
-    if (verbose) printf(" %f %f %f %d\n", dx, dy, dz, i);
-    i++;
-  }
-  each_ref_cloud_global(ref_cloud, item, cloud_global) {
-    if (center_global == cloud_global) continue; /* skip self */
-    dx = ref_cloud_aux(ref_cloud, 0, item) - xyzs[0];
-    dy = ref_cloud_aux(ref_cloud, 1, item) - xyzs[1];
-    dz = ref_cloud_aux(ref_cloud, 2, item) - xyzs[2];
-    geom[0] = 0.5 * dx * dx;
-    geom[1] = dx * dy;
-    geom[2] = dx * dz;
-    geom[3] = 0.5 * dy * dy;
-    geom[4] = dy * dz;
-    geom[5] = 0.5 * dz * dz;
-    geom[6] = dx;
-    geom[7] = dy;
-    geom[8] = dz;
-    for (j = 0; j < n; j++) {
-      a[i + m * j] = geom[j];
-      if (verbose) printf(" %12.4e", geom[j]);
-    }
-    if (verbose) printf(" %f %f %f %d\n", dx, dy, dz, i);
-    i++;
-  }
-  REIS(m, i, "A row miscount");
-  RSS(ref_matrix_qr(m, n, a, q, r), "kexact lsq hess qr");
-  if (verbose) RSS(ref_matrix_show_aqr(m, n, a, q, r), "show qr");
-  for (i = 0; i < 90; i++) ab[i] = 0.0;
-  for (i = 0; i < 9; i++) {
-    for (j = 0; j < 9; j++) {
-      ab[i + 9 * j] += r[i + 9 * j];
+/* one layer stencils in a flat arena, entries of node are first[node] to
+ * first[node + 1] - 1 with a global and xyz, nfield scalars and the owning
+ * part each. owners send the stencils of ghost nodes in one aggregated
+ * exchange */
+static REF_STATUS ref_recon_kexact_layer(REF_GRID ref_grid, REF_INT nfield,
+                                         REF_DBL *scalar, REF_INT **first_ptr,
+                                         REF_GLOB **global_ptr,
+                                         REF_DBL **aux_ptr) {
+  REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
+  REF_CELL ref_cell = ref_grid_tet(ref_grid);
+  REF_INT naux = 4 + nfield;
+  REF_INT node, item, cell, cell_node, target, entry, i, part, local;
+  REF_INT request, degree;
+  REF_INT *first, *mark;
+  REF_GLOB *global;
+  REF_DBL *aux;
+  REF_INT *a_nnode, *b_nnode, a_nnode_total, b_nnode_total;
+  REF_INT *a_nentry, *b_nentry, a_nentry_total, b_nentry_total;
+  REF_INT *a_next, *a_degree, *b_degree;
+  REF_GLOB *a_global, *b_global, *a_entry, *b_entry;
+  REF_DBL *a_aux, *b_aux;
+
+  if (ref_grid_twod(ref_grid)) ref_cell = ref_grid_tri(ref_grid);
+
+  ref_malloc_init(first, ref_node_max(ref_node) + 1, REF_INT, 0);
+  ref_malloc_init(mark, ref_node_max(ref_node), REF_INT, REF_EMPTY);
+  each_ref_node_valid_node(ref_node, node) {
+    if (!ref_node_owned(ref_node, node)) continue;
+    each_ref_cell_having_node(ref_cell, node, item, cell) {
+      each_ref_cell_cell_node(ref_cell, cell_node) {
+        target = ref_cell_c2n(ref_cell, cell_node, cell);
+        if (node == mark[target]) continue;
+        mark[target] = node;
+        first[node + 1]++;
+      }
     }
   }
-  i = 0;
-  if (twod) {
-    dq = 0;
-    for (j = 0; j < 9; j++) {
-      ab[j + 9 * 9] += q[i + m * j] * dq;
-    }
-    i++;
-    dq = 0;
-    for (j = 0; j < 9; j++) {
-      ab[j + 9 * 9] += q[i + m * j] * dq;
-    }
-    i++;
-    dq = 0;
-    for (j = 0; j < 9; j++) {
-      ab[j + 9 * 9] += q[i + m * j] * dq;
-    }
-    i++;
-    dq = 0;
-    for (j = 0; j < 9; j++) {
-      ab[j + 9 * 9] += q[i + m * j] * dq;
-    }
-    i++;
-  }
-  each_ref_cloud_global(ref_cloud, item, cloud_global) {
-    if (center_global == cloud_global) continue; /* skip self */
-    dq = ref_cloud_aux(ref_cloud, 3, item) - xyzs[3];
-    for (j = 0; j < 9; j++) {
-      ab[j + 9 * 9] += q[i + m * j] * dq;
-    }
-    i++;
-  }
-  REIS(m, i, "b row miscount");
-  if (verbose) RSS(ref_matrix_show_ab(9, 10, ab), "show");
-  RAISE(ref_matrix_solve_ab(9, 10, ab));
-  if (verbose) RSS(ref_matrix_show_ab(9, 10, ab), "show");
-  j = 9;
-  for (im = 0; im < 6; im++) {
-    hessian[im] = ab[im + 9 * j];
-  }
-  for (im = 0; im < 3; im++) {
-    gradient[im] = ab[im + 6 + 9 * j];
+
+  /* request the degree of ghost nodes from their owners */
+  ref_malloc_init(a_nnode, ref_mpi_n(ref_mpi), REF_INT, 0);
+  ref_malloc_init(b_nnode, ref_mpi_n(ref_mpi), REF_INT, 0);
+  ref_malloc_init(a_nentry, ref_mpi_n(ref_mpi), REF_INT, 0);
+  ref_malloc_init(b_nentry, ref_mpi_n(ref_mpi), REF_INT, 0);
+  ref_malloc_init(a_next, ref_mpi_n(ref_mpi), REF_INT, 0);
+  each_ref_node_valid_node(ref_node, node) {
+    if (!ref_node_owned(ref_node, node))
+      a_nnode[ref_node_part(ref_node, node)]++;
+  }
+  if (ref_mpi_para(ref_mpi))
+    RSS(ref_mpi_alltoall(ref_mpi, a_nnode, b_nnode, REF_INT_TYPE),
+        "alltoall nnodes");
+  a_nnode_total = 0;
+  each_ref_mpi_part(ref_mpi, part) a_nnode_total += a_nnode[part];
+  b_nnode_total = 0;
+  each_ref_mpi_part(ref_mpi, part) b_nnode_total += b_nnode[part];
+  ref_malloc(a_global, a_nnode_total, REF_GLOB);
+  ref_malloc(b_global, b_nnode_total, REF_GLOB);
+  ref_malloc(a_degree, a_nnode_total, REF_INT);
+  ref_malloc(b_degree, b_nnode_total, REF_INT);
+  each_ref_mpi_worker(ref_mpi, part) {
+    a_next[part] = a_next[part - 1] + a_nnode[part - 1];
+  }
+  each_ref_node_valid_node(ref_node, node) {
+    if (ref_node_owned(ref_node, node)) continue;
+    part = ref_node_part(ref_node, node);
+    a_global[a_next[part]] = ref_node_global(ref_node, node);
+    a_next[part]++;
+  }
+  if (ref_mpi_para(ref_mpi)) {
+    RSS(ref_mpi_alltoallv(ref_mpi, a_global, a_nnode, b_global, b_nnode, 1,
+                          REF_GLOB_TYPE),
+        "alltoallv global");
+    request = 0;
+    each_ref_mpi_part(ref_mpi, part) {
+      for (i = 0; i < b_nnode[part]; i++) {
+        RSS(ref_node_local(ref_node, b_global[request], &local), "g2l");
+        b_degree[request] = first[local + 1];
+        b_nentry[part] += b_degree[request];
+        request++;
+      }
+    }
+    RSS(ref_mpi_alltoallv(ref_mpi, b_degree, b_nnode, a_degree, a_nnode, 1,
+                          REF_INT_TYPE),
+        "alltoallv degree");
+    request = 0;
+    each_ref_mpi_part(ref_mpi, part) {
+      for (i = 0; i < a_nnode[part]; i++) {
+        RSS(ref_node_local(ref_node, a_global[request], &local), "g2l");
+        first[local + 1] = a_degree[request];
+        a_nentry[part] += a_degree[request];
+        request++;
+      }
+    }
   }
-  ref_free(r);
-  ref_free(q);
-  ref_free(a);
 
-  return REF_SUCCESS;
-}
+  for (node = 0; node < ref_node_max(ref_node); node++)
+    first[node + 1] += first[node];
+  ref_malloc(global, first[ref_node_max(ref_node)], REF_GLOB);
+  ref_malloc(aux, naux * first[ref_node_max(ref_node)], REF_DBL);
 
-static REF_STATUS ref_recon_local_immediate_cloud(REF_CLOUD *one_layer,
-                                                  REF_NODE ref_node,
-                                                  REF_CELL ref_cell,
-                                                  REF_DBL *scalar) {
-  REF_INT node, item, cell, cell_node, target;
-  REF_GLOB global;
-  REF_DBL xyzs[4];
+  for (node = 0; node < ref_node_max(ref_node); node++) mark[node] = REF_EMPTY;
   each_ref_node_valid_node(ref_node, node) {
-    if (ref_node_owned(ref_node, node)) {
-      each_ref_cell_having_node(ref_cell, node, item, cell) {
-        each_ref_cell_cell_node(ref_cell, cell_node) {
-          target = ref_cell_c2n(ref_cell, cell_node, cell);
-          global = ref_node_global(ref_node, target);
-          xyzs[0] = ref_node_xyz(ref_node, 0, target);
-          xyzs[1] = ref_node_xyz(ref_node, 1, target);
-          xyzs[2] = ref_node_xyz(ref_node, 2, target);
-          xyzs[3] = scalar[target];
-          RSS(ref_cloud_store(one_layer[node], global, xyzs),
-              "store could stencil");
-        }
+    if (!ref_node_owned(ref_node, node)) continue;
+    entry = first[node];
+    each_ref_cell_having_node(ref_cell, node, item, cell) {
+      each_ref_cell_cell_node(ref_cell, cell_node) {
+        target = ref_cell_c2n(ref_cell, cell_node, cell);
+        if (node == mark[target]) continue;
+        mark[target] = node;
+        global[entry] = ref_node_global(ref_node, target);
+        for (i = 0; i < 3; i++)
+          aux[i + naux * entry] = ref_node_xyz(ref_node, i, target);
+        for (i = 0; i < nfield; i++)
+          aux[3 + i + naux * entry] = scalar[i + nfield * target];
+        aux[3 + nfield + naux * entry] =
+            (REF_DBL)ref_node_part(ref_node, target);
+        entry++;
+      }
+    }
+  }
+  ref_free(mark);
+
+  /* owners reply with the stencils of requested ghost nodes */
+  b_nentry_total = 0;
+  each_ref_mpi_part(ref_mpi, part) b_nentry_total += b_nentry[part];
+  a_nentry_total = 0;
+  each_ref_mpi_part(ref_mpi, part) a_nentry_total += a_nentry[part];
+  ref_malloc(b_entry, b_nentry_total, REF_GLOB);
+  ref_malloc(b_aux, naux * b_nentry_total, REF_DBL);
+  ref_malloc(a_entry, a_nentry_total, REF_GLOB);
+  ref_malloc(a_aux, naux * a_nentry_total, REF_DBL);
+  if (ref_mpi_para(ref_mpi)) {
+    target = 0;
+    for (request = 0; request < b_nnode_total; request++) {
+      RSS(ref_node_local(ref_node, b_global[request], &local), "g2l");
+      for (entry = first[local]; entry < first[local + 1]; entry++) {
+        b_entry[target] = global[entry];
+        for (i = 0; i < naux; i++)
+          b_aux[i + naux * target] = aux[i + naux * entry];
+        target++;
+      }
+    }
+    RSS(ref_mpi_alltoallv(ref_mpi, b_entry, b_nentry, a_entry, a_nentry, 1,
+                          REF_GLOB_TYPE),
+        "alltoallv entry");
+    RSS(ref_mpi_alltoallv(ref_mpi, b_aux, b_nentry, a_aux, a_nentry, naux,
+                          REF_DBL_TYPE),
+        "alltoallv aux");
+    target = 0;
+    for (request = 0; request < a_nnode_total; request++) {
+      RSS(ref_node_local(ref_node, a_global[request], &local), "g2l");
+      degree = first[local + 1] - first[local];
+      REIS(a_degree[request], degree, "ghost degree mismatch");
+      for (entry = first[local]; entry < first[local + 1]; entry++) {
+        global[entry] = a_entry[target];
+        for (i = 0; i < naux; i++)
+          aux[i + naux * entry] = a_aux[i + naux * target];
+        target++;
       }
     }
   }
+
+  ref_free(a_aux);
+  ref_free(a_entry);
+  ref_free(b_aux);
+  ref_free(b_entry);
+  ref_free(b_degree);
+  ref_free(a_degree);
+  ref_free(b_global);
+  ref_free(a_global);
+  ref_free(a_next);
+  ref_free(b_nentry);
+  ref_free(a_nentry);
+  ref_free(b_nnode);
+  ref_free(a_nnode);
+
+  *first_ptr = first;
+  *global_ptr = global;
+  *aux_ptr = aux;
+
+  return REF_SUCCESS;
+}
+
+/* one layer stencils of pivots beyond the ghost layer, fetched from their
+ * owners and appended to the arena at first[slot] with slot >= node_max */
+typedef struct {
+  REF_INT n;
+  REF_GLOB *global; /* ascending */
+  REF_INT *slot;
+  REF_INT nmissing, max_missing;
+  REF_GLOB *missing;
+  REF_INT *missing_part;
+} REF_RECON_REMOTE_STRUCT;
+typedef REF_RECON_REMOTE_STRUCT *REF_RECON_REMOTE;
+
+/* arena index of the pivot global or REF_EMPTY, a pivot that is neither
+ * local nor fetched is recorded as missing when remote is provided */
+static REF_STATUS ref_recon_kexact_pivot(REF_NODE ref_node,
+                                         REF_RECON_REMOTE remote,
+                                         REF_GLOB global, REF_INT part,
+                                         REF_INT *pivot) {
+  REF_INT position;
+  REF_STATUS ref_status;
+
+  ref_status = ref_node_local(ref_node, global, pivot);
+  if (REF_NOT_FOUND != ref_status) return ref_status;
+  *pivot = REF_EMPTY;
+  if (NULL == remote) return REF_SUCCESS;
+
+  ref_status =
+      ref_sort_search_glob(remote->n, remote->global, global, &position);
+  if (REF_NOT_FOUND != ref_status) RSS(ref_status, "remote search");
+  if (REF_EMPTY != position) {
+    *pivot = remote->slot[position];
+    return REF_SUCCESS;
+  }
+
+  if (remote->nmissing >= remote->max_missing) {
+    remote->max_missing += 1000;
+    ref_realloc(remote->missing, remote->max_missing, REF_GLOB);
+    ref_realloc(remote->missing_part, remote->max_missing, REF_INT);
+  }
+  remote->missing[remote->nmissing] = global;
+  remote->missing_part[remote->nmissing] = part;
+  remote->nmissing++;
+
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_recon_ghost_cloud(REF_CLOUD *one_layer, REF_NODE ref_node) {
+/* owners reply with the one layer stencils of the missing pivots, which
+ * are appended to the arena after the existing slots */
+static REF_STATUS ref_recon_kexact_fetch(REF_NODE ref_node, REF_INT naux,
+                                         REF_RECON_REMOTE remote,
+                                         REF_INT **first_ptr,
+                                         REF_GLOB **global_ptr,
+                                         REF_DBL **aux_ptr) {
   REF_MPI ref_mpi = ref_node_mpi(ref_node);
-  REF_CLOUD ref_cloud;
-  REF_INT *a_nnode, *b_nnode;
-  REF_INT a_nnode_total, b_nnode_total;
-  REF_GLOB *a_global, *b_global;
-  REF_INT *a_part, *b_part;
-  REF_INT *a_ncloud, *b_ncloud;
-  REF_INT a_ncloud_total, b_ncloud_total;
-  REF_GLOB *a_keyval, *b_keyval;
+  REF_INT *first = *first_ptr;
+  REF_GLOB *global = *global_ptr;
+  REF_DBL *aux = *aux_ptr;
+  REF_INT *a_nnode, *b_nnode, a_nnode_total, b_nnode_total;
+  REF_INT *a_nentry, *b_nentry, a_nentry_total, b_nentry_total;
+  REF_INT *a_next, *a_degree, *b_degree, *order, *slot;
+  REF_GLOB *a_global, *b_global, *a_entry, *b_entry, *sorted;
   REF_DBL *a_aux, *b_aux;
-  REF_INT part, node, degree;
-  REF_INT *a_next, *b_next;
-  REF_INT local, cloud, key_index, aux_index;
-  REF_GLOB global;
-  REF_INT nkeyval = 2, naux = 4;
-
-  if (!ref_mpi_para(ref_mpi)) return REF_SUCCESS;
+  REF_INT i, j, part, request, local, entry, target, nslot;
 
-  ref_malloc_init(a_next, ref_mpi_n(ref_mpi), REF_INT, 0);
-  ref_malloc_init(b_next, ref_mpi_n(ref_mpi), REF_INT, 0);
   ref_malloc_init(a_nnode, ref_mpi_n(ref_mpi), REF_INT, 0);
   ref_malloc_init(b_nnode, ref_mpi_n(ref_mpi), REF_INT, 0);
-  ref_malloc_init(a_ncloud, ref_mpi_n(ref_mpi), REF_INT, 0);
-  ref_malloc_init(b_ncloud, ref_mpi_n(ref_mpi), REF_INT, 0);
+  ref_malloc_init(a_nentry, ref_mpi_n(ref_mpi), REF_INT, 0);
+  ref_malloc_init(b_nentry, ref_mpi_n(ref_mpi), REF_INT, 0);
+  ref_malloc_init(a_next, ref_mpi_n(ref_mpi), REF_INT, 0);
 
-  /* ghost nodes need to fill */
-  each_ref_node_valid_node(ref_node, node) {
-    if (ref_mpi_rank(ref_mpi) != ref_node_part(ref_node, node)) {
-      a_nnode[ref_node_part(ref_node, node)]++;
-    }
+  /* unique missing globals, grouped by owning part */
+  ref_malloc(order, remote->nmissing, REF_INT);
+  RSS(ref_sort_heap_glob(remote->nmissing, remote->missing, order), "sort");
+  for (j = 0; j < remote->nmissing; j++) {
+    if (0 < j && remote->missing[order[j - 1]] == remote->missing[order[j]])
+      continue;
+    a_nnode[remote->missing_part[order[j]]]++;
   }
-
   RSS(ref_mpi_alltoall(ref_mpi, a_nnode, b_nnode, REF_INT_TYPE),
       "alltoall nnodes");
-
   a_nnode_total = 0;
   each_ref_mpi_part(ref_mpi, part) a_nnode_total += a_nnode[part];
-  ref_malloc(a_global, a_nnode_total, REF_GLOB);
-  ref_malloc(a_part, a_nnode_total, REF_INT);
-
   b_nnode_total = 0;
   each_ref_mpi_part(ref_mpi, part) b_nnode_total += b_nnode[part];
+  ref_malloc(a_global, a_nnode_total, REF_GLOB);
   ref_malloc(b_global, b_nnode_total, REF_GLOB);
-  ref_malloc(b_part, b_nnode_total, REF_INT);
-
-  a_next[0] = 0;
+  ref_malloc(a_degree, a_nnode_total, REF_INT);
+  ref_malloc(b_degree, b_nnode_total, REF_INT);
   each_ref_mpi_worker(ref_mpi, part) {
     a_next[part] = a_next[part - 1] + a_nnode[part - 1];
   }
-
-  each_ref_node_valid_node(ref_node, node) {
-    if (ref_mpi_rank(ref_mpi) != ref_node_part(ref_node, node)) {
-      part = ref_node_part(ref_node, node);
-      a_global[a_next[part]] = ref_node_global(ref_node, node);
-      a_part[a_next[part]] = ref_mpi_rank(ref_mpi);
-      a_next[ref_node_part(ref_node, node)]++;
-    }
+  for (j = 0; j < remote->nmissing; j++) {
+    if (0 < j && remote->missing[order[j - 1]] == remote->missing[order[j]])
+      continue;
+    part = remote->missing_part[order[j]];
+    a_global[a_next[part]] = remote->missing[order[j]];
+    a_next[part]++;
   }
-
+  ref_free(order);
   RSS(ref_mpi_alltoallv(ref_mpi, a_global, a_nnode, b_global, b_nnode, 1,
                         REF_GLOB_TYPE),
       "alltoallv global");
-  RSS(ref_mpi_alltoallv(ref_mpi, a_part, a_nnode, b_part, b_nnode, 1,
+
+  request = 0;
+  each_ref_mpi_part(ref_mpi, part) {
+    for (i = 0; i < b_nnode[part]; i++) {
+      RSS(ref_node_local(ref_node, b_global[request], &local), "g2l");
+      RAS(ref_node_owned(ref_node, local), "requested stencil not owned");
+      b_degree[request] = first[local + 1] - first[local];
+      b_nentry[part] += b_degree[request];
+      request++;
+    }
+  }
+  RSS(ref_mpi_alltoallv(ref_mpi, b_degree, b_nnode, a_degree, a_nnode, 1,
                         REF_INT_TYPE),
-      "alltoallv part");
+      "alltoallv degree");
+  request = 0;
+  each_ref_mpi_part(ref_mpi, part) {
+    for (i = 0; i < a_nnode[part]; i++) {
+      a_nentry[part] += a_degree[request];
+      request++;
+    }
+  }
 
-  /* degree of these node cloud to send */
-  for (node = 0; node < b_nnode_total; node++) {
-    RSS(ref_node_local(ref_node, b_global[node], &local), "g2l");
-    part = b_part[node];
-    degree = ref_cloud_n(one_layer[local]);
-    b_ncloud[part] += degree;
+  b_nentry_total = 0;
+  each_ref_mpi_part(ref_mpi, part) b_nentry_total += b_nentry[part];
+  a_nentry_total = 0;
+  each_ref_mpi_part(ref_mpi, part) a_nentry_total += a_nentry[part];
+  ref_malloc(b_entry, b_nentry_total, REF_GLOB);
+  ref_malloc(b_aux, naux * b_nentry_total, REF_DBL);
+  ref_malloc(a_entry, a_nentry_total, REF_GLOB);
+  ref_malloc(a_aux, naux * a_nentry_total, REF_DBL);
+  target = 0;
+  for (request = 0; request < b_nnode_total; request++) {
+    RSS(ref_node_local(ref_node, b_global[request], &local), "g2l");
+    for (entry = first[local]; entry < first[local + 1]; entry++) {
+      b_entry[target] = global[entry];
+      for (i = 0; i < naux; i++)
+        b_aux[i + naux * target] = aux[i + naux * entry];
+      target++;
+    }
   }
+  RSS(ref_mpi_alltoallv(ref_mpi, b_entry, b_nentry, a_entry, a_nentry, 1,
+                        REF_GLOB_TYPE),
+      "alltoallv entry");
+  RSS(ref_mpi_alltoallv(ref_mpi, b_aux, b_nentry, a_aux, a_nentry, naux,
+                        REF_DBL_TYPE),
+      "alltoallv aux");
 
-  RSS(ref_mpi_alltoall(ref_mpi, b_ncloud, a_ncloud, REF_INT_TYPE),
-      "alltoall nclouds");
+  /* append after the existing slots */
+  nslot = ref_node_max(ref_node) + remote->n;
+  ref_realloc(first, nslot + a_nnode_total + 1, REF_INT);
+  ref_realloc(global, first[nslot] + a_nentry_total, REF_GLOB);
+  ref_realloc(aux, naux * (first[nslot] + a_nentry_total), REF_DBL);
+  target = 0;
+  for (request = 0; request < a_nnode_total; request++) {
+    first[nslot + request + 1] = first[nslot + request] + a_degree[request];
+    for (entry = first[nslot + request]; entry < first[nslot + request + 1];
+         entry++) {
+      global[entry] = a_entry[target];
+      for (i = 0; i < naux; i++)
+        aux[i + naux * entry] = a_aux[i + naux * target];
+      target++;
+    }
+  }
 
-  a_ncloud_total = 0;
-  each_ref_mpi_part(ref_mpi, part) a_ncloud_total += a_ncloud[part];
-  ref_malloc(a_keyval, nkeyval * a_ncloud_total, REF_GLOB);
-  ref_malloc(a_aux, naux * a_ncloud_total, REF_DBL);
+  /* rebuild the ascending index of fetched globals */
+  ref_realloc(remote->global, remote->n + a_nnode_total, REF_GLOB);
+  ref_realloc(remote->slot, remote->n + a_nnode_total, REF_INT);
+  for (request = 0; request < a_nnode_total; request++) {
+    remote->global[remote->n + request] = a_global[request];
+    remote->slot[remote->n + request] = nslot + request;
+  }
+  remote->n += a_nnode_total;
+  ref_malloc(order, remote->n, REF_INT);
+  ref_malloc(sorted, remote->n, REF_GLOB);
+  ref_malloc(slot, remote->n, REF_INT);
+  RSS(ref_sort_heap_glob(remote->n, remote->global, order), "sort");
+  for (j = 0; j < remote->n; j++) {
+    sorted[j] = remote->global[order[j]];
+    slot[j] = remote->slot[order[j]];
+  }
+  ref_free(remote->slot);
+  ref_free(remote->global);
+  remote->global = sorted;
+  remote->slot = slot;
+  ref_free(order);
+  remote->nmissing = 0;
+
+  ref_free(a_aux);
+  ref_free(a_entry);
+  ref_free(b_aux);
+  ref_free(b_entry);
+  ref_free(b_degree);
+  ref_free(a_degree);
+  ref_free(b_global);
+  ref_free(a_global);
+  ref_free(a_next);
+  ref_free(b_nentry);
+  ref_free(a_nentry);
+  ref_free(b_nnode);
+  ref_free(a_nnode);
+
+  *first_ptr = first;
+  *global_ptr = global;
+  *aux_ptr = aux;
 
-  b_ncloud_total = 0;
-  each_ref_mpi_part(ref_mpi, part) b_ncloud_total += b_ncloud[part];
-  ref_malloc(b_keyval, nkeyval * b_ncloud_total, REF_GLOB);
-  ref_malloc(b_aux, naux * b_ncloud_total, REF_DBL);
+  return REF_SUCCESS;
+}
 
-  b_next[0] = 0;
-  each_ref_mpi_worker(ref_mpi, part) {
-    b_next[part] = b_next[part - 1] + b_ncloud[part - 1];
-  }
-
-  for (node = 0; node < b_nnode_total; node++) {
-    RSS(ref_node_local(ref_node, b_global[node], &local), "g2l");
-    part = b_part[node];
-    ref_cloud = one_layer[local];
-    each_ref_cloud_item(ref_cloud, key_index) {
-      b_keyval[0 + nkeyval * b_next[part]] = b_global[node];
-      b_keyval[1 + nkeyval * b_next[part]] =
-          ref_cloud_global(ref_cloud, key_index);
-      for (aux_index = 0; aux_index < naux; aux_index++) {
-        b_aux[aux_index + naux * b_next[part]] =
-            ref_cloud_aux(ref_cloud, aux_index, key_index);
+/* grow the stencil of node to nlayer, unique by global. the candidate
+ * and stencil buffers are reallocated as needed and reused by the caller */
+static REF_STATUS ref_recon_kexact_stencil(
+    REF_NODE ref_node, REF_RECON_REMOTE remote, REF_INT node, REF_INT nlayer,
+    REF_INT naux, REF_INT *first, REF_GLOB *global, REF_DBL *aux,
+    REF_INT *max, REF_GLOB **cand_global, REF_DBL **cand_aux,
+    REF_INT **order, REF_INT *n, REF_GLOB **stencil_global,
+    REF_DBL **stencil_aux) {
+  REF_INT layer, ncand, entry, item, pivot, i, j;
+
+  *n = 0;
+  for (layer = 0; layer < nlayer; layer++) {
+    ncand = *n;
+    for (j = 0; j < *n; j++) {
+      (*cand_global)[j] = (*stencil_global)[j];
+      for (i = 0; i < naux; i++)
+        (*cand_aux)[i + naux * j] = (*stencil_aux)[i + naux * j];
+    }
+    for (item = -1; item < *n; item++) {
+      if (-1 == item) {
+        if (0 < layer) continue;
+        pivot = node;
+      } else {
+        RSS(ref_recon_kexact_pivot(
+                ref_node, remote, (*stencil_global)[item],
+                (REF_INT)(*stencil_aux)[naux - 1 + naux * item], &pivot),
+            "pivot");
+        if (REF_EMPTY == pivot) continue;
+      }
+      if (ncand + first[pivot + 1] - first[pivot] > *max) {
+        *max = ncand + first[pivot + 1] - first[pivot] + 1000;
+        ref_realloc(*cand_global, *max, REF_GLOB);
+        ref_realloc(*cand_aux, naux * (*max), REF_DBL);
+        ref_realloc(*order, *max, REF_INT);
+        ref_realloc(*stencil_global, *max, REF_GLOB);
+        ref_realloc(*stencil_aux, naux * (*max), REF_DBL);
+      }
+      for (entry = first[pivot]; entry < first[pivot + 1]; entry++) {
+        (*cand_global)[ncand] = global[entry];
+        for (i = 0; i < naux; i++)
+          (*cand_aux)[i + naux * ncand] = aux[i + naux * entry];
+        ncand++;
       }
-      b_next[part]++;
+    }
+    RSS(ref_sort_heap_glob(ncand, *cand_global, *order), "sort");
+    *n = 0;
+    for (j = 0; j < ncand; j++) {
+      if (0 < *n && (*stencil_global)[*n - 1] == (*cand_global)[(*order)[j]])
+        continue;
+      (*stencil_global)[*n] = (*cand_global)[(*order)[j]];
+      for (i = 0; i < naux; i++)
+        (*stencil_aux)[i + naux * (*n)] =
+            (*cand_aux)[i + naux * (*order)[j]];
+      (*n)++;
     }
   }
 
-  RSS(ref_mpi_alltoallv(ref_mpi, b_keyval, b_ncloud, a_keyval, a_ncloud,
-                        nkeyval, REF_GLOB_TYPE),
-      "alltoallv keyval");
-  RSS(ref_mpi_alltoallv(ref_mpi, b_aux, b_ncloud, a_aux, a_ncloud, naux,
-                        REF_DBL_TYPE),
-      "alltoallv aux");
+  return REF_SUCCESS;
+}
+
+static void ref_recon_kexact_row(REF_DBL dx, REF_DBL dy, REF_DBL dz,
+                                 REF_INT m, REF_INT row, REF_DBL *a) {
+  a[row + m * 0] = 0.5 * dx * dx;
+  a[row + m * 1] = dx * dy;
+  a[row + m * 2] = dx * dz;
+  a[row + m * 3] = 0.5 * dy * dy;
+  a[row + m * 4] = dy * dz;
+  a[row + m * 5] = 0.5 * dz * dz;
+  a[row + m * 6] = dx;
+  a[row + m * 7] = dy;
+  a[row + m * 8] = dz;
+}
+
+/* least squares Taylor fit of nfield scalars sharing one QR factorization,
+ * a and q hold m x 9 and r 9 x 9 with m from the stencil size */
+static REF_STATUS ref_recon_kexact_solve(REF_GLOB center, REF_INT nstencil,
+                                         REF_GLOB *stencil_global,
+                                         REF_DBL *stencil_aux, REF_INT naux,
+                                         REF_INT nfield, REF_BOOL twod,
+                                         REF_DBL *a, REF_DBL *q, REF_DBL *r,
+                                         REF_DBL *ab, REF_DBL *gradient,
+                                         REF_DBL *hessian) {
+  REF_INT m, n = 9, ncol = 9 + nfield;
+  REF_INT item, row, field, i, j, self;
+  REF_DBL *xyzs;
+  REF_DBL twod_rows[12] = {0, 0, 1, 0, 0, 2, 1, 0, 1, 0, 1, 1};
+  REF_STATUS status;
 
-  for (cloud = 0; cloud < a_ncloud_total; cloud++) {
-    global = a_keyval[0 + nkeyval * cloud];
-    RSS(ref_node_local(ref_node, global, &local), "g2l");
-    ref_cloud = one_layer[local];
-    RSS(ref_cloud_store(ref_cloud, a_keyval[1 + nkeyval * cloud],
-                        &(a_aux[naux * cloud])),
-        "add ghost");
-  }
-
-  free(b_aux);
-  free(b_keyval);
-  free(a_aux);
-  free(a_keyval);
-  free(b_part);
-  free(b_global);
-  free(a_part);
-  free(a_global);
-  free(b_ncloud);
-  free(a_ncloud);
-  free(b_nnode);
-  free(a_nnode);
-  free(b_next);
-  free(a_next);
+  self = REF_EMPTY;
+  for (item = 0; item < nstencil; item++)
+    if (center == stencil_global[item]) self = item;
+  RUS(REF_EMPTY, self, "missing center");
+  xyzs = &(stencil_aux[naux * self]);
+
+  m = nstencil - 1;     /* skip self */
+  if (twod) m += 4;     /* add z node node */
+  if (m < n) {           /* underdetermined, will end badly */
+    return REF_DIV_ZERO; /* signal stencil growth required */
+  }
+
+  row = 0;
+  if (twod) {
+    for (row = 0; row < 4; row++)
+      ref_recon_kexact_row(twod_rows[0 + 3 * row], twod_rows[1 + 3 * row],
+                           twod_rows[2 + 3 * row], m, row, a);
+  }
+  for (item = 0; item < nstencil; item++) {
+    if (item == self) continue;
+    ref_recon_kexact_row(stencil_aux[0 + naux * item] - xyzs[0],
+                         stencil_aux[1 + naux * item] - xyzs[1],
+                         stencil_aux[2 + naux * item] - xyzs[2], m, row, a);
+    row++;
+  }
+  REIS(m, row, "A row miscount");
+  RSS(ref_matrix_qr(m, n, a, q, r), "kexact lsq hess qr");
+
+  for (i = 0; i < n * ncol; i++) ab[i] = 0.0;
+  for (i = 0; i < n; i++)
+    for (j = 0; j < n; j++) ab[i + n * j] = r[i + n * j];
+  /* twod rows have zero scalar difference */
+  row = (twod ? 4 : 0);
+  for (item = 0; item < nstencil; item++) {
+    if (item == self) continue;
+    for (field = 0; field < nfield; field++)
+      for (j = 0; j < n; j++)
+        ab[j + n * (n + field)] +=
+            q[row + m * j] *
+            (stencil_aux[3 + field + naux * item] - xyzs[3 + field]);
+    row++;
+  }
+  status = ref_matrix_solve_ab(n, ncol, ab);
+  if (REF_SUCCESS != status) return status;
+  for (field = 0; field < nfield; field++) {
+    for (i = 0; i < 6; i++)
+      hessian[i + 6 * field] = ab[i + n * (n + field)];
+    for (i = 0; i < 3; i++)
+      gradient[i + 3 * field] = ab[i + 6 + n * (n + field)];
+  }
 
   return REF_SUCCESS;
 }
 
-static REF_STATUS ref_recon_grow_cloud_one_layer(REF_CLOUD ref_cloud,
-                                                 REF_CLOUD *one_layer,
-                                                 REF_NODE ref_node) {
-  REF_CLOUD copy;
-  REF_STATUS ref_status;
-  REF_INT pivot_index, local_pivot;
-  REF_INT add_index, i;
-  REF_GLOB global, global_pivot;
-  REF_DBL xyzs[4];
-  RSS(ref_cloud_deep_copy(&copy, ref_cloud), "copy");
-  each_ref_cloud_global(copy, pivot_index, global_pivot) {
-    ref_status = ref_node_local(ref_node, global_pivot, &local_pivot);
-    if (REF_NOT_FOUND == ref_status) {
-      continue;
-    } else {
-      RSS(ref_status, "local search");
+static REF_STATUS ref_recon_kexact_store(REF_BOOL twod, REF_INT nfield,
+                                         REF_INT node, REF_DBL *node_gradient,
+                                         REF_DBL *node_hessian,
+                                         REF_DBL *gradient, REF_DBL *hessian) {
+  REF_INT field, im;
+  for (field = 0; field < nfield; field++) {
+    if (NULL != gradient) {
+      if (twod) {
+        node_gradient[2 + 3 * field] = 0.0;
+      }
+      for (im = 0; im < 3; im++) {
+        gradient[im + 3 * field + 3 * nfield * node] =
+            node_gradient[im + 3 * field];
+      }
     }
-    each_ref_cloud_global(one_layer[local_pivot], add_index, global) {
-      each_ref_cloud_aux(one_layer[local_pivot], i) {
-        xyzs[i] = ref_cloud_aux(one_layer[local_pivot], i, add_index);
+    if (NULL != hessian) {
+      if (twod) {
+        node_hessian[2 + 6 * field] = 0.0;
+        node_hessian[4 + 6 * field] = 0.0;
+        node_hessian[5 + 6 * field] = 0.0;
+      }
+      for (im = 0; im < 6; im++) {
+        hessian[im + 6 * field + 6 * nfield * node] =
+            node_hessian[im + 6 * field];
       }
-      RSS(ref_cloud_store(ref_cloud, global, xyzs), "store stencil increase");
     }
   }
-  ref_cloud_free(copy);
-
   return REF_SUCCESS;
 }
 
 static REF_STATUS ref_recon_kexact_gradient_hessian(REF_GRID ref_grid,
+                                                    REF_INT nfield,
                                                     REF_DBL *scalar,
                                                     REF_DBL *gradient,
                                                     REF_DBL *hessian) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
-  REF_CELL ref_cell = ref_grid_tet(ref_grid);
-  REF_INT node, im;
-  REF_CLOUD ref_cloud;
-  REF_DBL node_gradient[3], node_hessian[6];
-  REF_STATUS status;
-  REF_CLOUD *one_layer;
-  REF_INT layer;
-
-  if (ref_grid_twod(ref_grid)) ref_cell = ref_grid_tri(ref_grid);
-
-  ref_malloc_init(one_layer, ref_node_max(ref_node), REF_CLOUD, NULL);
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
+  REF_BOOL twod = ref_grid_twod(ref_grid);
+  REF_INT naux = 4 + nfield;
+  REF_INT *first, *first2, *order, *nodes, *sizes, *by_size, *retry, *failed;
+  REF_GLOB *global, *global2, *cand_global, *stencil_global;
+  REF_DBL *aux, *aux2, *cand_aux, *stencil_aux;
+  REF_DBL *a, *q, *r, *ab, *node_gradient, *node_hessian;
+  REF_INT max, max2, n, nowned, nretry, nfailed, nwait, ntotal, nmissing;
+  REF_INT node, i, j, layer, m, work_m;
+  REF_RECON_REMOTE_STRUCT remote;
+  REF_STATUS status, failure;
+
+  RSS(ref_recon_kexact_layer(ref_grid, nfield, scalar, &first, &global, &aux),
+      "one layer");
+
+  max = 1000;
+  ref_malloc(cand_global, max, REF_GLOB);
+  ref_malloc(cand_aux, naux * max, REF_DBL);
+  ref_malloc(order, max, REF_INT);
+  ref_malloc(stencil_global, max, REF_GLOB);
+  ref_malloc(stencil_aux, naux * max, REF_DBL);
+
+  /* halo(2) stencils of owned nodes in one flat arena */
+  nowned = 0;
+  each_ref_node_valid_node(ref_node, node) {
+    if (ref_node_owned(ref_node, node)) nowned++;
+  }
+  ref_malloc(nodes, nowned, REF_INT);
+  ref_malloc(sizes, nowned, REF_INT);
+  ref_malloc_init(first2, nowned + 1, REF_INT, 0);
+  max2 = 30 * nowned + 1000;
+  ref_malloc(global2, max2, REF_GLOB);
+  ref_malloc(aux2, naux * max2, REF_DBL);
+  n = 0;
   each_ref_node_valid_node(ref_node, node) {
-    RSS(ref_cloud_create(&(one_layer[node]), 4), "cloud storage");
+    if (!ref_node_owned(ref_node, node)) continue;
+    RSS(ref_recon_kexact_stencil(ref_node, NULL, node, 2, naux, first, global,
+                                 aux, &max, &cand_global, &cand_aux, &order,
+                                 &m, &stencil_global, &stencil_aux),
+        "halo 2");
+    nodes[n] = node;
+    sizes[n] = m;
+    first2[n + 1] = first2[n] + m;
+    if (first2[n + 1] > max2) {
+      max2 = first2[n + 1] + max2 / 2;
+      ref_realloc(global2, max2, REF_GLOB);
+      ref_realloc(aux2, naux * max2, REF_DBL);
+    }
+    for (j = 0; j < m; j++) {
+      global2[j + first2[n]] = stencil_global[j];
+      for (i = 0; i < naux; i++)
+        aux2[i + naux * (j + first2[n])] = stencil_aux[i + naux * j];
+    }
+    n++;
   }
 
-  RSS(ref_recon_local_immediate_cloud(one_layer, ref_node, ref_cell, scalar),
-      "fill immediate cloud");
-  RSS(ref_recon_ghost_cloud(one_layer, ref_node), "fill ghosts");
+  ref_malloc(node_gradient, 3 * nfield, REF_DBL);
+  ref_malloc(node_hessian, 6 * nfield, REF_DBL);
+  ref_malloc(ab, 9 * (9 + nfield), REF_DBL);
+  ref_malloc(retry, nowned, REF_INT);
+  ref_malloc(failed, nowned, REF_INT);
+  nretry = 0;
+
+  /* one QR per node, visited by stencil size so the workspace is only
+   * reallocated when the size changes */
+  ref_malloc(by_size, nowned, REF_INT);
+  RSS(ref_sort_heap_int(nowned, sizes, by_size), "sort sizes");
+  a = NULL;
+  q = NULL;
+  r = NULL;
+  work_m = REF_EMPTY;
+  for (j = 0; j < nowned; j++) {
+    n = by_size[j];
+    node = nodes[n];
+    m = sizes[n] - 1 + (twod ? 4 : 0);
+    if (m != work_m) {
+      work_m = m;
+      ref_free(r);
+      ref_free(q);
+      ref_free(a);
+      ref_malloc(a, MAX(m, 9) * 9, REF_DBL);
+      ref_malloc(q, MAX(m, 9) * 9, REF_DBL);
+      ref_malloc(r, 9 * 9, REF_DBL);
+    }
+    status = ref_recon_kexact_solve(
+        ref_node_global(ref_node, node), sizes[n], &(global2[first2[n]]),
+        &(aux2[naux * first2[n]]), naux, nfield, twod, a, q, r, ab,
+        node_gradient, node_hessian);
+    if (REF_DIV_ZERO == status || REF_ILL_CONDITIONED == status) {
+      retry[nretry] = node;
+      nretry++;
+      continue;
+    }
+    RSS(status, "kexact solve");
+    RSS(ref_recon_kexact_store(twod, nfield, node, node_gradient,
+                               node_hessian, gradient, hessian),
+        "store");
+  }
 
-  each_ref_node_valid_node(ref_node, node) {
-    if (ref_node_owned(ref_node, node)) {
-      /* use ref_cloud to get a unique list of halo(2) nodes */
-      RSS(ref_cloud_deep_copy(&ref_cloud, one_layer[node]), "create ref_cloud");
-      status = REF_INVALID;
-      for (layer = 2; status != REF_SUCCESS && layer <= 8; layer++) {
-        RSS(ref_recon_grow_cloud_one_layer(ref_cloud, one_layer, ref_node),
+  /* grow the stencils that could not be solved with halo(2). pivots beyond
+   * the ghost layer are fetched from their owners, so the grown stencil is
+   * the same for any partition. collective, every part visits each layer */
+  remote.n = 0;
+  remote.global = NULL;
+  remote.slot = NULL;
+  remote.nmissing = 0;
+  remote.max_missing = 0;
+  remote.missing = NULL;
+  remote.missing_part = NULL;
+  failure = REF_SUCCESS;
+  for (layer = 3; layer <= 8; layer++) {
+    ntotal = nretry;
+    RSS(ref_mpi_allsum(ref_mpi, &ntotal, 1, REF_INT_TYPE), "sum retry");
+    if (0 == ntotal) break;
+    nfailed = 0;
+    do {
+      nwait = 0;
+      for (j = 0; j < nretry; j++) {
+        node = retry[j];
+        nmissing = remote.nmissing;
+        RSS(ref_recon_kexact_stencil(ref_node, &remote, node, layer, naux,
+                                     first, global, aux, &max, &cand_global,
+                                     &cand_aux, &order, &n, &stencil_global,
+                                     &stencil_aux),
             "grow");
-        status = ref_recon_kexact_with_aux(ref_node_global(ref_node, node),
-                                           ref_cloud, ref_grid_twod(ref_grid),
-                                           node_gradient, node_hessian);
-        if (REF_DIV_ZERO == status && layer > 4) {
-          ref_node_location(ref_node, node);
-          printf(" caught %s, for %d layers to kexact cloud; retry\n",
-                 "REF_DIV_ZERO", layer);
-        }
-        if (REF_ILL_CONDITIONED == status && layer > 4) {
-          ref_node_location(ref_node, node);
-          printf(" caught %s, for %d layers to kexact cloud; retry\n",
-                 "REF_ILL_CONDITIONED", layer);
+        if (nmissing < remote.nmissing) { /* wait for the fetch */
+          retry[nwait] = node;
+          nwait++;
+          continue;
         }
-      }
-      RSB(status, "kexact qr node", { ref_node_location(ref_node, node); });
-      if (NULL != gradient) {
-        if (ref_grid_twod(ref_grid)) {
-          node_gradient[2] = 0.0;
-        }
-        for (im = 0; im < 3; im++) {
-          gradient[im + 3 * node] = node_gradient[im];
-        }
-      }
-      if (NULL != hessian) {
-        if (ref_grid_twod(ref_grid)) {
-          node_hessian[2] = 0.0;
-          node_hessian[4] = 0.0;
-          node_hessian[5] = 0.0;
+        m = n - 1 + (twod ? 4 : 0);
+        if (m != work_m) {
+          work_m = m;
+          ref_free(r);
+          ref_free(q);
+          ref_free(a);
+          ref_malloc(a, MAX(m, 9) * 9, REF_DBL);
+          ref_malloc(q, MAX(m, 9) * 9, REF_DBL);
+          ref_malloc(r, 9 * 9, REF_DBL);
         }
-        for (im = 0; im < 6; im++) {
-          hessian[im + 6 * node] = node_hessian[im];
+        status = ref_recon_kexact_solve(ref_node_global(ref_node, node), n,
+                                        stencil_global, stencil_aux, naux,
+                                        nfield, twod, a, q, r, ab,
+                                        node_gradient, node_hessian);
+        if (REF_DIV_ZERO == status || REF_ILL_CONDITIONED == status) {
+          if (layer > 4) {
+            ref_node_location(ref_node, node);
+            printf(" caught %s, for %d layers to kexact cloud; retry\n",
+                   (REF_DIV_ZERO == status ? "REF_DIV_ZERO"
+                                           : "REF_ILL_CONDITIONED"),
+                   layer);
+          }
+          failure = status;
+          failed[nfailed] = node;
+          nfailed++;
+          continue;
         }
+        RSS(status, "kexact solve");
+        RSS(ref_recon_kexact_store(twod, nfield, node, node_gradient,
+                                   node_hessian, gradient, hessian),
+            "store");
       }
-      RSS(ref_cloud_free(ref_cloud), "free ref_cloud");
-    }
+      nretry = nwait;
+      nmissing = remote.nmissing;
+      RSS(ref_mpi_allsum(ref_mpi, &nmissing, 1, REF_INT_TYPE), "sum missing");
+      if (0 < nmissing)
+        RSS(ref_recon_kexact_fetch(ref_node, naux, &remote, &first, &global,
+                                   &aux),
+            "fetch");
+    } while (0 < nmissing);
+    for (j = 0; j < nfailed; j++) retry[j] = failed[j];
+    nretry = nfailed;
   }
-
-  each_ref_node_valid_node(ref_node, node) {
-    ref_cloud_free(one_layer[node]); /* no-op for null */
+  if (0 < nretry) {
+    node = retry[0];
+    RSB(failure, "kexact qr node", { ref_node_location(ref_node, node); });
   }
-  ref_free(one_layer);
+  ref_free(remote.missing_part);
+  ref_free(remote.missing);
+  ref_free(remote.slot);
+  ref_free(remote.global);
+
+  ref_free(r);
+  ref_free(q);
+  ref_free(a);
+  ref_free(failed);
+  ref_free(retry);
+  ref_free(by_size);
+  ref_free(ab);
+  ref_free(node_hessian);
+  ref_free(node_gradient);
+  ref_free(aux2);
+  ref_free(global2);
+  ref_free(first2);
+  ref_free(sizes);
+  ref_free(nodes);
+  ref_free(stencil_aux);
+  ref_free(stencil_global);
+  ref_free(order);
+  ref_free(cand_aux);
+  ref_free(cand_global);
+  ref_free(aux);
+  ref_free(global);
+  ref_free(first);
 
   if (NULL != gradient) {
-    RSS(ref_node_ghost_dbl(ref_node, gradient, 3), "update ghosts");
+    RSS(ref_node_ghost_dbl(ref_node, gradient, 3 * nfield), "update ghosts");
   }
 
   if (NULL != hessian) {
-    RSS(ref_node_ghost_dbl(ref_node, hessian, 6), "update ghosts");
+    RSS(ref_node_ghost_dbl(ref_node, hessian, 6 * nfield), "update ghosts");
   }
 
   return REF_SUCCESS;
@@ -708,48 +1124,69 @@ REF_STATUS ref_recon_extrapolate_zeroth(REF_GRID ref_grid, REF_DBL *recon,
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_recon_roundoff_limit(REF_DBL *recon, REF_GRID ref_grid) {
+REF_STATUS ref_recon_roundoff_floor(REF_GRID ref_grid, REF_INT node,
+                                    REF_DBL *eig_floor) {
   REF_CELL ref_cell = ref_grid_tet(ref_grid);
   REF_NODE ref_node = ref_grid_node(ref_grid);
-  REF_INT i, node;
+  REF_INT i;
   REF_DBL radius, dist;
   REF_DBL round_off_jitter = 1.0e-12;
-  REF_DBL eig_floor;
   REF_INT nnode, node_list[REF_RECON_MAX_DEGREE],
       max_node = REF_RECON_MAX_DEGREE;
-  REF_DBL diag_system[12];
 
   if (ref_grid_twod(ref_grid)) ref_cell = ref_grid_tri(ref_grid);
 
-  each_ref_node_valid_node(ref_node, node) {
-    RSS(ref_cell_node_list_around(ref_cell, node, max_node, &nnode, node_list),
-        "first halo of nodes");
-    radius = 0.0;
-    for (i = 0; i < nnode; i++) {
-      dist = sqrt(pow(ref_node_xyz(ref_node, 0, node_list[i]) -
-                          ref_node_xyz(ref_node, 0, node),
-                      2) +
-                  pow(ref_node_xyz(ref_node, 1, node_list[i]) -
-                          ref_node_xyz(ref_node, 1, node),
-                      2) +
-                  pow(ref_node_xyz(ref_node, 2, node_list[i]) -
-                          ref_node_xyz(ref_node, 2, node),
-                      2));
-      if (i == 0) radius = dist;
-      radius = MIN(radius, dist);
-    }
-    /* 2nd order central finite difference */
-    eig_floor = 4 * round_off_jitter / radius / radius;
+  RSS(ref_cell_node_list_around(ref_cell, node, max_node, &nnode, node_list),
+      "first halo of nodes");
+  radius = 0.0;
+  for (i = 0; i < nnode; i++) {
+    dist = sqrt(pow(ref_node_xyz(ref_node, 0, node_list[i]) -
+                        ref_node_xyz(ref_node, 0, node),
+                    2) +
+                pow(ref_node_xyz(ref_node, 1, node_list[i]) -
+                        ref_node_xyz(ref_node, 1, node),
+                    2) +
+                pow(ref_node_xyz(ref_node, 2, node_list[i]) -
+                        ref_node_xyz(ref_node, 2, node),
+                    2));
+    if (i == 0) radius = dist;
+    radius = MIN(radius, dist);
+  }
+  /* 2nd order central finite difference */
+  *eig_floor = 4 * round_off_jitter / radius / radius;
 
-    RSS(ref_matrix_diag_m(&(recon[6 * node]), diag_system), "eigen decomp");
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_recon_roundoff_limit(REF_DBL *recon, REF_GRID ref_grid) {
+  REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_INT node;
+  REF_DBL eig_floor;
+  REF_DBL diag_system[12];
+  REF_STATUS status;
+
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_grid_mpi(ref_grid))) \
+    schedule(static) private(eig_floor, diag_system) reduction(max : status)
+#endif
+  for (node = 0; node < ref_node_max(ref_node); node++) {
+    if (!ref_node_valid(ref_node, node)) continue;
+    if (REF_SUCCESS != ref_recon_roundoff_floor(ref_grid, node, &eig_floor) ||
+        REF_SUCCESS != ref_matrix_diag_m(&(recon[6 * node]), diag_system)) {
+      status = REF_FAILURE;
+      continue;
+    }
     ref_matrix_eig(diag_system, 0) =
         MAX(ref_matrix_eig(diag_system, 0), eig_floor);
     ref_matrix_eig(diag_system, 1) =
         MAX(ref_matrix_eig(diag_system, 1), eig_floor);
     ref_matrix_eig(diag_system, 2) =
         MAX(ref_matrix_eig(diag_system, 2), eig_floor);
-    RSS(ref_matrix_form_m(diag_system, &(recon[6 * node])), "re-form hess");
+    if (REF_SUCCESS != ref_matrix_form_m(diag_system, &(recon[6 * node])))
+      status = REF_FAILURE;
   }
+  RSS(status, "floor eigenvalues");
 
   RSS(ref_node_ghost_dbl(ref_node, recon, 6), "update ghosts");
 
@@ -806,6 +1243,29 @@ REF_STATUS ref_recon_max_jump_limit(REF_DBL *recon, REF_GRID ref_grid,
   return REF_SUCCESS;
 }
 
+REF_STATUS ref_recon_gradients(REF_GRID ref_grid, REF_INT nfield,
+                               REF_DBL *scalar, REF_DBL *grad,
+                               REF_RECON_RECONSTRUCTION recon) {
+  REF_RECON_OP ref_recon_op;
+  switch (recon) {
+    case REF_RECON_L2PROJECTION:
+      RSS(ref_recon_op_create(&ref_recon_op, ref_grid), "create op");
+      RSS(ref_recon_op_grad(ref_recon_op, nfield, scalar, grad), "l2");
+      RSS(ref_recon_op_free(ref_recon_op), "free op");
+      break;
+    case REF_RECON_KEXACT:
+      RSS(ref_recon_kexact_gradient_hessian(ref_grid, nfield, scalar, grad,
+                                            NULL),
+          "k-exact");
+      break;
+    case REF_RECON_LAST:
+    default:
+      THROW("reconstruction not available");
+  }
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_recon_gradient(REF_GRID ref_grid, REF_DBL *scalar, REF_DBL *grad,
                               REF_RECON_RECONSTRUCTION recon) {
   switch (recon) {
@@ -813,7 +1273,7 @@ REF_STATUS ref_recon_gradient(REF_GRID ref_grid, REF_DBL *scalar, REF_DBL *grad,
       RSS(ref_recon_l2_projection_grad(ref_grid, scalar, grad), "l2");
       break;
     case REF_RECON_KEXACT:
-      RSS(ref_recon_kexact_gradient_hessian(ref_grid, scalar, grad, NULL),
+      RSS(ref_recon_kexact_gradient_hessian(ref_grid, 1, scalar, grad, NULL),
           "k-exact");
       break;
     case REF_RECON_LAST:
@@ -824,47 +1284,60 @@ REF_STATUS ref_recon_gradient(REF_GRID ref_grid, REF_DBL *scalar, REF_DBL *grad,
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_recon_abs_value_hessian(REF_GRID ref_grid, REF_DBL *hessian) {
+static REF_STATUS ref_recon_abs_value_hessians(REF_GRID ref_grid,
+                                               REF_INT nfield,
+                                               REF_DBL *hessian) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
-  REF_DBL diag_system[12];
-  REF_INT node;
+  REF_DBL diag_system[12], *h;
+  REF_INT node, field;
 
   /* positive eignevalues to make positive definite */
   each_ref_node_valid_node(ref_node, node) {
     if (ref_node_owned(ref_node, node)) {
-      RSS(ref_matrix_diag_m(&(hessian[6 * node]), diag_system), "decomp");
-      ref_matrix_eig(diag_system, 0) = ABS(ref_matrix_eig(diag_system, 0));
-      ref_matrix_eig(diag_system, 1) = ABS(ref_matrix_eig(diag_system, 1));
-      ref_matrix_eig(diag_system, 2) = ABS(ref_matrix_eig(diag_system, 2));
-      RSS(ref_matrix_form_m(diag_system, &(hessian[6 * node])), "re-form");
+      for (field = 0; field < nfield; field++) {
+        h = &(hessian[6 * field + 6 * nfield * node]);
+        RSS(ref_matrix_diag_m(h, diag_system), "decomp");
+        ref_matrix_eig(diag_system, 0) = ABS(ref_matrix_eig(diag_system, 0));
+        ref_matrix_eig(diag_system, 1) = ABS(ref_matrix_eig(diag_system, 1));
+        ref_matrix_eig(diag_system, 2) = ABS(ref_matrix_eig(diag_system, 2));
+        RSS(ref_matrix_form_m(diag_system, h), "re-form");
+      }
     }
   }
 
-  RSS(ref_node_ghost_dbl(ref_node, hessian, 6), "update ghosts");
+  RSS(ref_node_ghost_dbl(ref_node, hessian, 6 * nfield), "update ghosts");
 
   return REF_SUCCESS;
 }
 
-REF_STATUS ref_recon_signed_hessian(REF_GRID ref_grid, REF_DBL *scalar,
-                                    REF_DBL *hessian,
-                                    REF_RECON_RECONSTRUCTION recon) {
+REF_STATUS ref_recon_abs_value_hessian(REF_GRID ref_grid, REF_DBL *hessian) {
+  RSS(ref_recon_abs_value_hessians(ref_grid, 1, hessian), "abs");
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_recon_signed_hessians(REF_GRID ref_grid, REF_INT nfield,
+                                     REF_DBL *scalar, REF_DBL *hessian,
+                                     REF_RECON_RECONSTRUCTION recon) {
   REF_BOOL *replace;
 
   switch (recon) {
     case REF_RECON_L2PROJECTION:
-      RSS(ref_recon_l2_projection_hessian(ref_grid, scalar, hessian), "l2");
-      ref_malloc(replace, 6 * ref_node_max(ref_grid_node(ref_grid)), REF_BOOL);
+      RSS(ref_recon_l2_projection_hessian(ref_grid, nfield, scalar, hessian),
+          "l2");
+      ref_malloc(replace, 6 * nfield * ref_node_max(ref_grid_node(ref_grid)),
+                 REF_BOOL);
       if (ref_grid_twod(ref_grid)) {
-        RSS(ref_recon_mask_edg(ref_grid, replace, 6), "mask edg");
+        RSS(ref_recon_mask_edg(ref_grid, replace, 6 * nfield), "mask edg");
       } else {
-        RSS(ref_recon_mask_tri(ref_grid, replace, 6), "mask tri");
+        RSS(ref_recon_mask_tri(ref_grid, replace, 6 * nfield), "mask tri");
       }
-      RSS(ref_recon_extrapolate_zeroth(ref_grid, hessian, replace, 6),
+      RSS(ref_recon_extrapolate_zeroth(ref_grid, hessian, replace, 6 * nfield),
           "bound extrap");
       ref_free(replace);
       break;
     case REF_RECON_KEXACT:
-      RSS(ref_recon_kexact_gradient_hessian(ref_grid, scalar, NULL, hessian),
+      RSS(ref_recon_kexact_gradient_hessian(ref_grid, nfield, scalar, NULL,
+                                            hessian),
           "k-exact");
       break;
     case REF_RECON_LAST:
@@ -875,6 +1348,22 @@ REF_STATUS ref_recon_signed_hessian(REF_GRID ref_grid, REF_DBL *scalar,
   return REF_SUCCESS;
 }
 
+REF_STATUS ref_recon_signed_hessian(REF_GRID ref_grid, REF_DBL *scalar,
+                                    REF_DBL *hessian,
+                                    REF_RECON_RECONSTRUCTION recon) {
+  RSS(ref_recon_signed_hessians(ref_grid, 1, scalar, hessian, recon), "one");
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_recon_hessians(REF_GRID ref_grid, REF_INT nfield,
+                              REF_DBL *scalar, REF_DBL *hessian,
+                              REF_RECON_RECONSTRUCTION recon) {
+  RSS(ref_recon_signed_hessians(ref_grid, nfield, scalar, hessian, recon),
+      "signed hess");
+  RSS(ref_recon_abs_value_hessians(ref_grid, nfield, hessian), "abs hess");
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_recon_hessian(REF_GRID ref_grid, REF_DBL *scalar,
                              REF_DBL *hessian, REF_RECON_RECONSTRUCTION recon) {
   RSS(ref_recon_signed_hessian(ref_grid, scalar, hessian, recon), "abs hess");
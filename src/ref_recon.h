@@ -34,6 +34,25 @@ END_C_DECLORATION
 
 BEGIN_C_DECLORATION
 
+/* L2-projection gradient as compressed sparse rows of owned nodes,
+ * weights are volume weighted shape function gradients (3 per entry) */
+typedef struct REF_RECON_OP_STRUCT REF_RECON_OP_STRUCT;
+typedef REF_RECON_OP_STRUCT *REF_RECON_OP;
+struct REF_RECON_OP_STRUCT {
+  REF_NODE ref_node;
+  REF_INT n;
+  REF_INT *first;
+  REF_INT *node;
+  REF_DBL *weight;
+  REF_DBL *vol;
+};
+
+REF_STATUS ref_recon_op_create(REF_RECON_OP *ref_recon_op, REF_GRID ref_grid);
+REF_STATUS ref_recon_op_free(REF_RECON_OP ref_recon_op);
+/* scalar has leading dimension nfield and grad 3 * nfield */
+REF_STATUS ref_recon_op_grad(REF_RECON_OP ref_recon_op, REF_INT nfield,
+                             REF_DBL *scalar, REF_DBL *grad);
+
 /* public for one-ring/plugin-refine */
 REF_STATUS ref_recon_l2_projection_grad(REF_GRID ref_grid, REF_DBL *scalar,
                                         REF_DBL *grad);
@@ -46,6 +65,17 @@ REF_STATUS ref_recon_signed_hessian(REF_GRID ref_grid, REF_DBL *scalar,
 REF_STATUS ref_recon_hessian(REF_GRID ref_grid, REF_DBL *scalar,
                              REF_DBL *hessian, REF_RECON_RECONSTRUCTION recon);
 
+/* nfield scalars interleaved, gradient 3 * nfield and hessian 6 * nfield */
+REF_STATUS ref_recon_gradients(REF_GRID ref_grid, REF_INT nfield,
+                               REF_DBL *scalar, REF_DBL *grad,
+                               REF_RECON_RECONSTRUCTION recon);
+REF_STATUS ref_recon_signed_hessians(REF_GRID ref_grid, REF_INT nfield,
+                                     REF_DBL *scalar, REF_DBL *hessian,
+                                     REF_RECON_RECONSTRUCTION recon);
+REF_STATUS ref_recon_hessians(REF_GRID ref_grid, REF_INT nfield,
+                              REF_DBL *scalar, REF_DBL *hessian,
+                              REF_RECON_RECONSTRUCTION recon);
+
 REF_STATUS ref_recon_extrapolate_zeroth(REF_GRID ref_grid, REF_DBL *recon,
                                         REF_BOOL *replace, REF_INT ldim);
 
@@ -53,9 +83,10 @@ REF_STATUS ref_recon_extrapolate_zeroth(REF_GRID ref_grid, REF_DBL *recon,
 REF_STATUS ref_recon_abs_value_hessian(REF_GRID ref_grid, REF_DBL *hessian);
 REF_STATUS ref_recon_mask_tri(REF_GRID ref_grid, REF_BOOL *replace,
                               REF_INT ldim);
-REF_STATUS ref_recon_ghost_cloud(REF_CLOUD *one_layer, REF_NODE ref_node);
 
 /* eliminate */
+REF_STATUS ref_recon_roundoff_floor(REF_GRID ref_grid, REF_INT node,
+                                    REF_DBL *eig_floor);
 REF_STATUS ref_recon_roundoff_limit(REF_DBL *recon, REF_GRID ref_grid);
 REF_STATUS ref_recon_max_jump_limit(REF_DBL *recon, REF_GRID ref_grid,
                                     REF_DBL max_jump);
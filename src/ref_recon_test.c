@@ -235,6 +235,53 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
+  { /* batched l2-projection hessians match one field at a time */
+    REF_DBL tol = -1.0;
+    REF_GRID ref_grid;
+    REF_NODE ref_node;
+    REF_DBL *scalar, *one, *hessians, *hessian;
+    REF_INT node, field, i;
+
+    RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+    ref_node = ref_grid_node(ref_grid);
+
+    ref_malloc(scalar, 2 * ref_node_max(ref_node), REF_DBL);
+    ref_malloc(one, ref_node_max(ref_node), REF_DBL);
+    ref_malloc(hessians, 12 * ref_node_max(ref_node), REF_DBL);
+    ref_malloc(hessian, 6 * ref_node_max(ref_node), REF_DBL);
+
+    each_ref_node_valid_node(ref_node, node) {
+      scalar[0 + 2 * node] = pow(ref_node_xyz(ref_node, 0, node), 2) +
+                             ref_node_xyz(ref_node, 1, node) *
+                                 ref_node_xyz(ref_node, 2, node);
+      scalar[1 + 2 * node] = 0.5 * pow(ref_node_xyz(ref_node, 2, node), 2);
+    }
+
+    RSS(ref_recon_hessians(ref_grid, 2, scalar, hessians,
+                           REF_RECON_L2PROJECTION),
+        "l2 hessians");
+
+    for (field = 0; field < 2; field++) {
+      each_ref_node_valid_node(ref_node, node) {
+        one[node] = scalar[field + 2 * node];
+      }
+      RSS(ref_recon_hessian(ref_grid, one, hessian, REF_RECON_L2PROJECTION),
+          "l2 hess");
+      each_ref_node_valid_node(ref_node, node) {
+        for (i = 0; i < 6; i++)
+          RWDS(hessian[i + 6 * node], hessians[i + 6 * field + 12 * node], tol,
+               "batched");
+      }
+    }
+
+    ref_free(hessian);
+    ref_free(hessians);
+    ref_free(one);
+    ref_free(scalar);
+
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
   { /* l2-projection hessian zero, constant gradient twod tri brick */
     REF_DBL tol = -1.0;
     REF_GRID ref_grid;
@@ -497,6 +544,57 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
+  { /* para file k-exact hessians of two fields share stencils */
+    REF_GRID ref_grid;
+    REF_NODE ref_node;
+    REF_INT node;
+    REF_DBL *scalar, *hessian;
+    REF_DBL tol = -1.0;
+    char file[] = "ref_recon_test.meshb";
+
+    if (ref_mpi_once(ref_mpi)) {
+      RSS(ref_fixture_tet_brick_grid(&ref_grid, ref_mpi), "brick");
+      RSS(ref_export_by_extension(ref_grid, file), "export");
+      RSS(ref_grid_free(ref_grid), "free");
+    }
+    RSS(ref_part_by_extension(&ref_grid, ref_mpi, file), "import");
+    if (ref_mpi_once(ref_mpi)) REIS(0, remove(file), "test clean up");
+
+    ref_node = ref_grid_node(ref_grid);
+    ref_malloc(scalar, 2 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+    ref_malloc(hessian, 12 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+    each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
+      REF_DBL x = ref_node_xyz(ref_node, 0, node);
+      REF_DBL y = ref_node_xyz(ref_node, 1, node);
+      REF_DBL z = ref_node_xyz(ref_node, 2, node);
+      scalar[0 + 2 * node] = 0.5 + 0.01 * (0.5 * x * x) + 0.02 * x * y +
+                             0.04 * (0.5 * y * y) + 0.06 * (0.5 * z * z);
+      scalar[1 + 2 * node] = 0.3 * x + 0.05 * y * z;
+    }
+    RSS(ref_recon_signed_hessians(ref_grid, 2, scalar, hessian,
+                                  REF_RECON_KEXACT),
+        "k-exact hess");
+    each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
+      RWDS(0.01, hessian[0 + 12 * node], tol, "m[0]");
+      RWDS(0.02, hessian[1 + 12 * node], tol, "m[1]");
+      RWDS(0.00, hessian[2 + 12 * node], tol, "m[2]");
+      RWDS(0.04, hessian[3 + 12 * node], tol, "m[3]");
+      RWDS(0.00, hessian[4 + 12 * node], tol, "m[4]");
+      RWDS(0.06, hessian[5 + 12 * node], tol, "m[5]");
+      RWDS(0.00, hessian[6 + 12 * node], tol, "n[0]");
+      RWDS(0.00, hessian[7 + 12 * node], tol, "n[1]");
+      RWDS(0.00, hessian[8 + 12 * node], tol, "n[2]");
+      RWDS(0.00, hessian[9 + 12 * node], tol, "n[3]");
+      RWDS(0.05, hessian[10 + 12 * node], tol, "n[4]");
+      RWDS(0.00, hessian[11 + 12 * node], tol, "n[5]");
+    }
+
+    ref_free(hessian);
+    ref_free(scalar);
+
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
   if (!ref_mpi_para(ref_mpi)) { /* k-exact 2D */
     REF_GRID ref_grid;
     REF_NODE ref_node;
@@ -555,74 +653,6 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free");
   }
 
-  { /* ghost cloud one_layer cloud */
-    REF_NODE ref_node;
-    REF_INT local, ghost;
-    REF_GLOB global;
-    REF_CLOUD one_layer[] = {NULL, NULL};
-    REF_DBL xyzs[4];
-
-    RSS(ref_node_create(&ref_node, ref_mpi), "create");
-
-    /* set up 0-local and 1-ghost with global=part */
-    global = ref_mpi_rank(ref_mpi);
-    RSS(ref_node_add(ref_node, global, &local), "add");
-    ref_node_part(ref_node, local) = (REF_INT)global;
-
-    if (ref_mpi_para(ref_mpi)) {
-      global = ref_mpi_rank(ref_mpi) + 1;
-      if (global >= ref_mpi_n(ref_mpi)) global = 0;
-      RSS(ref_node_add(ref_node, global, &ghost), "add");
-      ref_node_part(ref_node, ghost) = (REF_INT)global;
-    }
-
-    /* set up local cloud with both nodes if para */
-    each_ref_node_valid_node(ref_node, local) {
-      RSS(ref_cloud_create(&(one_layer[local]), 4), "cloud storage");
-    }
-    local = 0;
-    xyzs[0] = 10.0 * ref_node_part(ref_node, local);
-    xyzs[1] = 20.0 * ref_node_part(ref_node, local);
-    xyzs[2] = 30.0 * ref_node_part(ref_node, local);
-    xyzs[3] = 40.0 * ref_node_part(ref_node, local);
-    global = ref_node_global(ref_node, local);
-    RSS(ref_cloud_store(one_layer[0], global, xyzs), "store cloud stencil");
-    local = 1;
-    if (ref_node_valid(ref_node, local)) {
-      xyzs[0] = 10.0 * ref_node_part(ref_node, local);
-      xyzs[1] = 20.0 * ref_node_part(ref_node, local);
-      xyzs[2] = 30.0 * ref_node_part(ref_node, local);
-      xyzs[3] = 40.0 * ref_node_part(ref_node, local);
-      global = ref_node_global(ref_node, local);
-      RSS(ref_cloud_store(one_layer[0], global, xyzs), "store cloud stencil");
-    }
-    RSS(ref_recon_ghost_cloud(one_layer, ref_node), "update ghosts");
-
-    if (ref_mpi_para(ref_mpi)) {
-      REIS(2, ref_cloud_n(one_layer[0]), "local");
-      global = ref_mpi_rank(ref_mpi);
-      RAS(ref_cloud_has_global(one_layer[0], global), "local");
-      global = ref_mpi_rank(ref_mpi) + 1;
-      if (global >= ref_mpi_n(ref_mpi)) global = 0;
-      RAS(ref_cloud_has_global(one_layer[0], global), "local");
-
-      REIS(2, ref_cloud_n(one_layer[1]), "ghost");
-      global = ref_mpi_rank(ref_mpi) + 1;
-      if (global >= ref_mpi_n(ref_mpi)) global -= ref_mpi_n(ref_mpi);
-      RAS(ref_cloud_has_global(one_layer[1], global), "local");
-      global = ref_mpi_rank(ref_mpi) + 2;
-      if (global >= ref_mpi_n(ref_mpi)) global -= ref_mpi_n(ref_mpi);
-      RAS(ref_cloud_has_global(one_layer[1], global), "local");
-    } else {
-      REIS(1, ref_cloud_n(one_layer[0]), "no one");
-    }
-
-    each_ref_node_valid_node(ref_node, local) {
-      ref_cloud_free(one_layer[local]); /* no-op for null */
-    }
-    RSS(ref_node_free(ref_node), "free");
-  }
-
   RSS(ref_mpi_free(ref_mpi), "free");
   RSS(ref_mpi_stop(), "stop");
   return 0;
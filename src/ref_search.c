@@ -136,6 +136,123 @@ REF_STATUS ref_search_insert(REF_SEARCH ref_search, REF_INT item,
   return REF_SUCCESS;
 }
 
+/* rearrange index[0,n) so index[k] holds the k-th smallest center along
+ * axis, with smaller before and larger after (quickselect) */
+static void ref_search_select(REF_INT *index, REF_INT n, REF_INT k,
+                              REF_DBL *position, REF_INT axis) {
+  REF_INT low, high, i, j, temp;
+  REF_DBL pivot;
+  low = 0;
+  high = n - 1;
+  while (low < high) {
+    pivot = position[axis + 3 * index[(low + high) / 2]];
+    i = low;
+    j = high;
+    while (i <= j) {
+      while (position[axis + 3 * index[i]] < pivot) i++;
+      while (position[axis + 3 * index[j]] > pivot) j--;
+      if (i <= j) {
+        temp = index[i];
+        index[i] = index[j];
+        index[j] = temp;
+        i++;
+        j--;
+      }
+    }
+    if (k <= j) {
+      high = j;
+    } else if (k >= i) {
+      low = i;
+    } else {
+      break;
+    }
+  }
+}
+
+static REF_STATUS ref_search_build(REF_SEARCH ref_search, REF_INT *index,
+                                   REF_INT n, REF_INT *item,
+                                   REF_DBL *position, REF_DBL *radius,
+                                   REF_INT *root) {
+  REF_DBL low[3], high[3], distance;
+  REF_INT i, j, axis, mid, location;
+
+  *root = REF_EMPTY;
+  if (0 == n) return REF_SUCCESS;
+
+  /* split the bounding box of the centers across its longest side */
+  for (j = 0; j < 3; j++) {
+    low[j] = REF_DBL_MAX;
+    high[j] = REF_DBL_MIN;
+  }
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < 3; j++) {
+      low[j] = MIN(low[j], position[j + 3 * index[i]]);
+      high[j] = MAX(high[j], position[j + 3 * index[i]]);
+    }
+  }
+  axis = 0;
+  for (j = 1; j < 3; j++)
+    if (high[j] - low[j] > high[axis] - low[axis]) axis = j;
+
+  mid = n / 2;
+  ref_search_select(index, n, mid, position, axis);
+
+  /* preorder placement keeps the root at location 0 */
+  location = ref_search->empty;
+  (ref_search->empty)++;
+  ref_search->item[location] = item[index[mid]];
+  for (j = 0; j < 3; j++)
+    ref_search->pos[j + ref_search->d * location] =
+        position[j + 3 * index[mid]];
+  ref_search->radius[location] = radius[index[mid]];
+
+  ref_search->children_ball[location] = 0.0;
+  for (i = 0; i < n; i++) {
+    if (i == mid) continue;
+    distance = 0.0;
+    for (j = 0; j < 3; j++)
+      distance += pow(position[j + 3 * index[i]] -
+                          ref_search->pos[j + ref_search->d * location],
+                      2);
+    ref_search->children_ball[location] =
+        MAX(ref_search->children_ball[location],
+            sqrt(distance) + radius[index[i]]);
+  }
+
+  RSS(ref_search_build(ref_search, index, mid, item, position, radius,
+                       &(ref_search->left[location])),
+      "left");
+  RSS(ref_search_build(ref_search, &(index[mid + 1]), n - mid - 1, item,
+                       position, radius, &(ref_search->right[location])),
+      "right");
+
+  *root = location;
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_search_bulk(REF_SEARCH ref_search, REF_INT n, REF_INT *item,
+                           REF_DBL *position, REF_DBL *radius) {
+  REF_INT i, *index, root;
+
+  RAS(3 == ref_search->d, "bulk build expects 3D positions");
+  RAS(0 == ref_search->empty, "bulk build expects an empty tree");
+  if (n > ref_search->n)
+    RSS(REF_INCREASE_LIMIT, "need larger tree for more items");
+  for (i = 0; i < n; i++)
+    if (item[i] < 0) RSS(REF_INVALID, "item can not be negative");
+  if (0 == n) return REF_SUCCESS;
+
+  ref_malloc(index, n, REF_INT);
+  for (i = 0; i < n; i++) index[i] = i;
+  RSS(ref_search_build(ref_search, index, n, item, position, radius, &root),
+      "build");
+  ref_free(index);
+  REIS(0, root, "root not at top");
+
+  return REF_SUCCESS;
+}
+
 static REF_STATUS ref_search_gather(REF_SEARCH ref_search, REF_LIST ref_list,
                                     REF_INT parent, REF_DBL *position,
                                     REF_DBL radius) {
@@ -48,6 +48,11 @@ REF_STATUS ref_search_free(REF_SEARCH ref_search);
 REF_STATUS ref_search_insert(REF_SEARCH ref_search, REF_INT item,
                              REF_DBL *position, REF_DBL radius);
 
+/* balanced top-down build of an empty tree from all n items at once,
+ * position is 3*n centers, the tree can still be inserted into after */
+REF_STATUS ref_search_bulk(REF_SEARCH ref_search, REF_INT n, REF_INT *item,
+                           REF_DBL *position, REF_DBL *radius);
+
 REF_STATUS ref_search_touching(REF_SEARCH ref_search, REF_LIST ref_list,
                                REF_DBL *position, REF_DBL radius);
 
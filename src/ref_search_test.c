@@ -18,6 +18,7 @@
 
 #include "ref_search.h"
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -257,6 +258,83 @@ int main(int argc, char *argv[]) {
     RSS(ref_search_free(ref_search), "search free");
   }
 
+  { /* bulk build gathers the same items as brute force */
+    REF_SEARCH ref_search;
+    REF_LIST ref_list;
+    REF_INT n = 500, i, j, item, *items, found;
+    REF_DBL *xyz, *r, target[3], target_r, dist, trim, brute;
+    REF_BOOL contains;
+
+    ref_malloc(items, n, REF_INT);
+    ref_malloc(xyz, 3 * n, REF_DBL);
+    ref_malloc(r, n, REF_DBL);
+    for (i = 0; i < n; i++) {
+      items[i] = 2 * i;
+      /* structured ordering, the worst case for incremental insert */
+      xyz[0 + 3 * i] = (REF_DBL)(i % 10);
+      xyz[1 + 3 * i] = (REF_DBL)((i / 10) % 10);
+      xyz[2 + 3 * i] = (REF_DBL)(i / 100);
+      r[i] = 0.1 * (REF_DBL)(i % 7);
+    }
+    RSS(ref_search_create(&ref_search, n), "make search");
+    RSS(ref_search_bulk(ref_search, n, items, xyz, r), "bulk");
+    RSS(ref_list_create(&ref_list), "make list");
+
+    for (j = 0; j < 20; j++) {
+      target[0] = 0.47 * (REF_DBL)j;
+      target[1] = 9.0 - 0.41 * (REF_DBL)j;
+      target[2] = 0.23 * (REF_DBL)j;
+      target_r = 0.05 * (REF_DBL)j;
+      RSS(ref_list_erase(ref_list), "erase");
+      RSS(ref_search_touching(ref_search, ref_list, target, target_r), "t");
+      found = 0;
+      brute = REF_DBL_MAX;
+      for (i = 0; i < n; i++) {
+        dist = sqrt(pow(xyz[0 + 3 * i] - target[0], 2) +
+                    pow(xyz[1 + 3 * i] - target[1], 2) +
+                    pow(xyz[2 + 3 * i] - target[2], 2));
+        brute = MIN(brute, dist + r[i]);
+        RSS(ref_list_contains(ref_list, items[i], &contains), "has");
+        REIS(dist <= r[i] + target_r, contains, "touching mismatch");
+        if (contains) found++;
+      }
+      REIS(found, ref_list_n(ref_list), "each item once");
+      RSS(ref_search_trim_radius(ref_search, target, &trim), "trim");
+      RWDS(brute, trim, -1, "trim radius");
+      RSS(ref_list_erase(ref_list), "erase");
+      RSS(ref_search_nearest_candidates(ref_search, ref_list, target), "near");
+      RAS(0 < ref_list_n(ref_list), "nearest found");
+      each_ref_list_item(ref_list, item) {
+        REIS(0, ref_list_value(ref_list, item) % 2, "valid item");
+      }
+    }
+
+    RSS(ref_list_free(ref_list), "list free");
+    RSS(ref_search_free(ref_search), "search free");
+    ref_free(r);
+    ref_free(xyz);
+    ref_free(items);
+  }
+
+  { /* bulk build then insert */
+    REF_SEARCH ref_search;
+    REF_LIST ref_list;
+    REF_INT items[2] = {3, 4};
+    REF_DBL xyz[6] = {0.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+    REF_DBL r[2] = {0.1, 0.1};
+
+    RSS(ref_search_create(&ref_search, 3), "make search");
+    RSS(ref_search_bulk(ref_search, 2, items, xyz, r), "bulk");
+    xyz[0] = 2.0;
+    RSS(ref_search_insert(ref_search, 5, xyz, 0.1), "insert");
+    RSS(ref_list_create(&ref_list), "make list");
+    RSS(ref_search_touching(ref_search, ref_list, xyz, 0.5), "touches");
+    REIS(1, ref_list_n(ref_list), "one");
+    REIS(5, ref_list_value(ref_list, 0), "inserted item");
+    RSS(ref_list_free(ref_list), "list free");
+    RSS(ref_search_free(ref_search), "search free");
+  }
+
   { /* selection half */
     REF_DBL *elements, median, value;
     REF_INT n;
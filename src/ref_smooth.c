@@ -32,6 +32,7 @@
 #include "ref_matrix.h"
 #include "ref_metric.h"
 #include "ref_mpi.h"
+#include "ref_perf.h"
 
 static REF_STATUS ref_smooth_add_pliant_force(REF_NODE ref_node, REF_INT center,
                                               REF_INT neighbor,
@@ -689,6 +690,7 @@ static REF_STATUS ref_smooth_no_geom_edge_improve(REF_GRID ref_grid,
 
   backoff = 1.0;
   for (tries = 0; tries < 8; tries++) {
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     for (ixyz = 0; ixyz < 3; ixyz++)
       ref_node_xyz(ref_node, ixyz, node) =
           backoff * ideal[ixyz] + (1.0 - backoff) * original[ixyz];
@@ -784,6 +786,7 @@ static REF_STATUS ref_smooth_meshlink_edge_improve(REF_GRID ref_grid,
 
   backoff = 1.0;
   for (tries = 0; tries < 8; tries++) {
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     for (ixyz = 0; ixyz < 3; ixyz++)
       ref_node_xyz(ref_node, ixyz, node) =
           backoff * ideal[ixyz] + (1.0 - backoff) * original[ixyz];
@@ -958,6 +961,7 @@ static REF_STATUS ref_smooth_no_geom_tri_improve(REF_GRID ref_grid,
 
   backoff = 1.0;
   for (tries = 0; tries < 8; tries++) {
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     for (ixyz = 0; ixyz < 3; ixyz++)
       ref_node_xyz(ref_node, ixyz, node) =
           backoff * ideal[ixyz] + (1.0 - backoff) * original[ixyz];
@@ -1063,6 +1067,7 @@ static REF_STATUS ref_smooth_meshlink_face_improve(REF_GRID ref_grid,
 
   backoff = 1.0;
   for (tries = 0; tries < 8; tries++) {
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     for (ixyz = 0; ixyz < 3; ixyz++)
       ref_node_xyz(ref_node, ixyz, node) =
           backoff * ideal[ixyz] + (1.0 - backoff) * original[ixyz];
@@ -1349,6 +1354,7 @@ REF_STATUS ref_smooth_tet_improve(REF_GRID ref_grid, REF_INT node) {
   }
   backoff = 1.0;
   for (tries = 0; tries < 8; tries++) {
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     for (ixyz = 0; ixyz < 3; ixyz++)
       ref_node_xyz(ref_node, ixyz, node) =
           backoff * ideal[ixyz] + (1.0 - backoff) * original[ixyz];
@@ -1676,10 +1682,22 @@ REF_STATUS ref_smooth_geom_face(REF_GRID ref_grid, REF_INT node) {
   return REF_SUCCESS;
 }
 
+/* each smooth candidate is one attempt, only rejected next to a ghost */
+static REF_STATUS ref_smooth_tally(REF_PERF ref_perf, REF_BOOL allowed) {
+  ref_perf_attempt(ref_perf);
+  if (allowed) {
+    ref_perf_success(ref_perf);
+  } else {
+    ref_perf_reject(ref_perf, REF_PERF_GHOST);
+  }
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
   REF_CELL ref_cell;
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_GEOM ref_geom = ref_grid_geom(ref_grid);
+  REF_PERF ref_perf = ref_grid_perf(ref_grid);
   REF_INT geom, node;
   REF_BOOL allowed, geom_node, geom_edge, geom_face, interior;
 
@@ -1689,6 +1707,8 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
     ref_cell = ref_grid_tet(ref_grid);
   }
 
+  RSS(ref_perf_start(ref_grid, REF_PERF_SMOOTH), "perf");
+
   /* smooth edges first if we have geom */
   each_ref_geom_edge(ref_geom, geom) {
     node = ref_geom_node(ref_geom, geom);
@@ -1700,6 +1720,7 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
         "para");
     if (!allowed) {
       ref_node_age(ref_node, node)++;
+      RSS(ref_smooth_tally(ref_perf, REF_FALSE), "tally");
       continue;
     }
     if (ref_geom_meshlinked(ref_geom)) {
@@ -1707,6 +1728,7 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
     } else {
       RSS(ref_smooth_geom_edge(ref_grid, node), "ideal node for edge");
     }
+    RSS(ref_smooth_tally(ref_perf, REF_TRUE), "tally");
     ref_node_age(ref_node, node) = 0;
   }
 
@@ -1722,11 +1744,13 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
         "para");
     if (!allowed) {
       ref_node_age(ref_node, node)++;
+      RSS(ref_smooth_tally(ref_perf, REF_FALSE), "tally");
       continue;
     }
 
     ref_node_age(ref_node, node) = 0;
     RSS(ref_smooth_no_geom_edge_improve(ref_grid, node), "improve");
+    RSS(ref_smooth_tally(ref_perf, REF_TRUE), "tally");
   }
 
   if (ref_grid_adapt(ref_grid, instrument))
@@ -1743,6 +1767,7 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
         "para");
     if (!allowed) {
       ref_node_age(ref_node, node)++;
+      RSS(ref_smooth_tally(ref_perf, REF_FALSE), "tally");
       continue;
     }
     if (ref_geom_meshlinked(ref_geom)) {
@@ -1750,6 +1775,7 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
     } else {
       RSS(ref_smooth_geom_face(ref_grid, node), "ideal node for face");
     }
+    RSS(ref_smooth_tally(ref_perf, REF_TRUE), "tally");
     ref_node_age(ref_node, node) = 0;
   }
 
@@ -1769,9 +1795,11 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
         "para");
     if (!allowed) {
       ref_node_age(ref_node, node)++;
+      RSS(ref_smooth_tally(ref_perf, REF_FALSE), "tally");
       continue;
     }
     RSS(ref_smooth_no_geom_tri_improve(ref_grid, node), "no geom smooth");
+    RSS(ref_smooth_tally(ref_perf, REF_TRUE), "tally");
   }
 
   if (ref_grid_adapt(ref_grid, instrument))
@@ -1785,6 +1813,7 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
         "para");
     if (!allowed) {
       ref_node_age(ref_node, node)++;
+      RSS(ref_smooth_tally(ref_perf, REF_FALSE), "tally");
       continue;
     }
 
@@ -1793,6 +1822,7 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
                !ref_cell_node_empty(ref_grid_tet(ref_grid), node);
     if (interior) {
       RSS(ref_smooth_tet_improve(ref_grid, node), "ideal tet node");
+      RSS(ref_smooth_tally(ref_perf, REF_TRUE), "tally");
       ref_node_age(ref_node, node) = 0;
     }
   }
@@ -1815,6 +1845,7 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
               "para");
           if (!allowed) {
             ref_node_age(ref_node, node)++;
+            RSS(ref_smooth_tally(ref_perf, REF_FALSE), "tally");
             continue;
           }
 
@@ -1822,12 +1853,16 @@ REF_STATUS ref_smooth_pass(REF_GRID ref_grid) {
                      ref_cell_node_empty(ref_grid_qua(ref_grid), node);
           if (interior) {
             RSS(ref_smooth_tet_improve(ref_grid, node), "ideal");
+            RSS(ref_smooth_tally(ref_perf, REF_TRUE), "tally");
             ref_node_age(ref_node, node) = 0;
           }
         }
       }
     }
   }
+
+  RSS(ref_perf_stop(ref_grid), "perf");
+
   return REF_SUCCESS;
 }
 
@@ -2040,6 +2075,7 @@ static REF_STATUS ref_smooth_tet_nso_step(REF_GRID ref_grid, REF_INT node,
   last_qual = 0.0;
   max_reductions = 8;
   for (reductions = 0; reductions < max_reductions; reductions++) {
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     ref_node_xyz(ref_node, 0, node) = xyz[0] + alpha * dir[0];
     ref_node_xyz(ref_node, 1, node) = xyz[1] + alpha * dir[1];
     ref_node_xyz(ref_node, 2, node) = xyz[2] + alpha * dir[2];
@@ -20,6 +20,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ref_malloc.h"
 
@@ -188,6 +189,150 @@ REF_STATUS ref_sort_heap_dbl(REF_INT n, REF_DBL *original,
   return REF_SUCCESS;
 }
 
+#define REF_SORT_RADIX_BITS (8)
+#define REF_SORT_RADIX_BUCKETS (1 << REF_SORT_RADIX_BITS)
+#define ref_sort_radix_digit(key, pass)                  \
+  ((REF_INT)(((key) >> (REF_SORT_RADIX_BITS * (pass))) & \
+             (REF_ULONG)(REF_SORT_RADIX_BUCKETS - 1)))
+
+/* keys are overwritten, sorted_index orders them ascending and stable */
+static REF_STATUS ref_sort_radix_key(REF_INT n, REF_ULONG *key, REF_INT nbyte,
+                                     REF_INT *sorted_index) {
+  REF_INT i, j, pass, digit, offset, count, index;
+  REF_INT *counts;
+  REF_ULONG *scratch_key, *key_from, *key_to, *key_swap, k;
+  REF_INT *scratch_index, *index_from, *index_to, *index_swap;
+
+  for (i = 0; i < n; i++) sorted_index[i] = i;
+
+  if (n < REF_SORT_RADIX_MIN) {
+    for (i = 1; i < n; i++) {
+      k = key[i];
+      index = sorted_index[i];
+      for (j = i; j > 0 && key[j - 1] > k; j--) {
+        key[j] = key[j - 1];
+        sorted_index[j] = sorted_index[j - 1];
+      }
+      key[j] = k;
+      sorted_index[j] = index;
+    }
+    return REF_SUCCESS;
+  }
+
+  /* histogram every digit with one read of the keys */
+  ref_malloc_init(counts, nbyte * REF_SORT_RADIX_BUCKETS, REF_INT, 0);
+  for (i = 0; i < n; i++)
+    for (pass = 0; pass < nbyte; pass++)
+      counts[ref_sort_radix_digit(key[i], pass) +
+             REF_SORT_RADIX_BUCKETS * pass]++;
+
+  ref_malloc(scratch_key, n, REF_ULONG);
+  ref_malloc(scratch_index, n, REF_INT);
+  key_from = key;
+  key_to = scratch_key;
+  index_from = sorted_index;
+  index_to = scratch_index;
+
+  for (pass = 0; pass < nbyte; pass++) {
+    /* skip a digit shared by every key, e.g., high bytes of small ints */
+    if (n == counts[ref_sort_radix_digit(key_from[0], pass) +
+                    REF_SORT_RADIX_BUCKETS * pass])
+      continue;
+    offset = 0;
+    for (digit = 0; digit < REF_SORT_RADIX_BUCKETS; digit++) {
+      count = counts[digit + REF_SORT_RADIX_BUCKETS * pass];
+      counts[digit + REF_SORT_RADIX_BUCKETS * pass] = offset;
+      offset += count;
+    }
+    for (i = 0; i < n; i++) {
+      digit = ref_sort_radix_digit(key_from[i], pass);
+      j = counts[digit + REF_SORT_RADIX_BUCKETS * pass];
+      key_to[j] = key_from[i];
+      index_to[j] = index_from[i];
+      counts[digit + REF_SORT_RADIX_BUCKETS * pass]++;
+    }
+    key_swap = key_from;
+    key_from = key_to;
+    key_to = key_swap;
+    index_swap = index_from;
+    index_from = index_to;
+    index_to = index_swap;
+  }
+
+  if (index_from != sorted_index)
+    for (i = 0; i < n; i++) sorted_index[i] = index_from[i];
+
+  ref_free(scratch_index);
+  ref_free(scratch_key);
+  ref_free(counts);
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_sort_radix_int(REF_INT n, REF_INT *original,
+                              REF_INT *sorted_index) {
+  REF_INT i;
+  REF_ULONG *key;
+
+  if (n < 1) return REF_SUCCESS;
+
+  /* flip sign bit to order negative before positive */
+  ref_malloc(key, n, REF_ULONG);
+  for (i = 0; i < n; i++)
+    key[i] = (REF_ULONG)((REF_UINT)original[i] ^ (REF_UINT)REF_INT_MIN);
+  RSS(ref_sort_radix_key(n, key, (REF_INT)sizeof(REF_INT), sorted_index),
+      "radix");
+  ref_free(key);
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_sort_radix_glob(REF_INT n, REF_GLOB *original,
+                               REF_INT *sorted_index) {
+  REF_INT i;
+  REF_ULONG *key, sign_bit;
+
+  if (n < 1) return REF_SUCCESS;
+
+  /* flip sign bit to order negative before positive */
+  sign_bit = ((REF_ULONG)1) << (8 * sizeof(REF_ULONG) - 1);
+  ref_malloc(key, n, REF_ULONG);
+  for (i = 0; i < n; i++)
+    key[i] = ((REF_ULONG)((REF_LONG)original[i])) ^ sign_bit;
+  RSS(ref_sort_radix_key(n, key, (REF_INT)sizeof(REF_ULONG), sorted_index),
+      "radix");
+  ref_free(key);
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_sort_radix_dbl(REF_INT n, REF_DBL *original,
+                              REF_INT *sorted_index) {
+  REF_INT i;
+  REF_ULONG *key, sign_bit;
+
+  if (n < 1) return REF_SUCCESS;
+
+  REIS(sizeof(REF_ULONG), sizeof(REF_DBL), "dbl key size");
+
+  /* negative flips all bits to reverse order, positive flips sign bit */
+  sign_bit = ((REF_ULONG)1) << (8 * sizeof(REF_ULONG) - 1);
+  ref_malloc(key, n, REF_ULONG);
+  for (i = 0; i < n; i++) {
+    memcpy(&(key[i]), &(original[i]), sizeof(REF_ULONG));
+    if (key[i] & sign_bit) {
+      key[i] = ~key[i];
+    } else {
+      key[i] ^= sign_bit;
+    }
+  }
+  RSS(ref_sort_radix_key(n, key, (REF_INT)sizeof(REF_ULONG), sorted_index),
+      "radix");
+  ref_free(key);
+
+  return REF_SUCCESS;
+}
+
 REF_STATUS ref_sort_in_place_glob(REF_INT n, REF_GLOB *sorts) {
   REF_INT i;
   REF_INT *order;
@@ -197,7 +342,7 @@ REF_STATUS ref_sort_in_place_glob(REF_INT n, REF_GLOB *sorts) {
   if (2 > n) return REF_SUCCESS;
   ref_malloc(order, n, REF_INT);
   ref_malloc(sorted, n, REF_GLOB);
-  RSS(ref_sort_heap_glob(n, sorts, order), "heap");
+  RSS(ref_sort_radix_glob(n, sorts, order), "radix");
   for (i = 0; i < n; i++) {
     sorted[i] = sorts[order[i]];
   }
@@ -215,7 +360,17 @@ REF_STATUS ref_sort_unique_int(REF_INT n, REF_INT *original, REF_INT *nunique,
 
   *nunique = REF_EMPTY;
 
-  RSS(ref_sort_insertion_int(n, original, unique), "sort in unique");
+  /* cell nodes and parts are a handful of keys, where the radix sort would
+   * also fall back to insertion without allocating a permutation */
+  if (n < REF_SORT_RADIX_MIN) {
+    RSS(ref_sort_insertion_int(n, original, unique), "sort in unique");
+  } else {
+    REF_INT *order;
+    ref_malloc(order, n, REF_INT);
+    RSS(ref_sort_radix_int(n, original, order), "radix in unique");
+    for (i = 0; i < n; i++) unique[i] = original[order[i]];
+    ref_free(order);
+  }
 
   j = 0;
   for (i = 1; i < n; i++) {
@@ -33,6 +33,16 @@ REF_STATUS ref_sort_heap_glob(REF_INT n, REF_GLOB *original,
 REF_STATUS ref_sort_heap_dbl(REF_INT n, REF_DBL *original,
                              REF_INT *sorted_index);
 
+/* stable LSD radix sort, insertion sort below REF_SORT_RADIX_MIN */
+#define REF_SORT_RADIX_MIN (64)
+REF_STATUS ref_sort_radix_int(REF_INT n, REF_INT *original,
+                              REF_INT *sorted_index);
+REF_STATUS ref_sort_radix_glob(REF_INT n, REF_GLOB *original,
+                               REF_INT *sorted_index);
+/* orders IEEE bits, NaN not supported */
+REF_STATUS ref_sort_radix_dbl(REF_INT n, REF_DBL *original,
+                              REF_INT *sorted_index);
+
 REF_STATUS ref_sort_in_place_glob(REF_INT n, REF_GLOB *sorts);
 
 REF_STATUS ref_sort_unique_int(REF_INT n, REF_INT *original, REF_INT *nunique,
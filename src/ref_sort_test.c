@@ -22,8 +22,69 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#include "ref_args.h"
+#include "ref_malloc.h"
+
+static REF_DBL ref_sort_test_seconds(clock_t start) {
+  return ((REF_DBL)(clock() - start)) / ((REF_DBL)CLOCKS_PER_SEC);
+}
+
+int main(int argc, char *argv[]) {
+  REF_INT pos = REF_EMPTY;
+
+  RXS(ref_args_find(argc, argv, "--benchmark", &pos), REF_NOT_FOUND,
+      "arg search");
+  if (REF_EMPTY != pos) {
+    REF_INT i, n = 10000000;
+    REF_INT *ints, *order;
+    REF_GLOB *globs;
+    REF_DBL *dbls;
+    clock_t start;
+    REF_DBL seconds;
+    if (pos < argc - 1) n = atoi(argv[pos + 1]);
+    ref_malloc(ints, n, REF_INT);
+    ref_malloc(globs, n, REF_GLOB);
+    ref_malloc(dbls, n, REF_DBL);
+    ref_malloc(order, n, REF_INT);
+    for (i = 0; i < n; i++) {
+      ints[i] = rand();
+      globs[i] = (REF_GLOB)rand();
+      dbls[i] = (REF_DBL)rand() / (REF_DBL)RAND_MAX;
+    }
+    printf("%d keys, million keys per second\n", n);
+    start = clock();
+    RSS(ref_sort_heap_int(n, ints, order), "heap");
+    seconds = ref_sort_test_seconds(start);
+    printf("heap  int  %8.2f\n", 1.0e-6 * (REF_DBL)n / seconds);
+    start = clock();
+    RSS(ref_sort_radix_int(n, ints, order), "radix");
+    seconds = ref_sort_test_seconds(start);
+    printf("radix int  %8.2f\n", 1.0e-6 * (REF_DBL)n / seconds);
+    start = clock();
+    RSS(ref_sort_heap_glob(n, globs, order), "heap");
+    seconds = ref_sort_test_seconds(start);
+    printf("heap  glob %8.2f\n", 1.0e-6 * (REF_DBL)n / seconds);
+    start = clock();
+    RSS(ref_sort_radix_glob(n, globs, order), "radix");
+    seconds = ref_sort_test_seconds(start);
+    printf("radix glob %8.2f\n", 1.0e-6 * (REF_DBL)n / seconds);
+    start = clock();
+    RSS(ref_sort_heap_dbl(n, dbls, order), "heap");
+    seconds = ref_sort_test_seconds(start);
+    printf("heap  dbl  %8.2f\n", 1.0e-6 * (REF_DBL)n / seconds);
+    start = clock();
+    RSS(ref_sort_radix_dbl(n, dbls, order), "radix");
+    seconds = ref_sort_test_seconds(start);
+    printf("radix dbl  %8.2f\n", 1.0e-6 * (REF_DBL)n / seconds);
+    ref_free(order);
+    ref_free(dbls);
+    ref_free(globs);
+    ref_free(ints);
+    return 0;
+  }
 
-int main(void) {
   { /* insert sort ordered */
     REF_INT n = 4, original[4], sorted[4];
     original[0] = 1;
@@ -76,6 +137,19 @@ int main(void) {
     REIS(3, unique[2], "unique[2]");
   }
 
+  { /* unique of more than radix min */
+    REF_INT n = 3 * REF_SORT_RADIX_MIN, i, m;
+    REF_INT *original, *unique;
+    ref_malloc(original, n, REF_INT);
+    ref_malloc(unique, n, REF_INT);
+    for (i = 0; i < n; i++) original[i] = (7 * i) % REF_SORT_RADIX_MIN - 5;
+    RSS(ref_sort_unique_int(n, original, &m, unique), "unique");
+    REIS(REF_SORT_RADIX_MIN, m, "m");
+    for (i = 0; i < m; i++) REIS(i - 5, unique[i], "ascending");
+    ref_free(unique);
+    ref_free(original);
+  }
+
   { /* sparse global to local */
     REF_INT n = 7, i;
     REF_GLOB global[7], sorted_global[7];
@@ -245,5 +319,98 @@ int main(void) {
     REIS(1, sorted_index[3], "sorted_index[3]");
   }
 
+  { /* radix int small with negative */
+    REF_INT n = 5, original[5], sorted_index[5];
+    original[0] = 3;
+    original[1] = -7;
+    original[2] = 0;
+    original[3] = REF_INT_MAX;
+    original[4] = REF_INT_MIN;
+    RSS(ref_sort_radix_int(n, original, sorted_index), "sort");
+    REIS(4, sorted_index[0], "sorted_index[0]");
+    REIS(1, sorted_index[1], "sorted_index[1]");
+    REIS(2, sorted_index[2], "sorted_index[2]");
+    REIS(0, sorted_index[3], "sorted_index[3]");
+    REIS(3, sorted_index[4], "sorted_index[4]");
+  }
+
+  { /* radix int large, stable */
+    REF_INT i, n = 1000, *original, *sorted_index;
+    ref_malloc(original, n, REF_INT);
+    ref_malloc(sorted_index, n, REF_INT);
+    for (i = 0; i < n; i++) original[i] = (rand() % 201) - 100;
+    RSS(ref_sort_radix_int(n, original, sorted_index), "sort");
+    for (i = 1; i < n; i++) {
+      RAS(original[sorted_index[i - 1]] <= original[sorted_index[i]],
+          "not ascending");
+      if (original[sorted_index[i - 1]] == original[sorted_index[i]])
+        RAS(sorted_index[i - 1] < sorted_index[i], "not stable");
+    }
+    ref_free(sorted_index);
+    ref_free(original);
+  }
+
+  { /* radix glob large, stable */
+    REF_INT i, n = 1000, *sorted_index;
+    REF_GLOB *original;
+    ref_malloc(original, n, REF_GLOB);
+    ref_malloc(sorted_index, n, REF_INT);
+    for (i = 0; i < n; i++)
+      original[i] = (REF_GLOB)rand() - (REF_GLOB)(RAND_MAX / 2);
+    original[17] = original[500];
+    RSS(ref_sort_radix_glob(n, original, sorted_index), "sort");
+    for (i = 1; i < n; i++) {
+      RAS(original[sorted_index[i - 1]] <= original[sorted_index[i]],
+          "not ascending");
+      if (original[sorted_index[i - 1]] == original[sorted_index[i]])
+        RAS(sorted_index[i - 1] < sorted_index[i], "not stable");
+    }
+    ref_free(sorted_index);
+    ref_free(original);
+  }
+
+  { /* radix dbl small */
+    REF_INT n = 4;
+    REF_DBL original[4];
+    REF_INT sorted_index[4];
+    original[0] = 0.0;
+    original[1] = 7.0;
+    original[2] = 3.0;
+    original[3] = -1.0;
+    RSS(ref_sort_radix_dbl(n, original, sorted_index), "sort");
+    REIS(3, sorted_index[0], "sorted_index[0]");
+    REIS(0, sorted_index[1], "sorted_index[1]");
+    REIS(2, sorted_index[2], "sorted_index[2]");
+    REIS(1, sorted_index[3], "sorted_index[3]");
+  }
+
+  { /* radix dbl large, matches heap */
+    REF_INT i, n = 1000, *sorted_index, *heap_index;
+    REF_DBL *original;
+    ref_malloc(original, n, REF_DBL);
+    ref_malloc(sorted_index, n, REF_INT);
+    ref_malloc(heap_index, n, REF_INT);
+    for (i = 0; i < n; i++)
+      original[i] = ((REF_DBL)rand() / (REF_DBL)RAND_MAX - 0.5) * 1.0e3;
+    original[3] = -0.0;
+    original[4] = 0.0;
+    original[5] = 1.0e-300;
+    original[6] = -1.0e300;
+    RSS(ref_sort_radix_dbl(n, original, sorted_index), "sort");
+    RSS(ref_sort_heap_dbl(n, original, heap_index), "sort");
+    for (i = 1; i < n; i++) {
+      RAS(original[sorted_index[i - 1]] <= original[sorted_index[i]],
+          "not ascending");
+    }
+    for (i = 0; i < n; i++) {
+      RWDS(original[heap_index[i]], original[sorted_index[i]], -1.0,
+           "heap mismatch");
+    }
+    REIS(6, sorted_index[0], "most negative");
+    ref_free(heap_index);
+    ref_free(sorted_index);
+    ref_free(original);
+  }
+
   return 0;
 }
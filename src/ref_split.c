@@ -33,14 +33,17 @@
 #include "ref_matrix.h"
 #include "ref_metric.h"
 #include "ref_mpi.h"
+#include "ref_perf.h"
 #include "ref_smooth.h"
 #include "ref_sort.h"
 #include "ref_subdiv.h"
 
 #define MAX_CELL_SPLIT (100)
 
-REF_STATUS ref_split_pass(REF_GRID ref_grid) {
+static REF_STATUS ref_split_pass_frames(REF_GRID ref_grid) {
   REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
+  REF_ARENA ref_arena = ref_grid_arena(ref_grid);
+  REF_PERF ref_perf = ref_grid_perf(ref_grid);
   REF_NODE ref_node = ref_grid_node(ref_grid);
   REF_CELL ref_cell = ref_grid_tet(ref_grid);
   REF_EDGE ref_edge;
@@ -68,6 +71,8 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
   if (ref_grid_twod(ref_grid) || ref_grid_surf(ref_grid))
     ref_cell = ref_grid_tri(ref_grid);
 
+  RSS(ref_perf_start(ref_grid, REF_PERF_SPLIT), "perf");
+
   span_parts = ref_mpi_para(ref_grid_mpi(ref_grid)) &&
                !ref_grid_twod(ref_grid) && !ref_grid_surf(ref_grid);
 
@@ -78,22 +83,33 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
 
   RSS(ref_edge_create(&ref_edge, ref_grid), "orig edges");
 
-  ref_malloc(ratio, ref_edge_n(ref_edge), REF_DBL);
-  ref_malloc(order, ref_edge_n(ref_edge), REF_INT);
-  ref_malloc(edges, ref_edge_n(ref_edge), REF_INT);
+  ref_arena_malloc(ref_arena, ratio, ref_edge_n(ref_edge), REF_DBL);
+  ref_arena_malloc(ref_arena, order, ref_edge_n(ref_edge), REF_INT);
+  ref_arena_malloc(ref_arena, edges, ref_edge_n(ref_edge), REF_INT);
 
-  n = 0;
+  status = REF_SUCCESS;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(ref_mpi_nthread(ref_mpi)) \
+    schedule(static) private(node0, node1) reduction(max : status)
+#endif
   for (edge = 0; edge < ref_edge_n(ref_edge); edge++) {
     node0 = ref_edge_e2n(ref_edge, 0, edge);
     node1 = ref_edge_e2n(ref_edge, 1, edge);
-    RSS(ref_node_ratio(ref_node, node0, node1, &(ratio[n])), "ratio");
-    if (ratio[n] > ref_grid_adapt(ref_grid, split_ratio)) {
+    if (REF_SUCCESS != ref_node_ratio(ref_node, node0, node1, &(ratio[edge])))
+      status = REF_FAILURE;
+  }
+  RSS(status, "ratio");
+
+  n = 0;
+  for (edge = 0; edge < ref_edge_n(ref_edge); edge++) {
+    if (ratio[edge] > ref_grid_adapt(ref_grid, split_ratio)) {
+      ratio[n] = ratio[edge];
       edges[n] = edge;
       n++;
     }
   }
 
-  RSS(ref_sort_heap_dbl(n, ratio, order), "sort lengths");
+  RSS(ref_sort_radix_dbl(n, ratio, order), "sort lengths");
 
   for (i = n - 1; i >= 0; i--) {
     edge = edges[order[i]];
@@ -106,16 +122,23 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
     RSS(ref_cell_has_side(ref_cell, node0, node1, &allowed), "has side");
     if (transcript && !allowed) printf("not a side anymore\n");
     if (!allowed) continue;
+    ref_perf_attempt(ref_perf);
+    RSS(ref_perf_lap(ref_grid, REF_PERF_LAST_REASON), "lap");
 
     /* skip if neither node is owned */
     if (!ref_node_owned(ref_node, node0) && !ref_node_owned(ref_node, node1)) {
       if (transcript) printf("neither node is local\n");
+      ref_perf_reject(ref_perf, REF_PERF_GHOST);
       continue;
     }
 
     RSS(ref_split_edge_mixed(ref_grid, node0, node1, &allowed), "mixed");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_MIXED), "lap");
     if (transcript && !allowed) printf("mixed edge\n");
-    if (!allowed) continue;
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_MIXED);
+      continue;
+    }
 
     weight_node1 = 0.5;
     if (ref_grid_twod(ref_grid) || ref_grid_surf(ref_grid)) {
@@ -149,8 +172,11 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
     RSS(ref_geom_constrain(ref_grid, new_node), "geom constraint");
     RSS(ref_metric_interpolate_between(ref_grid, node0, node1, new_node),
         "interp new node metric");
+    /* building the new node is not a predicate */
+    RSS(ref_perf_lap(ref_grid, REF_PERF_LAST_REASON), "lap");
     RSS(ref_geom_supported(ref_grid_geom(ref_grid), new_node, &geom_support),
         "geom support");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_GEOMETRY), "lap");
     if (transcript && geom_support) printf("geom support\n");
 
     if (transcript) {
@@ -192,14 +218,17 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
                                    &allowed_tri_quality),
         "quality of new tri");
     if (transcript && !allowed_tri_quality) printf("tri quality poor\n");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_QUALITY), "lap");
 
     RSS(ref_split_edge_ratio(ref_grid, node0, node1, new_node, &allowed_ratio),
         "edge tet ratio");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_RATIO), "lap");
     if (transcript && !allowed_ratio) printf("ratio poor\n");
 
     RSS(ref_split_edge_tri_conformity(ref_grid, node0, node1, new_node,
                                       &allowed_tri_conformity),
         "edge tri qual");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_CONFORMITY), "lap");
     if (transcript && !allowed_tri_conformity) printf("tri conformity poor\n");
 
     RSS(ref_cell_has_side(ref_grid_edg(ref_grid), node0, node1, &has_edge),
@@ -214,6 +243,13 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
       } else {
         RSS(ref_node_remove(ref_node, new_node), "remove new node");
         RSS(ref_geom_remove_all(ref_grid_geom(ref_grid), new_node), "rm");
+        if (!allowed_ratio) {
+          ref_perf_reject(ref_perf, REF_PERF_RATIO);
+        } else if (!allowed_tri_conformity) {
+          ref_perf_reject(ref_perf, REF_PERF_CONFORMITY);
+        } else {
+          ref_perf_reject(ref_perf, REF_PERF_QUALITY);
+        }
         continue;
       }
     }
@@ -242,6 +278,7 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
         RSS(ref_geom_tattle(ref_grid_geom(ref_grid), node1), "t1");
         REF_WHERE("enlarge"); /* note but skip cavity failures */
       }
+      RSS(ref_perf_lap(ref_grid, REF_PERF_CAVITY), "lap");
       if (REF_CAVITY_VISIBLE == ref_cavity_state(ref_cavity)) {
         if (transcript) printf("cavity visible\n");
         RSS(ref_cavity_ratio(ref_cavity, &allowed_cavity_ratio),
@@ -265,14 +302,25 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
           ref_node_age(ref_node, node1) = 0;
           RSS(ref_smooth_post_edge_split(ref_grid, new_node),
               "smooth after split");
+          ref_perf_success(ref_perf);
           continue;
         }
+        if (!allowed_cavity_ratio && !has_edge) {
+          ref_perf_reject(ref_perf, REF_PERF_RATIO);
+        } else {
+          ref_perf_reject(ref_perf, REF_PERF_QUALITY);
+        }
       } else {
         if (transcript) {
           REF_BOOL normdev_improved;
           RSS(ref_cavity_normdev(ref_cavity, &normdev_improved), "nd");
           printf("cavity not visible %d\n", (int)ref_cavity_state(ref_cavity));
         }
+        if (REF_CAVITY_PARTITION_CONSTRAINED == ref_cavity_state(ref_cavity)) {
+          ref_perf_reject(ref_perf, REF_PERF_GHOST);
+        } else {
+          ref_perf_reject(ref_perf, REF_PERF_CAVITY);
+        }
       }
       if (REF_CAVITY_PARTITION_CONSTRAINED == ref_cavity_state(ref_cavity)) {
         if (span_parts) RSS(ref_list_push(para_cavity, edge), "push");
@@ -286,6 +334,7 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
 
     RSS(ref_cell_local_gem(ref_cell, ref_node, node0, node1, &allowed_local),
         "local tet");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_GHOST), "lap");
     if (!allowed_local) {
       if (span_parts) {
         RSS(ref_list_push(para_no_geom, edge), "push");
@@ -295,6 +344,7 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
       }
       RSS(ref_node_remove(ref_node, new_node), "remove new node");
       RSS(ref_geom_remove_all(ref_grid_geom(ref_grid), new_node), "rm");
+      ref_perf_reject(ref_perf, REF_PERF_GHOST);
       continue;
     }
 
@@ -303,6 +353,7 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
     if (REF_INCREASE_LIMIT == status) {
       RSS(ref_node_remove(ref_node, new_node), "remove new node");
       RSS(ref_geom_remove_all(ref_grid_geom(ref_grid), new_node), "rm");
+      ref_perf_reject(ref_perf, REF_PERF_DEGREE);
       continue;
     }
     RSS(status, "tet edge split");
@@ -311,11 +362,12 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
     ref_node_age(ref_node, node1) = 0;
 
     RSS(ref_smooth_post_edge_split(ref_grid, new_node), "smooth after split");
+    ref_perf_success(ref_perf);
   }
 
-  ref_free(edges);
-  ref_free(order);
-  ref_free(ratio);
+  ref_arena_release(ref_arena, edges);
+  ref_arena_release(ref_arena, order);
+  ref_arena_release(ref_arena, ratio);
 
   if (span_parts) {
     if (ref_grid_adapt(ref_grid, instrument))
@@ -352,6 +404,17 @@ REF_STATUS ref_split_pass(REF_GRID ref_grid) {
 
   ref_edge_free(ref_edge);
 
+  RSS(ref_perf_stop(ref_grid), "perf");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_split_pass(REF_GRID ref_grid) {
+  REF_ARENA ref_arena = ref_grid_arena(ref_grid);
+  REF_INT mark;
+  RSS(ref_arena_mark(ref_arena, &mark), "mark");
+  RSB(ref_split_pass_frames(ref_grid), "split pass",
+      { ref_arena_unwind(ref_arena, mark); });
   return REF_SUCCESS;
 }
 
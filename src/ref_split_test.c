@@ -236,6 +236,23 @@ int main(int argc, char *argv[]) {
     RSS(ref_grid_free(ref_grid), "free grid");
   }
 
+  { /* top small, threaded */
+    REF_GRID ref_grid;
+
+    RSS(ref_mpi_threads(ref_mpi, 2), "two threads");
+    RSS(ref_fixture_tet_grid(&ref_grid, ref_mpi), "set up");
+    RSS(ref_node_metric_form(ref_grid_node(ref_grid), 3, 1, 0, 0, 1, 0,
+                             1.0 / (0.25 * 0.25)),
+        "set top small");
+    RSS(ref_split_pass(ref_grid), "pass");
+
+    REIS(7, ref_node_n(ref_grid_node(ref_grid)), "nodes");
+    REIS(4, ref_cell_n(ref_grid_tet(ref_grid)), "tets");
+
+    RSS(ref_grid_free(ref_grid), "free grid");
+    RSS(ref_mpi_threads(ref_mpi, 1), "one thread");
+  }
+
   { /* split twod tri in two */
     REF_GRID ref_grid;
     REF_INT node0, node1, new_node;
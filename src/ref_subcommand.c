@@ -38,7 +38,9 @@
 #include "ref_metric.h"
 #include "ref_mpi.h"
 #include "ref_part.h"
+#include "ref_perf.h"
 #include "ref_split.h"
+#include "ref_surrogate.h"
 #include "ref_validation.h"
 
 #ifdef HAVE_CONFIG_H
@@ -47,6 +49,7 @@
 #define VERSION "not available"
 #endif
 
+
 static void usage(const char *name) {
   printf("usage: \n %s [--help] <subcommand> [<args>]\n", name);
   printf("\n");
@@ -60,6 +63,11 @@ static void usage(const char *name) {
   printf("  translate    Convert mesh formats.\n");
   printf("\n");
   printf("'ref <command> -h' provides details on a specific subcommand.\n");
+  printf("\n");
+  printf("options for all subcommands:\n");
+  printf("  --threads <n> threads per MPI rank (requires OpenMP build).\n");
+  printf("  --trace <trace.json> timeline of every rank for\n");
+  printf("        chrome://tracing or ui.perfetto.dev\n");
 }
 static void adapt_help(const char *name) {
   printf("usage: \n %s adapt input_mesh.extension [<options>]\n", name);
@@ -73,6 +81,7 @@ static void adapt_help(const char *name) {
   printf("      3: Zoltan graph partioning.\n");
   printf("      4: Zoltan recursive bisection.\n");
   printf("      5: native recursive bisection.\n");
+  printf("  --perf-report report.json per pass operator performance.\n");
   printf("\n");
 }
 static void bootstrap_help(const char *name) {
@@ -99,6 +108,8 @@ static void interpolate_help(const char *name) {
   printf("   --face <face id> <persist>.solb\n");
   printf("       where persist.solb is copied to receptor.solb\n");
   printf("       and face id is replaced with donor.solb.\n");
+  printf("   --ordered walks receptors in Morton order from the\n");
+  printf("       previous donor cell before agents and tree search.\n");
   printf("\n");
 }
 
@@ -124,6 +135,9 @@ static void loop_help(const char *name) {
       " [rho,u,v,w,p] or [rho,u,v,w,p,turb1]\n");
   printf("    in FUN3D nondimensionalization.\n");
   printf("   complexity is half of the target number of vertices.\n");
+  printf("    a ladder c1,c2,c3 adapts one mesh per complexity to\n");
+  printf("    <output_project_name>-1, <output_project_name>-2, ...\n");
+  printf("    from one solution load and Hessian reconstruction.\n");
   printf("\n");
   printf("  creates:\n");
   printf(
@@ -148,6 +162,7 @@ static void loop_help(const char *name) {
   printf("       4: Zoltan recursive bisection.\n");
   printf("       5: native recursive bisection.\n");
   printf("   --mesh-extension output mesh extension (replaces lb8.ugrid).\n");
+  printf("   --perf-report report.json per pass operator performance.\n");
 
   printf("\n");
 }
@@ -157,6 +172,8 @@ static void multiscale_help(const char *name) {
       "complexity metric.solb\n",
       name);
   printf("   complexity is approximately half the target number of vertices\n");
+  printf("   a ladder c1,c2,c3 writes metric-1.solb, metric-2.solb, ...\n");
+  printf("    from one Hessian reconstruction.\n");
   printf("\n");
   printf("  options:\n");
   printf("   --norm-power <power> multiscale metric norm power (default 2)\n");
@@ -182,11 +199,30 @@ static void translate_help(const char *name) {
   printf("\n");
 }
 
+static REF_STATUS ref_subcommand_surrogate(REF_GRID ref_grid) {
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
+  REF_LONG ngeom;
+  ngeom = (REF_LONG)ref_geom_n(ref_grid_geom(ref_grid));
+  RSS(ref_mpi_allsum(ref_mpi, &ngeom, 1, REF_LONG_TYPE), "sum geom");
+  if (0 == ngeom) {
+    if (ref_mpi_once(ref_mpi))
+      printf("warning: no geometry loaded, assuming planar faces.\n");
+    return REF_SUCCESS;
+  }
+  if (ref_mpi_once(ref_mpi))
+    printf("no geometry loaded, surrogate of associated surface\n");
+  RSS(ref_surrogate_open(ref_grid), "surrogate");
+  ref_mpi_stopwatch_stop(ref_mpi, "surrogate");
+  return REF_SUCCESS;
+}
+
 static REF_STATUS adapt(REF_MPI ref_mpi, int argc, char *argv[]) {
   char *in_mesh = NULL;
   char *in_metric = NULL;
   char *in_egads = NULL;
+  char *perf_report = NULL;
   REF_GRID ref_grid = NULL;
+  REF_PERF ref_perf = NULL;
   REF_BOOL curvature_metric = REF_TRUE;
   REF_BOOL all_done = REF_FALSE;
   REF_BOOL all_done0 = REF_FALSE;
@@ -228,8 +264,7 @@ static REF_STATUS adapt(REF_MPI ref_mpi, int argc, char *argv[]) {
         RSS(ref_egads_load(ref_grid_geom(ref_grid), NULL), "load egads");
         ref_mpi_stopwatch_stop(ref_mpi, "load egads");
       } else {
-        if (ref_mpi_once(ref_mpi))
-          printf("warning: no geometry loaded, assuming planar faces.\n");
+        RSS(ref_subcommand_surrogate(ref_grid), "surrogate");
       }
     }
   }
@@ -274,6 +309,14 @@ static REF_STATUS adapt(REF_MPI ref_mpi, int argc, char *argv[]) {
     if (ref_mpi_once(ref_mpi)) printf("--topo checks active\n");
   }
 
+  RXS(ref_args_char(argc, argv, "--perf-report", &perf_report), REF_NOT_FOUND,
+      "arg search");
+  if (NULL != perf_report) {
+    if (ref_mpi_once(ref_mpi)) printf("--perf-report %s\n", perf_report);
+    RSS(ref_perf_create(&ref_perf), "create perf");
+    ref_grid_perf(ref_grid) = ref_perf;
+  }
+
   RXS(ref_args_char(argc, argv, "-m", &in_metric), REF_NOT_FOUND,
       "metric arg search");
   if (NULL != in_metric) {
@@ -308,7 +351,8 @@ static REF_STATUS adapt(REF_MPI ref_mpi, int argc, char *argv[]) {
     ref_mpi_stopwatch_stop(ref_mpi, "curvature metric");
   } else {
     if (ref_geom_model_loaded(ref_grid_geom(ref_grid)) ||
-        ref_geom_meshlinked(ref_grid_geom(ref_grid))) {
+        ref_geom_meshlinked(ref_grid_geom(ref_grid)) ||
+        ref_geom_surrogated(ref_grid_geom(ref_grid))) {
       RSS(ref_metric_constrain_curvature(ref_grid), "crv const");
       RSS(ref_validation_cell_volume(ref_grid), "vol");
       ref_mpi_stopwatch_stop(ref_mpi, "crv const");
@@ -358,6 +402,14 @@ static REF_STATUS adapt(REF_MPI ref_mpi, int argc, char *argv[]) {
 
   RSS(ref_geom_verify_param(ref_grid), "final params");
   ref_mpi_stopwatch_stop(ref_mpi, "verify final params");
+  RSS(ref_geom_inverse_eval_tattle(ref_grid), "inverse eval stats");
+
+  if (NULL != ref_perf) {
+    RSS(ref_perf_report(ref_perf, ref_mpi, perf_report), "perf report");
+    RSS(ref_perf_free(ref_perf), "free perf");
+    ref_grid_perf(ref_grid) = NULL;
+    ref_mpi_stopwatch_stop(ref_mpi, "perf report");
+  }
 
   /* export via -x grid.ext and -f final-surf.tec*/
   for (opt = 0; opt < argc - 1; opt++) {
@@ -402,6 +454,7 @@ static REF_STATUS bootstrap(REF_MPI ref_mpi, int argc, char *argv[]) {
   const char *mesher = "tetgen";
   REF_INT passes = 15;
   REF_INT self_intersections;
+  REF_STATUS mesher_status;
   REF_INT global_pos = REF_EMPTY;
   REF_DBL *global_params = NULL;
 
@@ -537,27 +590,39 @@ static REF_STATUS bootstrap(REF_MPI ref_mpi, int argc, char *argv[]) {
 
   if (ref_geom_manifold(ref_grid_geom(ref_grid))) {
     if (strncmp(mesher, "t", 1) == 0) {
+      mesher_status = REF_SUCCESS;
       if (ref_mpi_once(ref_mpi)) {
         printf("fill volume with TetGen\n");
-        RSB(ref_geom_tetgen_volume(ref_grid), "tetgen surface to volume", {
+        mesher_status = ref_geom_tetgen_volume(ref_grid);
+      }
+      RSS(ref_mpi_bcast(ref_mpi, &mesher_status, 1, REF_INT_TYPE), "bcast");
+      if (REF_SUCCESS != mesher_status) {
+        if (ref_mpi_once(ref_mpi))
           printf("probing adapted tessellation self-intersections\n");
-          RSS(ref_dist_collisions(ref_grid, REF_TRUE, &self_intersections),
-              "bumps");
+        RSS(ref_dist_collisions(ref_grid, REF_TRUE, &self_intersections),
+            "bumps");
+        if (ref_mpi_once(ref_mpi))
           printf("%d segment-triangle intersections detected.\n",
                  self_intersections);
-        });
+        RSS(mesher_status, "tetgen surface to volume");
       }
       ref_mpi_stopwatch_stop(ref_mpi, "tetgen volume");
     } else if (strncmp(mesher, "a", 1) == 0) {
+      mesher_status = REF_SUCCESS;
       if (ref_mpi_once(ref_mpi)) {
         printf("fill volume with AFLR3\n");
-        RSB(ref_geom_aflr_volume(ref_grid), "aflr surface to volume", {
+        mesher_status = ref_geom_aflr_volume(ref_grid);
+      }
+      RSS(ref_mpi_bcast(ref_mpi, &mesher_status, 1, REF_INT_TYPE), "bcast");
+      if (REF_SUCCESS != mesher_status) {
+        if (ref_mpi_once(ref_mpi))
           printf("probing adapted tessellation self-intersections\n");
-          RSS(ref_dist_collisions(ref_grid, REF_TRUE, &self_intersections),
-              "bumps");
+        RSS(ref_dist_collisions(ref_grid, REF_TRUE, &self_intersections),
+            "bumps");
+        if (ref_mpi_once(ref_mpi))
           printf("%d segment-triangle intersections detected.\n",
                  self_intersections);
-        });
+        RSS(mesher_status, "aflr surface to volume");
       }
       ref_mpi_stopwatch_stop(ref_mpi, "aflr volume");
     } else {
@@ -654,6 +719,7 @@ static REF_STATUS interpolate(REF_MPI ref_mpi, int argc, char *argv[]) {
   REF_INT ldim;
   REF_DBL *donor_solution, *receipt_solution;
   REF_INTERP ref_interp;
+  REF_INTERP_PLAN ref_interp_plan;
   REF_INT pos;
   REF_INT faceid;
 
@@ -720,13 +786,25 @@ static REF_STATUS interpolate(REF_MPI ref_mpi, int argc, char *argv[]) {
     if (ref_mpi_once(ref_mpi)) printf("locate receptor nodes\n");
     RSS(ref_interp_create(&ref_interp, donor_grid, receipt_grid),
         "make interp");
+    RXS(ref_args_find(argc, argv, "--ordered", &pos), REF_NOT_FOUND,
+        "arg search");
+    if (REF_EMPTY != pos) {
+      if (ref_mpi_once(ref_mpi)) printf("--ordered receptor walks\n");
+      ref_interp_ordered(ref_interp) = REF_TRUE;
+    }
     RSS(ref_interp_locate(ref_interp), "map");
     ref_mpi_stopwatch_stop(ref_mpi, "locate");
+    if (ref_interp_ordered(ref_interp))
+      RSS(ref_interp_stats(ref_interp), "stats");
+    RSS(ref_interp_plan_create(&ref_interp_plan, ref_interp), "plan");
+    ref_mpi_stopwatch_stop(ref_mpi, "interp plan");
     if (ref_mpi_once(ref_mpi)) printf("interpolate receptor nodes\n");
     ref_malloc(receipt_solution,
                ldim * ref_node_max(ref_grid_node(receipt_grid)), REF_DBL);
-    RSS(ref_interp_scalar(ref_interp, ldim, donor_solution, receipt_solution),
-        "interp scalar");
+    RSS(ref_interp_plan_apply(ref_interp_plan, ldim, donor_solution,
+                              receipt_solution),
+        "interp field");
+    RSS(ref_interp_plan_free(ref_interp_plan), "free plan");
     ref_mpi_stopwatch_stop(ref_mpi, "interp");
   }
 
@@ -800,21 +878,278 @@ shutdown:
   return REF_FAILURE;
 }
 
-static REF_STATUS loop(REF_MPI ref_mpi, int argc, char *argv[]) {
-  char *in_project = NULL;
-  char *out_project = NULL;
+static REF_STATUS loop_geometry(REF_MPI ref_mpi, REF_GRID ref_grid, int argc,
+                                char *argv[]) {
+  REF_INT pos;
+
+  RXS(ref_args_find(argc, argv, "--meshlink", &pos), REF_NOT_FOUND,
+      "arg search");
+  if (REF_EMPTY != pos && pos < argc - 1) {
+    if (ref_mpi_once(ref_mpi)) printf("meshlink with %s\n", argv[pos + 1]);
+    RSS(ref_meshlink_open(ref_grid, argv[pos + 1]), "meshlink init");
+    RSS(ref_meshlink_infer_orientation(ref_grid), "meshlink orient");
+  } else {
+    RXS(ref_args_find(argc, argv, "--egads", &pos), REF_NOT_FOUND,
+        "arg search");
+    if (REF_EMPTY != pos && pos < argc - 1) {
+      if (ref_mpi_once(ref_mpi)) printf("load egads from %s\n", argv[pos + 1]);
+      RSS(ref_egads_load(ref_grid_geom(ref_grid), argv[pos + 1]), "load egads");
+      ref_mpi_stopwatch_stop(ref_mpi, "load egads");
+    } else {
+      if (0 < ref_geom_cad_data_size(ref_grid_geom(ref_grid))) {
+        if (ref_mpi_once(ref_mpi))
+          printf("load egadslite from .meshb byte stream\n");
+        RSS(ref_egads_load(ref_grid_geom(ref_grid), NULL), "load egads");
+        ref_mpi_stopwatch_stop(ref_mpi, "load egadslite cad data");
+      } else {
+        RSS(ref_subcommand_surrogate(ref_grid), "surrogate");
+      }
+    }
+  }
+
+  return REF_SUCCESS;
+}
+
+/* adapt ref_grid to the metric already set on its nodes and write the
+ * <out_project> family of files, -x and -f exports get the rung of nrung,
+ * frees ref_grid and initial_field */
+static REF_STATUS loop_adapt(REF_MPI ref_mpi, REF_GRID ref_grid, REF_INT ldim,
+                             REF_DBL *initial_field, const char *out_project,
+                             const char *mesh_extension, REF_INT passes,
+                             REF_INT rung, REF_INT nrung, int argc,
+                             char *argv[]) {
   char filename[1024];
-  REF_GRID ref_grid = NULL;
   REF_GRID extruded_grid = NULL;
   REF_BOOL all_done = REF_FALSE;
   REF_BOOL all_done0 = REF_FALSE;
   REF_BOOL all_done1 = REF_FALSE;
-  REF_INT pass, passes = 30;
+  REF_INT pass, pos;
+  REF_DBL *ref_field, *extruded_field = NULL;
+  REF_INTERP_PLAN ref_interp_plan;
+
+  ref_grid_surf(ref_grid) = ref_grid_twod(ref_grid);
+  if (ref_geom_model_loaded(ref_grid_geom(ref_grid))) {
+    RSS(ref_egads_mark_jump_degen(ref_grid), "T and UV jumps; UV degen");
+  }
+  if (ref_geom_model_loaded(ref_grid_geom(ref_grid)) ||
+      ref_geom_meshlinked(ref_grid_geom(ref_grid))) {
+    RSS(ref_geom_verify_topo(ref_grid), "geom topo");
+    RSS(ref_geom_verify_param(ref_grid), "geom param");
+    ref_mpi_stopwatch_stop(ref_mpi, "geom assoc");
+    RSS(ref_metric_constrain_curvature(ref_grid), "crv const");
+    RSS(ref_validation_cell_volume(ref_grid), "vol");
+    ref_mpi_stopwatch_stop(ref_mpi, "crv const");
+  }
+  if (ref_geom_surrogated(ref_grid_geom(ref_grid))) {
+    RSS(ref_metric_constrain_curvature(ref_grid), "crv const");
+    ref_mpi_stopwatch_stop(ref_mpi, "crv const");
+  }
+  RSS(ref_grid_cache_background(ref_grid), "cache");
+  RSS(ref_node_store_aux(ref_grid_node(ref_grid_background(ref_grid)), ldim,
+                         initial_field),
+      "store init field with background");
+  ref_free(initial_field);
+  ref_mpi_stopwatch_stop(ref_mpi, "cache background metric and field");
+
+  RSS(ref_histogram_quality(ref_grid), "gram");
+  RSS(ref_histogram_ratio(ref_grid), "gram");
+  ref_mpi_stopwatch_stop(ref_mpi, "histogram");
+
+  RSS(ref_migrate_to_balance(ref_grid), "balance");
+  RSS(ref_grid_pack(ref_grid), "pack");
+  ref_mpi_stopwatch_stop(ref_mpi, "pack");
+
+  for (pass = 0; !all_done && pass < passes; pass++) {
+    if (ref_mpi_once(ref_mpi))
+      printf("\n pass %d of %d with %d ranks\n", pass + 1, passes,
+             ref_mpi_n(ref_mpi));
+    all_done1 = all_done0;
+    RSS(ref_adapt_pass(ref_grid, &all_done0), "pass");
+    all_done = all_done0 && all_done1 && (pass > MIN(5, passes));
+    ref_mpi_stopwatch_stop(ref_mpi, "pass");
+    RSS(ref_metric_synchronize(ref_grid), "sync with background");
+    ref_mpi_stopwatch_stop(ref_mpi, "metric sync");
+    RSS(ref_validation_cell_volume(ref_grid), "vol");
+    RSS(ref_histogram_quality(ref_grid), "gram");
+    RSS(ref_histogram_ratio(ref_grid), "gram");
+    ref_mpi_stopwatch_stop(ref_mpi, "histogram");
+    RSS(ref_adapt_tattle_faces(ref_grid), "tattle");
+    ref_mpi_stopwatch_stop(ref_grid_mpi(ref_grid), "tattle faces");
+    RSS(ref_migrate_to_balance(ref_grid), "balance");
+    RSS(ref_grid_pack(ref_grid), "pack");
+    ref_mpi_stopwatch_stop(ref_mpi, "pack");
+  }
+
+  RSS(ref_node_implicit_global_from_local(ref_grid_node(ref_grid)),
+      "implicit global");
+  ref_mpi_stopwatch_stop(ref_mpi, "implicit global");
+
+  RSS(ref_geom_verify_param(ref_grid), "final params");
+  ref_mpi_stopwatch_stop(ref_mpi, "verify final params");
+  RSS(ref_geom_inverse_eval_tattle(ref_grid), "inverse eval stats");
+
+  RAS(snprintf(filename, sizeof(filename), "%s.meshb", out_project) <
+          (int)sizeof(filename),
+      "filename too long");
+  if (ref_mpi_once(ref_mpi))
+    printf("gather " REF_GLOB_FMT " nodes to %s\n",
+           ref_node_n_global(ref_grid_node(ref_grid)), filename);
+  RSS(ref_gather_by_extension(ref_grid, filename), "gather .meshb");
+  ref_mpi_stopwatch_stop(ref_mpi, "gather meshb");
+
+  RAS(snprintf(filename, sizeof(filename), "%s.%s", out_project,
+               mesh_extension) < (int)sizeof(filename),
+      "filename too long");
+  if (ref_grid_twod(ref_grid)) {
+    if (ref_mpi_once(ref_mpi)) printf("extrude twod\n");
+    RSS(ref_grid_extrude_twod(&extruded_grid, ref_grid), "extrude");
+    if (ref_mpi_once(ref_mpi))
+      printf("gather extruded " REF_GLOB_FMT " nodes to %s\n",
+             ref_node_n_global(ref_grid_node(extruded_grid)), filename);
+    if (ref_mpi_once(ref_mpi)) printf("gather extruded %s\n", filename);
+    RSS(ref_gather_by_extension(extruded_grid, filename),
+        "gather mesh extension");
+  } else {
+    if (ref_mpi_once(ref_mpi))
+      printf("gather " REF_GLOB_FMT " nodes to %s\n",
+             ref_node_n_global(ref_grid_node(ref_grid)), filename);
+    RSS(ref_gather_by_extension(ref_grid, filename), "gather mesh extension");
+  }
+  ref_mpi_stopwatch_stop(ref_mpi, "gather mesh extension");
+
+  if (ref_mpi_once(ref_mpi)) {
+    printf("%d leading dim from " REF_GLOB_FMT " donor nodes to " REF_GLOB_FMT
+           " receptor nodes\n",
+           ldim,
+           ref_node_n_global(ref_grid_node(ref_grid_background(ref_grid))),
+           ref_node_n_global(ref_grid_node(ref_grid)));
+  }
+
+  if (ref_mpi_once(ref_mpi)) printf("interpolate receptor nodes\n");
+  RSS(ref_interp_plan_create(&ref_interp_plan, ref_grid_interp(ref_grid)),
+      "plan");
+  ref_malloc(ref_field, ldim * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+  RSS(ref_node_extract_aux(ref_grid_node(ref_grid_background(ref_grid)), &ldim,
+                           &initial_field),
+      "store init field with background");
+  RSS(ref_interp_plan_apply(ref_interp_plan, ldim, initial_field, ref_field),
+      "interp field");
+  RSS(ref_interp_plan_free(ref_interp_plan), "free plan");
+  ref_free(initial_field);
+  /* free interp and background grid */
+  RSS(ref_grid_free(ref_grid_background(ref_grid)),
+      "free cached background grid");
+  RSS(ref_interp_free(ref_grid_interp(ref_grid)), "interp free");
+  ref_grid_interp(ref_grid) = NULL;
+  ref_mpi_stopwatch_stop(ref_mpi, "interp");
+
+  if (ref_grid_twod(ref_grid)) {
+    if (ref_mpi_once(ref_mpi)) printf("extruding field of %d\n", ldim);
+    ref_malloc(extruded_field,
+               ldim * ref_node_max(ref_grid_node(extruded_grid)), REF_DBL);
+    RSS(ref_grid_extrude_field(ref_grid, ldim, ref_field, extruded_grid,
+                               extruded_field),
+        "extrude field");
+    RXS(ref_args_find(argc, argv, "--usm3d", &pos), REF_NOT_FOUND,
+        "arg search");
+    if (REF_EMPTY == pos) {
+      RAS(snprintf(filename, sizeof(filename), "%s-restart.solb",
+                   out_project) < (int)sizeof(filename),
+          "filename too long");
+      if (ref_mpi_once(ref_mpi))
+        printf("writing interpolated extruded field %s\n", filename);
+      RSS(ref_gather_scalar_by_extension(extruded_grid, ldim, extruded_field,
+                                         NULL, filename),
+          "gather recept");
+    } else {
+      RAS(snprintf(filename, sizeof(filename), "%s.solb", out_project) <
+              (int)sizeof(filename),
+          "filename too long");
+      if (ref_mpi_once(ref_mpi))
+        printf("writing interpolated field at prism cell centers %s\n",
+               filename);
+      RSS(ref_gather_scalar_cell_solb(extruded_grid, ldim, extruded_field,
+                                      filename),
+          "gather cell center");
+    }
+    ref_free(extruded_field);
+    ref_grid_free(extruded_grid);
+  } else {
+    RXS(ref_args_find(argc, argv, "--usm3d", &pos), REF_NOT_FOUND,
+        "arg search");
+    if (REF_EMPTY == pos) {
+      RAS(snprintf(filename, sizeof(filename), "%s-restart.solb",
+                   out_project) < (int)sizeof(filename),
+          "filename too long");
+      if (ref_mpi_once(ref_mpi))
+        printf("writing interpolated field %s\n", filename);
+      RSS(ref_gather_scalar_by_extension(ref_grid, ldim, ref_field, NULL,
+                                         filename),
+          "gather recept");
+    } else {
+      RAS(snprintf(filename, sizeof(filename), "%s.solb", out_project) <
+              (int)sizeof(filename),
+          "filename too long");
+      if (ref_mpi_once(ref_mpi))
+        printf("writing interpolated field at tet cell centers %s\n", filename);
+      RSS(ref_gather_scalar_cell_solb(ref_grid, ldim, ref_field, filename),
+          "gather cell center");
+    }
+  }
+  ref_mpi_stopwatch_stop(ref_mpi, "gather receptor");
+
+  ref_free(ref_field);
+
+  /* export via -x grid.ext and -f final-surf.tec*/
+  for (pos = 0; pos < argc - 1; pos++) {
+    if (strcmp(argv[pos], "-x") == 0) {
+      RSS(ref_args_rung_filename(filename, sizeof(filename), argv[pos + 1],
+                                 rung, nrung),
+          "rung filename");
+      if (ref_mpi_para(ref_mpi)) {
+        if (ref_mpi_once(ref_mpi))
+          printf("gather " REF_GLOB_FMT " nodes to %s\n",
+                 ref_node_n_global(ref_grid_node(ref_grid)), filename);
+        RSS(ref_gather_by_extension(ref_grid, filename), "gather -x");
+      } else {
+        if (ref_mpi_once(ref_mpi))
+          printf("export " REF_GLOB_FMT " nodes to %s\n",
+                 ref_node_n_global(ref_grid_node(ref_grid)), filename);
+        RSS(ref_export_by_extension(ref_grid, filename), "export -x");
+      }
+    }
+    if (strcmp(argv[pos], "-f") == 0) {
+      RSS(ref_args_rung_filename(filename, sizeof(filename), argv[pos + 1],
+                                 rung, nrung),
+          "rung filename");
+      if (ref_mpi_once(ref_mpi))
+        printf("gather final surface status %s\n", filename);
+      RSS(ref_gather_surf_status_tec(ref_grid, filename), "gather -f");
+    }
+  }
+
+  RSS(ref_grid_free(ref_grid), "free");
+
+  return REF_SUCCESS;
+}
+
+static REF_STATUS loop(REF_MPI ref_mpi, int argc, char *argv[]) {
+  char *in_project = NULL;
+  char *out_project = NULL;
+  char *perf_report = NULL;
+  char filename[1024];
+  char rung_project[1024];
+  REF_GRID ref_grid = NULL;
+  REF_GRID rung_grid = NULL;
+  REF_PERF ref_perf = NULL;
+  REF_INT passes = 30;
   REF_DBL gamma = 1.4;
-  REF_INT ldim, node;
-  REF_DBL *initial_field, *ref_field, *extruded_field = NULL, *scalar, *metric;
+  REF_INT ldim, node, i;
+  REF_DBL *initial_field, *rung_field, *scalar, *hess, *metric;
   REF_INT p = 2;
   REF_DBL gradation = -1.0, complexity;
+  REF_INT ncomplexity, rung;
+  REF_DBL complexities[REF_ARGS_MAX_LADDER];
   REF_RECON_RECONSTRUCTION reconstruction = REF_RECON_L2PROJECTION;
   REF_BOOL buffer = REF_FALSE;
   REF_INT pos;
@@ -827,7 +1162,8 @@ static REF_STATUS loop(REF_MPI ref_mpi, int argc, char *argv[]) {
   if (argc < 5) goto shutdown;
   in_project = argv[2];
   out_project = argv[3];
-  complexity = atof(argv[4]);
+  if (REF_SUCCESS != ref_args_ladder(argv[4], &ncomplexity, complexities))
+    goto shutdown;
 
   p = 2;
   RXS(ref_args_find(argc, argv, "--norm-power", &pos), REF_NOT_FOUND,
@@ -877,7 +1213,8 @@ static REF_STATUS loop(REF_MPI ref_mpi, int argc, char *argv[]) {
   }
 
   if (ref_mpi_once(ref_mpi)) {
-    printf("complexity %f\n", complexity);
+    for (rung = 0; rung < ncomplexity; rung++)
+      printf("complexity %f\n", complexities[rung]);
     printf("Lp=%d\n", p);
     printf("gradation %f\n", gradation);
     printf("reconstruction %d\n", (int)reconstruction);
@@ -912,32 +1249,15 @@ static REF_STATUS loop(REF_MPI ref_mpi, int argc, char *argv[]) {
     if (ref_mpi_once(ref_mpi)) printf("--topo checks active\n");
   }
 
-  RXS(ref_args_find(argc, argv, "--meshlink", &pos), REF_NOT_FOUND,
+  RXS(ref_args_char(argc, argv, "--perf-report", &perf_report), REF_NOT_FOUND,
       "arg search");
-  if (REF_EMPTY != pos && pos < argc - 1) {
-    if (ref_mpi_once(ref_mpi)) printf("meshlink with %s\n", argv[pos + 1]);
-    RSS(ref_meshlink_open(ref_grid, argv[pos + 1]), "meshlink init");
-    RSS(ref_meshlink_infer_orientation(ref_grid), "meshlink orient");
-  } else {
-    RXS(ref_args_find(argc, argv, "--egads", &pos), REF_NOT_FOUND,
-        "arg search");
-    if (REF_EMPTY != pos && pos < argc - 1) {
-      if (ref_mpi_once(ref_mpi)) printf("load egads from %s\n", argv[pos + 1]);
-      RSS(ref_egads_load(ref_grid_geom(ref_grid), argv[pos + 1]), "load egads");
-      ref_mpi_stopwatch_stop(ref_mpi, "load egads");
-    } else {
-      if (0 < ref_geom_cad_data_size(ref_grid_geom(ref_grid))) {
-        if (ref_mpi_once(ref_mpi))
-          printf("load egadslite from .meshb byte stream\n");
-        RSS(ref_egads_load(ref_grid_geom(ref_grid), NULL), "load egads");
-        ref_mpi_stopwatch_stop(ref_mpi, "load egadslite cad data");
-      } else {
-        if (ref_mpi_once(ref_mpi))
-          printf("warning: no geometry loaded, assuming planar faces.\n");
-      }
-    }
+  if (NULL != perf_report) {
+    if (ref_mpi_once(ref_mpi)) printf("--perf-report %s\n", perf_report);
+    RSS(ref_perf_create(&ref_perf), "create perf");
   }
 
+  RSS(loop_geometry(ref_mpi, ref_grid, argc, argv), "geometry");
+
   RXS(ref_args_find(argc, argv, "--usm3d", &pos), REF_NOT_FOUND, "arg search");
   if (REF_EMPTY == pos) {
     sprintf(filename, "%s_volume.solb", in_project);
@@ -1009,208 +1329,83 @@ static REF_STATUS loop(REF_MPI ref_mpi, int argc, char *argv[]) {
     ref_mpi_stopwatch_stop(ref_mpi, "compute compressible scalar");
   }
 
-  if (ref_mpi_once(ref_mpi)) printf("reconstruct Hessian, compute metric\n");
-  ref_malloc(metric, 6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
-  RSS(ref_metric_lp(metric, ref_grid, scalar, NULL, reconstruction, p,
-                    gradation, complexity),
-      "lp norm");
-  ref_mpi_stopwatch_stop(ref_mpi, "compute metric");
+  /* the scaled Hessian is shared by every complexity of the ladder */
+  if (ref_mpi_once(ref_mpi)) printf("reconstruct Hessian, scale\n");
+  ref_malloc(hess, 6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+  RSS(ref_metric_lp_scale(hess, ref_grid, scalar, NULL, reconstruction, p),
+      "lp scale");
+  ref_mpi_stopwatch_stop(ref_mpi, "reconstruct and scale Hessian");
 
   ref_free(scalar);
 
-  if (buffer) {
-    if (ref_mpi_once(ref_mpi)) printf("buffer at complexity %e\n", complexity);
-    RSS(ref_metric_buffer_at_complexity(metric, ref_grid, complexity),
-        "buffer at complexity");
-    ref_mpi_stopwatch_stop(ref_mpi, "buffer");
-  }
-
-  RXS(ref_args_find(argc, argv, "--uniform", &pos), REF_NOT_FOUND,
-      "arg search");
-  if (REF_EMPTY != pos) {
-    RSS(ref_metric_parse(metric, ref_grid, argc, argv), "parse uniform");
-  }
-
-  RSS(ref_metric_to_node(metric, ref_grid_node(ref_grid)), "set node");
-  ref_free(metric);
-
-  ref_grid_surf(ref_grid) = ref_grid_twod(ref_grid);
-  if (ref_geom_model_loaded(ref_grid_geom(ref_grid))) {
-    RSS(ref_egads_mark_jump_degen(ref_grid), "T and UV jumps; UV degen");
-  }
-  if (ref_geom_model_loaded(ref_grid_geom(ref_grid)) ||
-      ref_geom_meshlinked(ref_grid_geom(ref_grid))) {
-    RSS(ref_geom_verify_topo(ref_grid), "geom topo");
-    RSS(ref_geom_verify_param(ref_grid), "geom param");
-    ref_mpi_stopwatch_stop(ref_mpi, "geom assoc");
-    RSS(ref_metric_constrain_curvature(ref_grid), "crv const");
-    RSS(ref_validation_cell_volume(ref_grid), "vol");
-    ref_mpi_stopwatch_stop(ref_mpi, "crv const");
-  }
-  RSS(ref_grid_cache_background(ref_grid), "cache");
-  RSS(ref_node_store_aux(ref_grid_node(ref_grid_background(ref_grid)), ldim,
-                         initial_field),
-      "store init field with background");
-  ref_free(initial_field);
-  ref_mpi_stopwatch_stop(ref_mpi, "cache background metric and field");
-
-  RSS(ref_histogram_quality(ref_grid), "gram");
-  RSS(ref_histogram_ratio(ref_grid), "gram");
-  ref_mpi_stopwatch_stop(ref_mpi, "histogram");
-
-  RSS(ref_migrate_to_balance(ref_grid), "balance");
-  RSS(ref_grid_pack(ref_grid), "pack");
-  ref_mpi_stopwatch_stop(ref_mpi, "pack");
-
-  for (pass = 0; !all_done && pass < passes; pass++) {
-    if (ref_mpi_once(ref_mpi))
-      printf("\n pass %d of %d with %d ranks\n", pass + 1, passes,
-             ref_mpi_n(ref_mpi));
-    all_done1 = all_done0;
-    RSS(ref_adapt_pass(ref_grid, &all_done0), "pass");
-    all_done = all_done0 && all_done1 && (pass > MIN(5, passes));
-    ref_mpi_stopwatch_stop(ref_mpi, "pass");
-    RSS(ref_metric_synchronize(ref_grid), "sync with background");
-    ref_mpi_stopwatch_stop(ref_mpi, "metric sync");
-    RSS(ref_validation_cell_volume(ref_grid), "vol");
-    RSS(ref_histogram_quality(ref_grid), "gram");
-    RSS(ref_histogram_ratio(ref_grid), "gram");
-    ref_mpi_stopwatch_stop(ref_mpi, "histogram");
-    RSS(ref_adapt_tattle_faces(ref_grid), "tattle");
-    ref_mpi_stopwatch_stop(ref_grid_mpi(ref_grid), "tattle faces");
-    RSS(ref_migrate_to_balance(ref_grid), "balance");
-    RSS(ref_grid_pack(ref_grid), "pack");
-    ref_mpi_stopwatch_stop(ref_mpi, "pack");
-  }
-
-  RSS(ref_node_implicit_global_from_local(ref_grid_node(ref_grid)),
-      "implicit global");
-  ref_mpi_stopwatch_stop(ref_mpi, "implicit global");
-
-  RSS(ref_geom_verify_param(ref_grid), "final params");
-  ref_mpi_stopwatch_stop(ref_mpi, "verify final params");
-
-  sprintf(filename, "%s.meshb", out_project);
-  if (ref_mpi_once(ref_mpi))
-    printf("gather " REF_GLOB_FMT " nodes to %s\n",
-           ref_node_n_global(ref_grid_node(ref_grid)), filename);
-  RSS(ref_gather_by_extension(ref_grid, filename), "gather .meshb");
-  ref_mpi_stopwatch_stop(ref_mpi, "gather meshb");
-
-  sprintf(filename, "%s.%s", out_project, mesh_extension);
-  if (ref_grid_twod(ref_grid)) {
-    if (ref_mpi_once(ref_mpi)) printf("extrude twod\n");
-    RSS(ref_grid_extrude_twod(&extruded_grid, ref_grid), "extrude");
-    if (ref_mpi_once(ref_mpi))
-      printf("gather extruded " REF_GLOB_FMT " nodes to %s\n",
-             ref_node_n_global(ref_grid_node(extruded_grid)), filename);
-    if (ref_mpi_once(ref_mpi)) printf("gather extruded %s\n", filename);
-    RSS(ref_gather_by_extension(extruded_grid, filename),
-        "gather mesh extension");
-  } else {
+  for (rung = 0; rung < ncomplexity; rung++) {
+    complexity = complexities[rung];
+    /* the last rung adapts the loaded grid, others adapt copies */
+    if (rung < ncomplexity - 1) {
+      RSS(ref_grid_deep_copy(&rung_grid, ref_grid), "copy rung grid");
+      RSS(loop_geometry(ref_mpi, rung_grid, argc, argv), "rung geometry");
+    } else {
+      rung_grid = ref_grid;
+    }
+    /* every rung appends its passes to one report */
+    ref_grid_perf(rung_grid) = ref_perf;
+    ref_malloc(metric, 6 * ref_node_max(ref_grid_node(rung_grid)), REF_DBL);
+    each_ref_node_valid_node(ref_grid_node(rung_grid), node) {
+      for (i = 0; i < 6; i++) metric[i + 6 * node] = hess[i + 6 * node];
+    }
     if (ref_mpi_once(ref_mpi))
-      printf("gather " REF_GLOB_FMT " nodes to %s\n",
-             ref_node_n_global(ref_grid_node(ref_grid)), filename);
-    RSS(ref_gather_by_extension(ref_grid, filename), "gather mesh extension");
-  }
-  ref_mpi_stopwatch_stop(ref_mpi, "gather mesh extension");
-
-  if (ref_mpi_once(ref_mpi)) {
-    printf("%d leading dim from " REF_GLOB_FMT " donor nodes to " REF_GLOB_FMT
-           " receptor nodes\n",
-           ldim,
-           ref_node_n_global(ref_grid_node(ref_grid_background(ref_grid))),
-           ref_node_n_global(ref_grid_node(ref_grid)));
-  }
-
-  if (ref_mpi_once(ref_mpi)) printf("interpolate receptor nodes\n");
-  ref_malloc(ref_field, ldim * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
-  RSS(ref_node_extract_aux(ref_grid_node(ref_grid_background(ref_grid)), &ldim,
-                           &initial_field),
-      "store init field with background");
-  RSS(ref_interp_scalar(ref_grid_interp(ref_grid), ldim, initial_field,
-                        ref_field),
-      "interp scalar");
-  ref_free(initial_field);
-  /* free interp and background grid */
-  RSS(ref_grid_free(ref_grid_background(ref_grid)),
-      "free cached background grid");
-  RSS(ref_interp_free(ref_grid_interp(ref_grid)), "interp free");
-  ref_grid_interp(ref_grid) = NULL;
-  ref_mpi_stopwatch_stop(ref_mpi, "interp");
+      printf("gradation at complexity %e\n", complexity);
+    RSS(ref_metric_gradation_at_complexity(metric, rung_grid, gradation,
+                                           complexity),
+        "gradation at complexity");
+    ref_mpi_stopwatch_stop(ref_mpi, "compute metric");
 
-  if (ref_grid_twod(ref_grid)) {
-    if (ref_mpi_once(ref_mpi)) printf("extruding field of %d\n", ldim);
-    ref_malloc(extruded_field,
-               ldim * ref_node_max(ref_grid_node(extruded_grid)), REF_DBL);
-    RSS(ref_grid_extrude_field(ref_grid, ldim, ref_field, extruded_grid,
-                               extruded_field),
-        "extrude field");
-    RXS(ref_args_find(argc, argv, "--usm3d", &pos), REF_NOT_FOUND,
-        "arg search");
-    if (REF_EMPTY == pos) {
-      sprintf(filename, "%s-restart.solb", out_project);
-      if (ref_mpi_once(ref_mpi))
-        printf("writing interpolated extruded field %s\n", filename);
-      RSS(ref_gather_scalar_by_extension(extruded_grid, ldim, extruded_field,
-                                         NULL, filename),
-          "gather recept");
-    } else {
-      sprintf(filename, "%s.solb", out_project);
+    if (buffer) {
       if (ref_mpi_once(ref_mpi))
-        printf("writing interpolated field at prism cell centers %s\n",
-               filename);
-      RSS(ref_gather_scalar_cell_solb(extruded_grid, ldim, extruded_field,
-                                      filename),
-          "gather cell center");
+        printf("buffer at complexity %e\n", complexity);
+      RSS(ref_metric_buffer_at_complexity(metric, rung_grid, complexity),
+          "buffer at complexity");
+      ref_mpi_stopwatch_stop(ref_mpi, "buffer");
     }
-    ref_free(extruded_field);
-    ref_grid_free(extruded_grid);
-  } else {
-    RXS(ref_args_find(argc, argv, "--usm3d", &pos), REF_NOT_FOUND,
+
+    RXS(ref_args_find(argc, argv, "--uniform", &pos), REF_NOT_FOUND,
         "arg search");
-    if (REF_EMPTY == pos) {
-      sprintf(filename, "%s-restart.solb", out_project);
-      if (ref_mpi_once(ref_mpi))
-        printf("writing interpolated field %s\n", filename);
-      RSS(ref_gather_scalar_by_extension(ref_grid, ldim, ref_field, NULL,
-                                         filename),
-          "gather recept");
-    } else {
-      sprintf(filename, "%s.solb", out_project);
-      if (ref_mpi_once(ref_mpi))
-        printf("writing interpolated field at tet cell centers %s\n", filename);
-      RSS(ref_gather_scalar_cell_solb(ref_grid, ldim, ref_field, filename),
-          "gather cell center");
+    if (REF_EMPTY != pos) {
+      RSS(ref_metric_parse(metric, rung_grid, argc, argv), "parse uniform");
     }
-  }
-  ref_mpi_stopwatch_stop(ref_mpi, "gather receptor");
 
-  ref_free(ref_field);
+    RSS(ref_metric_to_node(metric, ref_grid_node(rung_grid)), "set node");
+    ref_free(metric);
 
-  /* export via -x grid.ext and -f final-surf.tec*/
-  for (pos = 0; pos < argc - 1; pos++) {
-    if (strcmp(argv[pos], "-x") == 0) {
-      if (ref_mpi_para(ref_mpi)) {
-        if (ref_mpi_once(ref_mpi))
-          printf("gather " REF_GLOB_FMT " nodes to %s\n",
-                 ref_node_n_global(ref_grid_node(ref_grid)), argv[pos + 1]);
-        RSS(ref_gather_by_extension(ref_grid, argv[pos + 1]), "gather -x");
-      } else {
-        if (ref_mpi_once(ref_mpi))
-          printf("export " REF_GLOB_FMT " nodes to %s\n",
-                 ref_node_n_global(ref_grid_node(ref_grid)), argv[pos + 1]);
-        RSS(ref_export_by_extension(ref_grid, argv[pos + 1]), "export -x");
-      }
+    ref_malloc(rung_field, ldim * ref_node_max(ref_grid_node(rung_grid)),
+               REF_DBL);
+    each_ref_node_valid_node(ref_grid_node(rung_grid), node) {
+      for (i = 0; i < ldim; i++)
+        rung_field[i + ldim * node] = initial_field[i + ldim * node];
     }
-    if (strcmp(argv[pos], "-f") == 0) {
-      if (ref_mpi_once(ref_mpi))
-        printf("gather final surface status %s\n", argv[pos + 1]);
-      RSS(ref_gather_surf_status_tec(ref_grid, argv[pos + 1]), "gather -f");
+    /* project names have no extension, the rung is appended */
+    if (1 < ncomplexity) {
+      RAS(snprintf(rung_project, sizeof(rung_project), "%s-%d", out_project,
+                   (int)rung + 1) < (int)sizeof(rung_project),
+          "rung project name too long");
+    } else {
+      RAS(snprintf(rung_project, sizeof(rung_project), "%s", out_project) <
+              (int)sizeof(rung_project),
+          "project name too long");
     }
+    RSS(loop_adapt(ref_mpi, rung_grid, ldim, rung_field, rung_project,
+                   mesh_extension, passes, rung, ncomplexity, argc, argv),
+        "adapt rung");
   }
 
-  RSS(ref_grid_free(ref_grid), "free");
+  ref_free(hess);
+  ref_free(initial_field);
+
+  if (NULL != ref_perf) {
+    RSS(ref_perf_report(ref_perf, ref_mpi, perf_report), "perf report");
+    RSS(ref_perf_free(ref_perf), "free perf");
+    ref_mpi_stopwatch_stop(ref_mpi, "perf report");
+  }
 
   return REF_SUCCESS;
 shutdown:
@@ -1222,12 +1417,16 @@ static REF_STATUS multiscale(REF_MPI ref_mpi, int argc, char *argv[]) {
   char *out_metric;
   char *in_mesh;
   char *in_scalar;
+  char filename[1024];
   REF_GRID ref_grid = NULL;
-  REF_INT ldim;
+  REF_INT ldim, node, i;
   REF_DBL *scalar = NULL;
+  REF_DBL *hess = NULL;
   REF_DBL *metric = NULL;
   REF_INT p;
   REF_DBL gradation, complexity, current_complexity;
+  REF_INT ncomplexity, rung;
+  REF_DBL complexities[REF_ARGS_MAX_LADDER];
   REF_RECON_RECONSTRUCTION reconstruction = REF_RECON_L2PROJECTION;
   REF_INT pos;
   REF_BOOL buffer;
@@ -1235,7 +1434,8 @@ static REF_STATUS multiscale(REF_MPI ref_mpi, int argc, char *argv[]) {
   if (argc < 6) goto shutdown;
   in_mesh = argv[2];
   in_scalar = argv[3];
-  complexity = atof(argv[4]);
+  if (REF_SUCCESS != ref_args_ladder(argv[4], &ncomplexity, complexities))
+    goto shutdown;
   out_metric = argv[5];
 
   p = 2;
@@ -1269,7 +1469,8 @@ static REF_STATUS multiscale(REF_MPI ref_mpi, int argc, char *argv[]) {
   }
 
   if (ref_mpi_once(ref_mpi)) {
-    printf("complexity %f\n", complexity);
+    for (rung = 0; rung < ncomplexity; rung++)
+      printf("complexity %f\n", complexities[rung]);
     printf("Lp=%d\n", p);
     printf("gradation %f\n", gradation);
     printf("reconstruction %d\n", (int)reconstruction);
@@ -1288,7 +1489,8 @@ static REF_STATUS multiscale(REF_MPI ref_mpi, int argc, char *argv[]) {
     ref_mpi_stopwatch_stop(ref_mpi, "import");
   }
 
-  ref_malloc(metric, 6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+  /* the scaled Hessian is shared by every complexity of the ladder */
+  ref_malloc(hess, 6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
 
   RXS(ref_args_find(argc, argv, "--hessian", &pos), REF_NOT_FOUND,
       "arg search");
@@ -1296,16 +1498,13 @@ static REF_STATUS multiscale(REF_MPI ref_mpi, int argc, char *argv[]) {
     if (ref_mpi_once(ref_mpi)) printf("part hessian %s\n", in_scalar);
     RSS(ref_part_metric(ref_grid_node(ref_grid), in_scalar), "part scalar");
     ref_mpi_stopwatch_stop(ref_mpi, "part metric");
-    RSS(ref_metric_from_node(metric, ref_grid_node(ref_grid)), "get node");
-    RSS(ref_recon_abs_value_hessian(ref_grid, metric), "abs val");
-    RSS(ref_recon_roundoff_limit(metric, ref_grid),
+    RSS(ref_metric_from_node(hess, ref_grid_node(ref_grid)), "get node");
+    RSS(ref_recon_abs_value_hessian(ref_grid, hess), "abs val");
+    RSS(ref_recon_roundoff_limit(hess, ref_grid),
         "floor metric eignvalues based on grid size and solution jitter");
-    RSS(ref_metric_local_scale(metric, NULL, ref_grid, p),
+    RSS(ref_metric_local_scale(hess, NULL, ref_grid, p),
         "local scale lp norm");
-    RSS(ref_metric_gradation_at_complexity(metric, ref_grid, gradation,
-                                           complexity),
-        "gradation at complexity");
-    ref_mpi_stopwatch_stop(ref_mpi, "compute metric from hessian");
+    ref_mpi_stopwatch_stop(ref_mpi, "scale hessian");
   } else {
     if (ref_mpi_once(ref_mpi)) printf("part scalar %s\n", in_scalar);
     RSS(ref_part_scalar(ref_grid_node(ref_grid), &ldim, &scalar, in_scalar),
@@ -1313,31 +1512,49 @@ static REF_STATUS multiscale(REF_MPI ref_mpi, int argc, char *argv[]) {
     REIS(1, ldim, "expected one scalar");
     ref_mpi_stopwatch_stop(ref_mpi, "part scalar");
 
-    if (ref_mpi_once(ref_mpi)) printf("reconstruct Hessian, compute metric\n");
-    RSS(ref_metric_lp(metric, ref_grid, scalar, NULL, reconstruction, p,
-                      gradation, complexity),
-        "lp norm");
+    if (ref_mpi_once(ref_mpi)) printf("reconstruct Hessian, scale\n");
+    RSS(ref_metric_lp_scale(hess, ref_grid, scalar, NULL, reconstruction, p),
+        "lp scale");
     ref_free(scalar);
-    ref_mpi_stopwatch_stop(ref_mpi, "compute metric");
+    ref_mpi_stopwatch_stop(ref_mpi, "reconstruct and scale Hessian");
   }
 
-  if (buffer) {
-    if (ref_mpi_once(ref_mpi)) printf("buffer at complexity %e\n", complexity);
-    RSS(ref_metric_buffer_at_complexity(metric, ref_grid, complexity),
-        "buffer at complexity");
-    ref_mpi_stopwatch_stop(ref_mpi, "buffer");
-  }
+  ref_malloc(metric, 6 * ref_node_max(ref_grid_node(ref_grid)), REF_DBL);
+  for (rung = 0; rung < ncomplexity; rung++) {
+    complexity = complexities[rung];
+    each_ref_node_valid_node(ref_grid_node(ref_grid), node) {
+      for (i = 0; i < 6; i++) metric[i + 6 * node] = hess[i + 6 * node];
+    }
+    if (ref_mpi_once(ref_mpi))
+      printf("gradation at complexity %e\n", complexity);
+    RSS(ref_metric_gradation_at_complexity(metric, ref_grid, gradation,
+                                           complexity),
+        "gradation at complexity");
+    ref_mpi_stopwatch_stop(ref_mpi, "compute metric");
 
-  RSS(ref_metric_complexity(metric, ref_grid, &current_complexity), "cmp");
-  if (ref_mpi_once(ref_mpi))
-    printf("actual complexity %e\n", current_complexity);
-  RSS(ref_metric_to_node(metric, ref_grid_node(ref_grid)), "set node");
+    if (buffer) {
+      if (ref_mpi_once(ref_mpi))
+        printf("buffer at complexity %e\n", complexity);
+      RSS(ref_metric_buffer_at_complexity(metric, ref_grid, complexity),
+          "buffer at complexity");
+      ref_mpi_stopwatch_stop(ref_mpi, "buffer");
+    }
 
-  ref_free(metric);
+    RSS(ref_metric_complexity(metric, ref_grid, &current_complexity), "cmp");
+    if (ref_mpi_once(ref_mpi))
+      printf("actual complexity %e\n", current_complexity);
+    RSS(ref_metric_to_node(metric, ref_grid_node(ref_grid)), "set node");
 
-  if (ref_mpi_once(ref_mpi)) printf("gather %s\n", out_metric);
-  RSS(ref_gather_metric(ref_grid, out_metric), "gather metric");
-  ref_mpi_stopwatch_stop(ref_mpi, "gather metric");
+    RSS(ref_args_rung_filename(filename, sizeof(filename), out_metric,
+                                     rung, ncomplexity),
+        "rung filename");
+    if (ref_mpi_once(ref_mpi)) printf("gather %s\n", filename);
+    RSS(ref_gather_metric(ref_grid, filename), "gather metric");
+    ref_mpi_stopwatch_stop(ref_mpi, "gather metric");
+  }
+
+  ref_free(metric);
+  ref_free(hess);
 
   RSS(ref_grid_free(ref_grid), "free grid");
 
@@ -1448,6 +1665,7 @@ static REF_STATUS translate(REF_MPI ref_mpi, int argc, char *argv[]) {
         }
       }
     }
+    RSS(ref_node_index_invalidate(ref_node), "moved");
     RSS(ref_mpi_max(ref_mpi, &deviation, &total_deviation, REF_DBL_TYPE),
         "mpi max");
     printf("max deviation %e\n", deviation);
@@ -1485,6 +1703,8 @@ static void echo_argv(int argc, char *argv[]) {
 int main(int argc, char *argv[]) {
   REF_MPI ref_mpi;
   REF_INT help_pos = REF_EMPTY;
+  REF_INT threads_pos = REF_EMPTY;
+  REF_INT trace_pos = REF_EMPTY;
 
   RSS(ref_mpi_start(argc, argv), "start");
   RSS(ref_mpi_create(&ref_mpi), "make mpi");
@@ -1507,6 +1727,22 @@ int main(int argc, char *argv[]) {
     goto shutdown;
   }
 
+  RXS(ref_args_find(argc, argv, "--threads", &threads_pos), REF_NOT_FOUND,
+      "arg search");
+  if (REF_EMPTY != threads_pos && threads_pos < argc - 1) {
+    RSS(ref_mpi_threads(ref_mpi, atoi(argv[threads_pos + 1])), "threads");
+    if (ref_mpi_once(ref_mpi))
+      printf("--threads %d threads per rank\n", ref_mpi_nthread(ref_mpi));
+  }
+
+  RXS(ref_args_find(argc, argv, "--trace", &trace_pos), REF_NOT_FOUND,
+      "arg search");
+  if (REF_EMPTY != trace_pos && trace_pos < argc - 1) {
+    RSS(ref_mpi_trace_start(ref_mpi), "trace");
+    if (ref_mpi_once(ref_mpi))
+      printf("--trace %s timeline of every rank\n", argv[trace_pos + 1]);
+  }
+
   if (strncmp(argv[1], "a", 1) == 0) {
     if (REF_EMPTY == help_pos) {
       RSS(adapt(ref_mpi, argc, argv), "adapt");
@@ -1576,6 +1812,8 @@ int main(int argc, char *argv[]) {
   }
 
   ref_mpi_stopwatch_stop(ref_mpi, "done.");
+  if (ref_mpi_tracing(ref_mpi))
+    RSS(ref_mpi_trace_dump(ref_mpi, argv[trace_pos + 1]), "trace dump");
 shutdown:
   RSS(ref_mpi_free(ref_mpi), "mpi free");
   RSS(ref_mpi_stop(), "stop");
@@ -0,0 +1,760 @@
+
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include "ref_surrogate.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ref_cell.h"
+#include "ref_geom.h"
+#include "ref_malloc.h"
+#include "ref_math.h"
+#include "ref_matrix.h"
+#include "ref_mpi.h"
+#include "ref_node.h"
+
+#define REF_SURROGATE_TRI_DBL (24)
+#define REF_SURROGATE_SEG_DBL (16)
+
+static REF_STATUS ref_surrogate_corner_normal(REF_GRID ref_grid, REF_INT node,
+                                              REF_INT id, REF_DBL *normal) {
+  REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_CELL ref_cell = ref_grid_tri(ref_grid);
+  REF_INT item, cell, i, nodes[REF_CELL_MAX_SIZE_PER];
+  REF_DBL tri_normal[3];
+
+  for (i = 0; i < 3; i++) normal[i] = 0.0;
+  /* area weighted by the unnormalized cross product */
+  each_ref_cell_having_node(ref_cell, node, item, cell) {
+    RSS(ref_cell_nodes(ref_cell, cell, nodes), "nodes");
+    if (id != nodes[ref_cell_id_index(ref_cell)]) continue;
+    RSS(ref_node_tri_normal(ref_node, nodes, tri_normal), "norm");
+    for (i = 0; i < 3; i++) normal[i] += tri_normal[i];
+  }
+  RXS(ref_math_normalize(normal), REF_DIV_ZERO, "corner normal");
+
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_surrogate_end_curve(REF_GRID ref_grid, REF_INT node,
+                                          REF_INT other, REF_INT id,
+                                          REF_DBL *curve) {
+  REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_CELL ref_cell = ref_grid_edg(ref_grid);
+  REF_INT item, cell, i, next, nodes[REF_CELL_MAX_SIZE_PER];
+  REF_DBL *p0, *p1, *p2, d01[3], d12[3], d02[3], cross[3], bend[3];
+  REF_DBL len, tangent[3];
+
+  for (i = 0; i < 4; i++) curve[i] = 0.0;
+
+  /* the circle through the neighbors along the same edge id, when the
+   * node is interior to the edge polyline */
+  next = REF_EMPTY;
+  each_ref_cell_having_node(ref_cell, node, item, cell) {
+    RSS(ref_cell_nodes(ref_cell, cell, nodes), "nodes");
+    if (id != nodes[ref_cell_id_index(ref_cell)]) continue;
+    if (other == nodes[0] || other == nodes[1]) continue;
+    if (REF_EMPTY != next) return REF_SUCCESS; /* branches */
+    next = (node == nodes[0]) ? nodes[1] : nodes[0];
+  }
+  if (REF_EMPTY == next) return REF_SUCCESS;
+
+  p0 = ref_node_xyz_ptr(ref_node, other);
+  p1 = ref_node_xyz_ptr(ref_node, node);
+  p2 = ref_node_xyz_ptr(ref_node, next);
+  for (i = 0; i < 3; i++) {
+    d01[i] = p1[i] - p0[i];
+    d12[i] = p2[i] - p1[i];
+    d02[i] = p2[i] - p0[i];
+    bend[i] = p0[i] + p2[i] - 2.0 * p1[i];
+    tangent[i] = d02[i];
+  }
+  ref_math_cross_product(d01, d12, cross);
+  len = sqrt(ref_math_dot(d01, d01)) * sqrt(ref_math_dot(d12, d12)) *
+        sqrt(ref_math_dot(d02, d02));
+  if (!ref_math_divisible(2.0 * sqrt(ref_math_dot(cross, cross)), len))
+    return REF_SUCCESS;
+  curve[0] = 2.0 * sqrt(ref_math_dot(cross, cross)) / len;
+  /* toward the center of the circle */
+  if (REF_SUCCESS != ref_math_normalize(tangent)) return REF_SUCCESS;
+  len = ref_math_dot(bend, tangent);
+  for (i = 0; i < 3; i++) bend[i] -= len * tangent[i];
+  if (REF_SUCCESS != ref_math_normalize(bend)) {
+    curve[0] = 0.0;
+    return REF_SUCCESS;
+  }
+  for (i = 0; i < 3; i++) curve[1 + i] = bend[i];
+
+  return REF_SUCCESS;
+}
+
+/* principal curvatures from the change of corner normals along the tri
+ * sides, least squares fit of the shape operator in the tri plane */
+static REF_STATUS ref_surrogate_tri_curve(REF_DBL *xyz, REF_DBL *normal,
+                                          REF_DBL *curve) {
+  REF_DBL r[3], s[3], n[3], e[3], dn[3];
+  REF_DBL ab[12], er, es, nr, ns;
+  REF_DBL a, b, c, mean, radical, lambda[2], v[2], len;
+  REF_INT side, i, n0, n1;
+  REF_STATUS status;
+
+  for (i = 0; i < 8; i++) curve[i] = 0.0;
+
+  for (i = 0; i < 3; i++) {
+    r[i] = xyz[i + 3] - xyz[i];
+    e[i] = xyz[i + 6] - xyz[i];
+  }
+  ref_math_cross_product(r, e, n);
+  if (REF_SUCCESS != ref_math_normalize(n)) return REF_SUCCESS;
+  if (REF_SUCCESS != ref_math_normalize(r)) return REF_SUCCESS;
+  ref_math_cross_product(n, r, s);
+
+  for (i = 0; i < 12; i++) ab[i] = 0.0;
+  for (side = 0; side < 3; side++) {
+    n0 = side;
+    n1 = (side + 1) % 3;
+    for (i = 0; i < 3; i++) {
+      e[i] = xyz[i + 3 * n1] - xyz[i + 3 * n0];
+      dn[i] = normal[i + 3 * n1] - normal[i + 3 * n0];
+    }
+    er = ref_math_dot(e, r);
+    es = ref_math_dot(e, s);
+    nr = ref_math_dot(dn, r);
+    ns = ref_math_dot(dn, s);
+    /* normal equations of rows [er es 0] = nr and [0 er es] = ns */
+    ab[0 + 3 * 0] += er * er;
+    ab[0 + 3 * 1] += er * es;
+    ab[1 + 3 * 0] += er * es;
+    ab[1 + 3 * 1] += es * es + er * er;
+    ab[1 + 3 * 2] += er * es;
+    ab[2 + 3 * 1] += er * es;
+    ab[2 + 3 * 2] += es * es;
+    ab[0 + 3 * 3] += er * nr;
+    ab[1 + 3 * 3] += es * nr + er * ns;
+    ab[2 + 3 * 3] += es * ns;
+  }
+  status = ref_matrix_solve_ab(3, 4, ab);
+  if (REF_SUCCESS != status) return REF_SUCCESS;
+  a = ab[0 + 3 * 3];
+  b = ab[1 + 3 * 3];
+  c = ab[2 + 3 * 3];
+
+  mean = 0.5 * (a + c);
+  radical = sqrt(0.25 * (a - c) * (a - c) + b * b);
+  lambda[0] = mean + radical;
+  lambda[1] = mean - radical;
+  /* either row of the shifted operator gives the eigenvector, use longer */
+  v[0] = lambda[0] - c;
+  v[1] = b;
+  if (ABS(lambda[0] - a) + ABS(b) > ABS(lambda[0] - c) + ABS(b)) {
+    v[0] = b;
+    v[1] = lambda[0] - a;
+  }
+  len = sqrt(v[0] * v[0] + v[1] * v[1]);
+  if (ref_math_divisible(v[0], len) && ref_math_divisible(v[1], len)) {
+    v[0] /= len;
+    v[1] /= len;
+  } else { /* umbilic, any direction */
+    v[0] = 1.0;
+    v[1] = 0.0;
+  }
+  if (ABS(lambda[1]) > ABS(lambda[0])) {
+    curve[0] = lambda[1];
+    curve[4] = lambda[0];
+    len = v[0];
+    v[0] = -v[1];
+    v[1] = len;
+  } else {
+    curve[0] = lambda[0];
+    curve[4] = lambda[1];
+  }
+  for (i = 0; i < 3; i++) {
+    curve[1 + i] = v[0] * r[i] + v[1] * s[i];
+    curve[5 + i] = -v[1] * r[i] + v[0] * s[i];
+  }
+
+  return REF_SUCCESS;
+}
+
+/* cells of each id in one counting pass, the cells of id are
+ * order[first[id]] to order[first[id + 1] - 1] */
+static REF_STATUS ref_surrogate_bucket(REF_INT n, REF_INT *ids, REF_INT maxid,
+                                       REF_INT **first_ptr,
+                                       REF_INT **order_ptr) {
+  REF_INT i, id, *first, *order;
+
+  ref_malloc_init(first, maxid + 2, REF_INT, 0);
+  for (i = 0; i < n; i++) {
+    RAS(0 <= ids[i] && ids[i] <= maxid, "id out of range");
+    first[ids[i] + 1]++;
+  }
+  for (id = 0; id <= maxid; id++) first[id + 1] += first[id];
+  ref_malloc(order, n, REF_INT);
+  for (i = 0; i < n; i++) {
+    order[first[ids[i]]] = i;
+    first[ids[i]]++;
+  }
+  for (id = maxid; id > 0; id--) first[id] = first[id - 1];
+  first[0] = 0;
+
+  *first_ptr = first;
+  *order_ptr = order;
+
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_surrogate_bulk(REF_SEARCH *ref_search, REF_INT nitem,
+                                     REF_INT *item, REF_INT ncorner,
+                                     REF_INT dim, REF_DBL *corner) {
+  REF_INT i, j, k, n;
+  REF_DBL *position, *radius, dist;
+
+  *ref_search = NULL;
+  if (0 == nitem) return REF_SUCCESS;
+
+  ref_malloc_init(position, 3 * nitem, REF_DBL, 0.0);
+  ref_malloc_init(radius, nitem, REF_DBL, 0.0);
+  for (n = 0; n < nitem; n++) {
+    i = item[n];
+    for (k = 0; k < ncorner; k++)
+      for (j = 0; j < dim; j++)
+        position[j + 3 * n] +=
+            corner[j + dim * k + dim * ncorner * i] / (REF_DBL)ncorner;
+    for (k = 0; k < ncorner; k++) {
+      dist = 0.0;
+      for (j = 0; j < dim; j++)
+        dist += pow(corner[j + dim * k + dim * ncorner * i] -
+                        position[j + 3 * n],
+                    2);
+      radius[n] = MAX(radius[n], sqrt(dist));
+    }
+  }
+  RSS(ref_search_create(ref_search, nitem), "create");
+  RSS(ref_search_bulk(*ref_search, nitem, item, position, radius), "bulk");
+  ref_free(radius);
+  ref_free(position);
+
+  return REF_SUCCESS;
+}
+
+/* closest point in a triangle after Ericson, returns barycentrics */
+static REF_STATUS ref_surrogate_tri_closest(REF_DBL *a, REF_DBL *b, REF_DBL *c,
+                                            REF_DBL *p, REF_DBL *bary) {
+  REF_DBL ab[3], ac[3], ap[3], bp[3], cp[3];
+  REF_DBL d1, d2, d3, d4, d5, d6, va, vb, vc, v, w;
+  REF_INT i;
+
+  bary[0] = 1.0;
+  bary[1] = 0.0;
+  bary[2] = 0.0;
+  for (i = 0; i < 3; i++) {
+    ab[i] = b[i] - a[i];
+    ac[i] = c[i] - a[i];
+    ap[i] = p[i] - a[i];
+    bp[i] = p[i] - b[i];
+    cp[i] = p[i] - c[i];
+  }
+  d1 = ref_math_dot(ab, ap);
+  d2 = ref_math_dot(ac, ap);
+  if (d1 <= 0.0 && d2 <= 0.0) return REF_SUCCESS;
+  d3 = ref_math_dot(ab, bp);
+  d4 = ref_math_dot(ac, bp);
+  if (d3 >= 0.0 && d4 <= d3) {
+    bary[0] = 0.0;
+    bary[1] = 1.0;
+    return REF_SUCCESS;
+  }
+  vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+    if (!ref_math_divisible(d1, d1 - d3)) return REF_SUCCESS;
+    v = d1 / (d1 - d3);
+    bary[0] = 1.0 - v;
+    bary[1] = v;
+    return REF_SUCCESS;
+  }
+  d5 = ref_math_dot(ab, cp);
+  d6 = ref_math_dot(ac, cp);
+  if (d6 >= 0.0 && d5 <= d6) {
+    bary[0] = 0.0;
+    bary[2] = 1.0;
+    return REF_SUCCESS;
+  }
+  vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+    if (!ref_math_divisible(d2, d2 - d6)) return REF_SUCCESS;
+    w = d2 / (d2 - d6);
+    bary[0] = 1.0 - w;
+    bary[2] = w;
+    return REF_SUCCESS;
+  }
+  va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+    if (!ref_math_divisible((d4 - d3), (d4 - d3) + (d5 - d6)))
+      return REF_SUCCESS;
+    w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    bary[0] = 0.0;
+    bary[1] = 1.0 - w;
+    bary[2] = w;
+    return REF_SUCCESS;
+  }
+  if (!ref_math_divisible(vb, va + vb + vc) ||
+      !ref_math_divisible(vc, va + vb + vc))
+    return REF_SUCCESS;
+  v = vb / (va + vb + vc);
+  w = vc / (va + vb + vc);
+  bary[0] = 1.0 - v - w;
+  bary[1] = v;
+  bary[2] = w;
+
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_surrogate_seg_closest(REF_DBL *a, REF_DBL *b, REF_DBL *p,
+                                            REF_DBL *bary) {
+  REF_DBL ab[3], ap[3], len2, t;
+  REF_INT i;
+  for (i = 0; i < 3; i++) {
+    ab[i] = b[i] - a[i];
+    ap[i] = p[i] - a[i];
+  }
+  len2 = ref_math_dot(ab, ab);
+  t = 0.0;
+  if (ref_math_divisible(ref_math_dot(ab, ap), len2))
+    t = ref_math_dot(ab, ap) / len2;
+  t = MIN(1.0, MAX(0.0, t));
+  bary[0] = 1.0 - t;
+  bary[1] = t;
+  return REF_SUCCESS;
+}
+
+/* the element with the closest point to target among the tree candidates,
+ * corners and target have dim components */
+static REF_STATUS ref_surrogate_closest(REF_SEARCH ref_search, REF_INT ncorner,
+                                        REF_INT dim, REF_DBL *corner,
+                                        REF_DBL *target, REF_INT *best,
+                                        REF_DBL *best_bary) {
+  REF_LIST ref_list;
+  REF_INT item, elem, i, k;
+  REF_DBL p[3], xyz[9], closest[3], bary[3], dist, best_dist;
+
+  *best = REF_EMPTY;
+  best_dist = REF_DBL_MAX;
+  for (i = 0; i < 3; i++) p[i] = (i < dim) ? target[i] : 0.0;
+  RSS(ref_list_create(&ref_list), "create list");
+  RSS(ref_search_nearest_candidates(ref_search, ref_list, p), "candidates");
+  each_ref_list_item(ref_list, item) {
+    elem = ref_list_value(ref_list, item);
+    for (k = 0; k < ncorner; k++)
+      for (i = 0; i < 3; i++)
+        xyz[i + 3 * k] =
+            (i < dim) ? corner[i + dim * k + dim * ncorner * elem] : 0.0;
+    if (3 == ncorner) {
+      RSS(ref_surrogate_tri_closest(&(xyz[0]), &(xyz[3]), &(xyz[6]), p, bary),
+          "tri");
+    } else {
+      RSS(ref_surrogate_seg_closest(&(xyz[0]), &(xyz[3]), p, bary), "seg");
+    }
+    dist = 0.0;
+    for (i = 0; i < 3; i++) {
+      closest[i] = 0.0;
+      for (k = 0; k < ncorner; k++) closest[i] += bary[k] * xyz[i + 3 * k];
+      dist += pow(closest[i] - p[i], 2);
+    }
+    if (dist < best_dist) {
+      best_dist = dist;
+      *best = elem;
+      for (k = 0; k < ncorner; k++) best_bary[k] = bary[k];
+    }
+  }
+  RSS(ref_list_free(ref_list), "free list");
+  RUS(REF_EMPTY, *best, "no surrogate candidate");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_surrogate_create(REF_SURROGATE *ref_surrogate_ptr,
+                                REF_GRID ref_grid) {
+  REF_SURROGATE ref_surrogate;
+  REF_MPI ref_mpi = ref_grid_mpi(ref_grid);
+  REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_GEOM ref_geom = ref_grid_geom(ref_grid);
+  REF_CELL ref_cell;
+  REF_INT cell, nodes[REF_CELL_MAX_SIZE_PER], part, geom, sense;
+  REF_INT i, j, n, id, *local_id, *source, *first, *order;
+  REF_DBL *local, *all, *data;
+  REF_BOOL supported;
+
+  ref_malloc(*ref_surrogate_ptr, 1, REF_SURROGATE_STRUCT);
+  ref_surrogate = (*ref_surrogate_ptr);
+
+  ref_cell = ref_grid_tri(ref_grid);
+  ref_malloc(local_id, ref_cell_n(ref_cell), REF_INT);
+  ref_malloc(local, REF_SURROGATE_TRI_DBL * ref_cell_n(ref_cell), REF_DBL);
+  n = 0;
+  each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
+    RSS(ref_cell_part(ref_cell, ref_node, cell, &part), "part");
+    if (ref_mpi_rank(ref_mpi) != part) continue;
+    id = nodes[ref_cell_id_index(ref_cell)];
+    supported = REF_TRUE;
+    for (j = 0; j < 3; j++) {
+      if (REF_NOT_FOUND ==
+          ref_geom_find(ref_geom, nodes[j], REF_GEOM_FACE, id, &geom))
+        supported = REF_FALSE;
+    }
+    if (!supported) continue;
+    local_id[n] = id;
+    data = &(local[REF_SURROGATE_TRI_DBL * n]);
+    for (j = 0; j < 3; j++) {
+      for (i = 0; i < 3; i++)
+        data[i + 3 * j] = ref_node_xyz(ref_node, i, nodes[j]);
+      RSS(ref_geom_cell_tuv(ref_geom, nodes[j], nodes, REF_GEOM_FACE,
+                            &(data[9 + 2 * j]), &sense),
+          "corner uv");
+      RSS(ref_surrogate_corner_normal(ref_grid, nodes[j], id,
+                                      &(data[15 + 3 * j])),
+          "corner normal");
+    }
+    n++;
+  }
+  RSS(ref_mpi_allconcat(ref_mpi, 1, n, local_id, &(ref_surrogate->ntri),
+                        &source, (void **)&(ref_surrogate->tri_id),
+                        REF_INT_TYPE),
+      "concat id");
+  ref_free(source);
+  RSS(ref_mpi_allconcat(ref_mpi, REF_SURROGATE_TRI_DBL, n, local,
+                        &(ref_surrogate->ntri), &source, (void **)&all,
+                        REF_DBL_TYPE),
+      "concat tri");
+  ref_free(source);
+  ref_free(local);
+  ref_free(local_id);
+
+  ref_malloc(ref_surrogate->tri_xyz, 9 * ref_surrogate->ntri, REF_DBL);
+  ref_malloc(ref_surrogate->tri_uv, 6 * ref_surrogate->ntri, REF_DBL);
+  ref_malloc(ref_surrogate->tri_normal, 9 * ref_surrogate->ntri, REF_DBL);
+  ref_malloc(ref_surrogate->tri_curve, 8 * ref_surrogate->ntri, REF_DBL);
+  for (cell = 0; cell < ref_surrogate->ntri; cell++) {
+    data = &(all[REF_SURROGATE_TRI_DBL * cell]);
+    for (i = 0; i < 9; i++) ref_surrogate->tri_xyz[i + 9 * cell] = data[i];
+    for (i = 0; i < 6; i++) ref_surrogate->tri_uv[i + 6 * cell] = data[9 + i];
+    for (i = 0; i < 9; i++)
+      ref_surrogate->tri_normal[i + 9 * cell] = data[15 + i];
+    RSS(ref_surrogate_tri_curve(&(ref_surrogate->tri_xyz[9 * cell]),
+                                &(ref_surrogate->tri_normal[9 * cell]),
+                                &(ref_surrogate->tri_curve[8 * cell])),
+        "tri curvature");
+  }
+  ref_free(all);
+
+  ref_cell = ref_grid_edg(ref_grid);
+  ref_malloc(local_id, ref_cell_n(ref_cell), REF_INT);
+  ref_malloc(local, REF_SURROGATE_SEG_DBL * ref_cell_n(ref_cell), REF_DBL);
+  n = 0;
+  each_ref_cell_valid_cell_with_nodes(ref_cell, cell, nodes) {
+    RSS(ref_cell_part(ref_cell, ref_node, cell, &part), "part");
+    if (ref_mpi_rank(ref_mpi) != part) continue;
+    id = nodes[ref_cell_id_index(ref_cell)];
+    supported = REF_TRUE;
+    for (j = 0; j < 2; j++) {
+      if (REF_NOT_FOUND ==
+          ref_geom_find(ref_geom, nodes[j], REF_GEOM_EDGE, id, &geom))
+        supported = REF_FALSE;
+    }
+    if (!supported) continue;
+    local_id[n] = id;
+    data = &(local[REF_SURROGATE_SEG_DBL * n]);
+    for (j = 0; j < 2; j++) {
+      for (i = 0; i < 3; i++)
+        data[i + 3 * j] = ref_node_xyz(ref_node, i, nodes[j]);
+      RSS(ref_geom_cell_tuv(ref_geom, nodes[j], nodes, REF_GEOM_EDGE,
+                            &(data[6 + j]), &sense),
+          "end t");
+      RSS(ref_surrogate_end_curve(ref_grid, nodes[j], nodes[1 - j], id,
+                                  &(data[8 + 4 * j])),
+          "end curve");
+    }
+    n++;
+  }
+  RSS(ref_mpi_allconcat(ref_mpi, 1, n, local_id, &(ref_surrogate->nseg),
+                        &source, (void **)&(ref_surrogate->seg_id),
+                        REF_INT_TYPE),
+      "concat id");
+  ref_free(source);
+  RSS(ref_mpi_allconcat(ref_mpi, REF_SURROGATE_SEG_DBL, n, local,
+                        &(ref_surrogate->nseg), &source, (void **)&all,
+                        REF_DBL_TYPE),
+      "concat seg");
+  ref_free(source);
+  ref_free(local);
+  ref_free(local_id);
+
+  ref_malloc(ref_surrogate->seg_xyz, 6 * ref_surrogate->nseg, REF_DBL);
+  ref_malloc(ref_surrogate->seg_t, 2 * ref_surrogate->nseg, REF_DBL);
+  ref_malloc(ref_surrogate->seg_curve, 8 * ref_surrogate->nseg, REF_DBL);
+  for (cell = 0; cell < ref_surrogate->nseg; cell++) {
+    data = &(all[REF_SURROGATE_SEG_DBL * cell]);
+    for (i = 0; i < 6; i++) ref_surrogate->seg_xyz[i + 6 * cell] = data[i];
+    for (i = 0; i < 2; i++) ref_surrogate->seg_t[i + 2 * cell] = data[6 + i];
+    for (i = 0; i < 8; i++)
+      ref_surrogate->seg_curve[i + 8 * cell] = data[8 + i];
+  }
+  ref_free(all);
+
+  ref_surrogate->nface = 0;
+  for (cell = 0; cell < ref_surrogate->ntri; cell++)
+    ref_surrogate->nface =
+        MAX(ref_surrogate->nface, ref_surrogate->tri_id[cell]);
+  ref_surrogate->nedge = 0;
+  for (cell = 0; cell < ref_surrogate->nseg; cell++)
+    ref_surrogate->nedge =
+        MAX(ref_surrogate->nedge, ref_surrogate->seg_id[cell]);
+
+  ref_malloc(ref_surrogate->face_xyz, ref_surrogate->nface + 1, REF_SEARCH);
+  ref_malloc(ref_surrogate->face_uv, ref_surrogate->nface + 1, REF_SEARCH);
+  RSS(ref_surrogate_bucket(ref_surrogate->ntri, ref_surrogate->tri_id,
+                           ref_surrogate->nface, &first, &order),
+      "tris by face");
+  for (id = 0; id <= ref_surrogate->nface; id++) {
+    n = first[id + 1] - first[id];
+    RSS(ref_surrogate_bulk(&(ref_surrogate->face_xyz[id]), n,
+                           &(order[first[id]]), 3, 3, ref_surrogate->tri_xyz),
+        "face xyz tree");
+    RSS(ref_surrogate_bulk(&(ref_surrogate->face_uv[id]), n,
+                           &(order[first[id]]), 3, 2, ref_surrogate->tri_uv),
+        "face uv tree");
+  }
+  ref_free(order);
+  ref_free(first);
+  ref_malloc(ref_surrogate->edge_xyz, ref_surrogate->nedge + 1, REF_SEARCH);
+  ref_malloc(ref_surrogate->edge_t, ref_surrogate->nedge + 1, REF_SEARCH);
+  RSS(ref_surrogate_bucket(ref_surrogate->nseg, ref_surrogate->seg_id,
+                           ref_surrogate->nedge, &first, &order),
+      "segs by edge");
+  for (id = 0; id <= ref_surrogate->nedge; id++) {
+    n = first[id + 1] - first[id];
+    RSS(ref_surrogate_bulk(&(ref_surrogate->edge_xyz[id]), n,
+                           &(order[first[id]]), 2, 3, ref_surrogate->seg_xyz),
+        "edge xyz tree");
+    RSS(ref_surrogate_bulk(&(ref_surrogate->edge_t[id]), n,
+                           &(order[first[id]]), 2, 1, ref_surrogate->seg_t),
+        "edge t tree");
+  }
+  ref_free(order);
+  ref_free(first);
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_surrogate_free(REF_SURROGATE ref_surrogate) {
+  REF_INT id;
+  if (NULL == (void *)ref_surrogate) return REF_NULL;
+  for (id = 0; id <= ref_surrogate->nedge; id++) {
+    if (NULL != ref_surrogate->edge_t[id])
+      RSS(ref_search_free(ref_surrogate->edge_t[id]), "free t");
+    if (NULL != ref_surrogate->edge_xyz[id])
+      RSS(ref_search_free(ref_surrogate->edge_xyz[id]), "free xyz");
+  }
+  ref_free(ref_surrogate->edge_t);
+  ref_free(ref_surrogate->edge_xyz);
+  for (id = 0; id <= ref_surrogate->nface; id++) {
+    if (NULL != ref_surrogate->face_uv[id])
+      RSS(ref_search_free(ref_surrogate->face_uv[id]), "free uv");
+    if (NULL != ref_surrogate->face_xyz[id])
+      RSS(ref_search_free(ref_surrogate->face_xyz[id]), "free xyz");
+  }
+  ref_free(ref_surrogate->face_uv);
+  ref_free(ref_surrogate->face_xyz);
+  ref_free(ref_surrogate->seg_curve);
+  ref_free(ref_surrogate->seg_t);
+  ref_free(ref_surrogate->seg_xyz);
+  ref_free(ref_surrogate->seg_id);
+  ref_free(ref_surrogate->tri_curve);
+  ref_free(ref_surrogate->tri_normal);
+  ref_free(ref_surrogate->tri_uv);
+  ref_free(ref_surrogate->tri_xyz);
+  ref_free(ref_surrogate->tri_id);
+  ref_free(ref_surrogate);
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_surrogate_open(REF_GRID ref_grid) {
+  REF_GEOM ref_geom = ref_grid_geom(ref_grid);
+  REF_SURROGATE ref_surrogate;
+  if (NULL != ref_geom->surrogate)
+    RSS(ref_surrogate_free((REF_SURROGATE)(ref_geom->surrogate)), "free");
+  RSS(ref_surrogate_create(&ref_surrogate, ref_grid), "create");
+  ref_geom->surrogate = (void *)ref_surrogate;
+  return REF_SUCCESS;
+}
+
+static REF_STATUS ref_surrogate_tree(REF_SURROGATE ref_surrogate,
+                                     REF_INT type, REF_INT id,
+                                     REF_BOOL param_space,
+                                     REF_SEARCH *ref_search) {
+  *ref_search = NULL;
+  switch (type) {
+    case REF_GEOM_EDGE:
+      if (id < 1 || id > ref_surrogate->nedge) return REF_NOT_FOUND;
+      *ref_search = param_space ? ref_surrogate->edge_t[id]
+                                : ref_surrogate->edge_xyz[id];
+      break;
+    case REF_GEOM_FACE:
+      if (id < 1 || id > ref_surrogate->nface) return REF_NOT_FOUND;
+      *ref_search = param_space ? ref_surrogate->face_uv[id]
+                                : ref_surrogate->face_xyz[id];
+      break;
+    default:
+      RSS(REF_IMPLEMENT, "surrogate holds edges and faces");
+  }
+  if (NULL == (void *)(*ref_search)) return REF_NOT_FOUND;
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_surrogate_eval_at(REF_SURROGATE ref_surrogate, REF_INT type,
+                                 REF_INT id, REF_DBL *param, REF_DBL *xyz) {
+  REF_SEARCH ref_search;
+  REF_INT elem, i, k;
+  REF_DBL bary[3];
+
+  RSS(ref_surrogate_tree(ref_surrogate, type, id, REF_TRUE, &ref_search),
+      "no surrogate for id");
+  if (REF_GEOM_EDGE == type) {
+    RSS(ref_surrogate_closest(ref_search, 2, 1, ref_surrogate->seg_t, param,
+                              &elem, bary),
+        "closest t");
+    for (i = 0; i < 3; i++) {
+      xyz[i] = 0.0;
+      for (k = 0; k < 2; k++)
+        xyz[i] += bary[k] * ref_surrogate->seg_xyz[i + 3 * k + 6 * elem];
+    }
+  } else {
+    RSS(ref_surrogate_closest(ref_search, 3, 2, ref_surrogate->tri_uv, param,
+                              &elem, bary),
+        "closest uv");
+    for (i = 0; i < 3; i++) {
+      xyz[i] = 0.0;
+      for (k = 0; k < 3; k++)
+        xyz[i] += bary[k] * ref_surrogate->tri_xyz[i + 3 * k + 9 * elem];
+    }
+  }
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_surrogate_inverse_eval(REF_SURROGATE ref_surrogate,
+                                      REF_INT type, REF_INT id, REF_DBL *xyz,
+                                      REF_DBL *param) {
+  REF_SEARCH ref_search;
+  REF_INT elem, i, k;
+  REF_DBL bary[3];
+
+  RSS(ref_surrogate_tree(ref_surrogate, type, id, REF_FALSE, &ref_search),
+      "no surrogate for id");
+  if (REF_GEOM_EDGE == type) {
+    RSS(ref_surrogate_closest(ref_search, 2, 3, ref_surrogate->seg_xyz, xyz,
+                              &elem, bary),
+        "closest seg");
+    param[0] = 0.0;
+    for (k = 0; k < 2; k++)
+      param[0] += bary[k] * ref_surrogate->seg_t[k + 2 * elem];
+  } else {
+    RSS(ref_surrogate_closest(ref_search, 3, 3, ref_surrogate->tri_xyz, xyz,
+                              &elem, bary),
+        "closest tri");
+    for (i = 0; i < 2; i++) {
+      param[i] = 0.0;
+      for (k = 0; k < 3; k++)
+        param[i] += bary[k] * ref_surrogate->tri_uv[i + 2 * k + 6 * elem];
+    }
+  }
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_surrogate_face_normal(REF_SURROGATE ref_surrogate, REF_INT id,
+                                     REF_DBL *uv, REF_DBL *normal) {
+  REF_SEARCH ref_search;
+  REF_INT elem, i, k;
+  REF_DBL bary[3];
+
+  RSS(ref_surrogate_tree(ref_surrogate, REF_GEOM_FACE, id, REF_TRUE,
+                         &ref_search),
+      "no surrogate for id");
+  RSS(ref_surrogate_closest(ref_search, 3, 2, ref_surrogate->tri_uv, uv, &elem,
+                            bary),
+      "closest uv");
+  for (i = 0; i < 3; i++) {
+    normal[i] = 0.0;
+    for (k = 0; k < 3; k++)
+      normal[i] += bary[k] * ref_surrogate->tri_normal[i + 3 * k + 9 * elem];
+  }
+  RSS(ref_math_normalize(normal), "interpolated normal");
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_surrogate_face_curvature(REF_SURROGATE ref_surrogate,
+                                        REF_INT id, REF_DBL *uv, REF_DBL *kr,
+                                        REF_DBL *r, REF_DBL *ks, REF_DBL *s) {
+  REF_SEARCH ref_search;
+  REF_INT elem, i;
+  REF_DBL bary[3], *curve;
+
+  RSS(ref_surrogate_tree(ref_surrogate, REF_GEOM_FACE, id, REF_TRUE,
+                         &ref_search),
+      "no surrogate for id");
+  RSS(ref_surrogate_closest(ref_search, 3, 2, ref_surrogate->tri_uv, uv, &elem,
+                            bary),
+      "closest uv");
+  curve = &(ref_surrogate->tri_curve[8 * elem]);
+  *kr = curve[0];
+  *ks = curve[4];
+  for (i = 0; i < 3; i++) {
+    r[i] = curve[1 + i];
+    s[i] = curve[5 + i];
+  }
+
+  return REF_SUCCESS;
+}
+
+REF_STATUS ref_surrogate_edge_curvature(REF_SURROGATE ref_surrogate,
+                                        REF_INT id, REF_DBL *t, REF_DBL *k,
+                                        REF_DBL *normal) {
+  REF_SEARCH ref_search;
+  REF_INT elem, i, end;
+  REF_DBL bary[2], *curve;
+
+  RSS(ref_surrogate_tree(ref_surrogate, REF_GEOM_EDGE, id, REF_TRUE,
+                         &ref_search),
+      "no surrogate for id");
+  RSS(ref_surrogate_closest(ref_search, 2, 1, ref_surrogate->seg_t, t, &elem,
+                            bary),
+      "closest t");
+  curve = &(ref_surrogate->seg_curve[8 * elem]);
+  *k = 0.0;
+  for (i = 0; i < 3; i++) normal[i] = 0.0;
+  for (end = 0; end < 2; end++) {
+    *k += bary[end] * curve[0 + 4 * end];
+    for (i = 0; i < 3; i++) normal[i] += bary[end] * curve[1 + i + 4 * end];
+  }
+  RXS(ref_math_normalize(normal), REF_DIV_ZERO, "straight");
+
+  return REF_SUCCESS;
+}
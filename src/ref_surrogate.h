@@ -0,0 +1,79 @@
+
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef REF_SURROGATE_H
+#define REF_SURROGATE_H
+
+#include "ref_defs.h"
+
+BEGIN_C_DECLORATION
+typedef struct REF_SURROGATE_STRUCT REF_SURROGATE_STRUCT;
+typedef REF_SURROGATE_STRUCT *REF_SURROGATE;
+END_C_DECLORATION
+
+#include "ref_grid.h"
+#include "ref_search.h"
+
+BEGIN_C_DECLORATION
+/* frozen copy of the geometry associated boundary triangulation, stands in
+ * for a CAD kernel: eval at t or uv, inverse eval, and curvature */
+struct REF_SURROGATE_STRUCT {
+  REF_INT ntri;
+  REF_INT *tri_id;
+  REF_DBL *tri_xyz;    /* 9 per tri, corner xyz */
+  REF_DBL *tri_uv;     /* 6 per tri, corner uv */
+  REF_DBL *tri_normal; /* 9 per tri, corner normal of the face */
+  REF_DBL *tri_curve;  /* 8 per tri, kr r[3] ks s[3] */
+  REF_INT nseg;
+  REF_INT *seg_id;
+  REF_DBL *seg_xyz;   /* 6 per seg, end xyz */
+  REF_DBL *seg_t;     /* 2 per seg, end t */
+  REF_DBL *seg_curve; /* 8 per seg, end k normal[3] */
+  REF_INT nface, nedge;
+  REF_SEARCH *face_xyz, *face_uv; /* indexed by face id */
+  REF_SEARCH *edge_xyz, *edge_t;  /* indexed by edge id */
+};
+
+#define ref_surrogate_ntri(ref_surrogate) ((ref_surrogate)->ntri)
+#define ref_surrogate_nseg(ref_surrogate) ((ref_surrogate)->nseg)
+
+/* collective, every part holds the complete surface */
+REF_STATUS ref_surrogate_create(REF_SURROGATE *ref_surrogate,
+                                REF_GRID ref_grid);
+REF_STATUS ref_surrogate_free(REF_SURROGATE ref_surrogate);
+/* collective, attaches a surrogate of the current surface to ref_geom */
+REF_STATUS ref_surrogate_open(REF_GRID ref_grid);
+
+REF_STATUS ref_surrogate_eval_at(REF_SURROGATE ref_surrogate, REF_INT type,
+                                 REF_INT id, REF_DBL *param, REF_DBL *xyz);
+/* closest point of edge or face id to xyz, xyz is not modified */
+REF_STATUS ref_surrogate_inverse_eval(REF_SURROGATE ref_surrogate,
+                                      REF_INT type, REF_INT id, REF_DBL *xyz,
+                                      REF_DBL *param);
+REF_STATUS ref_surrogate_face_normal(REF_SURROGATE ref_surrogate, REF_INT id,
+                                     REF_DBL *uv, REF_DBL *normal);
+REF_STATUS ref_surrogate_face_curvature(REF_SURROGATE ref_surrogate,
+                                        REF_INT id, REF_DBL *uv, REF_DBL *kr,
+                                        REF_DBL *r, REF_DBL *ks, REF_DBL *s);
+REF_STATUS ref_surrogate_edge_curvature(REF_SURROGATE ref_surrogate,
+                                        REF_INT id, REF_DBL *t, REF_DBL *k,
+                                        REF_DBL *normal);
+
+END_C_DECLORATION
+
+#endif /* REF_SURROGATE_H */
@@ -0,0 +1,208 @@
+
+
+/* Copyright 2014 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space
+ * Administration. No copyright is claimed in the United States under
+ * Title 17, U.S. Code.  All Other Rights Reserved.
+ *
+ * The refine platform is licensed under the Apache License, Version
+ * 2.0 (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+ * implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include "ref_surrogate.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ref_cell.h"
+#include "ref_geom.h"
+#include "ref_grid.h"
+#include "ref_math.h"
+#include "ref_mpi.h"
+#include "ref_node.h"
+
+#define NI (13)
+#define NJ (5)
+
+/* unit radius half cylinder, face 1 with uv = (theta, z), edge 1 at z=0 */
+static REF_STATUS half_cylinder(REF_GRID *ref_grid_ptr, REF_MPI ref_mpi) {
+  REF_GRID ref_grid;
+  REF_NODE ref_node;
+  REF_INT i, j, node, cell, nodes[REF_CELL_MAX_SIZE_PER];
+  REF_DBL theta, param[2];
+
+  RSS(ref_grid_create(ref_grid_ptr, ref_mpi), "create");
+  ref_grid = *ref_grid_ptr;
+  ref_node = ref_grid_node(ref_grid);
+  for (j = 0; j < NJ; j++) {
+    for (i = 0; i < NI; i++) {
+      theta = ref_math_pi * (REF_DBL)i / (REF_DBL)(NI - 1);
+      RSS(ref_node_add(ref_node, i + NI * j, &node), "add");
+      ref_node_xyz(ref_node, 0, node) = cos(theta);
+      ref_node_xyz(ref_node, 1, node) = sin(theta);
+      ref_node_xyz(ref_node, 2, node) = (REF_DBL)j / (REF_DBL)(NJ - 1);
+      param[0] = theta;
+      param[1] = ref_node_xyz(ref_node, 2, node);
+      RSS(ref_geom_add(ref_grid_geom(ref_grid), node, REF_GEOM_FACE, 1, param),
+          "face");
+      if (0 == j)
+        RSS(ref_geom_add(ref_grid_geom(ref_grid), node, REF_GEOM_EDGE, 1,
+                         param),
+            "edge");
+    }
+  }
+  for (j = 0; j < NJ - 1; j++) {
+    for (i = 0; i < NI - 1; i++) {
+      nodes[0] = i + NI * j;
+      nodes[1] = i + 1 + NI * j;
+      nodes[2] = i + 1 + NI * (j + 1);
+      nodes[3] = 1;
+      RSS(ref_cell_add(ref_grid_tri(ref_grid), nodes, &cell), "tri");
+      nodes[0] = i + NI * j;
+      nodes[1] = i + 1 + NI * (j + 1);
+      nodes[2] = i + NI * (j + 1);
+      nodes[3] = 1;
+      RSS(ref_cell_add(ref_grid_tri(ref_grid), nodes, &cell), "tri");
+    }
+  }
+  for (i = 0; i < NI - 1; i++) {
+    nodes[0] = i;
+    nodes[1] = i + 1;
+    nodes[2] = 1;
+    RSS(ref_cell_add(ref_grid_edg(ref_grid), nodes, &cell), "edg");
+  }
+  return REF_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+  REF_MPI ref_mpi;
+  RSS(ref_mpi_start(argc, argv), "start");
+  RSS(ref_mpi_create(&ref_mpi), "make mpi");
+
+  { /* every part gathers the surface */
+    REF_GRID ref_grid;
+    REF_SURROGATE ref_surrogate;
+    RSS(half_cylinder(&ref_grid, ref_mpi), "fixture");
+    RSS(ref_surrogate_create(&ref_surrogate, ref_grid), "create");
+    REIS(ref_mpi_n(ref_mpi) * 2 * (NI - 1) * (NJ - 1),
+         ref_surrogate_ntri(ref_surrogate), "tri count");
+    REIS(ref_mpi_n(ref_mpi) * (NI - 1), ref_surrogate_nseg(ref_surrogate),
+         "seg count");
+    RSS(ref_surrogate_free(ref_surrogate), "free");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  { /* face eval and inverse eval round trip */
+    REF_GRID ref_grid;
+    REF_SURROGATE ref_surrogate;
+    REF_DBL uv[2], xyz[3], radius;
+    RSS(half_cylinder(&ref_grid, ref_mpi), "fixture");
+    RSS(ref_surrogate_create(&ref_surrogate, ref_grid), "create");
+    uv[0] = 0.5;
+    uv[1] = 0.37;
+    RSS(ref_surrogate_eval_at(ref_surrogate, REF_GEOM_FACE, 1, uv, xyz),
+        "eval");
+    RWDS(0.37, xyz[2], -1.0, "z");
+    radius = sqrt(xyz[0] * xyz[0] + xyz[1] * xyz[1]);
+    RWDS(1.0, radius, 1.0e-2, "faceted radius");
+    xyz[0] = 1.2 * cos(0.5);
+    xyz[1] = 1.2 * sin(0.5);
+    RSS(ref_surrogate_inverse_eval(ref_surrogate, REF_GEOM_FACE, 1, xyz, uv),
+        "inv");
+    RWDS(0.5, uv[0], 5.0e-2, "faceted theta");
+    RWDS(0.37, uv[1], -1.0, "z");
+    RSS(ref_surrogate_free(ref_surrogate), "free");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  { /* face curvature and normal */
+    REF_GRID ref_grid;
+    REF_SURROGATE ref_surrogate;
+    REF_DBL uv[2], kr, r[3], ks, s[3], normal[3];
+    RSS(half_cylinder(&ref_grid, ref_mpi), "fixture");
+    RSS(ref_surrogate_create(&ref_surrogate, ref_grid), "create");
+    uv[0] = 0.5 * ref_math_pi + 0.1;
+    uv[1] = 0.6;
+    RSS(ref_surrogate_face_curvature(ref_surrogate, 1, uv, &kr, r, &ks, s),
+        "curve");
+    RWDS(1.0, ABS(kr), 1.0e-8, "kr");
+    RWDS(0.0, ks, 1.0e-8, "ks");
+    RWDS(0.0, r[2], 1.0e-8, "r around");
+    RWDS(1.0, ABS(s[2]), 1.0e-8, "s along");
+    RSS(ref_surrogate_face_normal(ref_surrogate, 1, uv, normal), "norm");
+    RWDS(0.0, normal[2], 1.0e-8, "radial");
+    RWDS(1.0, ABS(normal[0] * cos(uv[0]) + normal[1] * sin(uv[0])), 1.0e-2,
+         "radial");
+    RSS(ref_surrogate_free(ref_surrogate), "free");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  { /* edge eval, inverse eval, and curvature */
+    REF_GRID ref_grid;
+    REF_SURROGATE ref_surrogate;
+    REF_DBL t, xyz[3], k, normal[3];
+    RSS(half_cylinder(&ref_grid, ref_mpi), "fixture");
+    RSS(ref_surrogate_create(&ref_surrogate, ref_grid), "create");
+    t = 0.5 * ref_math_pi;
+    RSS(ref_surrogate_eval_at(ref_surrogate, REF_GEOM_EDGE, 1, &t, xyz),
+        "eval");
+    RWDS(0.0, xyz[0], 1.0e-12, "x");
+    RWDS(1.0, xyz[1], 1.0e-12, "y on node");
+    RWDS(0.0, xyz[2], -1.0, "z");
+    xyz[0] = 2.0 * cos(0.7);
+    xyz[1] = 2.0 * sin(0.7);
+    xyz[2] = 0.3;
+    RSS(ref_surrogate_inverse_eval(ref_surrogate, REF_GEOM_EDGE, 1, xyz, &t),
+        "inv");
+    RWDS(0.7, t, 5.0e-2, "faceted t");
+    t = 0.5 * ref_math_pi;
+    RSS(ref_surrogate_edge_curvature(ref_surrogate, 1, &t, &k, normal),
+        "curve");
+    RWDS(1.0, k, 1.0e-12, "unit circle");
+    RWDS(0.0, normal[0], 1.0e-12, "to center");
+    RWDS(-1.0, normal[1], 1.0e-12, "to center");
+    RSS(ref_surrogate_free(ref_surrogate), "free");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  { /* geom constrain evaluates the surrogate without a model */
+    REF_GRID ref_grid;
+    REF_NODE ref_node;
+    REF_INT node, geom;
+    REF_DBL uv[2], radius;
+    RSS(half_cylinder(&ref_grid, ref_mpi), "fixture");
+    ref_node = ref_grid_node(ref_grid);
+    RSS(ref_surrogate_open(ref_grid), "open");
+    RAS(ref_geom_surrogated(ref_grid_geom(ref_grid)), "attached");
+    node = 6 + NI * 2;
+    ref_node_xyz(ref_node, 0, node) = 0.0;
+    ref_node_xyz(ref_node, 1, node) = 0.0;
+    ref_node_xyz(ref_node, 2, node) = 0.0;
+    RSS(ref_geom_find(ref_grid_geom(ref_grid), node, REF_GEOM_FACE, 1, &geom),
+        "find");
+    uv[0] = 0.5 * ref_math_pi + 0.05;
+    uv[1] = 0.45;
+    RSS(ref_geom_add(ref_grid_geom(ref_grid), node, REF_GEOM_FACE, 1, uv),
+        "move uv");
+    RSS(ref_geom_constrain(ref_grid, node), "constrain");
+    RWDS(0.45, ref_node_xyz(ref_node, 2, node), -1.0, "z");
+    radius = sqrt(pow(ref_node_xyz(ref_node, 0, node), 2) +
+                  pow(ref_node_xyz(ref_node, 1, node), 2));
+    RWDS(1.0, radius, 1.0e-2, "faceted radius");
+    RSS(ref_grid_free(ref_grid), "free");
+  }
+
+  RSS(ref_mpi_free(ref_mpi), "mpi free");
+  RSS(ref_mpi_stop(), "stop");
+
+  return 0;
+}
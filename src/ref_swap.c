@@ -24,6 +24,7 @@
 #include "ref_edge.h"
 #include "ref_export.h"
 #include "ref_math.h"
+#include "ref_perf.h"
 
 /* parallel requirement, all local */
 REF_STATUS ref_swap_remove_two_face_cell(REF_GRID ref_grid, REF_INT cell) {
@@ -713,6 +714,7 @@ static REF_STATUS ref_swap_edge_mixed(REF_GRID ref_grid, REF_INT node0,
 
 REF_STATUS ref_swap_tri_pass(REF_GRID ref_grid) {
   REF_NODE ref_node = ref_grid_node(ref_grid);
+  REF_PERF ref_perf = ref_grid_perf(ref_grid);
   REF_EDGE ref_edge;
   REF_INT edge, node0, node1;
   REF_BOOL allowed, has_edg, has_tri;
@@ -731,39 +733,73 @@ REF_STATUS ref_swap_tri_pass(REF_GRID ref_grid) {
     RSS(ref_cell_has_side(ref_grid_tri(ref_grid), node0, node1, &has_tri),
         "still triangle side");
     if (!has_tri) continue;
+    ref_perf_attempt(ref_perf);
+    RSS(ref_perf_lap(ref_grid, REF_PERF_LAST_REASON), "lap");
 
     /* skip if neither node is owned */
-    if (!ref_node_owned(ref_node, node0) && !ref_node_owned(ref_node, node1))
+    if (!ref_node_owned(ref_node, node0) && !ref_node_owned(ref_node, node1)) {
+      ref_perf_reject(ref_perf, REF_PERF_GHOST);
       continue;
+    }
 
     RSS(ref_swap_edge_mixed(ref_grid, node0, node1, &allowed), "faceid");
-    if (!allowed) continue;
+    RSS(ref_perf_lap(ref_grid, REF_PERF_MIXED), "lap");
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_MIXED);
+      continue;
+    }
     RSS(ref_swap_same_faceid(ref_grid, node0, node1, &allowed), "faceid");
-    if (!allowed) continue;
+    RSS(ref_perf_lap(ref_grid, REF_PERF_GEOMETRY), "lap");
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_GEOMETRY);
+      continue;
+    }
     RSS(ref_swap_manifold(ref_grid, node0, node1, &allowed), "manifold");
-    if (!allowed) continue;
+    RSS(ref_perf_lap(ref_grid, REF_PERF_GEOMETRY), "lap");
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_GEOMETRY);
+      continue;
+    }
     RSS(ref_swap_geom_topo(ref_grid, node0, node1, &allowed), "topo");
-    if (!allowed) continue;
+    RSS(ref_perf_lap(ref_grid, REF_PERF_GEOMETRY), "lap");
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_GEOMETRY);
+      continue;
+    }
     RSS(ref_swap_quality(ref_grid, node0, node1, &allowed), "qual");
-    if (!allowed) continue;
+    RSS(ref_perf_lap(ref_grid, REF_PERF_QUALITY), "lap");
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_QUALITY);
+      continue;
+    }
     RSS(ref_swap_ratio(ref_grid, node0, node1, &allowed), "ratio");
-    if (!allowed) continue;
+    RSS(ref_perf_lap(ref_grid, REF_PERF_RATIO), "lap");
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_RATIO);
+      continue;
+    }
     if (ref_grid_surf(ref_grid)) {
       RSS(ref_swap_conforming(ref_grid, node0, node1, &allowed), "normdev");
-      if (!allowed) continue;
     } else {
       RSS(ref_swap_outward_norm(ref_grid, node0, node1, &allowed), "area");
-      if (!allowed) continue;
+    }
+    RSS(ref_perf_lap(ref_grid, REF_PERF_CONFORMITY), "lap");
+    if (!allowed) {
+      ref_perf_reject(ref_perf, REF_PERF_CONFORMITY);
+      continue;
     }
 
     RSS(ref_swap_local_cell(ref_grid, node0, node1, &allowed), "local");
+    RSS(ref_perf_lap(ref_grid, REF_PERF_GHOST), "lap");
     if (!allowed) {
       ref_node_age(ref_node, node0)++;
       ref_node_age(ref_node, node1)++;
+      ref_perf_reject(ref_perf, REF_PERF_GHOST);
       continue;
     }
 
     RSS(ref_swap_tri_edge(ref_grid, node0, node1), "swap");
+    ref_perf_success(ref_perf);
   }
 
   ref_edge_free(ref_edge);
@@ -95,6 +95,7 @@ int main(int argc, char *argv[]) {
         ref_node_xyz(ref_node, 1, node) += dy;
         ref_node_xyz(ref_node, 2, node) += dz;
       }
+      RSS(ref_node_index_invalidate(ref_node), "moved");
     }
     if (strcmp(argv[pos], "--scale") == 0) {
       printf("%d: --scale\n", pos);
@@ -108,6 +109,7 @@ int main(int argc, char *argv[]) {
         ref_node_xyz(ref_node, 1, node) *= ds;
         ref_node_xyz(ref_node, 2, node) *= ds;
       }
+      RSS(ref_node_index_invalidate(ref_node), "moved");
     }
     if (strcmp(argv[pos], "--rotate") == 0) {
       printf("%d: --rotate\n", pos);
@@ -125,6 +127,7 @@ int main(int argc, char *argv[]) {
         ref_node_xyz(ref_node, 2, node) =
             x * sin(rotate_rad) + z * cos(rotate_rad);
       }
+      RSS(ref_node_index_invalidate(ref_node), "moved");
     }
     if (strcmp(argv[pos], "--egads") == 0) {
       printf("%d: --egads\n", pos);
@@ -209,6 +212,7 @@ int main(int argc, char *argv[]) {
           }
         }
       }
+      RSS(ref_node_index_invalidate(ref_node), "moved");
       printf("max deviation %e\n", deviation);
     }
     if (strcmp(argv[pos], "--drop-volume") == 0) {